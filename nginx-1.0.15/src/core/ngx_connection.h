@@ -47,6 +47,9 @@ struct ngx_listening_s {
     /* should be here because of the deferred accept */
     ngx_msec_t          post_accept_timeout;
 
+    /* reuseport模式下,该监听socket归属的worker进程编号 */
+    ngx_uint_t          worker;
+
     ngx_listening_t    *previous;
     /* 当前监听句柄对应着的ngx_connection_t结构体 */
     ngx_connection_t   *connection;
@@ -64,6 +67,12 @@ struct ngx_listening_s {
     unsigned            shared:1;    /* shared between threads or processes */
     unsigned            addr_ntop:1;
 
+#if (NGX_HAVE_REUSEPORT)
+    /* 为1表示每个worker进程拥有一个独立的SO_REUSEPORT监听socket */
+    unsigned            reuseport:1;
+    unsigned            add_reuseport:1;
+#endif
+
 #if (NGX_HAVE_INET6 && defined IPV6_V6ONLY)
     unsigned            ipv6only:2;
 #endif
@@ -108,6 +117,7 @@ typedef enum {
 
 #define NGX_LOWLEVEL_BUFFERED  0x0f
 #define NGX_SSL_BUFFERED       0x01
+#define NGX_IOURING_BUFFERED   0x02
 
 
 /* 代表一个被动连接 */
@@ -172,6 +182,7 @@ struct ngx_connection_s {
     unsigned            idle:1;
     unsigned            reusable:1;
     unsigned            close:1;
+    unsigned            need_last_buf:1;
 
     unsigned            sendfile:1;
     unsigned            sndlowat:1;
@@ -187,6 +198,10 @@ struct ngx_connection_s {
     ngx_buf_t          *busy_sendfile;
 #endif
 
+#if (NGX_THREAD_POOL)
+    ngx_thread_task_t  *sendfile_task;
+#endif
+
 #if (NGX_THREADS)
     ngx_atomic_t        lock;
 #endif
@@ -195,6 +210,7 @@ struct ngx_connection_s {
 
 ngx_listening_t *ngx_create_listening(ngx_conf_t *cf, void *sockaddr,
     socklen_t socklen);
+ngx_int_t ngx_clone_listening(ngx_cycle_t *cycle, ngx_listening_t *ls);
 ngx_int_t ngx_set_inherited_sockets(ngx_cycle_t *cycle);
 ngx_int_t ngx_open_listening_sockets(ngx_cycle_t *cycle);
 void ngx_configure_listening_sockets(ngx_cycle_t *cycle);
@@ -507,7 +507,8 @@ ngx_init_cycle(ngx_cycle_t *old_cycle)
                 continue;
             }
 
-            if (shm_zone[i].shm.size == oshm_zone[n].shm.size)
+            if (shm_zone[i].shm.size == oshm_zone[n].shm.size
+                && !shm_zone[i].noreuse)
             {
                 shm_zone[i].shm.addr = oshm_zone[n].shm.addr;
 
@@ -568,12 +569,27 @@ ngx_init_cycle(ngx_cycle_t *old_cycle)
                     continue;
                 }
 
+#if (NGX_HAVE_REUSEPORT)
+                /* reuseport的监听socket只能被同一个worker编号的副本继承 */
+                if (ls[i].worker != nls[n].worker)
+                {
+                    continue;
+                }
+#endif
+
                 if (ngx_cmp_sockaddr(nls[n].sockaddr, ls[i].sockaddr) == NGX_OK)
                 {
                     nls[n].fd = ls[i].fd;
                     nls[n].previous = &ls[i];
                     ls[i].remain = 1;
 
+#if (NGX_HAVE_REUSEPORT)
+                    if (nls[n].reuseport && !ls[i].reuseport)
+                    {
+                        nls[n].add_reuseport = 1;
+                    }
+#endif
+
                     if (ls[n].backlog != nls[i].backlog)
                     {
                         nls[n].listen = 1;
@@ -1086,7 +1102,7 @@ ngx_init_zone_pool(ngx_cycle_t *cycle, ngx_shm_zone_t *zn)
 
 #endif
 
-    if (ngx_shmtx_create(&sp->mutex, (void *) &sp->lock, file) != NGX_OK)
+    if (ngx_shmtx_create(&sp->mutex, &sp->lock, file) != NGX_OK)
     {
         return NGX_ERROR;
     }
@@ -1458,7 +1474,8 @@ ngx_shared_memory_add(ngx_conf_t *cf, ngx_str_t *name, size_t size, void *tag)
             continue;
         }
 
-        if (size && size != shm_zone[i].shm.size)
+        if (size && shm_zone[i].shm.size
+            && size != shm_zone[i].shm.size)
         {
             ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
                                "the size %uz of shared memory zone \"%V\" "
@@ -1467,6 +1484,18 @@ ngx_shared_memory_add(ngx_conf_t *cf, ngx_str_t *name, size_t size, void *tag)
             return NULL;
         }
 
+        /*
+         * a zone may be referenced without a size before the declaration
+         * that sets it, e.g. "zone name;" in several upstreams, so a zero
+         * size adopts the size declared later; a zone that never gets
+         * a size is rejected by ngx_init_cycle()
+         */
+
+        if (shm_zone[i].shm.size == 0)
+        {
+            shm_zone[i].shm.size = size;
+        }
+
         if (tag != shm_zone[i].tag)
         {
             ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
@@ -1493,6 +1522,7 @@ ngx_shared_memory_add(ngx_conf_t *cf, ngx_str_t *name, size_t size, void *tag)
     shm_zone->shm.exists = 0;
     shm_zone->init = NULL;
     shm_zone->tag = tag;
+    shm_zone->noreuse = 0;
 
     return shm_zone;
 }
@@ -34,6 +34,8 @@ struct ngx_shm_zone_s {
     ngx_shm_zone_init_pt      init;
     /* 对应ngx_shared_memory_add的tag参数 */
     void                     *tag;
+    /* the zone is always allocated anew on reconfiguration */
+    ngx_uint_t                noreuse;  /* unsigned  noreuse:1; */
 };
 
 
@@ -107,6 +109,8 @@ typedef struct {
      ngx_int_t                rlimit_sigpending;
      off_t                    rlimit_core;
 
+     size_t                   pool_cache_size;
+
      int                      priority;
 
      ngx_uint_t               cpu_affinity_n;
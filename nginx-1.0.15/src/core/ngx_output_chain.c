@@ -81,7 +81,7 @@ ngx_output_chain(ngx_output_chain_ctx_t *ctx, ngx_chain_t *in)
 
     for ( ;; ) {
 
-#if (NGX_HAVE_FILE_AIO)
+#if (NGX_HAVE_FILE_AIO || NGX_THREAD_POOL)
         if (ctx->aio) {
             return NGX_AGAIN;
         }
@@ -255,6 +255,13 @@ ngx_output_chain_as_is(ngx_output_chain_ctx_t *ctx, ngx_buf_t *buf)
         return 0;
     }
 
+#if (NGX_THREAD_POOL)
+    if (buf->in_file) {
+        buf->file->thread_handler = ctx->thread_handler;
+        buf->file->thread_ctx = ctx->filter_ctx;
+    }
+#endif
+
     return 1;
 }
 
@@ -521,6 +528,21 @@ ngx_output_chain_copy_buf(ngx_output_chain_ctx_t *ctx)
 
 #endif
 
+#if (NGX_THREAD_POOL)
+
+        if (ctx->thread_handler) {
+            src->file->thread_handler = ctx->thread_handler;
+            src->file->thread_ctx = ctx->filter_ctx;
+
+            n = ngx_thread_read(src->file, dst->pos, (size_t) size,
+                                src->file_pos, ctx->pool);
+            if (n == NGX_AGAIN) {
+                ctx->aio = 1;
+                return NGX_AGAIN;
+            }
+
+        } else
+#endif
 #if (NGX_HAVE_FILE_AIO)
 
         if (ctx->aio_handler) {
@@ -536,9 +558,10 @@ ngx_output_chain_copy_buf(ngx_output_chain_ctx_t *ctx)
                               src->file_pos);
         }
 #else
-
-        n = ngx_read_file(src->file, dst->pos, (size_t) size, src->file_pos);
-
+        {
+            n = ngx_read_file(src->file, dst->pos, (size_t) size,
+                              src->file_pos);
+        }
 #endif
 
 #if (NGX_HAVE_ALIGNED_DIRECTIO)
@@ -11,6 +11,40 @@
 
 static void *ngx_palloc_block(ngx_pool_t *pool, size_t size);
 static void *ngx_palloc_large(ngx_pool_t *pool, size_t size);
+static void *ngx_pool_block_alloc(size_t size, ngx_log_t *log);
+static void ngx_pool_block_free(void *p, size_t size);
+static ngx_int_t ngx_pool_block_slot(size_t *size);
+
+
+/*
+ * the pool blocks and the large allocations up to NGX_POOL_CACHE_MAX bytes
+ * are rounded up to a size class, four classes per power of two starting
+ * from 256 bytes; the freed blocks are kept in the per-process free lists
+ * while their total size does not exceed ngx_pool_cache_size
+ */
+
+#define NGX_POOL_CACHE_MIN_SHIFT  8
+#define NGX_POOL_CACHE_MAX_SHIFT  17
+#define NGX_POOL_CACHE_MAX        (1 << NGX_POOL_CACHE_MAX_SHIFT)
+#define NGX_POOL_CACHE_SLOTS                                                  \
+    (1 + 4 * (NGX_POOL_CACHE_MAX_SHIFT - NGX_POOL_CACHE_MIN_SHIFT))
+
+
+typedef struct ngx_pool_cached_s  ngx_pool_cached_t;
+
+struct ngx_pool_cached_s {
+    ngx_pool_cached_t    *next;
+};
+
+
+size_t                    ngx_pool_cache_size;
+
+static ngx_pool_stat_t    ngx_pool_stat0;
+ngx_pool_stat_t          *ngx_pool_stat = &ngx_pool_stat0;
+
+static ngx_pool_cached_t *ngx_pool_cache[NGX_POOL_CACHE_SLOTS];
+static size_t             ngx_pool_cache_idle;
+
 
 /* 创建内存池,注意它的size参数并不等同于可分配空间.它同时包含了管理结构的大小,这意味着
  * size绝对不能小于sizeof(ngx_pool_t),否则就会有内存越界错误.通常设置size为
@@ -22,7 +56,7 @@ ngx_create_pool(size_t size, ngx_log_t *log)
 {
     ngx_pool_t  *p;
 
-    p = ngx_memalign(NGX_POOL_ALIGNMENT, size, log);
+    p = ngx_pool_block_alloc(size, log);
     if (p == NULL) {
         return NULL;
     }
@@ -68,7 +102,7 @@ ngx_destroy_pool(ngx_pool_t *pool)
         ngx_log_debug1(NGX_LOG_DEBUG_ALLOC, pool->log, 0, "free: %p", l->alloc);
 
         if (l->alloc) {
-            ngx_free(l->alloc);
+            ngx_pool_block_free(l->alloc, l->size);
         }
     }
 
@@ -91,7 +125,7 @@ ngx_destroy_pool(ngx_pool_t *pool)
 #endif
     /* 释放小块内存 */
     for (p = pool, n = pool->d.next; /* void */; p = n, n = n->d.next) {
-        ngx_free(p);
+        ngx_pool_block_free(p, p->d.end - (u_char *) p);
 
         if (n == NULL) {
             break;
@@ -111,7 +145,7 @@ ngx_reset_pool(ngx_pool_t *pool)
 
     for (l = pool->large; l; l = l->next) {
         if (l->alloc) {
-            ngx_free(l->alloc);
+            ngx_pool_block_free(l->alloc, l->size);
         }
     }
 
@@ -199,7 +233,7 @@ ngx_palloc_block(ngx_pool_t *pool, size_t size)
     /* 内存池大小 */
     psize = (size_t) (pool->d.end - (u_char *) pool);
     /* 关于ngx_memalign实际用于分配内存 */
-    m = ngx_memalign(NGX_POOL_ALIGNMENT, psize, pool->log);
+    m = ngx_pool_block_alloc(psize, pool->log);
     if (m == NULL) {
         return NULL;
     }
@@ -240,7 +274,7 @@ ngx_palloc_large(ngx_pool_t *pool, size_t size)
     ngx_uint_t         n;
     ngx_pool_large_t  *large;
     /* 分配一块大内存 */
-    p = ngx_alloc(size, pool->log);
+    p = ngx_pool_block_alloc(size, pool->log);
     if (p == NULL) {
         return NULL;
     }
@@ -250,6 +284,7 @@ ngx_palloc_large(ngx_pool_t *pool, size_t size)
     for (large = pool->large; large; large = large->next) {
         if (large->alloc == NULL) {
             large->alloc = p;
+            large->size = size;
             return p;
         }
 
@@ -260,11 +295,12 @@ ngx_palloc_large(ngx_pool_t *pool, size_t size)
 
     large = ngx_palloc(pool, sizeof(ngx_pool_large_t));
     if (large == NULL) {
-        ngx_free(p);
+        ngx_pool_block_free(p, size);
         return NULL;
     }
 
     large->alloc = p;
+    large->size = size;
     large->next = pool->large;
     pool->large = large;
 
@@ -293,6 +329,7 @@ ngx_pmemalign(ngx_pool_t *pool, size_t size, size_t alignment)
     }
 
     large->alloc = p;
+    large->size = 0;
     large->next = pool->large;
     pool->large = large;
 
@@ -313,7 +350,7 @@ ngx_pfree(ngx_pool_t *pool, void *p)
         if (p == l->alloc) {
             ngx_log_debug1(NGX_LOG_DEBUG_ALLOC, pool->log, 0,
                            "free: %p", l->alloc);
-            ngx_free(l->alloc);
+            ngx_pool_block_free(l->alloc, l->size);
             l->alloc = NULL;
 
             return NGX_OK;
@@ -439,30 +476,89 @@ ngx_pool_delete_file(void *data)
 }
 
 
-#if 0
 
 static void *
-ngx_get_cached_block(size_t size)
+ngx_pool_block_alloc(size_t size, ngx_log_t *log)
 {
-    void                     *p;
-    ngx_cached_block_slot_t  *slot;
+    ngx_int_t           n;
+    ngx_pool_cached_t  *b;
 
-    if (ngx_cycle->cache == NULL) {
-        return NULL;
+    n = ngx_pool_block_slot(&size);
+
+    if (n == NGX_DECLINED) {
+        return ngx_memalign(NGX_POOL_ALIGNMENT, size, log);
     }
 
-    slot = &ngx_cycle->cache[(size + ngx_pagesize - 1) / ngx_pagesize];
+    b = ngx_pool_cache[n];
 
-    slot->tries++;
+    if (b) {
+        ngx_pool_cache[n] = b->next;
+        ngx_pool_cache_idle -= size;
+        ngx_pool_stat->hits++;
 
-    if (slot->number) {
-        p = slot->block;
-        slot->block = slot->block->next;
-        slot->number--;
-        return p;
+        return b;
     }
 
-    return NULL;
+    ngx_pool_stat->misses++;
+
+    return ngx_memalign(NGX_POOL_ALIGNMENT, size, log);
 }
 
-#endif
+
+static void
+ngx_pool_block_free(void *p, size_t size)
+{
+    ngx_int_t           n;
+    ngx_pool_cached_t  *b;
+
+    n = size ? ngx_pool_block_slot(&size) : NGX_DECLINED;
+
+    if (n == NGX_DECLINED) {
+        ngx_free(p);
+        return;
+    }
+
+    if (ngx_pool_cache_idle + size > ngx_pool_cache_size) {
+        ngx_pool_stat->released++;
+        ngx_free(p);
+        return;
+    }
+
+    b = p;
+    b->next = ngx_pool_cache[n];
+    ngx_pool_cache[n] = b;
+    ngx_pool_cache_idle += size;
+}
+
+
+/* rounds the size up to its class and returns the class index */
+
+static ngx_int_t
+ngx_pool_block_slot(size_t *size)
+{
+    size_t      s;
+    ngx_uint_t  shift, k;
+
+    s = *size;
+
+    if (s > NGX_POOL_CACHE_MAX) {
+        return NGX_DECLINED;
+    }
+
+    if (s <= (1 << NGX_POOL_CACHE_MIN_SHIFT)) {
+        *size = 1 << NGX_POOL_CACHE_MIN_SHIFT;
+        return 0;
+    }
+
+    s--;
+
+    for (shift = NGX_POOL_CACHE_MIN_SHIFT; s >> (shift + 1); shift++) {
+        /* void */
+    }
+
+    k = (s - ((size_t) 1 << shift)) >> (shift - 2);
+
+    *size = ((size_t) 1 << shift) + ((k + 1) << (shift - 2));
+
+    return 1 + 4 * (shift - NGX_POOL_CACHE_MIN_SHIFT) + k;
+}
@@ -43,6 +43,7 @@ typedef struct ngx_pool_large_s  ngx_pool_large_t;
 struct ngx_pool_large_s {
     ngx_pool_large_t     *next; /* 所有的大块内存通过next指针连在一起 */
     void                 *alloc; /* 实际通过ngx_alloc分配出的大块内存 */
+    size_t                size;  /* 0 if the block is not cacheable */
 };
 
 
@@ -85,6 +86,13 @@ typedef struct {
 } ngx_pool_cleanup_file_t;
 
 
+typedef struct {
+    ngx_atomic_uint_t     hits;
+    ngx_atomic_uint_t     misses;
+    ngx_atomic_uint_t     released;
+} ngx_pool_stat_t;
+
+
 void *ngx_alloc(size_t size, ngx_log_t *log);
 void *ngx_calloc(size_t size, ngx_log_t *log);
 
@@ -105,4 +113,8 @@ void ngx_pool_cleanup_file(void *data);
 void ngx_pool_delete_file(void *data);
 
 
+extern size_t            ngx_pool_cache_size;
+extern ngx_pool_stat_t  *ngx_pool_stat;
+
+
 #endif /* _NGX_PALLOC_H_INCLUDED_ */
@@ -9,12 +9,81 @@
 #include <ngx_core.h>
 
 
+#define NGX_REGEX_JIT_STACK_MIN  (32 * 1024)
+#define NGX_REGEX_JIT_STACK_MAX  (1024 * 1024)
+
+#define ngx_regex_isalnum(c)                                                 \
+    (((c) >= '0' && (c) <= '9')                                              \
+     || (((c) | 0x20) >= 'a' && ((c) | 0x20) <= 'z'))
+
+
+typedef struct {
+    ngx_flag_t     pcre_jit;
+} ngx_regex_conf_t;
+
+
 static void * ngx_libc_cdecl ngx_regex_malloc(size_t size);
 static void ngx_libc_cdecl ngx_regex_free(void *p);
+static u_char *ngx_regex_skip_class(u_char *p, u_char *last);
+static u_char *ngx_regex_skip_group(u_char *p, u_char *last);
+static u_char *ngx_regex_skip_escape(u_char *p, u_char *last);
+static u_char *ngx_regex_quantifier(u_char *p, u_char *last, ngx_uint_t *min);
+#if (NGX_HAVE_PCRE_JIT)
+static void ngx_pcre_free_studies(void *data);
+static void ngx_pcre_free_jit_stack(void *data);
+#endif
+static void ngx_regex_cleanup(void *data);
+
+static ngx_int_t ngx_regex_module_init(ngx_cycle_t *cycle);
+
+static void *ngx_regex_create_conf(ngx_cycle_t *cycle);
+static char *ngx_regex_init_conf(ngx_cycle_t *cycle, void *conf);
+
+static char *ngx_regex_pcre_jit(ngx_conf_t *cf, void *post, void *data);
+static ngx_conf_post_t  ngx_regex_pcre_jit_post = { ngx_regex_pcre_jit };
+
+
+static ngx_command_t  ngx_regex_commands[] = {
+
+    { ngx_string("pcre_jit"),
+      NGX_MAIN_CONF|NGX_DIRECT_CONF|NGX_CONF_FLAG,
+      ngx_conf_set_flag_slot,
+      0,
+      offsetof(ngx_regex_conf_t, pcre_jit),
+      &ngx_regex_pcre_jit_post },
+
+      ngx_null_command
+};
+
+
+static ngx_core_module_t  ngx_regex_module_ctx = {
+    ngx_string("regex"),
+    ngx_regex_create_conf,
+    ngx_regex_init_conf
+};
+
+
+ngx_module_t  ngx_regex_module = {
+    NGX_MODULE_V1,
+    &ngx_regex_module_ctx,                 /* module context */
+    ngx_regex_commands,                    /* module directives */
+    NGX_CORE_MODULE,                       /* module type */
+    NULL,                                  /* init master */
+    ngx_regex_module_init,                 /* init module */
+    NULL,                                  /* init process */
+    NULL,                                  /* init thread */
+    NULL,                                  /* exit thread */
+    NULL,                                  /* exit process */
+    NULL,                                  /* exit master */
+    NGX_MODULE_V1_PADDING
+};
 
 
 static ngx_pool_t  *ngx_pcre_pool;
 
+/* 配置解析期间编译的正则表达式,在模块初始化时统一study */
+static ngx_list_t  *ngx_pcre_studies;
+
 
 void
 ngx_regex_init(void)
@@ -63,10 +132,11 @@ ngx_regex_malloc_done(void)
 ngx_int_t
 ngx_regex_compile(ngx_regex_compile_t *rc)
 {
-    int           n, erroff;
-    char         *p;
-    const char   *errstr;
-    ngx_regex_t  *re;
+    int               n, erroff;
+    char             *p;
+    pcre             *re;
+    const char       *errstr;
+    ngx_regex_elt_t  *elt;
 
     ngx_regex_malloc_init(rc->pool);
 
@@ -93,7 +163,24 @@ ngx_regex_compile(ngx_regex_compile_t *rc)
         return NGX_ERROR;
     }
 
-    rc->regex = re;
+    rc->regex = ngx_pcalloc(rc->pool, sizeof(ngx_regex_t));
+    if (rc->regex == NULL) {
+        goto nomem;
+    }
+
+    rc->regex->code = re;
+
+    /* do not study at runtime */
+
+    if (ngx_pcre_studies != NULL) {
+        elt = ngx_list_push(ngx_pcre_studies);
+        if (elt == NULL) {
+            goto nomem;
+        }
+
+        elt->regex = rc->regex;
+        elt->name = rc->pattern.data;
+    }
 
     n = pcre_fullinfo(re, NULL, PCRE_INFO_CAPTURECOUNT, &rc->captures);
     if (n < 0) {
@@ -134,6 +221,14 @@ failed:
     rc->err.len = ngx_snprintf(rc->err.data, rc->err.len, p, &rc->pattern, n)
                   - rc->err.data;
     return NGX_OK;
+
+nomem:
+
+    rc->err.len = ngx_snprintf(rc->err.data, rc->err.len,
+                               "regex \"%V\" compilation failed: no memory",
+                               &rc->pattern)
+                  - rc->err.data;
+    return NGX_ERROR;
 }
 
 
@@ -170,6 +265,428 @@ ngx_regex_exec_array(ngx_array_t *a, ngx_str_t *s, ngx_log_t *log)
 }
 
 
+/*
+ * ngx_regex_literal() finds the longest literal string which any subject
+ * matched by the pattern must contain.  The parser is deliberately
+ * conservative: whenever the pattern uses a construct that is not fully
+ * understood (top-level alternation, \Q...\E, extended mode, verbs, etc.)
+ * an empty literal is returned.  Non-ASCII bytes are never included, so
+ * the literal may be safely compared case-insensitively with ASCII folding.
+ */
+
+ngx_int_t
+ngx_regex_literal(ngx_pool_t *pool, ngx_str_t *pattern, ngx_str_t *literal)
+{
+    u_char      *p, *q, *last, *run, *best, ch;
+    size_t       len, best_len;
+    ngx_uint_t   min;
+
+    literal->len = 0;
+    literal->data = NULL;
+
+    if (pattern->len == 0) {
+        return NGX_OK;
+    }
+
+    best = ngx_pnalloc(pool, pattern->len * 2);
+    if (best == NULL) {
+        return NGX_ERROR;
+    }
+
+    run = best + pattern->len;
+    len = 0;
+    best_len = 0;
+
+    p = pattern->data;
+    last = p + pattern->len;
+
+    while (p < last) {
+
+        ch = *p;
+
+        switch (ch) {
+
+        case '|':
+        case ')':
+            return NGX_OK;
+
+        case '(':
+        case '[':
+        case '\\':
+        case '.':
+        case '^':
+        case '$':
+
+            if (ch == '(') {
+                p = ngx_regex_skip_group(p, last);
+
+            } else if (ch == '[') {
+                p = ngx_regex_skip_class(p, last);
+
+            } else if (ch == '\\') {
+
+                if (p + 1 == last) {
+                    return NGX_OK;
+                }
+
+                ch = p[1];
+
+                if (ch < 0x80 && !ngx_regex_isalnum(ch)) {
+                    /* an escaped punctuation character is a literal */
+                    p += 2;
+                    break;
+                }
+
+                p = ngx_regex_skip_escape(p, last);
+
+            } else {
+                p++;
+            }
+
+            if (p == NULL) {
+                return NGX_OK;
+            }
+
+            /* the atom is not a literal, it terminates the current run */
+
+            if (len > best_len) {
+                ngx_memcpy(best, run, len);
+                best_len = len;
+            }
+
+            len = 0;
+
+            q = ngx_regex_quantifier(p, last, &min);
+            p = q;
+
+            continue;
+
+        default:
+            p++;
+            break;
+        }
+
+        if (ch >= 0x80) {
+            ch = 0;
+        }
+
+        q = ngx_regex_quantifier(p, last, &min);
+
+        if (q == p && ch) {
+            run[len++] = ch;
+            continue;
+        }
+
+        /* a quantified character ends the run, it is kept if mandatory */
+
+        if (ch && min) {
+            run[len++] = ch;
+        }
+
+        if (len > best_len) {
+            ngx_memcpy(best, run, len);
+            best_len = len;
+        }
+
+        len = 0;
+        p = q;
+    }
+
+    if (len > best_len) {
+        ngx_memcpy(best, run, len);
+        best_len = len;
+    }
+
+    literal->len = best_len;
+    literal->data = best;
+
+    return NGX_OK;
+}
+
+
+static u_char *
+ngx_regex_skip_class(u_char *p, u_char *last)
+{
+    u_char  *q;
+
+    p++;
+
+    if (p < last && *p == '^') {
+        p++;
+    }
+
+    if (p < last && *p == ']') {
+        p++;
+    }
+
+    while (p < last) {
+
+        switch (*p) {
+
+        case '\\':
+            if (p + 1 < last && (p[1] == 'Q' || p[1] == 'E')) {
+                return NULL;
+            }
+
+            p += 2;
+            break;
+
+        case '[':
+            /* POSIX classes: [:alpha:], [.ch.], [=ch=] */
+
+            if (p + 1 < last && (p[1] == ':' || p[1] == '.' || p[1] == '=')) {
+                for (q = p + 2; q + 1 < last; q++) {
+                    if (q[0] == p[1] && q[1] == ']') {
+                        break;
+                    }
+                }
+
+                if (q + 1 < last) {
+                    p = q + 2;
+                    break;
+                }
+            }
+
+            p++;
+            break;
+
+        case ']':
+            return p + 1;
+
+        default:
+            p++;
+        }
+    }
+
+    return NULL;
+}
+
+
+static u_char *
+ngx_regex_skip_group(u_char *p, u_char *last)
+{
+    u_char      *q;
+    ngx_uint_t   depth;
+
+    depth = 0;
+
+    while (p < last) {
+
+        switch (*p) {
+
+        case '\\':
+            if (p + 1 < last && (p[1] == 'Q' || p[1] == 'E')) {
+                return NULL;
+            }
+
+            p += 2;
+            break;
+
+        case '[':
+            p = ngx_regex_skip_class(p, last);
+            if (p == NULL) {
+                return NULL;
+            }
+
+            break;
+
+        case '(':
+            if (p + 1 < last && p[1] == '*') {
+                /* verbs and (*UTF8) like options are not supported */
+                return NULL;
+            }
+
+            if (p + 2 < last && p[1] == '?') {
+
+                if (p[2] == '#') {
+                    q = ngx_strlchr(p + 3, last, ')');
+                    if (q == NULL) {
+                        return NULL;
+                    }
+
+                    p = q + 1;
+
+                    if (depth == 0) {
+                        return p;
+                    }
+
+                    break;
+                }
+
+                /* the extended mode changes the meaning of the pattern */
+
+                for (q = p + 2; q < last; q++) {
+                    if (*q == 'x') {
+                        return NULL;
+                    }
+
+                    if (*q != '-' && ((*q | 0x20) < 'a' || (*q | 0x20) > 'z')) {
+                        break;
+                    }
+                }
+            }
+
+            depth++;
+            p++;
+            break;
+
+        case ')':
+            p++;
+
+            if (--depth == 0) {
+                return p;
+            }
+
+            break;
+
+        default:
+            p++;
+        }
+    }
+
+    return NULL;
+}
+
+
+static u_char *
+ngx_regex_skip_escape(u_char *p, u_char *last)
+{
+    u_char  *q, ch;
+
+    ch = p[1];
+
+    if (ch == 'Q' || ch == 'E') {
+        return NULL;
+    }
+
+    p += 2;
+
+    if (ch == 'c' && p < last) {
+        p++;
+    }
+
+    /* \x41, \012, \12, \g1 and so on */
+
+    while (p < last && ngx_regex_isalnum(*p)) {
+        p++;
+    }
+
+    if (p == last) {
+        return p;
+    }
+
+    /*
+     * \x{263a}, \p{Lu}, \k<name>, \g'name'; after other escapes
+     * such as \d the brace is a quantifier and is left in place
+     */
+
+    switch (ch) {
+    case 'x':
+    case 'o':
+    case 'p':
+    case 'P':
+    case 'k':
+    case 'g':
+    case 'N':
+        break;
+    default:
+        return p;
+    }
+
+    switch (*p) {
+    case '{':
+        ch = '}';
+        break;
+    case '<':
+        ch = '>';
+        break;
+    case '\'':
+        ch = '\'';
+        break;
+    default:
+        return p;
+    }
+
+    q = ngx_strlchr(p + 1, last, ch);
+    if (q == NULL) {
+        return NULL;
+    }
+
+    return q + 1;
+}
+
+
+static u_char *
+ngx_regex_quantifier(u_char *p, u_char *last, ngx_uint_t *min)
+{
+    u_char  *q;
+
+    if (p == last) {
+        return p;
+    }
+
+    switch (*p) {
+
+    case '*':
+    case '?':
+        *min = 0;
+        p++;
+        break;
+
+    case '+':
+        *min = 1;
+        p++;
+        break;
+
+    case '{':
+
+        /* {n}, {n,} and {n,m}; anything else is a literal brace */
+
+        q = p + 1;
+
+        if (q == last || *q < '0' || *q > '9') {
+            return p;
+        }
+
+        *min = 0;
+
+        while (q < last && *q >= '0' && *q <= '9') {
+            if (*q != '0') {
+                *min = 1;
+            }
+
+            q++;
+        }
+
+        if (q < last && *q == ',') {
+            q++;
+
+            while (q < last && *q >= '0' && *q <= '9') {
+                q++;
+            }
+        }
+
+        if (q == last || *q != '}') {
+            return p;
+        }
+
+        p = q + 1;
+        break;
+
+    default:
+        return p;
+    }
+
+    /* lazy and possessive quantifiers */
+
+    if (p < last && (*p == '?' || *p == '+')) {
+        p++;
+    }
+
+    return p;
+}
+
+
 static void * ngx_libc_cdecl
 ngx_regex_malloc(size_t size)
 {
@@ -204,3 +721,258 @@ ngx_regex_free(void *p)
 {
     return;
 }
+
+
+#if (NGX_HAVE_PCRE_JIT)
+
+static void
+ngx_pcre_free_studies(void *data)
+{
+    ngx_list_t *studies = data;
+
+    ngx_uint_t        i;
+    ngx_list_part_t  *part;
+    ngx_regex_elt_t  *elts;
+
+    part = &studies->part;
+    elts = part->elts;
+
+    for (i = 0 ; /* void */ ; i++) {
+
+        if (i >= part->nelts) {
+            if (part->next == NULL) {
+                break;
+            }
+
+            part = part->next;
+            elts = part->elts;
+            i = 0;
+        }
+
+        if (elts[i].regex->extra != NULL) {
+            pcre_free_study(elts[i].regex->extra);
+        }
+    }
+}
+
+
+static void
+ngx_pcre_free_jit_stack(void *data)
+{
+    pcre_jit_stack *stack = data;
+
+    pcre_jit_stack_free(stack);
+}
+
+#endif
+
+
+static void
+ngx_regex_cleanup(void *data)
+{
+    /*
+     * ngx_regex_module_init() is not called if the configuration
+     * has failed, so the list in the destroyed pool is forgotten here,
+     * or the workers forked later would add the run-time regexes to it
+     */
+
+    if (ngx_pcre_studies == data) {
+        ngx_pcre_studies = NULL;
+    }
+}
+
+
+static ngx_int_t
+ngx_regex_module_init(ngx_cycle_t *cycle)
+{
+    int                  opt;
+    const char          *errstr;
+    ngx_uint_t           i;
+    ngx_list_part_t     *part;
+    ngx_regex_elt_t     *elts;
+#if (NGX_HAVE_PCRE_JIT)
+    int                  jit, n;
+    pcre_jit_stack      *stack;
+    ngx_regex_conf_t    *rcf;
+    ngx_pool_cleanup_t  *cln;
+#endif
+
+    opt = 0;
+
+#if (NGX_HAVE_PCRE_JIT)
+
+    stack = NULL;
+
+    rcf = (ngx_regex_conf_t *) ngx_get_conf(cycle->conf_ctx, ngx_regex_module);
+
+    if (rcf->pcre_jit) {
+        opt = PCRE_STUDY_JIT_COMPILE;
+
+        /*
+         * The PCRE JIT compiler uses mmap for its executable codes, so we
+         * have to explicitly call the pcre_free_study() function to free
+         * this memory.
+         */
+
+        cln = ngx_pool_cleanup_add(cycle->pool, 0);
+        if (cln == NULL) {
+            return NGX_ERROR;
+        }
+
+        cln->handler = ngx_pcre_free_studies;
+        cln->data = ngx_pcre_studies;
+
+        /*
+         * The default JIT stack is 32K on the machine stack, which is not
+         * enough for some patterns.  The stack is allocated in the master
+         * process before the fork, so every worker uses its own copy.
+         */
+
+        ngx_regex_malloc_init(cycle->pool);
+
+        stack = pcre_jit_stack_alloc(NGX_REGEX_JIT_STACK_MIN,
+                                     NGX_REGEX_JIT_STACK_MAX);
+
+        ngx_regex_malloc_done();
+
+        if (stack == NULL) {
+            ngx_log_error(NGX_LOG_WARN, cycle->log, 0,
+                          "pcre_jit_stack_alloc() failed, "
+                          "the default JIT stack is used");
+
+        } else {
+            cln = ngx_pool_cleanup_add(cycle->pool, 0);
+            if (cln == NULL) {
+                pcre_jit_stack_free(stack);
+                return NGX_ERROR;
+            }
+
+            cln->handler = ngx_pcre_free_jit_stack;
+            cln->data = stack;
+        }
+    }
+
+#endif
+
+    ngx_regex_malloc_init(cycle->pool);
+
+    part = &ngx_pcre_studies->part;
+    elts = part->elts;
+
+    for (i = 0 ; /* void */ ; i++) {
+
+        if (i >= part->nelts) {
+            if (part->next == NULL) {
+                break;
+            }
+
+            part = part->next;
+            elts = part->elts;
+            i = 0;
+        }
+
+        elts[i].regex->extra = pcre_study(elts[i].regex->code, opt, &errstr);
+
+        if (errstr != NULL) {
+            ngx_log_error(NGX_LOG_ALERT, cycle->log, 0,
+                          "pcre_study() failed: %s in \"%s\"",
+                          errstr, elts[i].name);
+        }
+
+#if (NGX_HAVE_PCRE_JIT)
+        if (opt & PCRE_STUDY_JIT_COMPILE) {
+            jit = 0;
+            n = pcre_fullinfo(elts[i].regex->code, elts[i].regex->extra,
+                              PCRE_INFO_JIT, &jit);
+
+            if (n != 0 || jit != 1) {
+                ngx_log_error(NGX_LOG_INFO, cycle->log, 0,
+                              "JIT compiler does not support pattern: \"%s\"",
+                              elts[i].name);
+
+            } else if (stack) {
+                pcre_assign_jit_stack(elts[i].regex->extra, NULL, stack);
+            }
+        }
+#endif
+    }
+
+    ngx_regex_malloc_done();
+
+    ngx_pcre_studies = NULL;
+
+    return NGX_OK;
+}
+
+
+static void *
+ngx_regex_create_conf(ngx_cycle_t *cycle)
+{
+    ngx_regex_conf_t    *rcf;
+    ngx_pool_cleanup_t  *cln;
+
+    rcf = ngx_pcalloc(cycle->pool, sizeof(ngx_regex_conf_t));
+    if (rcf == NULL) {
+        return NULL;
+    }
+
+    rcf->pcre_jit = NGX_CONF_UNSET;
+
+    cln = ngx_pool_cleanup_add(cycle->pool, 0);
+    if (cln == NULL) {
+        return NULL;
+    }
+
+    ngx_pcre_studies = ngx_list_create(cycle->pool, 8, sizeof(ngx_regex_elt_t));
+    if (ngx_pcre_studies == NULL) {
+        return NULL;
+    }
+
+    cln->handler = ngx_regex_cleanup;
+    cln->data = ngx_pcre_studies;
+
+    return rcf;
+}
+
+
+static char *
+ngx_regex_init_conf(ngx_cycle_t *cycle, void *conf)
+{
+    ngx_regex_conf_t *rcf = conf;
+
+    ngx_conf_init_value(rcf->pcre_jit, 0);
+
+    return NGX_CONF_OK;
+}
+
+
+static char *
+ngx_regex_pcre_jit(ngx_conf_t *cf, void *post, void *data)
+{
+    ngx_flag_t  *fp = data;
+
+    if (*fp == 0) {
+        return NGX_CONF_OK;
+    }
+
+#if (NGX_HAVE_PCRE_JIT)
+    {
+    int  jit, r;
+
+    jit = 0;
+    r = pcre_config(PCRE_CONFIG_JIT, &jit);
+
+    if (r != 0 || jit != 1) {
+        ngx_conf_log_error(NGX_LOG_WARN, cf, 0,
+                           "PCRE library does not support JIT");
+        *fp = 0;
+    }
+    }
+#else
+    ngx_conf_log_error(NGX_LOG_WARN, cf, 0,
+                       "nginx was built without PCRE JIT support");
+    *fp = 0;
+#endif
+
+    return NGX_CONF_OK;
+}
@@ -20,7 +20,10 @@
 
 #define NGX_REGEX_CASELESS    PCRE_CASELESS
 
-typedef pcre  ngx_regex_t;
+typedef struct {
+    pcre        *code;
+    pcre_extra  *extra;
+} ngx_regex_t;
 
 
 typedef struct {
@@ -47,11 +50,13 @@ void ngx_regex_init(void);
 ngx_int_t ngx_regex_compile(ngx_regex_compile_t *rc);
 
 #define ngx_regex_exec(re, s, captures, size)                                \
-    pcre_exec(re, NULL, (const char *) (s)->data, (s)->len, 0, 0,            \
+    pcre_exec(re->code, re->extra, (const char *) (s)->data, (s)->len, 0, 0, \
               captures, size)
 #define ngx_regex_exec_n      "pcre_exec()"
 
 ngx_int_t ngx_regex_exec_array(ngx_array_t *a, ngx_str_t *s, ngx_log_t *log);
+ngx_int_t ngx_regex_literal(ngx_pool_t *pool, ngx_str_t *pattern,
+    ngx_str_t *literal);
 
 
 #endif /* _NGX_REGEX_H_INCLUDED_ */
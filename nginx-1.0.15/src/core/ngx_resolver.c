@@ -132,11 +132,12 @@ ngx_resolver_create(ngx_conf_t *cf, ngx_addr_t *addr)
     r->event->handler = ngx_resolver_resend_handler;
     r->event->data = r;
     r->event->log = &cf->cycle->new_log;
+    r->event->cancelable = 1;
     r->ident = -1;
 
     r->resend_timeout = 5;
     r->expire = 30;
-    r->valid = 300;
+    r->valid = 0;  /* use the TTL of the answer */
 
     r->log = &cf->cycle->new_log;
     r->log_level = NGX_LOG_ERR;
@@ -418,6 +419,7 @@ ngx_resolve_name_locked(ngx_resolver_t *r, ngx_resolver_ctx_t *ctx)
                     ctx->naddrs = naddrs;
                     ctx->addrs = (naddrs == 1) ? &ctx->addr : addrs;
                     ctx->addr = addr;
+                    ctx->valid = rn->valid;
                     next = ctx->next;
 
                     ctx->handler(ctx);
@@ -1121,7 +1123,7 @@ ngx_resolver_process_a(ngx_resolver_t *r, u_char *buf, size_t last,
     char                 *err;
     u_char               *cname;
     size_t                len;
-    uint32_t              hash;
+    uint32_t              hash, ttl;
     in_addr_t             addr, *addrs;
     ngx_str_t             name;
     ngx_uint_t            qtype, qident, naddrs, a, i, n, start;
@@ -1191,6 +1193,7 @@ ngx_resolver_process_a(ngx_resolver_t *r, u_char *buf, size_t last,
     addrs = NULL;
     cname = NULL;
     qtype = 0;
+    ttl = NGX_MAX_INT32_VALUE;
 
     for (a = 0; a < nan; a++) {
 
@@ -1231,6 +1234,22 @@ ngx_resolver_process_a(ngx_resolver_t *r, u_char *buf, size_t last,
         qtype = (an->type_hi << 8) + an->type_lo;
         len = (an->len_hi << 8) + an->len_lo;
 
+        if (qtype == NGX_RESOLVE_A || qtype == NGX_RESOLVE_CNAME) {
+
+            /* the answer is cached for the least TTL of its records */
+
+            n = ((ngx_uint_t) an->ttl[0] << 24) + (an->ttl[1] << 16)
+                + (an->ttl[2] << 8) + (an->ttl[3]);
+
+            if (n > NGX_MAX_INT32_VALUE) {
+                n = 0;
+            }
+
+            if (n < ttl) {
+                ttl = n;
+            }
+        }
+
         if (qtype == NGX_RESOLVE_A) {
 
             i += sizeof(ngx_resolver_an_t);
@@ -1329,7 +1348,7 @@ ngx_resolver_process_a(ngx_resolver_t *r, u_char *buf, size_t last,
 
         ngx_queue_remove(&rn->queue);
 
-        rn->valid = ngx_time() + r->valid;
+        rn->valid = ngx_time() + (r->valid ? r->valid : (time_t) ttl);
         rn->expire = ngx_time() + r->expire;
 
         ngx_queue_insert_head(&r->name_expire_queue, &rn->queue);
@@ -1345,6 +1364,7 @@ ngx_resolver_process_a(ngx_resolver_t *r, u_char *buf, size_t last,
              ctx->naddrs = naddrs;
              ctx->addrs = (naddrs == 1) ? &ctx->addr : addrs;
              ctx->addr = addr;
+             ctx->valid = rn->valid;
              next = ctx->next;
 
              ctx->handler(ctx);
@@ -1371,7 +1391,7 @@ ngx_resolver_process_a(ngx_resolver_t *r, u_char *buf, size_t last,
 
         rn->cnlen = (u_short) name.len;
         rn->u.cname = name.data;
-        rn->valid = ngx_time() + r->valid;
+        rn->valid = ngx_time() + (r->valid ? r->valid : (time_t) ttl);
         rn->expire = ngx_time() + r->expire;
 
         ngx_queue_insert_head(&r->name_expire_queue, &rn->queue);
@@ -1421,6 +1441,7 @@ ngx_resolver_process_ptr(ngx_resolver_t *r, u_char *buf, size_t n,
 {
     char                 *err;
     size_t                len;
+    uint32_t              ttl;
     in_addr_t             addr;
     ngx_int_t             digit;
     ngx_str_t             name;
@@ -1518,6 +1539,13 @@ ngx_resolver_process_ptr(ngx_resolver_t *r, u_char *buf, size_t n,
 
     len = (an->len_hi << 8) + an->len_lo;
 
+    ttl = ((uint32_t) an->ttl[0] << 24) + (an->ttl[1] << 16)
+          + (an->ttl[2] << 8) + (an->ttl[3]);
+
+    if (ttl > NGX_MAX_INT32_VALUE) {
+        ttl = 0;
+    }
+
     ngx_log_debug3(NGX_LOG_DEBUG_CORE, r->log, 0,
                   "resolver qt:%ui cl:%ui len:%uz",
                   (an->type_hi << 8) + an->type_lo,
@@ -1553,7 +1581,7 @@ ngx_resolver_process_ptr(ngx_resolver_t *r, u_char *buf, size_t n,
 
     ngx_queue_remove(&rn->queue);
 
-    rn->valid = ngx_time() + r->valid;
+    rn->valid = ngx_time() + (r->valid ? r->valid : (time_t) ttl);
     rn->expire = ngx_time() + r->expire;
 
     ngx_queue_insert_head(&r->addr_expire_queue, &rn->queue);
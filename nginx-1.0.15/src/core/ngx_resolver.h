@@ -124,6 +124,9 @@ struct ngx_resolver_ctx_s {
     in_addr_t                *addrs;
     in_addr_t                 addr;
 
+    /* the time the answer stays valid, derived from its TTL */
+    time_t                    valid;
+
     /* TODO: DNS peers balancer ctx */
 
     ngx_resolver_handler_pt   handler;
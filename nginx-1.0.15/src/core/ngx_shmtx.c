@@ -12,10 +12,55 @@
 #if (NGX_HAVE_ATOMIC_OPS)
 
 
+#if (NGX_HAVE_FUTEX)
+
+/*
+ * if there are sleeping processes, the unlocking process hands the lock
+ * off to the one woken up instead of releasing it, so the processes that
+ * only spin cannot overtake the ones queued in the kernel
+ */
+
+#define NGX_SHMTX_HANDOFF       0xffffffff
+
+/* the timeout guards against a woken process that dies before taking over */
+#define NGX_SHMTX_WAIT_TIMEOUT  500
+
+/*
+ * the low half of the wait word counts the sleeping processes and the high
+ * half is an epoch: a process killed while sleeping would stay counted,
+ * so a forced unlock starts a new epoch with no sleepers and wakes them all
+ * to register again, while the ones registered in an older epoch do not
+ * unregister
+ */
+
+#define NGX_SHMTX_WAIT_MASK                                                   \
+    (((ngx_atomic_uint_t) 1 << (sizeof(ngx_atomic_uint_t) * 4)) - 1)
+
+#define ngx_shmtx_cmp_set(lock, old, new)                                     \
+    __sync_bool_compare_and_swap(lock, old, new)
+
+static void ngx_shmtx_futex_wait(ngx_shmtx_t *mtx, uint32_t val);
+static void ngx_shmtx_futex_unwait(ngx_shmtx_t *mtx, ngx_atomic_uint_t epoch);
+
+#else
+
+#define ngx_shmtx_cmp_set(lock, old, new)                                     \
+    ngx_atomic_cmp_set(lock, old, new)
+
+#endif
+
+
+static ngx_uint_t ngx_shmtx_release(ngx_shmtx_t *mtx, ngx_pid_t pid);
+static void ngx_shmtx_contended(ngx_shmtx_t *mtx, ngx_uint_t spins,
+    struct timeval *start);
+
+
 ngx_int_t
-ngx_shmtx_create(ngx_shmtx_t *mtx, void *addr, u_char *name)
+ngx_shmtx_create(ngx_shmtx_t *mtx, ngx_shmtx_sh_t *addr, u_char *name)
 {
-    mtx->lock = addr;
+    mtx->lock = &addr->lock;
+    mtx->wait = &addr->wait;
+    mtx->stat = &addr->stat;
 
     if (mtx->spin == (ngx_uint_t) -1) {
         return NGX_OK;
@@ -23,7 +68,7 @@ ngx_shmtx_create(ngx_shmtx_t *mtx, void *addr, u_char *name)
 
     mtx->spin = 2048;
 
-#if (NGX_HAVE_POSIX_SEM)
+#if (NGX_HAVE_POSIX_SEM && !(NGX_HAVE_FUTEX))
 
     if (sem_init(&mtx->sem, 1, 0) == -1) {
         ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, ngx_errno,
@@ -41,7 +86,7 @@ ngx_shmtx_create(ngx_shmtx_t *mtx, void *addr, u_char *name)
 void
 ngx_shmtx_destory(ngx_shmtx_t *mtx)
 {
-#if (NGX_HAVE_POSIX_SEM)
+#if (NGX_HAVE_POSIX_SEM && !(NGX_HAVE_FUTEX))
 
     if (mtx->semaphore) {
         if (sem_destroy(&mtx->sem) == -1) {
@@ -57,32 +102,36 @@ ngx_shmtx_destory(ngx_shmtx_t *mtx)
 ngx_uint_t
 ngx_shmtx_trylock(ngx_shmtx_t *mtx)
 {
-    ngx_atomic_uint_t  val;
-
-    val = *mtx->lock;
+    if (*mtx->lock == 0 && ngx_shmtx_cmp_set(mtx->lock, 0, ngx_pid)) {
+        mtx->stat->acquires++;
+        return 1;
+    }
 
-    return ((val & 0x80000000) == 0
-            && ngx_atomic_cmp_set(mtx->lock, val, val | 0x80000000));
+    return 0;
 }
 
 
 void
 ngx_shmtx_lock(ngx_shmtx_t *mtx)
 {
-    ngx_uint_t         i, n;
-    ngx_atomic_uint_t  val;
+    ngx_uint_t       i, n, spins;
+    struct timeval   start;
+#if (NGX_HAVE_FUTEX)
+    uint32_t            val;
+    ngx_atomic_uint_t   epoch;
+#endif
 
     ngx_log_debug0(NGX_LOG_DEBUG_CORE, ngx_cycle->log, 0, "shmtx lock");
 
-    for ( ;; ) {
+    if (*mtx->lock == 0 && ngx_shmtx_cmp_set(mtx->lock, 0, ngx_pid)) {
+        mtx->stat->acquires++;
+        return;
+    }
 
-        val = *mtx->lock;
+    ngx_gettimeofday(&start);
+    spins = 0;
 
-        if ((val & 0x80000000) == 0
-            && ngx_atomic_cmp_set(mtx->lock, val, val | 0x80000000))
-        {
-            return;
-        }
+    for ( ;; ) {
 
         if (ngx_ncpu > 1) {
 
@@ -92,49 +141,84 @@ ngx_shmtx_lock(ngx_shmtx_t *mtx)
                     ngx_cpu_pause();
                 }
 
-                val = *mtx->lock;
+                spins += n;
 
-                if ((val & 0x80000000) == 0
-                    && ngx_atomic_cmp_set(mtx->lock, val, val | 0x80000000))
+                if (*mtx->lock == 0
+                    && ngx_shmtx_cmp_set(mtx->lock, 0, ngx_pid))
                 {
+                    ngx_shmtx_contended(mtx, spins, &start);
                     return;
                 }
             }
         }
 
-#if (NGX_HAVE_POSIX_SEM)
+#if (NGX_HAVE_FUTEX)
 
-        if (mtx->semaphore) {
+        for ( ;; ) {
             val = *mtx->lock;
 
-            if ((val & 0x80000000)
-                && ngx_atomic_cmp_set(mtx->lock, val, val + 1))
+            if (val == 0 || val == NGX_SHMTX_HANDOFF) {
+
+                if (ngx_shmtx_cmp_set(mtx->lock, val, ngx_pid)) {
+                    break;
+                }
+
+                continue;
+            }
+
+            epoch = ngx_atomic_fetch_add(mtx->wait, 1) & ~NGX_SHMTX_WAIT_MASK;
+
+            ngx_shmtx_futex_wait(mtx, val);
+
+            ngx_shmtx_futex_unwait(mtx, epoch);
+        }
+
+        ngx_shmtx_contended(mtx, spins, &start);
+        return;
+
+#elif (NGX_HAVE_POSIX_SEM)
+
+        if (mtx->semaphore) {
+            (void) ngx_atomic_fetch_add(mtx->wait, 1);
+
+            if (*mtx->lock == 0
+                && ngx_shmtx_cmp_set(mtx->lock, 0, ngx_pid))
             {
-                ngx_log_debug1(NGX_LOG_DEBUG_CORE, ngx_cycle->log, 0,
-                               "shmtx wait %XA", val);
+                (void) ngx_atomic_fetch_add(mtx->wait, -1);
 
-                while (sem_wait(&mtx->sem) == -1) {
-                    ngx_err_t  err;
+                ngx_shmtx_contended(mtx, spins, &start);
+                return;
+            }
 
-                    err = ngx_errno;
+            ngx_log_debug1(NGX_LOG_DEBUG_CORE, ngx_cycle->log, 0,
+                           "shmtx wait %uA", *mtx->wait);
 
-                    if (err != NGX_EINTR) {
-                        ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, err,
-                                   "sem_wait() failed while waiting on shmtx");
-                        break;
-                    }
-                }
+            while (sem_wait(&mtx->sem) == -1) {
+                ngx_err_t  err;
 
-                ngx_log_debug0(NGX_LOG_DEBUG_CORE, ngx_cycle->log, 0,
-                               "shmtx awoke");
+                err = ngx_errno;
+
+                if (err != NGX_EINTR) {
+                    ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, err,
+                               "sem_wait() failed while waiting on shmtx");
+                    break;
+                }
             }
 
+            ngx_log_debug0(NGX_LOG_DEBUG_CORE, ngx_cycle->log, 0,
+                           "shmtx awoke");
+
             continue;
         }
 
 #endif
 
         ngx_sched_yield();
+
+        if (*mtx->lock == 0 && ngx_shmtx_cmp_set(mtx->lock, 0, ngx_pid)) {
+            ngx_shmtx_contended(mtx, spins, &start);
+            return;
+        }
     }
 }
 
@@ -142,31 +226,164 @@ ngx_shmtx_lock(ngx_shmtx_t *mtx)
 void
 ngx_shmtx_unlock(ngx_shmtx_t *mtx)
 {
-    ngx_atomic_uint_t  val, old, wait;
-
     if (mtx->spin != (ngx_uint_t) -1) {
         ngx_log_debug0(NGX_LOG_DEBUG_CORE, ngx_cycle->log, 0, "shmtx unlock");
     }
 
+    (void) ngx_shmtx_release(mtx, ngx_pid);
+}
+
+
+ngx_uint_t
+ngx_shmtx_force_unlock(ngx_shmtx_t *mtx, ngx_pid_t pid)
+{
+#if (NGX_HAVE_FUTEX)
+    ngx_atomic_uint_t  wait;
+#endif
+
+    ngx_log_debug0(NGX_LOG_DEBUG_CORE, ngx_cycle->log, 0,
+                   "shmtx forced unlock");
+
+#if (NGX_HAVE_FUTEX)
+
+    /* the exited process may have been counted as sleeping */
+
     for ( ;; ) {
+        wait = *mtx->wait;
+
+        if ((wait & NGX_SHMTX_WAIT_MASK) == 0) {
+            break;
+        }
 
-        old = *mtx->lock;
-        wait = old & 0x7fffffff;
-        val = wait ? wait - 1 : 0;
+        if (ngx_atomic_cmp_set(mtx->wait, wait,
+                               (wait | NGX_SHMTX_WAIT_MASK) + 1))
+        {
+            if (syscall(SYS_futex, mtx->lock, FUTEX_WAKE, INT_MAX,
+                        NULL, NULL, 0)
+                == -1)
+            {
+                ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, ngx_errno,
+                              "futex(FUTEX_WAKE) failed while wake shmtx");
+            }
 
-        if (ngx_atomic_cmp_set(mtx->lock, old, val)) {
             break;
         }
     }
 
+#endif
+
+    return ngx_shmtx_release(mtx, pid);
+}
+
+
+#if (NGX_HAVE_FUTEX)
+
+static ngx_uint_t
+ngx_shmtx_release(ngx_shmtx_t *mtx, ngx_pid_t pid)
+{
+    uint32_t  val;
+
+    val = (*mtx->wait & NGX_SHMTX_WAIT_MASK) ? NGX_SHMTX_HANDOFF : 0;
+
+    if (!ngx_shmtx_cmp_set(mtx->lock, (uint32_t) pid, val)) {
+        return 0;
+    }
+
+    /* a process may have started to wait after the check above */
+
+    if (val == 0 && (*mtx->wait & NGX_SHMTX_WAIT_MASK) == 0) {
+        return 1;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_CORE, ngx_cycle->log, 0,
+                   "shmtx wake %uA", *mtx->wait & NGX_SHMTX_WAIT_MASK);
+
+    if (syscall(SYS_futex, mtx->lock, FUTEX_WAKE, 1, NULL, NULL, 0) == -1) {
+        ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, ngx_errno,
+                      "futex(FUTEX_WAKE) failed while wake shmtx");
+    }
+
+    return 1;
+}
+
+
+static void
+ngx_shmtx_futex_wait(ngx_shmtx_t *mtx, uint32_t val)
+{
+    ngx_err_t        err;
+    struct timespec  ts;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_CORE, ngx_cycle->log, 0,
+                   "shmtx wait %uA", *mtx->wait & NGX_SHMTX_WAIT_MASK);
+
+    ts.tv_sec = NGX_SHMTX_WAIT_TIMEOUT / 1000;
+    ts.tv_nsec = (NGX_SHMTX_WAIT_TIMEOUT % 1000) * 1000000;
+
+    if (syscall(SYS_futex, mtx->lock, FUTEX_WAIT, val, &ts, NULL, 0) == -1) {
+        err = ngx_errno;
+
+        if (err != NGX_EAGAIN && err != NGX_EINTR && err != NGX_ETIMEDOUT) {
+            ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, err,
+                          "futex(FUTEX_WAIT) failed while waiting on shmtx");
+        }
+    }
+
+    ngx_log_debug0(NGX_LOG_DEBUG_CORE, ngx_cycle->log, 0, "shmtx awoke");
+}
+
+
+static void
+ngx_shmtx_futex_unwait(ngx_shmtx_t *mtx, ngx_atomic_uint_t epoch)
+{
+    ngx_atomic_uint_t  wait;
+
+    for ( ;; ) {
+        wait = *mtx->wait;
+
+        if ((wait & ~NGX_SHMTX_WAIT_MASK) != epoch
+            || (wait & NGX_SHMTX_WAIT_MASK) == 0)
+        {
+            return;
+        }
+
+        if (ngx_atomic_cmp_set(mtx->wait, wait, wait - 1)) {
+            return;
+        }
+    }
+}
+
+#else
+
+static ngx_uint_t
+ngx_shmtx_release(ngx_shmtx_t *mtx, ngx_pid_t pid)
+{
+    ngx_atomic_uint_t  wait;
+
+    if (!ngx_shmtx_cmp_set(mtx->lock, pid, 0)) {
+        return 0;
+    }
+
 #if (NGX_HAVE_POSIX_SEM)
 
-    if (wait == 0 || !mtx->semaphore) {
-        return;
+    if (!mtx->semaphore) {
+        return 1;
+    }
+
+    for ( ;; ) {
+
+        wait = *mtx->wait;
+
+        if ((ngx_atomic_int_t) wait <= 0) {
+            return 1;
+        }
+
+        if (ngx_atomic_cmp_set(mtx->wait, wait, wait - 1)) {
+            break;
+        }
     }
 
     ngx_log_debug1(NGX_LOG_DEBUG_CORE, ngx_cycle->log, 0,
-                   "shmtx wake %XA", old);
+                   "shmtx wake %uA", wait);
 
     if (sem_post(&mtx->sem) == -1) {
         ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, ngx_errno,
@@ -174,6 +391,33 @@ ngx_shmtx_unlock(ngx_shmtx_t *mtx)
     }
 
 #endif
+
+    return 1;
+}
+
+#endif
+
+
+static void
+ngx_shmtx_contended(ngx_shmtx_t *mtx, ngx_uint_t spins, struct timeval *start)
+{
+    ngx_int_t       usec;
+    struct timeval  tv;
+
+    /* the counters are updated by the lock owner only */
+
+    ngx_gettimeofday(&tv);
+
+    usec = (tv.tv_sec - start->tv_sec) * 1000000
+           + (tv.tv_usec - start->tv_usec);
+
+    mtx->stat->acquires++;
+    mtx->stat->contended++;
+    mtx->stat->spins += spins;
+
+    if (usec > 0) {
+        mtx->stat->wait_time += usec;
+    }
 }
 
 
@@ -181,8 +425,10 @@ ngx_shmtx_unlock(ngx_shmtx_t *mtx)
 
 
 ngx_int_t
-ngx_shmtx_create(ngx_shmtx_t *mtx, void *addr, u_char *name)
+ngx_shmtx_create(ngx_shmtx_t *mtx, ngx_shmtx_sh_t *addr, u_char *name)
 {
+    mtx->stat = &addr->stat;
+
     if (mtx->name) {
 
         if (ngx_strcmp(name, mtx->name) == 0) {
@@ -231,6 +477,7 @@ ngx_shmtx_trylock(ngx_shmtx_t *mtx)
     err = ngx_trylock_fd(mtx->fd);
 
     if (err == 0) {
+        mtx->stat->acquires++;
         return 1;
     }
 
@@ -260,6 +507,7 @@ ngx_shmtx_lock(ngx_shmtx_t *mtx)
     err = ngx_lock_fd(mtx->fd);
 
     if (err == 0) {
+        mtx->stat->acquires++;
         return;
     }
 
@@ -281,4 +529,13 @@ ngx_shmtx_unlock(ngx_shmtx_t *mtx)
     ngx_log_abort(err, ngx_unlock_fd_n " %s failed", mtx->name);
 }
 
+
+ngx_uint_t
+ngx_shmtx_force_unlock(ngx_shmtx_t *mtx, ngx_pid_t pid)
+{
+    /* the file locks are released by the kernel */
+
+    return 0;
+}
+
 #endif
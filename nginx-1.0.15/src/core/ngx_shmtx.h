@@ -13,26 +13,55 @@
 #include <ngx_core.h>
 
 
+typedef struct {
+    ngx_atomic_uint_t    acquires;
+    ngx_atomic_uint_t    contended;
+    ngx_atomic_uint_t    spins;
+    ngx_atomic_uint_t    wait_time;     /* in microseconds */
+} ngx_shmtx_stat_t;
+
+
+typedef struct {
+#if (NGX_HAVE_FUTEX)
+    volatile uint32_t    lock;
+#else
+    ngx_atomic_t         lock;
+#endif
+#if (NGX_HAVE_ATOMIC_OPS)
+    ngx_atomic_t         wait;
+#endif
+    ngx_shmtx_stat_t     stat;
+} ngx_shmtx_sh_t;
+
+
 typedef struct {
 #if (NGX_HAVE_ATOMIC_OPS)
-    ngx_atomic_t  *lock;
-#if (NGX_HAVE_POSIX_SEM)
-    ngx_uint_t     semaphore;
-    sem_t          sem;
+#if (NGX_HAVE_FUTEX)
+    volatile uint32_t   *lock;
+#else
+    ngx_atomic_t        *lock;
+#endif
+    ngx_atomic_t        *wait;
+#if (NGX_HAVE_POSIX_SEM && !(NGX_HAVE_FUTEX))
+    ngx_uint_t           semaphore;
+    sem_t                sem;
 #endif
 #else
-    ngx_fd_t       fd;
-    u_char        *name;
+    ngx_fd_t             fd;
+    u_char              *name;
 #endif
-    ngx_uint_t     spin;
+    ngx_shmtx_stat_t    *stat;
+    ngx_uint_t           spin;
 } ngx_shmtx_t;
 
 
-ngx_int_t ngx_shmtx_create(ngx_shmtx_t *mtx, void *addr, u_char *name);
+ngx_int_t ngx_shmtx_create(ngx_shmtx_t *mtx, ngx_shmtx_sh_t *addr,
+    u_char *name);
 void ngx_shmtx_destory(ngx_shmtx_t *mtx);
 ngx_uint_t ngx_shmtx_trylock(ngx_shmtx_t *mtx);
 void ngx_shmtx_lock(ngx_shmtx_t *mtx);
 void ngx_shmtx_unlock(ngx_shmtx_t *mtx);
+ngx_uint_t ngx_shmtx_force_unlock(ngx_shmtx_t *mtx, ngx_pid_t pid);
 
 
 #endif /* _NGX_SHMTX_H_INCLUDED_ */
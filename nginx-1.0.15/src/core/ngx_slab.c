@@ -60,6 +60,27 @@
 
 #endif
 
+
+/*
+ * the chunks of the seven smallest size classes are cached per process,
+ * if the zone has at least NGX_SLAB_MAGAZINE_PAGES pages
+ */
+
+#define NGX_SLAB_MAGAZINES         64
+#define NGX_SLAB_MAGAZINE_CLASSES  7
+#define NGX_SLAB_MAGAZINE_PAGES    1024
+
+
+static void *ngx_slab_alloc_chunk(ngx_slab_pool_t *pool, size_t size);
+static void ngx_slab_free_chunk(ngx_slab_pool_t *pool, void *p);
+static ngx_uint_t ngx_slab_slot(ngx_slab_pool_t *pool, size_t size);
+static ngx_slab_magazine_t *ngx_slab_magazines(ngx_slab_pool_t *pool);
+static ngx_slab_magazine_t *ngx_slab_chunk_magazine(ngx_slab_pool_t *pool,
+    void *p);
+static ngx_int_t ngx_slab_cached(ngx_slab_pool_t *pool,
+    ngx_slab_magazine_t *mag, void *p);
+static void ngx_slab_flush_locked(ngx_slab_pool_t *pool,
+    ngx_slab_magazine_t *mag, ngx_uint_t n);
 static ngx_slab_page_t *ngx_slab_alloc_pages(ngx_slab_pool_t *pool,
     ngx_uint_t pages);
 static void ngx_slab_free_pages(ngx_slab_pool_t *pool, ngx_slab_page_t *page,
@@ -77,9 +98,9 @@ void
 ngx_slab_init(ngx_slab_pool_t *pool)
 {
     u_char           *p;
-    size_t            size;
+    size_t            size, cache;
     ngx_int_t         m;
-    ngx_uint_t        i, n, pages;
+    ngx_uint_t        i, k, n, pages;
     ngx_slab_page_t  *slots;
 
     /* STUB */
@@ -115,6 +136,50 @@ ngx_slab_init(ngx_slab_pool_t *pool)
     /* 前面是n个页描述块,后面才是真正的内存块 */
     p += n * sizeof(ngx_slab_page_t);
 
+    pool->stats = (ngx_slab_stat_t *) p;
+    ngx_memzero(pool->stats, n * sizeof(ngx_slab_stat_t));
+
+    p += n * sizeof(ngx_slab_stat_t);
+
+    if (size / ngx_pagesize >= NGX_SLAB_MAGAZINE_PAGES) {
+        n = NGX_SLAB_MAGAZINES * NGX_SLAB_MAGAZINE_CLASSES
+            * sizeof(ngx_slab_magazine_t);
+
+        pool->magazines = (ngx_slab_magazine_t *) p;
+        ngx_memzero(pool->magazines, n);
+
+        p += n;
+        size -= n;
+
+        /*
+         * a process returns only its own cached chunks when the zone
+         * is exhausted, so the magazines of all slots together are
+         * limited to 1/16 of the zone; a class that would get less
+         * than two chunks per magazine is not cached
+         */
+
+        cache = size / (16 * NGX_SLAB_MAGAZINES * NGX_SLAB_MAGAZINE_CLASSES);
+
+        for (i = 0; i < NGX_SLAB_MAGAZINE_CLASSES; i++) {
+            n = ngx_min(cache >> (pool->min_shift + i),
+                        NGX_SLAB_MAGAZINE_SIZE);
+
+            if (n < 2) {
+                n = 0;
+            }
+
+            for (k = i;
+                 k < NGX_SLAB_MAGAZINES * NGX_SLAB_MAGAZINE_CLASSES;
+                 k += NGX_SLAB_MAGAZINE_CLASSES)
+            {
+                pool->magazines[k].size = n;
+            }
+        }
+
+    } else {
+        pool->magazines = NULL;
+    }
+
     pages = (ngx_uint_t) (size / (ngx_pagesize + sizeof(ngx_slab_page_t)));
 
     ngx_memzero(p, pages * sizeof(ngx_slab_page_t));
@@ -141,13 +206,35 @@ ngx_slab_init(ngx_slab_pool_t *pool)
 
     pool->log_ctx = &pool->zero;
     pool->zero = '\0';
+
+    pool->log_nomem = 1;
 }
 
 /* 内存分配 */
 void *
 ngx_slab_alloc(ngx_slab_pool_t *pool, size_t size)
 {
-    void  *p;
+    void                 *p;
+    ngx_uint_t            slot;
+    ngx_slab_magazine_t  *mag;
+
+    mag = ngx_slab_magazines(pool);
+
+    if (mag && size < ngx_slab_max_size) {
+        slot = ngx_slab_slot(pool, size);
+
+        if (slot < NGX_SLAB_MAGAZINE_CLASSES && mag[slot].n) {
+            mag += slot;
+            mag->hits++;
+
+            p = mag->chunk[--mag->n];
+
+            ngx_log_debug1(NGX_LOG_DEBUG_ALLOC, ngx_cycle->log, 0,
+                           "slab alloc: %p cached", p);
+
+            return p;
+        }
+    }
 
     ngx_shmtx_lock(&pool->mutex);
 
@@ -158,11 +245,92 @@ ngx_slab_alloc(ngx_slab_pool_t *pool, size_t size)
     return p;
 }
 
+
+void *
+ngx_slab_alloc_locked(ngx_slab_pool_t *pool, size_t size)
+{
+    void                 *p;
+    ngx_uint_t            i, slot, nomem;
+    ngx_slab_magazine_t  *mag;
+
+    if (size >= ngx_slab_max_size) {
+        return ngx_slab_alloc_chunk(pool, size);
+    }
+
+    slot = ngx_slab_slot(pool, size);
+
+    mag = ngx_slab_magazines(pool);
+
+    if (mag == NULL
+        || slot >= NGX_SLAB_MAGAZINE_CLASSES
+        || mag[slot].size == 0)
+    {
+        pool->stats[slot].reqs++;
+
+        p = ngx_slab_alloc_chunk(pool, size);
+
+        if (p == NULL) {
+            pool->stats[slot].fails++;
+        }
+
+        return p;
+    }
+
+    if (mag[slot].n) {
+        mag[slot].hits++;
+        return mag[slot].chunk[--mag[slot].n];
+    }
+
+    pool->stats[slot].reqs++;
+
+    nomem = pool->log_nomem;
+    pool->log_nomem = 0;
+
+    p = ngx_slab_alloc_chunk(pool, size);
+
+    if (p == NULL) {
+
+        /* the chunks cached by this process may free whole pages */
+
+        for (i = 0; i < NGX_SLAB_MAGAZINE_CLASSES; i++) {
+            ngx_slab_flush_locked(pool, &mag[i], NGX_SLAB_MAGAZINE_SIZE);
+        }
+
+        pool->log_nomem = nomem;
+
+        p = ngx_slab_alloc_chunk(pool, size);
+
+        if (p == NULL) {
+            pool->stats[slot].fails++;
+            return NULL;
+        }
+    }
+
+    /* refill the magazine while the mutex is held */
+
+    mag += slot;
+
+    while (mag->n < mag->size / 2) {
+        mag->chunk[mag->n] = ngx_slab_alloc_chunk(pool, size);
+
+        if (mag->chunk[mag->n] == NULL) {
+            break;
+        }
+
+        mag->n++;
+    }
+
+    pool->log_nomem = nomem;
+
+    return p;
+}
+
+
 /*
  * 内存分配,size表示待分配的字节数
  */
-void *
-ngx_slab_alloc_locked(ngx_slab_pool_t *pool, size_t size)
+static void *
+ngx_slab_alloc_chunk(ngx_slab_pool_t *pool, size_t size)
 {
     size_t            s;
     uintptr_t         p, n, m, mask, *bitmap;
@@ -238,6 +406,8 @@ ngx_slab_alloc_locked(ngx_slab_pool_t *pool, size_t size)
                                      if (bitmap[n] != NGX_SLAB_BUSY) {
                                          p = (uintptr_t) bitmap + i;
 
+                                         pool->stats[slot].used++;
+
                                          goto done;
                                      }
                                 }
@@ -253,6 +423,8 @@ ngx_slab_alloc_locked(ngx_slab_pool_t *pool, size_t size)
                             /* p指向空闲内存块的首地址 */
                             p = (uintptr_t) bitmap + i;
 
+                            pool->stats[slot].used++;
+
                             goto done;
                         }
                     }
@@ -288,6 +460,8 @@ ngx_slab_alloc_locked(ngx_slab_pool_t *pool, size_t size)
                         p += i << shift;
                         p += (uintptr_t) pool->start;
 
+                        pool->stats[slot].used++;
+
                         goto done;
                     }
                 }
@@ -330,6 +504,8 @@ ngx_slab_alloc_locked(ngx_slab_pool_t *pool, size_t size)
                         p += i << shift;
                         p += (uintptr_t) pool->start;
 
+                        pool->stats[slot].used++;
+
                         goto done;
                     }
                 }
@@ -378,6 +554,9 @@ ngx_slab_alloc_locked(ngx_slab_pool_t *pool, size_t size)
             /* p指向该空闲块的首地址 */
             p += (uintptr_t) pool->start;
 
+            pool->stats[slot].total += (ngx_pagesize >> shift) - n;
+            pool->stats[slot].used++;
+
             goto done;
 
         } else if (shift == ngx_slab_exact_shift) {
@@ -394,6 +573,9 @@ ngx_slab_alloc_locked(ngx_slab_pool_t *pool, size_t size)
             /* p指向该空闲块的首地址 */
             p += (uintptr_t) pool->start;
 
+            pool->stats[slot].total += 8 * sizeof(uintptr_t);
+            pool->stats[slot].used++;
+
             goto done;
 
         } else { /* shift > ngx_slab_exact_shift */
@@ -407,6 +589,9 @@ ngx_slab_alloc_locked(ngx_slab_pool_t *pool, size_t size)
             p = (page - pool->pages) << ngx_pagesize_shift;
             p += (uintptr_t) pool->start;
 
+            pool->stats[slot].total += ngx_pagesize >> shift;
+            pool->stats[slot].used++;
+
             goto done;
         }
     }
@@ -424,6 +609,24 @@ done:
 void
 ngx_slab_free(ngx_slab_pool_t *pool, void *p)
 {
+    ngx_slab_magazine_t  *mag;
+
+    mag = ngx_slab_chunk_magazine(pool, p);
+
+    if (mag) {
+        if (ngx_slab_cached(pool, mag, p)) {
+            return;
+        }
+
+        if (mag->n < mag->size) {
+            ngx_log_debug1(NGX_LOG_DEBUG_ALLOC, ngx_cycle->log, 0,
+                           "slab free: %p cached", p);
+
+            mag->chunk[mag->n++] = p;
+            return;
+        }
+    }
+
     ngx_shmtx_lock(&pool->mutex);
 
     ngx_slab_free_locked(pool, p);
@@ -431,13 +634,40 @@ ngx_slab_free(ngx_slab_pool_t *pool, void *p)
     ngx_shmtx_unlock(&pool->mutex);
 }
 
-/* 内存释放 */
 void
 ngx_slab_free_locked(ngx_slab_pool_t *pool, void *p)
+{
+    ngx_slab_magazine_t  *mag;
+
+    mag = ngx_slab_chunk_magazine(pool, p);
+
+    if (mag == NULL) {
+        ngx_slab_free_chunk(pool, p);
+        return;
+    }
+
+    if (ngx_slab_cached(pool, mag, p)) {
+        return;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_ALLOC, ngx_cycle->log, 0,
+                   "slab free: %p cached", p);
+
+    if (mag->n == mag->size) {
+        ngx_slab_flush_locked(pool, mag, mag->size / 2);
+    }
+
+    mag->chunk[mag->n++] = p;
+}
+
+
+/* 内存释放 */
+static void
+ngx_slab_free_chunk(ngx_slab_pool_t *pool, void *p)
 {
     size_t            size;
     uintptr_t         slab, m, *bitmap;
-    ngx_uint_t        n, type, slot, shift, map;
+    ngx_uint_t        i, n, type, slot, shift, map;
     ngx_slab_page_t  *slots, *page;
 
     ngx_log_debug1(NGX_LOG_DEBUG_ALLOC, ngx_cycle->log, 0, "slab free: %p", p);
@@ -472,11 +702,12 @@ ngx_slab_free_locked(ngx_slab_pool_t *pool, void *p)
         bitmap = (uintptr_t *) ((uintptr_t) p & ~(ngx_pagesize - 1));
 
         if (bitmap[n] & m) {
+            slot = shift - pool->min_shift;
+
             /* 如果此内存块不在连表之中 */
             if (page->next == NULL) {
                 slots = (ngx_slab_page_t *)
                                    ((u_char *) pool + sizeof(ngx_slab_pool_t));
-                slot = shift - pool->min_shift;
 
                 page->next = slots[slot].next;
                 /* 将此内存块加入slots链表中 */
@@ -500,14 +731,16 @@ ngx_slab_free_locked(ngx_slab_pool_t *pool, void *p)
 
             map = (1 << (ngx_pagesize_shift - shift)) / (sizeof(uintptr_t) * 8);
 
-            for (n = 1; n < map; n++) {
-                if (bitmap[n]) {
+            for (i = 1; i < map; i++) {
+                if (bitmap[i]) {
                     goto done;
                 }
             }
             /* 如果次内存块没有被任何内存占用,就要回收此页面 */
             ngx_slab_free_pages(pool, page, 1);
 
+            pool->stats[slot].total -= (ngx_pagesize >> shift) - n;
+
             goto done;
         }
 
@@ -524,10 +757,11 @@ ngx_slab_free_locked(ngx_slab_pool_t *pool, void *p)
         }
 
         if (slab & m) {
+            slot = ngx_slab_exact_shift - pool->min_shift;
+
             if (slab == NGX_SLAB_BUSY) {
                 slots = (ngx_slab_page_t *)
                                    ((u_char *) pool + sizeof(ngx_slab_pool_t));
-                slot = ngx_slab_exact_shift - pool->min_shift;
 
                 page->next = slots[slot].next;
                 slots[slot].next = page;
@@ -544,6 +778,8 @@ ngx_slab_free_locked(ngx_slab_pool_t *pool, void *p)
 
             ngx_slab_free_pages(pool, page, 1);
 
+            pool->stats[slot].total -= 8 * sizeof(uintptr_t);
+
             goto done;
         }
 
@@ -562,11 +798,11 @@ ngx_slab_free_locked(ngx_slab_pool_t *pool, void *p)
                               + NGX_SLAB_MAP_SHIFT);
 
         if (slab & m) {
+            slot = shift - pool->min_shift;
 
             if (page->next == NULL) {
                 slots = (ngx_slab_page_t *)
                                    ((u_char *) pool + sizeof(ngx_slab_pool_t));
-                slot = shift - pool->min_shift;
 
                 page->next = slots[slot].next;
                 slots[slot].next = page;
@@ -583,6 +819,8 @@ ngx_slab_free_locked(ngx_slab_pool_t *pool, void *p)
 
             ngx_slab_free_pages(pool, page, 1);
 
+            pool->stats[slot].total -= ngx_pagesize >> shift;
+
             goto done;
         }
 
@@ -622,6 +860,8 @@ ngx_slab_free_locked(ngx_slab_pool_t *pool, void *p)
 
 done:
 
+    pool->stats[slot].used--;
+
     ngx_slab_junk(p, size);
 
     return;
@@ -643,6 +883,144 @@ fail:
     return;
 }
 
+
+static ngx_uint_t
+ngx_slab_slot(ngx_slab_pool_t *pool, size_t size)
+{
+    size_t      s;
+    ngx_uint_t  shift;
+
+    if (size <= pool->min_size) {
+        return 0;
+    }
+
+    shift = 1;
+    for (s = size - 1; s >>= 1; shift++) { /* void */ }
+
+    return shift - pool->min_shift;
+}
+
+
+static ngx_slab_magazine_t *
+ngx_slab_magazines(ngx_slab_pool_t *pool)
+{
+    /*
+     * the master process allocates from the zones during reconfiguration
+     * while the workers are running, so it does not use the magazines
+     */
+
+    if (pool->magazines == NULL
+        || ngx_process == NGX_PROCESS_MASTER
+        || ngx_process_slot >= NGX_SLAB_MAGAZINES)
+    {
+        return NULL;
+    }
+
+    return &pool->magazines[ngx_process_slot * NGX_SLAB_MAGAZINE_CLASSES];
+}
+
+
+static ngx_slab_magazine_t *
+ngx_slab_chunk_magazine(ngx_slab_pool_t *pool, void *p)
+{
+    uintptr_t             slab, m;
+    ngx_uint_t            n, shift;
+    ngx_slab_page_t      *page;
+    ngx_slab_magazine_t  *mag;
+
+    mag = ngx_slab_magazines(pool);
+
+    if (mag == NULL
+        || (u_char *) p < pool->start
+        || (u_char *) p >= pool->end)
+    {
+        return NULL;
+    }
+
+    /*
+     * the type and the chunk size of a page do not change, and the bit
+     * of the chunk stays set, while the caller owns the chunk; other
+     * bits may change, but a read of the whole word is atomic
+     */
+
+    page = &pool->pages[((u_char *) p - pool->start) >> ngx_pagesize_shift];
+    slab = page->slab;
+
+    switch (page->prev & NGX_SLAB_PAGE_MASK) {
+
+    case NGX_SLAB_SMALL:
+        shift = slab & NGX_SLAB_SHIFT_MASK;
+        n = ((uintptr_t) p & (ngx_pagesize - 1)) >> shift;
+        m = (uintptr_t) 1 << (n & (sizeof(uintptr_t) * 8 - 1));
+        slab = ((uintptr_t *) ((uintptr_t) p & ~(ngx_pagesize - 1)))
+                   [n / (sizeof(uintptr_t) * 8)];
+        break;
+
+    case NGX_SLAB_EXACT:
+        shift = ngx_slab_exact_shift;
+        m = (uintptr_t) 1 << (((uintptr_t) p & (ngx_pagesize - 1)) >> shift);
+        break;
+
+    case NGX_SLAB_BIG:
+        shift = slab & NGX_SLAB_SHIFT_MASK;
+
+        if (shift <= ngx_slab_exact_shift) {
+            return NULL;
+        }
+
+        m = (uintptr_t) 1 << ((((uintptr_t) p & (ngx_pagesize - 1)) >> shift)
+                              + NGX_SLAB_MAP_SHIFT);
+        break;
+
+    default: /* NGX_SLAB_PAGE */
+        return NULL;
+    }
+
+    if (shift - pool->min_shift >= NGX_SLAB_MAGAZINE_CLASSES
+        || ((uintptr_t) p & (((uintptr_t) 1 << shift) - 1))
+        || (slab & m) == 0
+        || mag[shift - pool->min_shift].size == 0)
+    {
+        /*
+         * invalid pointers and chunks that are already free
+         * are reported by ngx_slab_free_chunk()
+         */
+        return NULL;
+    }
+
+    return &mag[shift - pool->min_shift];
+}
+
+
+static ngx_int_t
+ngx_slab_cached(ngx_slab_pool_t *pool, ngx_slab_magazine_t *mag, void *p)
+{
+    ngx_uint_t  i;
+
+    /* the bit of a cached chunk is still set */
+
+    for (i = 0; i < mag->n; i++) {
+        if (mag->chunk[i] == p) {
+            ngx_slab_error(pool, NGX_LOG_ALERT,
+                           "ngx_slab_free(): chunk is already free");
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+static void
+ngx_slab_flush_locked(ngx_slab_pool_t *pool, ngx_slab_magazine_t *mag,
+    ngx_uint_t n)
+{
+    while (n-- && mag->n) {
+        ngx_slab_free_chunk(pool, mag->chunk[--mag->n]);
+    }
+}
+
+
 /*
  * pages表示需要分配的页数
  */
@@ -699,7 +1077,10 @@ ngx_slab_alloc_pages(ngx_slab_pool_t *pool, ngx_uint_t pages)
         }
     }
 
-    ngx_slab_error(pool, NGX_LOG_CRIT, "ngx_slab_alloc() failed: no memory");
+    if (pool->log_nomem) {
+        ngx_slab_error(pool, NGX_LOG_CRIT,
+                       "ngx_slab_alloc() failed: no memory");
+    }
 
     return NULL;
 }
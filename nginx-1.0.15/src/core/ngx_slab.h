@@ -23,9 +23,34 @@ struct ngx_slab_page_s {
 };
 
 
+typedef struct {
+    ngx_uint_t        total;
+    ngx_uint_t        used;
+
+    ngx_uint_t        reqs;
+    ngx_uint_t        fails;
+} ngx_slab_stat_t;
+
+
+/*
+ * a per-process cache of free chunks of one size class, it is accessed
+ * without the pool mutex by the process owning the slot only;
+ * "size" is set once by ngx_slab_init(), 0 disables the magazine
+ */
+
+#define NGX_SLAB_MAGAZINE_SIZE    16
+
+typedef struct {
+    ngx_uint_t        n;
+    ngx_uint_t        size;
+    ngx_uint_t        hits;
+    void             *chunk[NGX_SLAB_MAGAZINE_SIZE];
+} ngx_slab_magazine_t;
+
+
 typedef struct {
     /* 为下面的互斥锁成员ngx_shmtx_t mutex服务,使用信号量作为进程同步工具时会使用它 */
-    ngx_atomic_t      lock;
+    ngx_shmtx_sh_t    lock;
     /* 设定的最小内存块长度 */
     size_t            min_size;
     /* min_size对应的位偏移,因为slab的算法大量采用位操作 */
@@ -36,6 +61,11 @@ typedef struct {
     /* 所有的空闲页组成一个链表挂在free成员上 */
     ngx_slab_page_t   free;
 
+    ngx_slab_stat_t  *stats;
+
+    /* NULL if the zone is too small to keep chunks per process */
+    ngx_slab_magazine_t *magazines;
+
     /* 共享内存的范围 */
     u_char           *start;
     u_char           *end;
@@ -45,6 +75,8 @@ typedef struct {
     u_char           *log_ctx;
     u_char            zero;
 
+    unsigned          log_nomem:1;
+
     void             *data;
     /* 指向所属的ngx_shm_t成员的addr成员 */
     void             *addr;
@@ -0,0 +1,2239 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_event.h>
+
+/*
+ * io_uring事件模块: accept,recv和send以完成请求的形式放入提交队列,
+ * recv使用内核提供的缓冲区环(provided buffer ring),空闲连接不占用缓冲区,
+ * send先把数据复制到模块的发送缓冲区;文件缓冲区和SSL连接仍然走原来的
+ * 就绪通知方式,即IORING_OP_POLL_ADD请求.所有请求与等待事件合并为一次
+ * io_uring_enter
+ */
+
+
+/* the low bits of user_data, the poll requests keep the event pointer */
+
+#define NGX_IOURING_POLL     0
+#define NGX_IOURING_RECV     2
+#define NGX_IOURING_SEND     4
+#define NGX_IOURING_ACCEPT   6
+#define NGX_IOURING_OP_MASK  6
+
+#define NGX_IOURING_ACCEPTS  16
+
+/* the seconds a peer is given to read the data of a closed connection */
+
+#define NGX_IOURING_CLOSE_TIMEOUT  60
+
+
+typedef struct {
+    ngx_uint_t  entries;
+    ngx_bufs_t  buffers;
+} ngx_iouring_conf_t;
+
+
+typedef struct ngx_iouring_buf_s  ngx_iouring_buf_t;
+
+struct ngx_iouring_buf_s {
+    ngx_connection_t      *connection;
+    u_char                *start;
+    u_char                *pos;
+    u_char                *last;
+    ngx_iouring_buf_t     *next;
+    u_int                  sqe;
+    struct __kernel_timespec  ts;
+    unsigned               active:1;
+    unsigned               timer:1;
+};
+
+
+typedef struct {
+    ngx_connection_t      *connection;
+    ngx_socket_t           fd;
+    ngx_err_t              err;
+    socklen_t              socklen;
+    unsigned               active:1;
+    unsigned               closed:1;
+    u_char                 sockaddr[NGX_SOCKADDRLEN];
+} ngx_iouring_accept_t;
+
+
+typedef struct {
+    ngx_iouring_buf_t     *send;
+    ngx_iouring_accept_t  *accept;
+
+    /* the received data not read yet */
+    u_char                *pos;
+    u_char                *last;
+    ngx_uint_t             buffer;
+
+    ngx_err_t              recv_error;
+    ngx_err_t              send_error;
+
+    uint32_t               gen;
+    u_int                  sqe;
+
+    unsigned               recv:1;
+    unsigned               recv_active:1;
+    unsigned               eof:1;
+    unsigned               read_poll:1;
+    unsigned               write_poll:1;
+} ngx_iouring_conn_t;
+
+
+#define ngx_iouring_conn(c)  (&conns[(c) - ngx_cycle->connections])
+
+
+static ngx_int_t ngx_iouring_init(ngx_cycle_t *cycle, ngx_msec_t timer);
+static ngx_int_t ngx_iouring_buffers_init(ngx_cycle_t *cycle,
+    ngx_bufs_t *bufs);
+static void ngx_iouring_done(ngx_cycle_t *cycle);
+static ngx_int_t ngx_iouring_add_event(ngx_event_t *ev, ngx_int_t event,
+    ngx_uint_t flags);
+static ngx_int_t ngx_iouring_del_event(ngx_event_t *ev, ngx_int_t event,
+    ngx_uint_t flags);
+static ngx_int_t ngx_iouring_del_connection(ngx_connection_t *c,
+    ngx_uint_t flags);
+static ngx_int_t ngx_iouring_poll_add(ngx_event_t *ev);
+static ngx_int_t ngx_iouring_poll_remove(ngx_event_t *ev);
+static ngx_int_t ngx_iouring_cancel(uint64_t data, ngx_log_t *log);
+static struct io_uring_sqe *ngx_iouring_get_sqe(ngx_log_t *log);
+static ngx_int_t ngx_iouring_submit(ngx_log_t *log);
+#if (NGX_HAVE_EVENTFD)
+static ngx_int_t ngx_iouring_notify_init(ngx_log_t *log);
+static void ngx_iouring_notify_handler(ngx_event_t *ev);
+static ngx_int_t ngx_iouring_notify(ngx_event_handler_pt handler);
+#endif
+static ngx_int_t ngx_iouring_process_events(ngx_cycle_t *cycle,
+    ngx_msec_t timer, ngx_uint_t flags);
+static void ngx_iouring_post_event(ngx_event_t *ev, ngx_uint_t flags);
+
+static ngx_int_t ngx_iouring_accept_add(ngx_event_t *ev,
+    ngx_iouring_conn_t *ic);
+static ngx_int_t ngx_iouring_accept_del(ngx_event_t *ev,
+    ngx_iouring_conn_t *ic, ngx_uint_t flags);
+static ngx_int_t ngx_iouring_accept_start(ngx_iouring_accept_t *a,
+    ngx_log_t *log);
+static void ngx_iouring_accept_done(ngx_iouring_accept_t *a, int32_t res,
+    ngx_uint_t flags);
+
+static ssize_t ngx_iouring_recv(ngx_connection_t *c, u_char *buf,
+    size_t size);
+static ssize_t ngx_iouring_recv_chain(ngx_connection_t *c,
+    ngx_chain_t *chain);
+static ssize_t ngx_iouring_recv_queued(ngx_connection_t *c,
+    ngx_iouring_conn_t *ic);
+static ngx_int_t ngx_iouring_recv_start(ngx_connection_t *c,
+    ngx_iouring_conn_t *ic);
+static void ngx_iouring_recv_done(uint64_t data, int32_t res,
+    uint32_t cflags, ngx_uint_t flags);
+static void ngx_iouring_buffer_free(ngx_uint_t bid);
+
+static ssize_t ngx_iouring_send(ngx_connection_t *c, u_char *buf,
+    size_t size);
+static ngx_chain_t *ngx_iouring_send_chain(ngx_connection_t *c,
+    ngx_chain_t *in, off_t limit);
+static ngx_int_t ngx_iouring_send_start(ngx_iouring_buf_t *sb,
+    ngx_log_t *log);
+static void ngx_iouring_send_done(ngx_iouring_buf_t *sb, int32_t res,
+    ngx_uint_t flags);
+static ngx_int_t ngx_iouring_send_timeout(ngx_iouring_buf_t *sb,
+    ngx_log_t *log);
+static void ngx_iouring_timeout_remove(ngx_iouring_buf_t *sb);
+static void ngx_iouring_send_expire(ngx_iouring_buf_t *sb, int32_t res);
+
+static void *ngx_iouring_create_conf(ngx_cycle_t *cycle);
+static char *ngx_iouring_init_conf(ngx_cycle_t *cycle, void *conf);
+
+
+static int                        ring = -1;
+
+static u_char                    *sq_ring;
+static size_t                     sq_ring_size;
+static volatile u_int            *sq_head;
+static volatile u_int            *sq_tail;
+static u_int                      sq_mask;
+static u_int                      sq_entries;
+static u_int                      sq_local_tail;
+static struct io_uring_sqe       *sqes;
+static size_t                     sqes_size;
+
+static u_char                    *cq_ring;
+static volatile u_int            *cq_head;
+static volatile u_int            *cq_tail;
+static u_int                      cq_mask;
+static struct io_uring_cqe       *cqes;
+
+static ngx_iouring_conn_t        *conns;
+
+static ngx_bufs_t                 buffers;
+static struct io_uring_buf_ring  *buf_ring;
+static u_int                      buf_ring_mask;
+static uint16_t                   buf_ring_tail;
+static u_char                    *recv_bufs;
+static ngx_uint_t                 recv_held;
+static ngx_iouring_buf_t         *send_bufs;
+static ngx_iouring_buf_t         *send_free;
+
+#if (NGX_HAVE_EVENTFD)
+static int                        notify_fd = -1;
+static ngx_event_t                notify_event;
+static ngx_connection_t           notify_conn;
+static ngx_event_handler_pt       notify_handler;
+#endif
+
+
+static ngx_os_io_t  ngx_iouring_io = {
+    ngx_iouring_recv,
+    ngx_iouring_recv_chain,
+    NULL,
+    ngx_iouring_send,
+    ngx_iouring_send_chain,
+    0
+};
+
+
+static ngx_str_t      iouring_name = ngx_string("io_uring");
+
+static ngx_command_t  ngx_iouring_commands[] = {
+
+    { ngx_string("io_uring_entries"),
+      NGX_EVENT_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_num_slot,
+      0,
+      offsetof(ngx_iouring_conf_t, entries),
+      NULL },
+
+    { ngx_string("io_uring_buffers"),
+      NGX_EVENT_CONF|NGX_CONF_TAKE2,
+      ngx_conf_set_bufs_slot,
+      0,
+      offsetof(ngx_iouring_conf_t, buffers),
+      NULL },
+
+      ngx_null_command
+};
+
+
+ngx_event_module_t  ngx_iouring_module_ctx = {
+    &iouring_name,
+    ngx_iouring_create_conf,             /* create configuration */
+    ngx_iouring_init_conf,               /* init configuration */
+
+    {
+        ngx_iouring_add_event,           /* add an event */
+        ngx_iouring_del_event,           /* delete an event */
+        ngx_iouring_add_event,           /* enable an event */
+        ngx_iouring_del_event,           /* disable an event */
+        NULL,                            /* add an connection */
+        ngx_iouring_del_connection,      /* delete an connection */
+#if (NGX_HAVE_EVENTFD)
+        ngx_iouring_notify,              /* trigger a notify */
+#else
+        NULL,                            /* trigger a notify */
+#endif
+        NULL,                            /* process the changes */
+        ngx_iouring_process_events,      /* process the events */
+        ngx_iouring_init,                /* init the events */
+        ngx_iouring_done,                /* done the events */
+    }
+};
+
+ngx_module_t  ngx_iouring_module = {
+    NGX_MODULE_V1,
+    &ngx_iouring_module_ctx,             /* module context */
+    ngx_iouring_commands,                /* module directives */
+    NGX_EVENT_MODULE,                    /* module type */
+    NULL,                                /* init master */
+    NULL,                                /* init module */
+    NULL,                                /* init process */
+    NULL,                                /* init thread */
+    NULL,                                /* exit thread */
+    NULL,                                /* exit process */
+    NULL,                                /* exit master */
+    NGX_MODULE_V1_PADDING
+};
+
+
+/*
+ * We call io_uring_setup(), io_uring_enter(), and io_uring_register()
+ * directly as syscalls, the rings are small enough to be handled
+ * without liburing.
+ */
+
+static int
+io_uring_setup(u_int entries, struct io_uring_params *p)
+{
+    return syscall(SYS_io_uring_setup, entries, p);
+}
+
+
+static int
+io_uring_enter(int fd, u_int to_submit, u_int min_complete, u_int flags,
+    void *arg, size_t argsz)
+{
+    return syscall(SYS_io_uring_enter, fd, to_submit, min_complete, flags,
+                   arg, argsz);
+}
+
+
+static int
+io_uring_register(int fd, u_int opcode, void *arg, u_int nr_args)
+{
+    return syscall(SYS_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+
+static ngx_int_t
+ngx_iouring_init(ngx_cycle_t *cycle, ngx_msec_t timer)
+{
+    u_char                 *p;
+    u_int                   features;
+    size_t                  size;
+    ngx_uint_t              i;
+    ngx_iouring_conf_t     *iucf;
+    struct io_uring_params  params;
+
+    iucf = ngx_event_get_conf(cycle->conf_ctx, ngx_iouring_module);
+
+    if (ring == -1) {
+        ngx_memzero(&params, sizeof(struct io_uring_params));
+
+        /*
+         * every connection may have a poll or a receive, a send,
+         * and a cancellation in flight, and completions are not lost
+         * when the queue overflows
+         */
+
+        params.flags = IORING_SETUP_CQSIZE|IORING_SETUP_CLAMP;
+        params.cq_entries = ngx_max(cycle->connection_n * 4,
+                                    iucf->entries * 2);
+
+        ring = io_uring_setup(iucf->entries, &params);
+
+        if (ring == -1) {
+            ngx_log_error(NGX_LOG_EMERG, cycle->log, ngx_errno,
+                          "io_uring_setup() failed");
+            return NGX_ERROR;
+        }
+
+        /* IORING_FEAT_RSRC_TAGS marks 5.13 kernels with multishot poll */
+
+        features = IORING_FEAT_SINGLE_MMAP|IORING_FEAT_NODROP
+                   |IORING_FEAT_EXT_ARG|IORING_FEAT_RSRC_TAGS;
+
+        if ((params.features & features) != features) {
+            ngx_log_error(NGX_LOG_EMERG, cycle->log, 0,
+                          "io_uring features %08XD are not supported, "
+                          "at least Linux 5.13 is required",
+                          features & ~params.features);
+            goto failed;
+        }
+
+        /* both rings are in the same mapping */
+
+        sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u_int);
+        size = params.cq_off.cqes
+               + params.cq_entries * sizeof(struct io_uring_cqe);
+
+        sq_ring_size = ngx_max(sq_ring_size, size);
+
+        sq_ring = mmap(NULL, sq_ring_size, PROT_READ|PROT_WRITE,
+                       MAP_SHARED|MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+
+        if (sq_ring == MAP_FAILED) {
+            ngx_log_error(NGX_LOG_EMERG, cycle->log, ngx_errno,
+                          "mmap(IORING_OFF_SQ_RING) failed");
+            sq_ring = NULL;
+            goto failed;
+        }
+
+        cq_ring = sq_ring;
+
+        sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+        sqes = mmap(NULL, sqes_size, PROT_READ|PROT_WRITE,
+                    MAP_SHARED|MAP_POPULATE, ring, IORING_OFF_SQES);
+
+        if (sqes == MAP_FAILED) {
+            ngx_log_error(NGX_LOG_EMERG, cycle->log, ngx_errno,
+                          "mmap(IORING_OFF_SQES) failed");
+            sqes = NULL;
+            goto failed;
+        }
+
+        sq_head = (u_int *) (sq_ring + params.sq_off.head);
+        sq_tail = (u_int *) (sq_ring + params.sq_off.tail);
+        sq_mask = *(u_int *) (sq_ring + params.sq_off.ring_mask);
+        sq_entries = *(u_int *) (sq_ring + params.sq_off.ring_entries);
+        sq_local_tail = *sq_tail;
+
+        /* the submission entries are always used in the ring order */
+
+        p = sq_ring + params.sq_off.array;
+
+        for (i = 0; i < sq_entries; i++) {
+            ((u_int *) p)[i] = (u_int) i;
+        }
+
+        cq_head = (u_int *) (cq_ring + params.cq_off.head);
+        cq_tail = (u_int *) (cq_ring + params.cq_off.tail);
+        cq_mask = *(u_int *) (cq_ring + params.cq_off.ring_mask);
+        cqes = (struct io_uring_cqe *) (cq_ring + params.cq_off.cqes);
+
+        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                       "io_uring: fd:%d sq:%ud cq:%ud",
+                       ring, params.sq_entries, params.cq_entries);
+
+        conns = ngx_calloc(sizeof(ngx_iouring_conn_t) * cycle->connection_n,
+                           cycle->log);
+        if (conns == NULL) {
+            goto failed;
+        }
+
+        switch (ngx_iouring_buffers_init(cycle, &iucf->buffers)) {
+
+        case NGX_ERROR:
+            goto failed;
+
+        case NGX_DECLINED:
+            ngx_log_error(NGX_LOG_NOTICE, cycle->log, ngx_errno,
+                          "io_uring provided buffers are not supported, "
+                          "only the readiness notifications are used");
+            break;
+
+        default: /* NGX_OK */
+            break;
+        }
+
+#if (NGX_HAVE_EVENTFD)
+        if (ngx_iouring_notify_init(cycle->log) != NGX_OK) {
+            ngx_iouring_module_ctx.actions.notify = NULL;
+        }
+#endif
+    }
+
+    ngx_event_actions = ngx_iouring_module_ctx.actions;
+
+    ngx_event_flags = NGX_USE_CLEAR_EVENT|NGX_USE_GREEDY_EVENT;
+
+    if (buf_ring) {
+        ngx_iouring_io.udp_recv = ngx_os_io.udp_recv;
+        ngx_iouring_io.flags = ngx_os_io.flags;
+
+        ngx_io = ngx_iouring_io;
+
+        ngx_event_flags |= NGX_USE_IOURING_EVENT;
+
+    } else {
+        ngx_io = ngx_os_io;
+    }
+
+#if (NGX_HAVE_FILE_AIO)
+
+    /* the Linux AIO completions are reported via epoll only */
+
+    ngx_file_aio = 0;
+
+#endif
+
+    return NGX_OK;
+
+failed:
+
+    ngx_iouring_done(cycle);
+
+    return NGX_ERROR;
+}
+
+
+/*
+ * The received data are placed by the kernel into the buffers
+ * of a provided buffer ring (Linux 5.19), so a connection waiting
+ * for data holds no buffer.  The data to send are copied into
+ * the buffers of a separate pool and the caller's buffers are released
+ * at once, as if writev() has succeeded.
+ */
+
+static ngx_int_t
+ngx_iouring_buffers_init(ngx_cycle_t *cycle, ngx_bufs_t *bufs)
+{
+    u_char                  *p;
+    ngx_uint_t               i, n;
+    struct io_uring_buf_reg  reg;
+
+    for (n = 1; n < (ngx_uint_t) bufs->num; n <<= 1) { /* void */ }
+
+    buf_ring = ngx_memalign(ngx_pagesize, n * sizeof(struct io_uring_buf),
+                            cycle->log);
+    if (buf_ring == NULL) {
+        return NGX_ERROR;
+    }
+
+    ngx_memzero(buf_ring, n * sizeof(struct io_uring_buf));
+
+    ngx_memzero(&reg, sizeof(struct io_uring_buf_reg));
+
+    reg.ring_addr = (uintptr_t) buf_ring;
+    reg.ring_entries = n;
+    reg.bgid = 0;
+
+    if (io_uring_register(ring, IORING_REGISTER_PBUF_RING, &reg, 1) == -1) {
+        ngx_free(buf_ring);
+        buf_ring = NULL;
+        return NGX_DECLINED;
+    }
+
+    buf_ring_mask = n - 1;
+    buf_ring_tail = 0;
+
+    buffers = *bufs;
+
+    recv_bufs = ngx_alloc(2 * bufs->num * bufs->size, cycle->log);
+    if (recv_bufs == NULL) {
+        return NGX_ERROR;
+    }
+
+    send_bufs = ngx_alloc(bufs->num * sizeof(ngx_iouring_buf_t), cycle->log);
+    if (send_bufs == NULL) {
+        return NGX_ERROR;
+    }
+
+    p = recv_bufs + bufs->num * bufs->size;
+    send_free = NULL;
+
+    for (i = 0; i < (ngx_uint_t) bufs->num; i++) {
+        ngx_iouring_buffer_free(i);
+
+        send_bufs[i].connection = NULL;
+        send_bufs[i].start = p;
+        send_bufs[i].active = 0;
+        send_bufs[i].timer = 0;
+        send_bufs[i].next = send_free;
+        send_free = &send_bufs[i];
+
+        p += bufs->size;
+    }
+
+    recv_held = 0;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                   "io_uring buffers: %i %uz", bufs->num, bufs->size);
+
+    return NGX_OK;
+}
+
+
+#if (NGX_HAVE_EVENTFD)
+
+static ngx_int_t
+ngx_iouring_notify_init(ngx_log_t *log)
+{
+#if (NGX_HAVE_SYS_EVENTFD_H)
+    notify_fd = eventfd(0, 0);
+#else
+    notify_fd = syscall(SYS_eventfd, 0);
+#endif
+
+    if (notify_fd == -1) {
+        ngx_log_error(NGX_LOG_EMERG, log, ngx_errno, "eventfd() failed");
+        return NGX_ERROR;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_EVENT, log, 0,
+                   "notify eventfd: %d", notify_fd);
+
+    notify_event.handler = ngx_iouring_notify_handler;
+    notify_event.data = &notify_conn;
+    notify_event.log = log;
+
+    notify_conn.fd = notify_fd;
+    notify_conn.read = &notify_event;
+    notify_conn.log = log;
+
+    /*
+     * the multishot poll reports every write() to the descriptor,
+     * so it is never read in the usual way, see ngx_iouring_notify_handler()
+     */
+
+    if (ngx_iouring_poll_add(&notify_event) != NGX_OK) {
+
+        if (close(notify_fd) == -1) {
+            ngx_log_error(NGX_LOG_ALERT, log, ngx_errno,
+                          "eventfd close() failed");
+        }
+
+        notify_fd = -1;
+
+        return NGX_ERROR;
+    }
+
+    notify_event.active = 1;
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_iouring_notify_handler(ngx_event_t *ev)
+{
+    ssize_t   n;
+    uint64_t  count;
+
+    /* drain the counter before it could overflow */
+
+    if (++ev->index == NGX_MAX_UINT32_VALUE) {
+        ev->index = 0;
+
+        n = read(notify_fd, &count, sizeof(uint64_t));
+
+        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, ev->log, 0,
+                       "read() eventfd %d: %z count:%uL", notify_fd, n, count);
+
+        if ((size_t) n != sizeof(uint64_t)) {
+            ngx_log_error(NGX_LOG_ALERT, ev->log, ngx_errno,
+                          "read() eventfd %d failed", notify_fd);
+        }
+    }
+
+    notify_handler(ev);
+}
+
+
+static ngx_int_t
+ngx_iouring_notify(ngx_event_handler_pt handler)
+{
+    static uint64_t inc = 1;
+
+    /* may be called from other threads, the handler is always the same */
+
+    notify_handler = handler;
+
+    if ((size_t) write(notify_fd, &inc, sizeof(uint64_t)) != sizeof(uint64_t))
+    {
+        ngx_log_error(NGX_LOG_ALERT, notify_event.log, ngx_errno,
+                      "write() to eventfd %d failed", notify_fd);
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+#endif
+
+
+static void
+ngx_iouring_done(ngx_cycle_t *cycle)
+{
+    if (sqes) {
+        if (munmap(sqes, sqes_size) == -1) {
+            ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                          "munmap(IORING_OFF_SQES) failed");
+        }
+
+        sqes = NULL;
+    }
+
+    if (sq_ring) {
+        if (munmap(sq_ring, sq_ring_size) == -1) {
+            ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                          "munmap(IORING_OFF_SQ_RING) failed");
+        }
+
+        sq_ring = NULL;
+        cq_ring = NULL;
+    }
+
+    if (close(ring) == -1) {
+        ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                      "io_uring close() failed");
+    }
+
+    ring = -1;
+
+    /* the buffer ring is unregistered when the ring is closed */
+
+    if (buf_ring) {
+        ngx_free(buf_ring);
+        buf_ring = NULL;
+    }
+
+    if (recv_bufs) {
+        ngx_free(recv_bufs);
+        recv_bufs = NULL;
+    }
+
+    if (send_bufs) {
+        ngx_free(send_bufs);
+        send_bufs = NULL;
+        send_free = NULL;
+    }
+
+    if (conns) {
+        ngx_free(conns);
+        conns = NULL;
+    }
+
+#if (NGX_HAVE_EVENTFD)
+
+    if (notify_fd != -1) {
+
+        if (close(notify_fd) == -1) {
+            ngx_log_error(NGX_LOG_ALERT, cycle->log, ngx_errno,
+                          "eventfd close() failed");
+        }
+
+        notify_fd = -1;
+        notify_event.active = 0;
+    }
+
+#endif
+}
+
+
+/*
+ * The read and write events of a connection are separate poll requests
+ * keyed by the event pointer and its instance bit.  A multishot poll reports
+ * every wakeup as EPOLLET does, so it is used for NGX_CLEAR_EVENT; other
+ * events get a oneshot poll that is rearmed on each report, that is
+ * a level-triggered event.
+ *
+ * A multishot POLLOUT may miss the write space wakeups of a socket whose
+ * connection has been established after the peer's accept queue was full,
+ * so a clear write event gets a oneshot poll and becomes inactive when
+ * it is reported, as with event ports: ngx_handle_write_event() adds
+ * a new poll after the next EAGAIN.
+ *
+ * With the completion I/O an active read event of a connection that
+ * has switched to the receive requests, and an active write event
+ * of a connection with a send in flight, are reported by the completions
+ * of these requests instead of a poll, and the accept events are
+ * the accept requests.
+ */
+
+static ngx_int_t
+ngx_iouring_add_event(ngx_event_t *ev, ngx_int_t event, ngx_uint_t flags)
+{
+    ngx_connection_t    *c;
+    ngx_iouring_conn_t  *ic;
+
+    if (ev->active) {
+        return NGX_OK;
+    }
+
+    c = ev->data;
+    ic = ngx_iouring_conn(c);
+
+    ev->oneshot = (flags & NGX_CLEAR_EVENT) ? 0 : 1;
+
+    if (ngx_event_flags & NGX_USE_IOURING_EVENT) {
+
+        if (ev->accept) {
+            return ngx_iouring_accept_add(ev, ic);
+        }
+
+        if (ev->write) {
+            if (ic->send) {
+                ev->active = 1;
+                return NGX_OK;
+            }
+
+        } else if (ic->recv) {
+            ev->active = 1;
+
+            if (ic->recv_active) {
+                return NGX_OK;
+            }
+
+            if (ic->pos || ic->eof || ic->recv_error) {
+                ev->ready = 1;
+                ngx_post_event(ev, &ngx_posted_events);
+                return NGX_OK;
+            }
+
+            if (ngx_iouring_recv_start(c, ic) == NGX_ERROR) {
+                return NGX_ERROR;
+            }
+
+            return NGX_OK;
+        }
+    }
+
+    if (ngx_iouring_poll_add(ev) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    if (ev->write) {
+        ic->write_poll = 1;
+
+    } else {
+        ic->read_poll = 1;
+    }
+
+    ev->active = 1;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_iouring_del_event(ngx_event_t *ev, ngx_int_t event, ngx_uint_t flags)
+{
+    ngx_connection_t    *c;
+    ngx_iouring_conn_t  *ic;
+
+    if (!ev->active) {
+        return NGX_OK;
+    }
+
+    c = ev->data;
+    ic = ngx_iouring_conn(c);
+
+    if (ev->accept && (ngx_event_flags & NGX_USE_IOURING_EVENT)) {
+        return ngx_iouring_accept_del(ev, ic, flags);
+    }
+
+    ev->active = 0;
+
+    if (ev->write) {
+        if (!ic->write_poll) {
+            return NGX_OK;
+        }
+
+        ic->write_poll = 0;
+
+    } else {
+        if (!ic->read_poll) {
+            return NGX_OK;
+        }
+
+        ic->read_poll = 0;
+    }
+
+    return ngx_iouring_poll_remove(ev);
+}
+
+
+/*
+ * Unlike epoll, the requests hold a reference to the file, so they are
+ * removed even if the descriptor is closed: the socket is released
+ * when the requests are cancelled on the next submit.
+ */
+
+static ngx_int_t
+ngx_iouring_del_connection(ngx_connection_t *c, ngx_uint_t flags)
+{
+    uint32_t              gen;
+    ngx_iouring_buf_t    *sb;
+    ngx_iouring_conn_t   *ic;
+    struct io_uring_sqe  *sqe;
+
+    ic = ngx_iouring_conn(c);
+
+    if (ic->read_poll) {
+        if (ngx_iouring_poll_remove(c->read) != NGX_OK) {
+            return NGX_ERROR;
+        }
+
+        ic->read_poll = 0;
+    }
+
+    if (ic->write_poll) {
+        if (ngx_iouring_poll_remove(c->write) != NGX_OK) {
+            return NGX_ERROR;
+        }
+
+        ic->write_poll = 0;
+    }
+
+    c->read->active = 0;
+    c->write->active = 0;
+
+    if (!(flags & NGX_CLOSE_EVENT)) {
+        return NGX_OK;
+    }
+
+    if (ic->recv_active) {
+
+        if (ic->sqe - *sq_head < sq_local_tail - *sq_head) {
+
+            /* the receive is not submitted yet, so it becomes a nop */
+
+            sqe = &sqes[ic->sqe & sq_mask];
+            ngx_memzero(sqe, sizeof(struct io_uring_sqe));
+
+        } else if (ngx_iouring_cancel((uint64_t) ic->gen << 32
+                                      | (uint64_t) (ic - conns) << 3
+                                      | NGX_IOURING_RECV,
+                                      c->log)
+                   != NGX_OK)
+        {
+            return NGX_ERROR;
+        }
+    }
+
+    if (ic->pos) {
+        ngx_iouring_buffer_free(ic->buffer);
+        recv_held--;
+    }
+
+    sb = ic->send;
+
+    if (sb) {
+
+        /*
+         * the data were reported as sent, so they are submitted
+         * before the descriptor is closed, the send holds the socket
+         * open until it completes, and the completion frees the buffer;
+         * the send is cancelled at once only if the peer has not read
+         * for the send timeout, otherwise it is given
+         * NGX_IOURING_CLOSE_TIMEOUT seconds more, as c->error is also set
+         * by the normal closes, e.g. after the HTTP/2 GOAWAY frame
+         */
+
+        if (sb->sqe - *sq_head < sq_local_tail - *sq_head
+            && ngx_iouring_submit(c->log) != NGX_OK)
+        {
+            return NGX_ERROR;
+        }
+
+        sb->connection = NULL;
+
+        if (c->write->timedout) {
+            if (ngx_iouring_cancel((uintptr_t) sb | NGX_IOURING_SEND, c->log)
+                != NGX_OK)
+            {
+                return NGX_ERROR;
+            }
+
+        } else if (ngx_iouring_send_timeout(sb, c->log) != NGX_OK) {
+            return NGX_ERROR;
+        }
+    }
+
+    gen = ic->gen + 1;
+
+    ngx_memzero(ic, sizeof(ngx_iouring_conn_t));
+
+    ic->gen = gen;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_iouring_poll_add(ngx_event_t *ev)
+{
+    uint32_t              events;
+    ngx_connection_t     *c;
+    struct io_uring_sqe  *sqe;
+
+    c = ev->data;
+
+    sqe = ngx_iouring_get_sqe(ev->log);
+    if (sqe == NULL) {
+        return NGX_ERROR;
+    }
+
+    events = ev->write ? POLLOUT : POLLIN;
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = c->fd;
+#if (NGX_HAVE_LITTLE_ENDIAN)
+    sqe->poll32_events = events;
+#else
+    sqe->poll32_events = (events << 16) | (events >> 16);
+#endif
+    sqe->len = (ev->oneshot || ev->write) ? 0 : IORING_POLL_ADD_MULTI;
+    sqe->user_data = (uintptr_t) ev | ev->instance;
+
+    ngx_log_debug3(NGX_LOG_DEBUG_EVENT, ev->log, 0,
+                   "io_uring poll add: fd:%d ev:%04XD oneshot:%d",
+                   c->fd, events, ev->oneshot);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_iouring_poll_remove(ngx_event_t *ev)
+{
+    struct io_uring_sqe  *sqe;
+
+    sqe = ngx_iouring_get_sqe(ev->log);
+    if (sqe == NULL) {
+        return NGX_ERROR;
+    }
+
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = (uintptr_t) ev | ev->instance;
+
+    /* user_data 0 marks the completions to ignore */
+
+    sqe->user_data = 0;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_EVENT, ev->log, 0,
+                   "io_uring poll remove: fd:%d w:%d",
+                   ((ngx_connection_t *) ev->data)->fd, ev->write);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_iouring_cancel(uint64_t data, ngx_log_t *log)
+{
+    struct io_uring_sqe  *sqe;
+
+    sqe = ngx_iouring_get_sqe(log);
+    if (sqe == NULL) {
+        return NGX_ERROR;
+    }
+
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = data;
+    sqe->user_data = 0;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_EVENT, log, 0,
+                   "io_uring cancel: %uL", data);
+
+    return NGX_OK;
+}
+
+
+static struct io_uring_sqe *
+ngx_iouring_get_sqe(ngx_log_t *log)
+{
+    struct io_uring_sqe  *sqe;
+
+    if (sq_local_tail - *sq_head == sq_entries) {
+
+        /* the queue is full, submit it without waiting */
+
+        if (ngx_iouring_submit(log) != NGX_OK) {
+            return NULL;
+        }
+
+        if (sq_local_tail - *sq_head == sq_entries) {
+            ngx_log_error(NGX_LOG_ALERT, log, 0,
+                          "io_uring submission queue is full");
+            return NULL;
+        }
+    }
+
+    sqe = &sqes[sq_local_tail & sq_mask];
+    sq_local_tail++;
+
+    ngx_memzero(sqe, sizeof(struct io_uring_sqe));
+
+    return sqe;
+}
+
+
+static ngx_int_t
+ngx_iouring_submit(ngx_log_t *log)
+{
+    ngx_memory_barrier();
+
+    *sq_tail = sq_local_tail;
+
+    if (io_uring_enter(ring, sq_local_tail - *sq_head, 0, 0, NULL, 0) == -1) {
+        ngx_log_error(NGX_LOG_ALERT, log, ngx_errno,
+                      "io_uring_enter() failed");
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_iouring_process_events(ngx_cycle_t *cycle, ngx_msec_t timer,
+    ngx_uint_t flags)
+{
+    int                             n;
+    u_int                           head, tail, more;
+    int32_t                         res;
+    uint32_t                        revents, cflags;
+    uint64_t                        data;
+    ngx_int_t                       instance;
+    ngx_uint_t                      level;
+    ngx_err_t                       err;
+    ngx_event_t                    *ev;
+    ngx_connection_t               *c;
+    ngx_iouring_buf_t              *sb;
+    ngx_iouring_conn_t             *ic;
+    struct io_uring_cqe            *cqe;
+    struct __kernel_timespec        ts;
+    struct io_uring_getevents_arg   arg;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                   "io_uring timer: %M, submit: %ud",
+                   timer, sq_local_tail - *sq_head);
+
+    /* the pending changes are submitted by the same call that waits */
+
+    ngx_memory_barrier();
+
+    *sq_tail = sq_local_tail;
+
+    ngx_memzero(&arg, sizeof(struct io_uring_getevents_arg));
+    arg.sigmask_sz = _NSIG / 8;
+
+    if (timer != NGX_TIMER_INFINITE) {
+        ts.tv_sec = timer / 1000;
+        ts.tv_nsec = (timer % 1000) * 1000000;
+        arg.ts = (uintptr_t) &ts;
+    }
+
+    n = io_uring_enter(ring, sq_local_tail - *sq_head, 1,
+                       IORING_ENTER_GETEVENTS|IORING_ENTER_EXT_ARG,
+                       &arg, sizeof(struct io_uring_getevents_arg));
+
+    err = (n == -1) ? ngx_errno : 0;
+
+    if (flags & NGX_UPDATE_TIME || ngx_event_timer_alarm) {
+        ngx_time_update();
+    }
+
+    if (err && err != ETIME && err != NGX_EBUSY) {
+        if (err == NGX_EINTR) {
+
+            if (ngx_event_timer_alarm) {
+                ngx_event_timer_alarm = 0;
+                return NGX_OK;
+            }
+
+            level = NGX_LOG_INFO;
+
+        } else {
+            level = NGX_LOG_ALERT;
+        }
+
+        ngx_log_error(level, cycle->log, err, "io_uring_enter() failed");
+        return NGX_ERROR;
+    }
+
+    head = *cq_head;
+    tail = *cq_tail;
+
+    ngx_memory_barrier();
+
+    if (head == tail) {
+        return NGX_OK;
+    }
+
+    ngx_mutex_lock(ngx_posted_events_mutex);
+
+    for ( /* void */ ; head != tail; head++) {
+        cqe = &cqes[head & cq_mask];
+
+        data = cqe->user_data;
+        res = cqe->res;
+        cflags = cqe->flags;
+
+        /* the entry is consumed before the handlers may submit again */
+
+        ngx_memory_barrier();
+
+        *cq_head = head + 1;
+
+        switch (data & NGX_IOURING_OP_MASK) {
+
+        case NGX_IOURING_RECV:
+            ngx_iouring_recv_done(data, res, cflags, flags);
+            continue;
+
+        case NGX_IOURING_SEND:
+            sb = (ngx_iouring_buf_t *) (uintptr_t)
+                     (data & ~(uint64_t) (NGX_IOURING_OP_MASK|1));
+
+            /* the low bit marks the timeout of a closed connection's send */
+
+            if (data & 1) {
+                ngx_iouring_send_expire(sb, res);
+
+            } else {
+                ngx_iouring_send_done(sb, res, flags);
+            }
+
+            continue;
+
+        case NGX_IOURING_ACCEPT:
+            ngx_iouring_accept_done((ngx_iouring_accept_t *) (uintptr_t)
+                                    (data & ~(uint64_t) NGX_IOURING_OP_MASK),
+                                    res, flags);
+            continue;
+
+        default: /* NGX_IOURING_POLL */
+            break;
+        }
+
+        if (data == 0) {
+            continue;
+        }
+
+        more = cflags & IORING_CQE_F_MORE;
+
+        instance = data & 1;
+        ev = (ngx_event_t *) (uintptr_t) (data & (uint64_t) ~1);
+        c = ev->data;
+
+        if (c->fd == -1 || ev->instance != instance) {
+
+            /*
+             * the stale event from a file descriptor
+             * that was just closed in this iteration
+             */
+
+            ngx_log_debug1(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                           "io_uring: stale event %p", ev);
+            continue;
+        }
+
+        ngx_log_debug4(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                       "io_uring: fd:%d w:%d res:%D more:%ud",
+                       c->fd, ev->write, res, more);
+
+        if (res == -NGX_ECANCELED || !ev->active) {
+            /* the event was deleted */
+            continue;
+        }
+
+        ic = NULL;
+
+#if (NGX_HAVE_EVENTFD)
+        if (ev != &notify_event)
+#endif
+        {
+            ic = ngx_iouring_conn(c);
+
+            if (!(ev->write ? ic->write_poll : ic->read_poll)) {
+                /* the poll was replaced by a receive or a send */
+                continue;
+            }
+        }
+
+        if (res < 0) {
+            ngx_log_error(NGX_LOG_ALERT, cycle->log, -res,
+                          "io_uring poll on fd:%d failed", c->fd);
+
+            ev->active = 0;
+            revents = POLLERR;
+
+        } else {
+            revents = (uint32_t) res;
+
+            /*
+             * the oneshot poll has completed, and the multishot one
+             * may be terminated on the completion queue overflow
+             */
+
+            if (!more) {
+                if (ev->write && !ev->oneshot) {
+                    ev->active = 0;
+
+                } else if (ngx_iouring_poll_add(ev) != NGX_OK) {
+                    ev->active = 0;
+                }
+            }
+        }
+
+        if (!ev->active && ic) {
+            if (ev->write) {
+                ic->write_poll = 0;
+
+            } else {
+                ic->read_poll = 0;
+            }
+        }
+
+        if (revents & (POLLERR|POLLHUP)) {
+            ngx_log_debug2(NGX_LOG_DEBUG_EVENT, cycle->log, 0,
+                           "io_uring poll error on fd:%d ev:%04XD",
+                           c->fd, revents);
+        }
+
+        ngx_iouring_post_event(ev, flags);
+    }
+
+    ngx_mutex_unlock(ngx_posted_events_mutex);
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_iouring_post_event(ngx_event_t *ev, ngx_uint_t flags)
+{
+    ngx_event_t  **queue;
+
+    if ((flags & NGX_POST_THREAD_EVENTS) && !ev->accept) {
+        ev->posted_ready = 1;
+
+    } else {
+        ev->ready = 1;
+    }
+
+    if (flags & NGX_POST_EVENTS) {
+        queue = (ngx_event_t **) (ev->accept ?
+                       &ngx_posted_accept_events : &ngx_posted_events);
+
+        ngx_locked_post_event(ev, queue);
+
+    } else {
+        ev->handler(ev);
+    }
+}
+
+
+/*
+ * Each listening socket has several accept requests in flight while
+ * its event is active.  The accepted sockets are taken one by one
+ * by ngx_event_accept() via ngx_iouring_accept().
+ */
+
+static ngx_int_t
+ngx_iouring_accept_add(ngx_event_t *ev, ngx_iouring_conn_t *ic)
+{
+    ngx_uint_t             i;
+    ngx_iouring_accept_t  *a;
+
+    a = ic->accept;
+
+    if (a == NULL) {
+        a = ngx_pcalloc(ngx_cycle->pool,
+                        NGX_IOURING_ACCEPTS * sizeof(ngx_iouring_accept_t));
+        if (a == NULL) {
+            return NGX_ERROR;
+        }
+
+        for (i = 0; i < NGX_IOURING_ACCEPTS; i++) {
+            a[i].connection = ev->data;
+            a[i].fd = (ngx_socket_t) -1;
+        }
+
+        ic->accept = a;
+    }
+
+    ev->active = 1;
+
+    for (i = 0; i < NGX_IOURING_ACCEPTS; i++) {
+
+        /* the cancelled requests are restarted by their completions */
+
+        if (a[i].active || a[i].fd != (ngx_socket_t) -1 || a[i].err) {
+            continue;
+        }
+
+        if (ngx_iouring_accept_start(&a[i], ev->log) != NGX_OK) {
+            return NGX_ERROR;
+        }
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_iouring_accept_del(ngx_event_t *ev, ngx_iouring_conn_t *ic,
+    ngx_uint_t flags)
+{
+    ngx_uint_t             i;
+    ngx_iouring_accept_t  *a;
+
+    ev->active = 0;
+
+    a = ic->accept;
+
+    if (a == NULL) {
+        return NGX_OK;
+    }
+
+    for (i = 0; i < NGX_IOURING_ACCEPTS; i++) {
+
+        if (a[i].active
+            && ngx_iouring_cancel((uintptr_t) &a[i] | NGX_IOURING_ACCEPT,
+                                  ev->log)
+               != NGX_OK)
+        {
+            return NGX_ERROR;
+        }
+
+        if (!(flags & NGX_CLOSE_EVENT)) {
+            continue;
+        }
+
+        a[i].closed = 1;
+
+        if (a[i].fd != (ngx_socket_t) -1) {
+            if (ngx_close_socket(a[i].fd) == -1) {
+                ngx_log_error(NGX_LOG_ALERT, ev->log, ngx_socket_errno,
+                              ngx_close_socket_n " failed");
+            }
+
+            a[i].fd = (ngx_socket_t) -1;
+        }
+    }
+
+    if (!(flags & NGX_CLOSE_EVENT)) {
+        return NGX_OK;
+    }
+
+    ic->accept = NULL;
+
+    /* the listening socket must not accept after it is closed */
+
+    return ngx_iouring_submit(ev->log);
+}
+
+
+static ngx_int_t
+ngx_iouring_accept_start(ngx_iouring_accept_t *a, ngx_log_t *log)
+{
+    struct io_uring_sqe  *sqe;
+
+    sqe = ngx_iouring_get_sqe(log);
+    if (sqe == NULL) {
+        return NGX_ERROR;
+    }
+
+    a->socklen = NGX_SOCKADDRLEN;
+
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = a->connection->fd;
+    sqe->addr = (uintptr_t) a->sockaddr;
+    sqe->addr2 = (uintptr_t) &a->socklen;
+    sqe->accept_flags = SOCK_NONBLOCK;
+    sqe->user_data = (uintptr_t) a | NGX_IOURING_ACCEPT;
+
+    a->active = 1;
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_iouring_accept_done(ngx_iouring_accept_t *a, int32_t res,
+    ngx_uint_t flags)
+{
+    ngx_connection_t  *lc;
+
+    a->active = 0;
+
+    lc = a->connection;
+
+    if (a->closed || lc->fd == (ngx_socket_t) -1) {
+
+        if (res >= 0 && ngx_close_socket(res) == -1) {
+            ngx_log_error(NGX_LOG_ALERT, ngx_cycle->log, ngx_socket_errno,
+                          ngx_close_socket_n " failed");
+        }
+
+        return;
+    }
+
+    ngx_log_debug2(NGX_LOG_DEBUG_EVENT, lc->log, 0,
+                   "io_uring accept: fd:%d res:%D", lc->fd, res);
+
+    if (res == -NGX_ECANCELED) {
+
+        /* the event has been enabled again before the completion */
+
+        if (lc->read->active) {
+            (void) ngx_iouring_accept_start(a, lc->log);
+        }
+
+        return;
+    }
+
+    if (res >= 0) {
+        a->fd = res;
+
+    } else {
+        a->err = -res;
+    }
+
+    ngx_iouring_post_event(lc->read, flags);
+}
+
+
+ngx_socket_t
+ngx_iouring_accept(ngx_event_t *ev, struct sockaddr *sa, socklen_t *socklen)
+{
+    ngx_uint_t             i;
+    ngx_socket_t           s;
+    ngx_connection_t      *lc;
+    ngx_iouring_accept_t  *a, *ready;
+
+    lc = ev->data;
+    a = ngx_iouring_conn(lc)->accept;
+    ready = NULL;
+
+    for (i = 0; a && i < NGX_IOURING_ACCEPTS; i++) {
+
+        if (a[i].fd == (ngx_socket_t) -1 && a[i].err == 0) {
+            continue;
+        }
+
+        if (ready == NULL) {
+            ready = &a[i];
+            continue;
+        }
+
+        /* there are more accepted sockets than will be taken now */
+
+        if (!ev->available) {
+            ev->ready = 1;
+            ngx_post_event(ev, &ngx_posted_accept_events);
+        }
+
+        break;
+    }
+
+    if (ready == NULL) {
+        ngx_set_socket_errno(NGX_EAGAIN);
+        return (ngx_socket_t) -1;
+    }
+
+    s = ready->fd;
+
+    if (s == (ngx_socket_t) -1) {
+        ngx_set_socket_errno(ready->err);
+        ready->err = 0;
+
+    } else {
+        *socklen = ngx_min(*socklen, ready->socklen);
+        ngx_memcpy(sa, ready->sockaddr, *socklen);
+        ready->fd = (ngx_socket_t) -1;
+    }
+
+    if (ev->active) {
+        (void) ngx_iouring_accept_start(ready, ev->log);
+    }
+
+    return s;
+}
+
+
+/*
+ * A connection starts with plain recv() calls, as there are usually
+ * data already, and switches to the receive requests on the first
+ * EAGAIN.  The received data are copied from the ring buffer, which is
+ * returned to the kernel when it is drained.  If the ring runs out of
+ * buffers, the connection returns to recv() and a poll.
+ */
+
+static ssize_t
+ngx_iouring_recv(ngx_connection_t *c, u_char *buf, size_t size)
+{
+    ssize_t              n;
+    ngx_iouring_conn_t  *ic;
+
+    ic = ngx_iouring_conn(c);
+
+    if (ic->recv) {
+
+        if (ic->pos == NULL) {
+            n = ngx_iouring_recv_queued(c, ic);
+
+            if (n != NGX_DECLINED) {
+                return n;
+            }
+
+            goto plain;
+        }
+
+        n = ngx_min((size_t) (ic->last - ic->pos), size);
+
+        ngx_memcpy(buf, ic->pos, n);
+        ic->pos += n;
+
+        ngx_log_debug2(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                       "io_uring recv: fd:%d %z", c->fd, n);
+
+        if (ic->pos == ic->last) {
+            ngx_iouring_buffer_free(ic->buffer);
+            recv_held--;
+
+            ic->pos = NULL;
+            ic->last = NULL;
+
+            /* the next data are reported by the receive completion */
+
+            c->read->ready = 0;
+
+            if (ngx_iouring_recv_start(c, ic) == NGX_ERROR) {
+                return NGX_ERROR;
+            }
+        }
+
+        return n;
+    }
+
+plain:
+
+    n = ngx_os_io.recv(c, buf, size);
+
+    if (n == NGX_AGAIN && ngx_iouring_recv_start(c, ic) == NGX_ERROR) {
+        c->read->error = 1;
+        return NGX_ERROR;
+    }
+
+    return n;
+}
+
+
+static ssize_t
+ngx_iouring_recv_chain(ngx_connection_t *c, ngx_chain_t *chain)
+{
+    size_t               size;
+    ssize_t              n;
+    ngx_chain_t         *cl;
+    ngx_iouring_conn_t  *ic;
+
+    ic = ngx_iouring_conn(c);
+
+    if (ic->recv) {
+
+        if (ic->pos == NULL) {
+            n = ngx_iouring_recv_queued(c, ic);
+
+            if (n != NGX_DECLINED) {
+                return n;
+            }
+
+            goto plain;
+        }
+
+        /* the bufs are filled in order and their last is not moved */
+
+        n = 0;
+
+        for (cl = chain; cl && ic->pos < ic->last; cl = cl->next) {
+            size = ngx_min((size_t) (cl->buf->end - cl->buf->last),
+                           (size_t) (ic->last - ic->pos));
+
+            ngx_memcpy(cl->buf->last, ic->pos, size);
+
+            ic->pos += size;
+            n += size;
+        }
+
+        ngx_log_debug2(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                       "io_uring recv chain: fd:%d %z", c->fd, n);
+
+        if (ic->pos == ic->last) {
+            ngx_iouring_buffer_free(ic->buffer);
+            recv_held--;
+
+            ic->pos = NULL;
+            ic->last = NULL;
+
+            c->read->ready = 0;
+
+            if (ngx_iouring_recv_start(c, ic) == NGX_ERROR) {
+                return NGX_ERROR;
+            }
+        }
+
+        return n;
+    }
+
+plain:
+
+    n = ngx_os_io.recv_chain(c, chain);
+
+    if (n == NGX_AGAIN && ngx_iouring_recv_start(c, ic) == NGX_ERROR) {
+        c->read->error = 1;
+        return NGX_ERROR;
+    }
+
+    return n;
+}
+
+
+static ssize_t
+ngx_iouring_recv_queued(ngx_connection_t *c, ngx_iouring_conn_t *ic)
+{
+    ngx_event_t  *rev;
+
+    rev = c->read;
+
+    if (ic->eof) {
+        rev->ready = 0;
+        rev->eof = 1;
+        return 0;
+    }
+
+    if (ic->recv_error) {
+        rev->ready = 0;
+        rev->error = 1;
+        return ngx_connection_error(c, ic->recv_error, "recv() failed");
+    }
+
+    if (!ic->recv_active) {
+        switch (ngx_iouring_recv_start(c, ic)) {
+
+        case NGX_ERROR:
+            rev->error = 1;
+            return NGX_ERROR;
+
+        case NGX_DECLINED:
+            return NGX_DECLINED;
+
+        default: /* NGX_OK */
+            break;
+        }
+    }
+
+    rev->ready = 0;
+
+    return NGX_AGAIN;
+}
+
+
+static ngx_int_t
+ngx_iouring_recv_start(ngx_connection_t *c, ngx_iouring_conn_t *ic)
+{
+    ngx_event_t          *rev;
+    struct io_uring_sqe  *sqe;
+
+    rev = c->read;
+
+    if (recv_held < (ngx_uint_t) buffers.num) {
+
+        if (ic->read_poll) {
+            if (ngx_iouring_poll_remove(rev) != NGX_OK) {
+                return NGX_ERROR;
+            }
+
+            ic->read_poll = 0;
+        }
+
+        sqe = ngx_iouring_get_sqe(c->log);
+        if (sqe == NULL) {
+            return NGX_ERROR;
+        }
+
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = c->fd;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = 0;
+        sqe->len = buffers.size;
+        sqe->user_data = (uint64_t) ic->gen << 32
+                         | (uint64_t) (ic - conns) << 3
+                         | NGX_IOURING_RECV;
+
+        ic->sqe = sq_local_tail - 1;
+        ic->recv = 1;
+        ic->recv_active = 1;
+
+        ngx_log_debug1(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                       "io_uring recv add: fd:%d", c->fd);
+
+        return NGX_OK;
+    }
+
+    /* all buffers hold unread data, so wait for readiness */
+
+    ic->recv = 0;
+
+    if (rev->active && !ic->read_poll) {
+        if (ngx_iouring_poll_add(rev) != NGX_OK) {
+            return NGX_ERROR;
+        }
+
+        ic->read_poll = 1;
+    }
+
+    return NGX_DECLINED;
+}
+
+
+static void
+ngx_iouring_recv_done(uint64_t data, int32_t res, uint32_t cflags,
+    ngx_uint_t flags)
+{
+    ngx_uint_t           i, bid;
+    ngx_event_t         *rev;
+    ngx_connection_t    *c;
+    ngx_iouring_conn_t  *ic;
+
+    i = (ngx_uint_t) (data >> 3) & 0x1fffffff;
+    ic = &conns[i];
+
+    bid = cflags >> IORING_CQE_BUFFER_SHIFT;
+
+    if (ic->gen != (uint32_t) (data >> 32)) {
+
+        /* the connection was closed */
+
+        if (cflags & IORING_CQE_F_BUFFER) {
+            ngx_iouring_buffer_free(bid);
+        }
+
+        return;
+    }
+
+    c = &ngx_cycle->connections[i];
+    rev = c->read;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                   "io_uring recv: fd:%d res:%D", c->fd, res);
+
+    ic->recv_active = 0;
+
+    if (res > 0) {
+        ic->buffer = bid;
+        ic->pos = recv_bufs + bid * buffers.size;
+        ic->last = ic->pos + res;
+
+        recv_held++;
+
+    } else if (res == 0) {
+        ic->eof = 1;
+
+    } else if (res == -ENOBUFS) {
+
+        /* the data are read with recv() */
+
+        ic->recv = 0;
+
+    } else {
+        ic->recv_error = -res;
+    }
+
+    if (rev->active) {
+        ngx_iouring_post_event(rev, flags);
+
+    } else {
+        rev->ready = 1;
+    }
+}
+
+
+/*
+ * The data and the end of stream taken by a receive request are not seen
+ * by recv(MSG_PEEK) any more, so the tests of idle connections ask here
+ * first.  Returns 1 if there are data, 0 on the end of stream, -1 with
+ * the socket errno set on an error, and NGX_DECLINED if nothing is queued.
+ */
+
+ngx_int_t
+ngx_iouring_pending(ngx_connection_t *c)
+{
+    ngx_iouring_conn_t  *ic;
+
+    ic = ngx_iouring_conn(c);
+
+    if (ic->pos) {
+        return 1;
+    }
+
+    if (ic->eof) {
+        return 0;
+    }
+
+    if (ic->recv_error) {
+        ngx_set_socket_errno(ic->recv_error);
+        return -1;
+    }
+
+    return NGX_DECLINED;
+}
+
+
+static void
+ngx_iouring_buffer_free(ngx_uint_t bid)
+{
+    struct io_uring_buf  *b;
+
+    /* bufs[0].resv is the ring tail, so the fields are set one by one */
+
+    b = &buf_ring->bufs[buf_ring_tail & buf_ring_mask];
+
+    b->addr = (uintptr_t) (recv_bufs + bid * buffers.size);
+    b->len = buffers.size;
+    b->bid = (uint16_t) bid;
+
+    buf_ring_tail++;
+
+    ngx_memory_barrier();
+
+    *(volatile uint16_t *) &buf_ring->tail = buf_ring_tail;
+}
+
+
+static ssize_t
+ngx_iouring_send(ngx_connection_t *c, u_char *buf, size_t size)
+{
+    ngx_buf_t     b;
+    ngx_chain_t   cl, *rc;
+
+    if (size == 0) {
+        return 0;
+    }
+
+    ngx_memzero(&b, sizeof(ngx_buf_t));
+
+    b.pos = buf;
+    b.last = buf + size;
+    b.memory = 1;
+
+    cl.buf = &b;
+    cl.next = NULL;
+
+    rc = ngx_iouring_send_chain(c, &cl, size);
+
+    if (rc == NGX_CHAIN_ERROR) {
+        return NGX_ERROR;
+    }
+
+    if (b.pos == buf) {
+        return NGX_AGAIN;
+    }
+
+    return b.pos - buf;
+}
+
+
+/*
+ * A connection has at most one send in flight.  Until it completes,
+ * the write event is not ready and c->buffered keeps the HTTP requests
+ * from being finalized, as the OpenSSL buffer does.  The file buffers
+ * are sent by sendfile() as before.
+ */
+
+static ngx_chain_t *
+ngx_iouring_send_chain(ngx_connection_t *c, ngx_chain_t *in, off_t limit)
+{
+    size_t               size;
+    ngx_buf_t           *b;
+    ngx_chain_t         *cl;
+    ngx_event_t         *wev;
+    ngx_iouring_buf_t   *sb;
+    ngx_iouring_conn_t  *ic;
+
+    wev = c->write;
+    ic = ngx_iouring_conn(c);
+
+    if (ic->send) {
+        wev->ready = 0;
+        return in;
+    }
+
+    c->buffered &= ~NGX_IOURING_BUFFERED;
+
+    if (ic->send_error) {
+        wev->error = 1;
+        (void) ngx_connection_error(c, ic->send_error, "send() failed");
+        return NGX_CHAIN_ERROR;
+    }
+
+    if (!wev->ready) {
+        return in;
+    }
+
+    for (cl = in; cl; cl = cl->next) {
+        if (cl->buf->in_file) {
+            break;
+        }
+    }
+
+    sb = send_free;
+
+    if (cl || sb == NULL) {
+
+        cl = ngx_os_io.send_chain(c, in, limit);
+
+        if (cl != NGX_CHAIN_ERROR
+            && !wev->ready && wev->active && !ic->write_poll)
+        {
+            /* the event was reported by the completed send */
+
+            if (ngx_iouring_poll_add(wev) != NGX_OK) {
+                return NGX_CHAIN_ERROR;
+            }
+
+            ic->write_poll = 1;
+        }
+
+        return cl;
+    }
+
+    if (limit == 0 || limit > (off_t) buffers.size) {
+        limit = buffers.size;
+    }
+
+    sb->pos = sb->start;
+    sb->last = sb->start;
+
+    for (cl = in; cl && sb->last - sb->start < limit; cl = cl->next) {
+        b = cl->buf;
+
+        if (ngx_buf_special(b)) {
+            continue;
+        }
+
+        size = ngx_min((size_t) (b->last - b->pos),
+                       (size_t) (limit - (sb->last - sb->start)));
+
+        sb->last = ngx_cpymem(sb->last, b->pos, size);
+        b->pos += size;
+    }
+
+    if (sb->last != sb->start) {
+        sb->connection = c;
+
+        if (ngx_iouring_send_start(sb, c->log) != NGX_OK) {
+            sb->connection = NULL;
+            return NGX_CHAIN_ERROR;
+        }
+
+        send_free = sb->next;
+
+        ic->send = sb;
+        c->buffered |= NGX_IOURING_BUFFERED;
+        c->sent += sb->last - sb->start;
+
+        wev->ready = 0;
+    }
+
+    for (cl = in; cl; cl = cl->next) {
+        if (!ngx_buf_special(cl->buf) && cl->buf->pos != cl->buf->last) {
+            break;
+        }
+    }
+
+    return cl;
+}
+
+
+static ngx_int_t
+ngx_iouring_send_start(ngx_iouring_buf_t *sb, ngx_log_t *log)
+{
+    struct io_uring_sqe  *sqe;
+
+    sqe = ngx_iouring_get_sqe(log);
+    if (sqe == NULL) {
+        return NGX_ERROR;
+    }
+
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = sb->connection->fd;
+    sqe->addr = (uintptr_t) sb->pos;
+    sqe->len = sb->last - sb->pos;
+    sqe->msg_flags = MSG_NOSIGNAL|MSG_WAITALL;
+    sqe->user_data = (uintptr_t) sb | NGX_IOURING_SEND;
+
+    sb->sqe = sq_local_tail - 1;
+    sb->active = 1;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_EVENT, log, 0,
+                   "io_uring send add: fd:%d %uz",
+                   sb->connection->fd, (size_t) (sb->last - sb->pos));
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_iouring_send_done(ngx_iouring_buf_t *sb, int32_t res, ngx_uint_t flags)
+{
+    ngx_event_t         *wev;
+    ngx_connection_t    *c;
+    ngx_iouring_conn_t  *ic;
+
+    c = sb->connection;
+
+    sb->active = 0;
+
+    if (c) {
+        ngx_log_debug2(NGX_LOG_DEBUG_EVENT, c->log, 0,
+                       "io_uring send: fd:%d res:%D", c->fd, res);
+
+        ic = ngx_iouring_conn(c);
+
+        if (res > 0) {
+            sb->pos += res;
+
+            /* MSG_WAITALL sends may still be interrupted */
+
+            if (sb->pos < sb->last) {
+                if (ngx_iouring_send_start(sb, c->log) == NGX_OK) {
+                    return;
+                }
+
+                ic->send_error = NGX_EBUSY;
+            }
+
+        } else if (res < 0) {
+            ic->send_error = -res;
+        }
+
+        ic->send = NULL;
+
+        wev = c->write;
+
+        if (wev->active) {
+            ngx_iouring_post_event(wev, flags);
+
+        } else {
+            wev->ready = 1;
+        }
+    }
+
+    /*
+     * the send of a closed connection has completed, the rest of
+     * an interrupted send is dropped as the descriptor is already closed,
+     * and the buffer is freed when the timeout is removed
+     */
+
+    sb->connection = NULL;
+
+    if (sb->timer) {
+        ngx_log_debug1(NGX_LOG_DEBUG_EVENT, ngx_cycle->log, 0,
+                       "io_uring send of closed connection: res:%D", res);
+
+        ngx_iouring_timeout_remove(sb);
+        return;
+    }
+
+    sb->next = send_free;
+    send_free = sb;
+}
+
+
+static ngx_int_t
+ngx_iouring_send_timeout(ngx_iouring_buf_t *sb, ngx_log_t *log)
+{
+    struct io_uring_sqe  *sqe;
+
+    sqe = ngx_iouring_get_sqe(log);
+    if (sqe == NULL) {
+        return NGX_ERROR;
+    }
+
+    /* the time is read when the request is submitted */
+
+    sb->ts.tv_sec = NGX_IOURING_CLOSE_TIMEOUT;
+    sb->ts.tv_nsec = 0;
+
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->fd = -1;
+    sqe->addr = (uintptr_t) &sb->ts;
+    sqe->len = 1;
+    sqe->user_data = (uintptr_t) sb | NGX_IOURING_SEND | 1;
+
+    sb->timer = 1;
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_iouring_timeout_remove(ngx_iouring_buf_t *sb)
+{
+    struct io_uring_sqe  *sqe;
+
+    sqe = ngx_iouring_get_sqe(ngx_cycle->log);
+    if (sqe == NULL) {
+
+        /* the timeout expires later and finds the send inactive */
+
+        return;
+    }
+
+    sqe->opcode = IORING_OP_TIMEOUT_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = (uintptr_t) sb | NGX_IOURING_SEND | 1;
+    sqe->user_data = 0;
+}
+
+
+static void
+ngx_iouring_send_expire(ngx_iouring_buf_t *sb, int32_t res)
+{
+    ngx_log_debug2(NGX_LOG_DEBUG_EVENT, ngx_cycle->log, 0,
+                   "io_uring send timeout: res:%D active:%ud",
+                   res, sb->active);
+
+    sb->timer = 0;
+
+    if (sb->active) {
+
+        /* the peer has not read the data in time */
+
+        ngx_log_error(NGX_LOG_INFO, ngx_cycle->log, 0,
+                      "io_uring send of closed connection timed out");
+
+        /* the completion of the cancelled send frees the buffer */
+
+        (void) ngx_iouring_cancel((uintptr_t) sb | NGX_IOURING_SEND,
+                                  ngx_cycle->log);
+        return;
+    }
+
+    /* the timeout was removed after the send had completed */
+
+    sb->connection = NULL;
+    sb->next = send_free;
+    send_free = sb;
+}
+
+
+static void *
+ngx_iouring_create_conf(ngx_cycle_t *cycle)
+{
+    ngx_iouring_conf_t  *iucf;
+
+    iucf = ngx_pcalloc(cycle->pool, sizeof(ngx_iouring_conf_t));
+    if (iucf == NULL) {
+        return NULL;
+    }
+
+    /*
+     * set by ngx_pcalloc():
+     *
+     *     iucf->buffers = { 0, 0 };
+     */
+
+    iucf->entries = NGX_CONF_UNSET;
+
+    return iucf;
+}
+
+
+static char *
+ngx_iouring_init_conf(ngx_cycle_t *cycle, void *conf)
+{
+    ngx_iouring_conf_t *iucf = conf;
+
+    ngx_conf_init_uint_value(iucf->entries, 512);
+
+    if (iucf->buffers.num == 0) {
+        iucf->buffers.num = 64;
+        iucf->buffers.size = 16384;
+    }
+
+    /* the ring of provided buffers has at most 32768 entries */
+
+    if (iucf->buffers.num > 32768) {
+        ngx_log_error(NGX_LOG_EMERG, cycle->log, 0,
+                      "the number of \"io_uring_buffers\" must not be "
+                      "more than 32768");
+        return NGX_CONF_ERROR;
+    }
+
+    return NGX_CONF_OK;
+}
@@ -23,7 +23,9 @@ extern ngx_module_t ngx_select_module;
 
 static ngx_int_t ngx_event_module_init(ngx_cycle_t *cycle);
 static ngx_int_t ngx_event_process_init(ngx_cycle_t *cycle);
+static ngx_uint_t ngx_event_shared_listening(ngx_cycle_t *cycle);
 static char *ngx_events_block(ngx_conf_t *cf, ngx_command_t *cmd, void *conf);
+static char *ngx_events_init_conf(ngx_cycle_t *cycle, void *conf);
 
 static char *ngx_event_connections(ngx_conf_t *cf, ngx_command_t *cmd,
     void *conf);
@@ -72,6 +74,11 @@ ngx_atomic_t   ngx_stat_reading0;
 ngx_atomic_t  *ngx_stat_reading = &ngx_stat_reading0;
 ngx_atomic_t   ngx_stat_writing0;
 ngx_atomic_t  *ngx_stat_writing = &ngx_stat_writing0;
+ngx_atomic_t   ngx_stat_large_header_hits0;
+ngx_atomic_t  *ngx_stat_large_header_hits = &ngx_stat_large_header_hits0;
+ngx_atomic_t   ngx_stat_large_header_misses0;
+ngx_atomic_t  *ngx_stat_large_header_misses = &ngx_stat_large_header_misses0;
+ngx_pool_stat_t  *ngx_stat_pools;
 
 #endif
 
@@ -93,7 +100,7 @@ static ngx_command_t  ngx_events_commands[] = {
 static ngx_core_module_t  ngx_events_module_ctx = {
     ngx_string("events"),
     NULL,
-    NULL
+    ngx_events_init_conf
 };
 
 
@@ -116,6 +123,13 @@ ngx_module_t  ngx_events_module = {
 static ngx_str_t  event_core_name = ngx_string("event_core");
 
 
+static ngx_conf_enum_t  ngx_event_timer_engines[] = {
+    { ngx_string("rbtree"), NGX_EVENT_TIMER_RBTREE },
+    { ngx_string("wheel"), NGX_EVENT_TIMER_WHEEL },
+    { ngx_null_string, 0 }
+};
+
+
 static ngx_command_t  ngx_event_core_commands[] = {
 
     { ngx_string("worker_connections"),
@@ -160,6 +174,20 @@ static ngx_command_t  ngx_event_core_commands[] = {
       offsetof(ngx_event_conf_t, accept_mutex_delay),
       NULL },
 
+    { ngx_string("timer_engine"),
+      NGX_EVENT_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_enum_slot,
+      0,
+      offsetof(ngx_event_conf_t, timer_engine),
+      &ngx_event_timer_engines },
+
+    { ngx_string("timer_slack"),
+      NGX_EVENT_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_msec_slot,
+      0,
+      offsetof(ngx_event_conf_t, timer_slack),
+      NULL },
+
     { ngx_string("debug_connection"),
       NGX_EVENT_CONF|NGX_CONF_TAKE1,
       ngx_event_debug_connection,
@@ -176,7 +204,7 @@ ngx_event_module_t  ngx_event_core_module_ctx = {
     ngx_event_create_conf,                 /* create configuration */
     ngx_event_init_conf,                   /* init configuration */
 
-    { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL }
+    { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL }
 };
 
 
@@ -509,7 +537,10 @@ ngx_event_module_init(ngx_cycle_t *cycle)
            + cl          /* ngx_stat_requests */
            + cl          /* ngx_stat_active */
            + cl          /* ngx_stat_reading */
-           + cl;         /* ngx_stat_writing */
+           + cl          /* ngx_stat_writing */
+           + cl          /* ngx_stat_large_header_hits */
+           + cl          /* ngx_stat_large_header_misses */
+           + NGX_MAX_PROCESSES * sizeof(ngx_pool_stat_t);  /* ngx_stat_pools */
 
 #endif
 
@@ -527,7 +558,8 @@ ngx_event_module_init(ngx_cycle_t *cycle)
     ngx_accept_mutex_ptr = (ngx_atomic_t *) shared;
     ngx_accept_mutex.spin = (ngx_uint_t) -1;
 
-    if (ngx_shmtx_create(&ngx_accept_mutex, shared, cycle->lock_file.data)
+    if (ngx_shmtx_create(&ngx_accept_mutex, (ngx_shmtx_sh_t *) shared,
+                         cycle->lock_file.data)
         != NGX_OK)
     {
         return NGX_ERROR;
@@ -555,6 +587,9 @@ ngx_event_module_init(ngx_cycle_t *cycle)
     ngx_stat_active = (ngx_atomic_t *) (shared + 6 * cl);
     ngx_stat_reading = (ngx_atomic_t *) (shared + 7 * cl);
     ngx_stat_writing = (ngx_atomic_t *) (shared + 8 * cl);
+    ngx_stat_large_header_hits = (ngx_atomic_t *) (shared + 9 * cl);
+    ngx_stat_large_header_misses = (ngx_atomic_t *) (shared + 10 * cl);
+    ngx_stat_pools = (ngx_pool_stat_t *) (shared + 11 * cl);
 
 #endif
 
@@ -591,7 +626,9 @@ ngx_event_process_init(ngx_cycle_t *cycle)
     ccf = (ngx_core_conf_t *) ngx_get_conf(cycle->conf_ctx, ngx_core_module);
     ecf = ngx_event_get_conf(cycle->conf_ctx, ngx_event_core_module);
 
-    if (ccf->master && ccf->worker_processes > 1 && ecf->accept_mutex) {
+    if (ccf->master && ccf->worker_processes > 1 && ecf->accept_mutex
+        && ngx_event_shared_listening(cycle))
+    {
         ngx_use_accept_mutex = 1;
         ngx_accept_mutex_held = 0;
         ngx_accept_mutex_delay = ecf->accept_mutex_delay;
@@ -600,6 +637,12 @@ ngx_event_process_init(ngx_cycle_t *cycle)
         ngx_use_accept_mutex = 0;
     }
 
+#if (NGX_STAT_STUB)
+    if (ngx_stat_pools) {
+        ngx_pool_stat = &ngx_stat_pools[ngx_process_slot];
+    }
+#endif
+
 #if (NGX_THREADS)
     ngx_posted_events_mutex = ngx_mutex_init(cycle->log, 0);
     if (ngx_posted_events_mutex == NULL) {
@@ -607,6 +650,9 @@ ngx_event_process_init(ngx_cycle_t *cycle)
     }
 #endif
 
+    ngx_event_timer_engine = ecf->timer_engine;
+    ngx_event_timer_slack = ecf->timer_slack;
+
     if (ngx_event_timer_init(cycle->log) == NGX_ERROR) {
         return NGX_ERROR;
     }
@@ -742,6 +788,13 @@ ngx_event_process_init(ngx_cycle_t *cycle)
     ls = cycle->listening.elts;
     for (i = 0; i < cycle->listening.nelts; i++) {
 
+#if (NGX_HAVE_REUSEPORT)
+        /* 其他worker进程的reuseport监听socket不需要本进程处理 */
+        if (ls[i].reuseport && ls[i].worker != ngx_worker) {
+            continue;
+        }
+#endif
+
         c = ngx_get_connection(ls[i].fd, cycle->log);
 
         if (c == NULL) {
@@ -822,7 +875,12 @@ ngx_event_process_init(ngx_cycle_t *cycle)
 
         rev->handler = ngx_event_accept;
 
-        if (ngx_use_accept_mutex) {
+        if (ngx_use_accept_mutex
+#if (NGX_HAVE_REUSEPORT)
+            && !ls[i].reuseport
+#endif
+           )
+        {
             continue;
         }
 
@@ -845,6 +903,35 @@ ngx_event_process_init(ngx_cycle_t *cycle)
 }
 
 
+/*
+ * 判断是否存在被所有worker进程共享的监听socket,
+ * 如果所有监听socket都是reuseport的,就不再需要accept_mutex
+ */
+static ngx_uint_t
+ngx_event_shared_listening(ngx_cycle_t *cycle)
+{
+#if (NGX_HAVE_REUSEPORT)
+
+    ngx_uint_t        i;
+    ngx_listening_t  *ls;
+
+    ls = cycle->listening.elts;
+    for (i = 0; i < cycle->listening.nelts; i++) {
+        if (!ls[i].reuseport) {
+            return 1;
+        }
+    }
+
+    return 0;
+
+#else
+
+    return 1;
+
+#endif
+}
+
+
 ngx_int_t
 ngx_send_lowat(ngx_connection_t *c, size_t lowat)
 {
@@ -958,6 +1045,40 @@ ngx_events_block(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 }
 
 
+/*
+ * reuseport的监听socket在所有核心模块的配置确定之后才复制,
+ * 这时worker_processes已经是最终的值
+ */
+static char *
+ngx_events_init_conf(ngx_cycle_t *cycle, void *conf)
+{
+#if (NGX_HAVE_REUSEPORT)
+
+    ngx_uint_t        i;
+    ngx_listening_t  *ls;
+
+    ls = cycle->listening.elts;
+    for (i = 0; i < cycle->listening.nelts; i++) {
+
+        if (!ls[i].reuseport || ls[i].worker != 0) {
+            continue;
+        }
+
+        if (ngx_clone_listening(cycle, &ls[i]) != NGX_OK) {
+            return NGX_CONF_ERROR;
+        }
+
+        /* cloning may change cycle->listening.elts */
+
+        ls = cycle->listening.elts;
+    }
+
+#endif
+
+    return NGX_CONF_OK;
+}
+
+
 static char *
 ngx_event_connections(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 {
@@ -1134,6 +1255,8 @@ ngx_event_create_conf(ngx_cycle_t *cycle)
     ecf->multi_accept = NGX_CONF_UNSET;
     ecf->accept_mutex = NGX_CONF_UNSET;
     ecf->accept_mutex_delay = NGX_CONF_UNSET_MSEC;
+    ecf->timer_engine = NGX_CONF_UNSET_UINT;
+    ecf->timer_slack = NGX_CONF_UNSET_MSEC;
     ecf->name = (void *) NGX_CONF_UNSET;
 
 #if (NGX_DEBUG)
@@ -1249,6 +1372,8 @@ ngx_event_init_conf(ngx_cycle_t *cycle, void *conf)
     ngx_conf_init_value(ecf->multi_accept, 0);
     ngx_conf_init_value(ecf->accept_mutex, 1);
     ngx_conf_init_msec_value(ecf->accept_mutex_delay, 500);
+    ngx_conf_init_uint_value(ecf->timer_engine, NGX_EVENT_TIMER_RBTREE);
+    ngx_conf_init_msec_value(ecf->timer_slack, NGX_TIMER_LAZY_DELAY);
 
 
 #if (NGX_HAVE_RTSIG)
@@ -76,6 +76,8 @@ struct ngx_event_s {
     unsigned         timedout:1;
     /* 标志位,为1时表示这个事件存在与定时器中 */
     unsigned         timer_set:1;
+    /* the timer does not keep a gracefully exiting worker alive */
+    unsigned         cancelable:1;
     /* 标志位,为1时表示需要延迟处理这个事件,它仅用于限速功能 */
     unsigned         delayed:1;
 
@@ -142,6 +144,7 @@ struct ngx_event_s {
     ngx_log_t       *log;
     /* 定时器节点,用于定时器红黑树中 */
     ngx_rbtree_node_t   timer;
+    ngx_msec_t       deadline;
 
     unsigned         closed:1;
 
@@ -251,6 +254,8 @@ typedef struct {
     /* 从事件驱动机制中移除一个连接的读写事件 */
     ngx_int_t  (*del_conn)(ngx_connection_t *c, ngx_uint_t flags);
 
+    ngx_int_t  (*notify)(ngx_event_handler_pt handler);
+
     ngx_int_t  (*process_changes)(ngx_cycle_t *cycle, ngx_uint_t nowait);
     /* 在正常的工作循环中,将通过调用process_events方法来处理事件 */
     ngx_int_t  (*process_events)(ngx_cycle_t *cycle, ngx_msec_t timer,
@@ -345,6 +350,12 @@ extern ngx_event_actions_t   ngx_event_actions;
  */
 #define NGX_USE_VNODE_EVENT      0x00002000
 
+/*
+ * The event filter accepts connections and receives and sends data
+ * by itself: io_uring.
+ */
+#define NGX_USE_IOURING_EVENT    0x00004000
+
 
 /*
  * The event filter is deleted just before the closing file.
@@ -480,6 +491,8 @@ extern ngx_event_actions_t   ngx_event_actions;
 #define ngx_add_conn         ngx_event_actions.add_conn
 #define ngx_del_conn         ngx_event_actions.del_conn
 
+#define ngx_notify           ngx_event_actions.notify
+
 #define ngx_add_timer        ngx_event_add_timer
 #define ngx_del_timer        ngx_event_del_timer
 
@@ -506,6 +519,9 @@ typedef struct {
 
     ngx_msec_t    accept_mutex_delay;
 
+    ngx_uint_t    timer_engine;
+    ngx_msec_t    timer_slack;
+
     u_char       *name;
 
 #if (NGX_DEBUG)
@@ -546,6 +562,9 @@ extern ngx_atomic_t  *ngx_stat_requests;
 extern ngx_atomic_t  *ngx_stat_active;
 extern ngx_atomic_t  *ngx_stat_reading;
 extern ngx_atomic_t  *ngx_stat_writing;
+extern ngx_atomic_t  *ngx_stat_large_header_hits;
+extern ngx_atomic_t  *ngx_stat_large_header_misses;
+extern ngx_pool_stat_t  *ngx_stat_pools;
 
 #endif
 
@@ -582,6 +601,12 @@ ngx_int_t ngx_event_post_acceptex(ngx_listening_t *ls, ngx_uint_t n);
 u_char *ngx_acceptex_log_error(ngx_log_t *log, u_char *buf, size_t len);
 #endif
 
+#if (NGX_HAVE_IO_URING)
+ngx_socket_t ngx_iouring_accept(ngx_event_t *ev, struct sockaddr *sa,
+    socklen_t *socklen);
+ngx_int_t ngx_iouring_pending(ngx_connection_t *c);
+#endif
+
 
 ngx_int_t ngx_send_lowat(ngx_connection_t *c, size_t lowat);
 
@@ -83,6 +83,9 @@ struct ngx_event_pipe_s {
 
     ngx_temp_file_t   *temp_file;
 
+    /* 尚未读取的上游包体长度,-1表示长度未知 */
+    off_t              length;
+
     /* STUB */ int     num;
 };
 
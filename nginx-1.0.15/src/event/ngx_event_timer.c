@@ -18,6 +18,67 @@ ngx_mutex_t  *ngx_event_timer_mutex;
 ngx_thread_volatile ngx_rbtree_t  ngx_event_timer_rbtree;
 static ngx_rbtree_node_t          ngx_event_timer_sentinel;
 
+ngx_uint_t                        ngx_event_timer_engine;
+ngx_msec_t                        ngx_event_timer_slack;
+
+
+/*
+ * the timer wheel has the first level of 256 one millisecond slots
+ * and four upper levels of 64 slots, a slot of an upper level spans
+ * the whole level below it; the timers of a slot are linked in a list
+ * through the left and right pointers of the timer node, the timers
+ * that were added already expired are kept in the separate list;
+ * the node data keeps the level of the timer, and the timers of each
+ * level are counted, so the expiration skips empty spans at once
+ */
+
+#define NGX_TIMER_WHEEL_BITS0   8
+#define NGX_TIMER_WHEEL_SIZE0   (1 << NGX_TIMER_WHEEL_BITS0)
+#define NGX_TIMER_WHEEL_MASK0   (NGX_TIMER_WHEEL_SIZE0 - 1)
+
+#define NGX_TIMER_WHEEL_BITS    6
+#define NGX_TIMER_WHEEL_SIZE    (1 << NGX_TIMER_WHEEL_BITS)
+#define NGX_TIMER_WHEEL_MASK    (NGX_TIMER_WHEEL_SIZE - 1)
+
+#define NGX_TIMER_WHEEL_LEVELS  4
+
+
+static void ngx_event_timer_wheel_init(void);
+static ngx_msec_t ngx_event_timer_wheel_find(void);
+static void ngx_event_timer_wheel_expire(void);
+static void ngx_event_timer_wheel_cascade(ngx_rbtree_node_t *head);
+static ngx_int_t ngx_event_timer_wheel_no_timers_left(void);
+static ngx_int_t ngx_event_timer_list_cancelable(ngx_rbtree_node_t *head);
+
+
+static ngx_rbtree_node_t  ngx_event_timer_wheel0[NGX_TIMER_WHEEL_SIZE0];
+static ngx_rbtree_node_t  ngx_event_timer_wheel[NGX_TIMER_WHEEL_LEVELS]
+                                               [NGX_TIMER_WHEEL_SIZE];
+static ngx_rbtree_node_t  ngx_event_timer_expired;
+
+/* the next millisecond to be handled by the wheel */
+static ngx_msec_t         ngx_event_timer_base;
+static ngx_uint_t         ngx_event_timer_n;
+
+/* the first level, the upper levels, and the expired list */
+static ngx_uint_t         ngx_event_timer_level_n[NGX_TIMER_WHEEL_LEVELS + 2];
+
+
+#define ngx_event_timer_list_init(head)                                       \
+    (head)->left = head;                                                      \
+    (head)->right = head
+
+#define ngx_event_timer_list_empty(head)                                      \
+    ((head)->right == head)
+
+#define ngx_event_timer_list_add(from, to)                                    \
+    (from)->right->left = (to)->left;                                         \
+    (to)->left->right = (from)->right;                                        \
+    (from)->left->right = to;                                                 \
+    (to)->left = (from)->left;                                                \
+    ngx_event_timer_list_init(from)
+
+
 /*
  * the event timer rbtree may contain the duplicate keys, however,
  * it should not be a problem, because we use the rbtree to find
@@ -32,6 +93,10 @@ ngx_event_timer_init(ngx_log_t *log)
     ngx_rbtree_init(&ngx_event_timer_rbtree, &ngx_event_timer_sentinel,
                     ngx_rbtree_insert_timer_value);
 
+    if (ngx_event_timer_engine == NGX_EVENT_TIMER_WHEEL) {
+        ngx_event_timer_wheel_init();
+    }
+
 #if (NGX_THREADS)
 
     if (ngx_event_timer_mutex) {
@@ -59,6 +124,10 @@ ngx_event_find_timer(void)
     ngx_msec_int_t      timer;
     ngx_rbtree_node_t  *node, *root, *sentinel;
 
+    if (ngx_event_timer_engine == NGX_EVENT_TIMER_WHEEL) {
+        return ngx_event_timer_wheel_find();
+    }
+
     if (ngx_event_timer_rbtree.root == &ngx_event_timer_sentinel) {
         return NGX_TIMER_INFINITE;
     }
@@ -86,6 +155,11 @@ ngx_event_expire_timers(void)
     ngx_event_t        *ev;
     ngx_rbtree_node_t  *node, *root, *sentinel;
 
+    if (ngx_event_timer_engine == NGX_EVENT_TIMER_WHEEL) {
+        ngx_event_timer_wheel_expire();
+        return;
+    }
+
     sentinel = ngx_event_timer_rbtree.sentinel;
 
     for ( ;; ) {
@@ -130,6 +204,29 @@ ngx_event_expire_timers(void)
 
             ngx_rbtree_delete(&ngx_event_timer_rbtree, &ev->timer);
 
+            if ((ngx_msec_int_t) (ev->deadline - ngx_current_msec) > 0) {
+
+                /* the timer was lazily moved to a later deadline */
+
+                ev->timer.key = ev->deadline;
+
+                ngx_log_debug2(NGX_LOG_DEBUG_EVENT, ev->log, 0,
+                               "event timer move: %d: %M",
+                               ngx_event_ident(ev->data), ev->timer.key);
+
+                ngx_rbtree_insert(&ngx_event_timer_rbtree, &ev->timer);
+
+                ngx_mutex_unlock(ngx_event_timer_mutex);
+
+#if (NGX_THREADS)
+                if (ngx_threaded) {
+                    ngx_unlock(ev->lock);
+                }
+#endif
+
+                continue;
+            }
+
             ngx_mutex_unlock(ngx_event_timer_mutex);
 
 #if (NGX_DEBUG)
@@ -164,3 +261,477 @@ ngx_event_expire_timers(void)
 
     ngx_mutex_unlock(ngx_event_timer_mutex);
 }
+
+
+ngx_int_t
+ngx_event_no_timers_left(void)
+{
+    ngx_event_t        *ev;
+    ngx_rbtree_t       *tree;
+    ngx_rbtree_node_t  *node, *root, *sentinel;
+
+    if (ngx_event_timer_engine == NGX_EVENT_TIMER_WHEEL) {
+        return ngx_event_timer_wheel_no_timers_left();
+    }
+
+    tree = (ngx_rbtree_t *) &ngx_event_timer_rbtree;
+
+    sentinel = tree->sentinel;
+    root = tree->root;
+
+    if (root == sentinel) {
+        return NGX_OK;
+    }
+
+    for (node = ngx_rbtree_min(root, sentinel);
+         node;
+         node = ngx_rbtree_next(tree, node))
+    {
+        ev = (ngx_event_t *) ((char *) node - offsetof(ngx_event_t, timer));
+
+        if (!ev->cancelable) {
+            return NGX_DECLINED;
+        }
+    }
+
+    /* only cancelable timers left */
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_event_timer_wheel_init(void)
+{
+    ngx_uint_t  i, level;
+
+    for (i = 0; i < NGX_TIMER_WHEEL_SIZE0; i++) {
+        ngx_event_timer_list_init(&ngx_event_timer_wheel0[i]);
+    }
+
+    for (level = 0; level < NGX_TIMER_WHEEL_LEVELS; level++) {
+        for (i = 0; i < NGX_TIMER_WHEEL_SIZE; i++) {
+            ngx_event_timer_list_init(&ngx_event_timer_wheel[level][i]);
+        }
+    }
+
+    ngx_event_timer_list_init(&ngx_event_timer_expired);
+
+    ngx_event_timer_base = ngx_current_msec;
+    ngx_event_timer_n = 0;
+
+    ngx_memzero(ngx_event_timer_level_n, sizeof(ngx_event_timer_level_n));
+}
+
+
+void
+ngx_event_timer_wheel_insert(ngx_rbtree_node_t *node)
+{
+    ngx_msec_t          key, delta;
+    ngx_uint_t          level, shift;
+    ngx_rbtree_node_t  *head;
+
+    key = node->key;
+    delta = key - ngx_event_timer_base;
+
+    if ((ngx_msec_int_t) delta < 0) {
+        head = &ngx_event_timer_expired;
+        node->data = NGX_TIMER_WHEEL_LEVELS + 1;
+
+    } else if (delta < NGX_TIMER_WHEEL_SIZE0) {
+        head = &ngx_event_timer_wheel0[key & NGX_TIMER_WHEEL_MASK0];
+        node->data = 0;
+
+    } else {
+        shift = NGX_TIMER_WHEEL_BITS0;
+
+        for (level = 0; level < NGX_TIMER_WHEEL_LEVELS - 1; level++) {
+            if ((delta >> (shift + NGX_TIMER_WHEEL_BITS)) == 0) {
+                break;
+            }
+
+            shift += NGX_TIMER_WHEEL_BITS;
+        }
+
+#if (NGX_PTR_SIZE == 8)
+
+        /* the last slot will cascade the timer back to the last level */
+
+        if (delta >> (shift + NGX_TIMER_WHEEL_BITS)) {
+            key = ngx_event_timer_base + 0xffffffff;
+        }
+
+#endif
+
+        head = &ngx_event_timer_wheel[level]
+                                     [(key >> shift) & NGX_TIMER_WHEEL_MASK];
+        node->data = (u_char) (level + 1);
+    }
+
+    node->right = head;
+    node->left = head->left;
+    head->left->right = node;
+    head->left = node;
+
+    ngx_event_timer_n++;
+    ngx_event_timer_level_n[node->data]++;
+}
+
+
+void
+ngx_event_timer_wheel_delete(ngx_rbtree_node_t *node)
+{
+    node->left->right = node->right;
+    node->right->left = node->left;
+
+    ngx_event_timer_n--;
+    ngx_event_timer_level_n[node->data]--;
+}
+
+
+/*
+ * the exact expiration time is known for the first level slots only,
+ * an upper level slot reports the time when it is cascaded, so the
+ * result is never later than the nearest timer expiration time
+ */
+
+static ngx_msec_t
+ngx_event_timer_wheel_find(void)
+{
+    ngx_msec_t          base, block, delta, min;
+    ngx_uint_t          i, j, level, shift;
+    ngx_msec_int_t      timer;
+    ngx_rbtree_node_t  *head;
+
+    if (ngx_event_timer_n == 0) {
+        return NGX_TIMER_INFINITE;
+    }
+
+    if (!ngx_event_timer_list_empty(&ngx_event_timer_expired)) {
+        return 0;
+    }
+
+    ngx_mutex_lock(ngx_event_timer_mutex);
+
+    base = ngx_event_timer_base;
+    min = (ngx_msec_t) -1;
+
+    if (ngx_event_timer_level_n[0]) {
+
+        for (i = 0; i < NGX_TIMER_WHEEL_SIZE0; i++) {
+            head = &ngx_event_timer_wheel0[(base + i) & NGX_TIMER_WHEEL_MASK0];
+
+            if (!ngx_event_timer_list_empty(head)) {
+                min = i;
+                break;
+            }
+        }
+    }
+
+    shift = NGX_TIMER_WHEEL_BITS0;
+
+    for (level = 0; level < NGX_TIMER_WHEEL_LEVELS; level++) {
+
+        /*
+         * the current slot is not cascaded yet if the base is at
+         * the slot start, otherwise it holds the next turn timers
+         */
+
+        j = (base & (((ngx_msec_t) 1 << shift) - 1)) ? 1 : 0;
+        block = base >> shift;
+
+        /*
+         * the first slot of a level is cascaded not earlier than
+         * that of the level below, so the upper levels cannot be
+         * nearer than the time already found
+         */
+
+        if (((block + j) << shift) - base >= min) {
+            break;
+        }
+
+        if (ngx_event_timer_level_n[level + 1] == 0) {
+            shift += NGX_TIMER_WHEEL_BITS;
+            continue;
+        }
+
+        for (i = j; i < j + NGX_TIMER_WHEEL_SIZE; i++) {
+            head = &ngx_event_timer_wheel[level]
+                                         [(block + i) & NGX_TIMER_WHEEL_MASK];
+
+            if (!ngx_event_timer_list_empty(head)) {
+                delta = ((block + i) << shift) - base;
+
+                if (delta < min) {
+                    min = delta;
+                }
+
+                break;
+            }
+        }
+
+        shift += NGX_TIMER_WHEEL_BITS;
+    }
+
+    ngx_mutex_unlock(ngx_event_timer_mutex);
+
+    timer = (ngx_msec_int_t) (base + min - ngx_current_msec);
+
+    return (ngx_msec_t) (timer > 0 ? timer : 0);
+}
+
+
+static void
+ngx_event_timer_wheel_expire(void)
+{
+    ngx_msec_t          next;
+    ngx_uint_t          i, level, shift;
+    ngx_event_t        *ev;
+    ngx_rbtree_node_t  *node, *head, list;
+
+    ngx_mutex_lock(ngx_event_timer_mutex);
+
+    head = &ngx_event_timer_expired;
+
+    for ( ;; ) {
+
+        if (ngx_event_timer_list_empty(head)) {
+
+            if (head != &ngx_event_timer_expired) {
+                head = &ngx_event_timer_expired;
+                continue;
+            }
+
+            if ((ngx_msec_int_t) (ngx_current_msec - ngx_event_timer_base) < 0)
+            {
+                break;
+            }
+
+            if (ngx_event_timer_n == 0) {
+                ngx_event_timer_base = ngx_current_msec + 1;
+                break;
+            }
+
+            if (ngx_event_timer_level_n[0] == 0) {
+
+                /*
+                 * the first level is empty: jump to the next cascade
+                 * of the lowest level that has timers
+                 */
+
+                shift = NGX_TIMER_WHEEL_BITS0;
+
+                for (level = 1; level <= NGX_TIMER_WHEEL_LEVELS; level++) {
+                    if (ngx_event_timer_level_n[level]) {
+                        break;
+                    }
+
+                    shift += NGX_TIMER_WHEEL_BITS;
+                }
+
+                if (level > NGX_TIMER_WHEEL_LEVELS) {
+                    ngx_event_timer_base = ngx_current_msec + 1;
+                    break;
+                }
+
+                next = (ngx_event_timer_base + ((ngx_msec_t) 1 << shift) - 1)
+                       & ~(((ngx_msec_t) 1 << shift) - 1);
+
+                if ((ngx_msec_int_t) (next - ngx_current_msec) > 0) {
+                    ngx_event_timer_base = ngx_current_msec + 1;
+                    break;
+                }
+
+                ngx_event_timer_base = next;
+            }
+
+            i = ngx_event_timer_base & NGX_TIMER_WHEEL_MASK0;
+
+            if (i == 0) {
+                shift = NGX_TIMER_WHEEL_BITS0;
+
+                for (level = 0; level < NGX_TIMER_WHEEL_LEVELS; level++) {
+                    i = (ngx_event_timer_base >> shift) & NGX_TIMER_WHEEL_MASK;
+
+                    ngx_event_timer_wheel_cascade(
+                                            &ngx_event_timer_wheel[level][i]);
+
+                    if (i) {
+                        break;
+                    }
+
+                    shift += NGX_TIMER_WHEEL_BITS;
+                }
+
+                i = 0;
+            }
+
+            ngx_event_timer_base++;
+
+            /*
+             * the slot is moved to the local list, so the timers added
+             * by the handlers with the same slot wait for the next turn
+             */
+
+            ngx_event_timer_list_init(&list);
+
+            if (!ngx_event_timer_list_empty(&ngx_event_timer_wheel0[i])) {
+                ngx_event_timer_list_add(&ngx_event_timer_wheel0[i], &list);
+                head = &list;
+            }
+
+            continue;
+        }
+
+        node = head->right;
+
+        ev = (ngx_event_t *) ((char *) node - offsetof(ngx_event_t, timer));
+
+#if (NGX_THREADS)
+
+        if (ngx_threaded && ngx_trylock(ev->lock) == 0) {
+
+            /*
+             * the busy event and the rest of the list are returned
+             * to the expired list to be handled next time
+             */
+
+            ngx_log_debug1(NGX_LOG_DEBUG_EVENT, ev->log, 0,
+                           "event %p is busy in expire timers", ev);
+
+            if (head != &ngx_event_timer_expired) {
+                ngx_event_timer_list_add(head, &ngx_event_timer_expired);
+            }
+
+            break;
+        }
+#endif
+
+        ngx_log_debug2(NGX_LOG_DEBUG_EVENT, ev->log, 0,
+                       "event timer del: %d: %M",
+                       ngx_event_ident(ev->data), ev->timer.key);
+
+        ngx_event_timer_wheel_delete(node);
+
+        if ((ngx_msec_int_t) (ev->deadline - ngx_current_msec) > 0) {
+
+            /* the timer was lazily moved to a later deadline */
+
+            node->key = ev->deadline;
+
+            ngx_log_debug2(NGX_LOG_DEBUG_EVENT, ev->log, 0,
+                           "event timer move: %d: %M",
+                           ngx_event_ident(ev->data), node->key);
+
+            ngx_event_timer_wheel_insert(node);
+
+#if (NGX_THREADS)
+            if (ngx_threaded) {
+                ngx_unlock(ev->lock);
+            }
+#endif
+
+            continue;
+        }
+
+        ngx_mutex_unlock(ngx_event_timer_mutex);
+
+#if (NGX_DEBUG)
+        ev->timer.left = NULL;
+        ev->timer.right = NULL;
+        ev->timer.parent = NULL;
+#endif
+
+        ev->timer_set = 0;
+
+#if (NGX_THREADS)
+        if (ngx_threaded) {
+            ev->posted_timedout = 1;
+
+            ngx_post_event(ev, &ngx_posted_events);
+
+            ngx_unlock(ev->lock);
+
+            ngx_mutex_lock(ngx_event_timer_mutex);
+
+            continue;
+        }
+#endif
+
+        ev->timedout = 1;
+
+        ev->handler(ev);
+
+        ngx_mutex_lock(ngx_event_timer_mutex);
+    }
+
+    ngx_mutex_unlock(ngx_event_timer_mutex);
+}
+
+
+static void
+ngx_event_timer_wheel_cascade(ngx_rbtree_node_t *head)
+{
+    ngx_rbtree_node_t  *node;
+
+    while (!ngx_event_timer_list_empty(head)) {
+        node = head->right;
+
+        ngx_event_timer_wheel_delete(node);
+        ngx_event_timer_wheel_insert(node);
+    }
+}
+
+
+static ngx_int_t
+ngx_event_timer_wheel_no_timers_left(void)
+{
+    ngx_uint_t  i, level;
+
+    if (ngx_event_timer_list_cancelable(&ngx_event_timer_expired)
+        == NGX_DECLINED)
+    {
+        return NGX_DECLINED;
+    }
+
+    for (i = 0; i < NGX_TIMER_WHEEL_SIZE0; i++) {
+        if (ngx_event_timer_list_cancelable(&ngx_event_timer_wheel0[i])
+            == NGX_DECLINED)
+        {
+            return NGX_DECLINED;
+        }
+    }
+
+    for (level = 0; level < NGX_TIMER_WHEEL_LEVELS; level++) {
+        for (i = 0; i < NGX_TIMER_WHEEL_SIZE; i++) {
+            if (ngx_event_timer_list_cancelable(
+                                            &ngx_event_timer_wheel[level][i])
+                == NGX_DECLINED)
+            {
+                return NGX_DECLINED;
+            }
+        }
+    }
+
+    /* only cancelable timers left */
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_event_timer_list_cancelable(ngx_rbtree_node_t *head)
+{
+    ngx_event_t        *ev;
+    ngx_rbtree_node_t  *node;
+
+    for (node = head->right; node != head; node = node->right) {
+        ev = (ngx_event_t *) ((char *) node - offsetof(ngx_event_t, timer));
+
+        if (!ev->cancelable) {
+            return NGX_DECLINED;
+        }
+    }
+
+    return NGX_OK;
+}
@@ -18,10 +18,17 @@
 
 #define NGX_TIMER_LAZY_DELAY  300
 
+#define NGX_EVENT_TIMER_RBTREE  0
+#define NGX_EVENT_TIMER_WHEEL   1
+
 
 ngx_int_t ngx_event_timer_init(ngx_log_t *log);
 ngx_msec_t ngx_event_find_timer(void);
 void ngx_event_expire_timers(void);
+ngx_int_t ngx_event_no_timers_left(void);
+
+void ngx_event_timer_wheel_insert(ngx_rbtree_node_t *node);
+void ngx_event_timer_wheel_delete(ngx_rbtree_node_t *node);
 
 
 #if (NGX_THREADS)
@@ -30,6 +37,8 @@ extern ngx_mutex_t  *ngx_event_timer_mutex;
 
 
 extern ngx_thread_volatile ngx_rbtree_t  ngx_event_timer_rbtree;
+extern ngx_uint_t                        ngx_event_timer_engine;
+extern ngx_msec_t                        ngx_event_timer_slack;
 
 
 static ngx_inline void
@@ -41,7 +50,12 @@ ngx_event_del_timer(ngx_event_t *ev)
 
     ngx_mutex_lock(ngx_event_timer_mutex);
 
-    ngx_rbtree_delete(&ngx_event_timer_rbtree, &ev->timer);
+    if (ngx_event_timer_engine == NGX_EVENT_TIMER_WHEEL) {
+        ngx_event_timer_wheel_delete(&ev->timer);
+
+    } else {
+        ngx_rbtree_delete(&ngx_event_timer_rbtree, &ev->timer);
+    }
 
     ngx_mutex_unlock(ngx_event_timer_mutex);
 
@@ -66,17 +80,22 @@ ngx_event_add_timer(ngx_event_t *ev, ngx_msec_t timer)
     if (ev->timer_set) {
 
         /*
-         * Use a previous timer value if difference between it and a new
-         * value is less than NGX_TIMER_LAZY_DELAY milliseconds: this allows
-         * to minimize the rbtree operations for fast connections.
+         * Leave the timer in place if difference between its value and
+         * a new value is less than ngx_event_timer_slack milliseconds:
+         * this allows to minimize the rbtree operations for fast
+         * connections.  A later value is kept as the deadline, and
+         * the timer is moved to it when the current value expires.
          */
 
         diff = (ngx_msec_int_t) (key - ev->timer.key);
 
-        if (ngx_abs(diff) < NGX_TIMER_LAZY_DELAY) {
+        if (ngx_abs(diff) < (ngx_msec_int_t) ngx_event_timer_slack) {
             ngx_log_debug3(NGX_LOG_DEBUG_EVENT, ev->log, 0,
                            "event timer: %d, old: %M, new: %M",
                             ngx_event_ident(ev->data), ev->timer.key, key);
+
+            ev->deadline = (diff > 0) ? key : ev->timer.key;
+
             return;
         }
 
@@ -84,6 +103,7 @@ ngx_event_add_timer(ngx_event_t *ev, ngx_msec_t timer)
     }
 
     ev->timer.key = key;
+    ev->deadline = key;
 
     ngx_log_debug3(NGX_LOG_DEBUG_EVENT, ev->log, 0,
                    "event timer add: %d: %M:%M",
@@ -91,7 +111,12 @@ ngx_event_add_timer(ngx_event_t *ev, ngx_msec_t timer)
 
     ngx_mutex_lock(ngx_event_timer_mutex);
 
-    ngx_rbtree_insert(&ngx_event_timer_rbtree, &ev->timer);
+    if (ngx_event_timer_engine == NGX_EVENT_TIMER_WHEEL) {
+        ngx_event_timer_wheel_insert(&ev->timer);
+
+    } else {
+        ngx_rbtree_insert(&ngx_event_timer_rbtree, &ev->timer);
+    }
 
     ngx_mutex_unlock(ngx_event_timer_mutex);
 
@@ -10,38 +10,28 @@
 #include <ngx_http.h>
 
 
-typedef struct {
-    in_addr_t         mask;
-    in_addr_t         addr;
-    ngx_uint_t        deny;      /* unsigned  deny:1; */
-} ngx_http_access_rule_t;
-
-#if (NGX_HAVE_INET6)
-
-typedef struct {
-    struct in6_addr   addr;
-    struct in6_addr   mask;
-    ngx_uint_t        deny;      /* unsigned  deny:1; */
-} ngx_http_access_rule6_t;
-
-#endif
+/*
+ * The rules are kept in radix trees, the value of a node is the "deny" flag.
+ * A rule is added to a tree only if no earlier rule covers its network,
+ * so the longest prefix match returns the first matching rule.
+ */
 
 typedef struct {
-    ngx_array_t      *rules;     /* array of ngx_http_access_rule_t */
+    ngx_radix_tree_t  *rules;
 #if (NGX_HAVE_INET6)
-    ngx_array_t      *rules6;    /* array of ngx_http_access_rule6_t */
+    ngx_radix_tree_t  *rules6;
 #endif
 } ngx_http_access_loc_conf_t;
 
 
 static ngx_int_t ngx_http_access_handler(ngx_http_request_t *r);
-static ngx_int_t ngx_http_access_inet(ngx_http_request_t *r,
-    ngx_http_access_loc_conf_t *alcf, in_addr_t addr);
+static ngx_int_t ngx_http_access_found(ngx_http_request_t *r, uintptr_t deny);
+static ngx_int_t ngx_http_access_add_rule(ngx_radix_tree_t *tree,
+    uint32_t addr, uint32_t mask, uintptr_t deny);
 #if (NGX_HAVE_INET6)
-static ngx_int_t ngx_http_access_inet6(ngx_http_request_t *r,
-    ngx_http_access_loc_conf_t *alcf, u_char *p);
+static ngx_int_t ngx_http_access_add_rule6(ngx_radix_tree_t *tree,
+    u_char *addr, u_char *mask, uintptr_t deny);
 #endif
-static ngx_int_t ngx_http_access_found(ngx_http_request_t *r, ngx_uint_t deny);
 static char *ngx_http_access_rule(ngx_conf_t *cf, ngx_command_t *cmd,
     void *conf);
 static void *ngx_http_access_create_loc_conf(ngx_conf_t *cf);
@@ -107,11 +97,12 @@ ngx_module_t  ngx_http_access_module = {
 static ngx_int_t
 ngx_http_access_handler(ngx_http_request_t *r)
 {
+    uint32_t                     addr;
+    uintptr_t                    deny;
     struct sockaddr_in          *sin;
     ngx_http_access_loc_conf_t  *alcf;
 #if (NGX_HAVE_INET6)
     u_char                      *p;
-    in_addr_t                    addr;
     struct sockaddr_in6         *sin6;
 #endif
 
@@ -122,7 +113,16 @@ ngx_http_access_handler(ngx_http_request_t *r)
     case AF_INET: /* ipv4地址 */
         if (alcf->rules) {
             sin = (struct sockaddr_in *) r->connection->sockaddr;
-            return ngx_http_access_inet(r, alcf, sin->sin_addr.s_addr);
+            addr = ntohl(sin->sin_addr.s_addr);
+
+            ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                           "access: %08XD", addr);
+
+            deny = ngx_radix32tree_find(alcf->rules, addr);
+
+            if (deny != NGX_RADIX_NO_VALUE) {
+                return ngx_http_access_found(r, deny);
+            }
         }
         break;
 
@@ -137,92 +137,35 @@ ngx_http_access_handler(ngx_http_request_t *r)
             addr += p[13] << 16;
             addr += p[14] << 8;
             addr += p[15];
-            return ngx_http_access_inet(r, alcf, htonl(addr));
-        }
-
-        if (alcf->rules6) {
-            return ngx_http_access_inet6(r, alcf, p);
-        }
-
-#endif
-    }
-
-    return NGX_DECLINED;
-}
-
-
-static ngx_int_t
-ngx_http_access_inet(ngx_http_request_t *r, ngx_http_access_loc_conf_t *alcf,
-    in_addr_t addr)
-{
-    ngx_uint_t               i;
-    ngx_http_access_rule_t  *rule;
 
-    rule = alcf->rules->elts;
-    for (i = 0; i < alcf->rules->nelts; i++) {
+            deny = ngx_radix32tree_find(alcf->rules, addr);
 
-        ngx_log_debug3(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
-                       "access: %08XD %08XD %08XD",
-                       addr, rule[i].mask, rule[i].addr);
+            if (deny != NGX_RADIX_NO_VALUE) {
+                return ngx_http_access_found(r, deny);
+            }
 
-        if ((addr & rule[i].mask) == rule[i].addr) {
-            return ngx_http_access_found(r, rule[i].deny);
+            break;
         }
-    }
-
-    return NGX_DECLINED;
-}
-
 
-#if (NGX_HAVE_INET6)
-
-static ngx_int_t
-ngx_http_access_inet6(ngx_http_request_t *r, ngx_http_access_loc_conf_t *alcf,
-    u_char *p)
-{
-    ngx_uint_t                n;
-    ngx_uint_t                i;
-    ngx_http_access_rule6_t  *rule6;
-
-    rule6 = alcf->rules6->elts;
-    for (i = 0; i < alcf->rules6->nelts; i++) {
-
-#if (NGX_DEBUG)
-        {
-        size_t  cl, ml, al;
-        u_char  ct[NGX_INET6_ADDRSTRLEN];
-        u_char  mt[NGX_INET6_ADDRSTRLEN];
-        u_char  at[NGX_INET6_ADDRSTRLEN];
-
-        cl = ngx_inet6_ntop(p, ct, NGX_INET6_ADDRSTRLEN);
-        ml = ngx_inet6_ntop(rule6[i].mask.s6_addr, mt, NGX_INET6_ADDRSTRLEN);
-        al = ngx_inet6_ntop(rule6[i].addr.s6_addr, at, NGX_INET6_ADDRSTRLEN);
-
-        ngx_log_debug6(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
-                       "access: %*s %*s %*s", cl, ct, ml, mt, al, at);
-        }
-#endif
+        if (alcf->rules6) {
+            deny = ngx_radix128tree_find(alcf->rules6, p);
 
-        for (n = 0; n < 16; n++) {
-            if ((p[n] & rule6[i].mask.s6_addr[n]) != rule6[i].addr.s6_addr[n]) {
-                goto next;
+            if (deny != NGX_RADIX_NO_VALUE) {
+                return ngx_http_access_found(r, deny);
             }
         }
 
-        return ngx_http_access_found(r, rule6[i].deny);
+        break;
 
-    next:
-        continue;
+#endif
     }
 
     return NGX_DECLINED;
 }
 
-#endif
-
 
 static ngx_int_t
-ngx_http_access_found(ngx_http_request_t *r, ngx_uint_t deny)
+ngx_http_access_found(ngx_http_request_t *r, uintptr_t deny)
 {
     ngx_http_core_loc_conf_t  *clcf;
 
@@ -248,14 +191,11 @@ ngx_http_access_rule(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 {
     ngx_http_access_loc_conf_t *alcf = conf;
 
-    ngx_int_t                 rc;
-    ngx_uint_t                all;
-    ngx_str_t                *value;
-    ngx_cidr_t                cidr;
-    ngx_http_access_rule_t   *rule;
-#if (NGX_HAVE_INET6)
-    ngx_http_access_rule6_t  *rule6;
-#endif
+    ngx_int_t    rc;
+    ngx_str_t   *value;
+    uintptr_t    deny;
+    ngx_uint_t   all;
+    ngx_cidr_t   cidr;
 
     ngx_memzero(&cidr, sizeof(ngx_cidr_t));
 
@@ -279,6 +219,8 @@ ngx_http_access_rule(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
         }
     }
 
+    deny = (value[0].data[0] == 'd') ? 1 : 0;
+
     switch (cidr.family) {
 
 #if (NGX_HAVE_INET6)
@@ -286,22 +228,19 @@ ngx_http_access_rule(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     case 0: /* all */
 
         if (alcf->rules6 == NULL) {
-            alcf->rules6 = ngx_array_create(cf->pool, 4,
-                                            sizeof(ngx_http_access_rule6_t));
+            alcf->rules6 = ngx_radix_tree_create(cf->pool, -1);
             if (alcf->rules6 == NULL) {
                 return NGX_CONF_ERROR;
             }
         }
 
-        rule6 = ngx_array_push(alcf->rules6);
-        if (rule6 == NULL) {
+        if (ngx_http_access_add_rule6(alcf->rules6, cidr.u.in6.addr.s6_addr,
+                                      cidr.u.in6.mask.s6_addr, deny)
+            != NGX_OK)
+        {
             return NGX_CONF_ERROR;
         }
 
-        rule6->mask = cidr.u.in6.mask;
-        rule6->addr = cidr.u.in6.addr;
-        rule6->deny = (value[0].data[0] == 'd') ? 1 : 0;
-
         if (!all) {
             break;
         }
@@ -312,27 +251,109 @@ ngx_http_access_rule(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     default: /* AF_INET */
 
         if (alcf->rules == NULL) {
-            alcf->rules = ngx_array_create(cf->pool, 4,
-                                           sizeof(ngx_http_access_rule_t));
+            alcf->rules = ngx_radix_tree_create(cf->pool, -1);
             if (alcf->rules == NULL) {
                 return NGX_CONF_ERROR;
             }
         }
-
-        rule = ngx_array_push(alcf->rules);
-        if (rule == NULL) {
+        /* 添加一条规则 */
+        if (ngx_http_access_add_rule(alcf->rules, ntohl(cidr.u.in.addr),
+                                     ntohl(cidr.u.in.mask), deny)
+            != NGX_OK)
+        {
             return NGX_CONF_ERROR;
         }
-        /* 创建一条规则 */
-        rule->mask = cidr.u.in.mask;
-        rule->addr = cidr.u.in.addr;
-        rule->deny = (value[0].data[0] == 'd') ? 1 : 0;
     }
 
     return NGX_CONF_OK;
 }
 
 
+static ngx_int_t
+ngx_http_access_add_rule(ngx_radix_tree_t *tree, uint32_t addr, uint32_t mask,
+    uintptr_t deny)
+{
+    uint32_t           bit;
+    ngx_radix_node_t  *node;
+
+    /* the rule is never reached if an earlier rule covers its network */
+
+    bit = 0x80000000;
+    node = tree->root;
+
+    for ( ;; ) {
+        if (node->value != NGX_RADIX_NO_VALUE) {
+            return NGX_OK;
+        }
+
+        if (!(bit & mask)) {
+            break;
+        }
+
+        node = (addr & bit) ? node->right : node->left;
+
+        if (node == NULL) {
+            break;
+        }
+
+        bit >>= 1;
+    }
+
+    if (ngx_radix32tree_insert(tree, addr, mask, deny) == NGX_ERROR) {
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+
+#if (NGX_HAVE_INET6)
+
+static ngx_int_t
+ngx_http_access_add_rule6(ngx_radix_tree_t *tree, u_char *addr, u_char *mask,
+    uintptr_t deny)
+{
+    u_char             bit;
+    ngx_uint_t         i;
+    ngx_radix_node_t  *node;
+
+    i = 0;
+    bit = 0x80;
+    node = tree->root;
+
+    for ( ;; ) {
+        if (node->value != NGX_RADIX_NO_VALUE) {
+            return NGX_OK;
+        }
+
+        if (i == 16 || !(bit & mask[i])) {
+            break;
+        }
+
+        node = (addr[i] & bit) ? node->right : node->left;
+
+        if (node == NULL) {
+            break;
+        }
+
+        bit >>= 1;
+
+        if (bit == 0) {
+            i++;
+            bit = 0x80;
+        }
+    }
+
+    if (ngx_radix128tree_insert(tree, addr, mask, deny) == NGX_ERROR) {
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+#endif
+
+
 static void *
 ngx_http_access_create_loc_conf(ngx_conf_t *cf)
 {
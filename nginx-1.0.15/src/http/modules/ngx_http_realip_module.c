@@ -17,13 +17,10 @@
 
 
 typedef struct {
-    in_addr_t          mask;
-    in_addr_t          addr;
-} ngx_http_realip_from_t;
-
-
-typedef struct {
-    ngx_array_t       *from;     /* array of ngx_http_realip_from_t */
+    ngx_radix_tree_t  *from;
+#if (NGX_HAVE_INET6)
+    ngx_radix_tree_t  *from6;
+#endif
     ngx_uint_t         type;
     ngx_uint_t         hash;
     ngx_str_t          header;
@@ -114,14 +111,18 @@ ngx_http_realip_handler(ngx_http_request_t *r)
 {
     u_char                      *ip, *p;
     size_t                       len;
+    uint32_t                     addr;
     ngx_uint_t                   i, hash;
     ngx_list_part_t             *part;
     ngx_table_elt_t             *header;
     struct sockaddr_in          *sin;
     ngx_connection_t            *c;
     ngx_http_realip_ctx_t       *ctx;
-    ngx_http_realip_from_t      *from;
     ngx_http_realip_loc_conf_t  *rlcf;
+#if (NGX_HAVE_INET6)
+    u_char                      *a;
+    struct sockaddr_in6         *sin6;
+#endif
 
     ctx = ngx_http_get_module_ctx(r, ngx_http_realip_module);
 
@@ -132,6 +133,9 @@ ngx_http_realip_handler(ngx_http_request_t *r)
     rlcf = ngx_http_get_module_loc_conf(r, ngx_http_realip_module);
 
     if (rlcf->from == NULL
+#if (NGX_HAVE_INET6)
+        && rlcf->from6 == NULL
+#endif
 #if (NGX_HAVE_UNIX_DOMAIN)
         && !rlcf->unixsock
 #endif
@@ -214,22 +218,57 @@ found:
 
     ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0, "realip: \"%s\"", ip);
 
-    /* AF_INET only */
+    switch (c->sockaddr->sa_family) {
+
+    case AF_INET:
+        if (rlcf->from == NULL) {
+            break;
+        }
 
-    if (c->sockaddr->sa_family == AF_INET) {
         sin = (struct sockaddr_in *) c->sockaddr;
+        addr = ntohl(sin->sin_addr.s_addr);
+
+        ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                       "realip: %08XD", addr);
 
-        from = rlcf->from->elts;
-        for (i = 0; i < rlcf->from->nelts; i++) {
+        if (ngx_radix32tree_find(rlcf->from, addr) != NGX_RADIX_NO_VALUE) {
+            return ngx_http_realip_set_addr(r, ip, len);
+        }
 
-            ngx_log_debug3(NGX_LOG_DEBUG_HTTP, c->log, 0,
-                           "realip: %08XD %08XD %08XD",
-                           sin->sin_addr.s_addr, from[i].mask, from[i].addr);
+        break;
 
-            if ((sin->sin_addr.s_addr & from[i].mask) == from[i].addr) {
+#if (NGX_HAVE_INET6)
+
+    case AF_INET6:
+        sin6 = (struct sockaddr_in6 *) c->sockaddr;
+        a = sin6->sin6_addr.s6_addr;
+
+        if (IN6_IS_ADDR_V4MAPPED(&sin6->sin6_addr)) {
+            if (rlcf->from == NULL) {
+                break;
+            }
+
+            addr = a[12] << 24;
+            addr += a[13] << 16;
+            addr += a[14] << 8;
+            addr += a[15];
+
+            if (ngx_radix32tree_find(rlcf->from, addr) != NGX_RADIX_NO_VALUE) {
                 return ngx_http_realip_set_addr(r, ip, len);
             }
+
+            break;
         }
+
+        if (rlcf->from6
+            && ngx_radix128tree_find(rlcf->from6, a) != NGX_RADIX_NO_VALUE)
+        {
+            return ngx_http_realip_set_addr(r, ip, len);
+        }
+
+        break;
+
+#endif
     }
 
 #if (NGX_HAVE_UNIX_DOMAIN)
@@ -318,10 +357,9 @@ ngx_http_realip_from(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 {
     ngx_http_realip_loc_conf_t *rlcf = conf;
 
-    ngx_int_t                rc;
-    ngx_str_t               *value;
-    ngx_cidr_t               cidr;
-    ngx_http_realip_from_t  *from;
+    ngx_int_t    rc;
+    ngx_str_t   *value;
+    ngx_cidr_t   cidr;
 
     value = cf->args->elts;
 /* unix域套接字 */
@@ -334,19 +372,6 @@ ngx_http_realip_from(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 
 #endif
 
-    if (rlcf->from == NULL) {
-        rlcf->from = ngx_array_create(cf->pool, 2,
-                                      sizeof(ngx_http_realip_from_t));
-        if (rlcf->from == NULL) {
-            return NGX_CONF_ERROR;
-        }
-    }
-
-    from = ngx_array_push(rlcf->from);
-    if (from == NULL) {
-        return NGX_CONF_ERROR;
-    }
-
     rc = ngx_ptocidr(&value[1], &cidr);
 
     if (rc == NGX_ERROR) {
@@ -355,19 +380,46 @@ ngx_http_realip_from(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
         return NGX_CONF_ERROR;
     }
 
-    if (cidr.family != AF_INET) {
-        ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
-                           "\"set_real_ip_from\" supports IPv4 only");
-        return NGX_CONF_ERROR;
-    }
-
     if (rc == NGX_DONE) {
         ngx_conf_log_error(NGX_LOG_WARN, cf, 0,
                            "low address bits of %V are meaningless", &value[1]);
     }
-    /* 设置ip地址以及掩码 */
-    from->mask = cidr.u.in.mask;
-    from->addr = cidr.u.in.addr;
+
+    switch (cidr.family) {
+
+#if (NGX_HAVE_INET6)
+    case AF_INET6:
+
+        if (rlcf->from6 == NULL) {
+            rlcf->from6 = ngx_radix_tree_create(cf->pool, -1);
+            if (rlcf->from6 == NULL) {
+                return NGX_CONF_ERROR;
+            }
+        }
+
+        rc = ngx_radix128tree_insert(rlcf->from6, cidr.u.in6.addr.s6_addr,
+                                     cidr.u.in6.mask.s6_addr, 1);
+        break;
+#endif
+
+    default: /* AF_INET */
+
+        if (rlcf->from == NULL) {
+            rlcf->from = ngx_radix_tree_create(cf->pool, -1);
+            if (rlcf->from == NULL) {
+                return NGX_CONF_ERROR;
+            }
+        }
+        /* 以主机字节序插入ip地址以及掩码 */
+        rc = ngx_radix32tree_insert(rlcf->from, ntohl(cidr.u.in.addr),
+                                    ntohl(cidr.u.in.mask), 1);
+    }
+
+    /* NGX_BUSY: the same network was already listed */
+
+    if (rc == NGX_ERROR) {
+        return NGX_CONF_ERROR;
+    }
 
     return NGX_CONF_OK;
 }
@@ -415,6 +467,7 @@ ngx_http_realip_create_loc_conf(ngx_conf_t *cf)
      * set by ngx_pcalloc():
      *
      *     conf->from = NULL;
+     *     conf->from6 = NULL;
      *     conf->hash = 0;
      *     conf->header = { 0, NULL };
      */
@@ -434,8 +487,16 @@ ngx_http_realip_merge_loc_conf(ngx_conf_t *cf, void *parent, void *child)
     ngx_http_realip_loc_conf_t  *prev = parent;
     ngx_http_realip_loc_conf_t  *conf = child;
 
-    if (conf->from == NULL) {
+    if (conf->from == NULL
+#if (NGX_HAVE_INET6)
+        && conf->from6 == NULL
+#endif
+       )
+    {
         conf->from = prev->from;
+#if (NGX_HAVE_INET6)
+        conf->from6 = prev->from6;
+#endif
     }
 
 #if (NGX_HAVE_UNIX_DOMAIN)
@@ -12,6 +12,7 @@
 
 static char *ngx_http_set_status(ngx_conf_t *cf, ngx_command_t *cmd,
                                  void *conf);
+static u_char *ngx_http_status_mutex(u_char *p, ngx_shmtx_stat_t *stat);
 
 static ngx_command_t  ngx_http_status_commands[] = {
 
@@ -62,9 +63,13 @@ static ngx_int_t ngx_http_status_handler(ngx_http_request_t *r)
 {
     size_t             size;
     ngx_int_t          rc;
+    ngx_uint_t         i;
     ngx_buf_t         *b;
     ngx_chain_t        out;
-    ngx_atomic_int_t   ap, hn, ac, rq, rd, wr;
+    ngx_shm_zone_t    *shm_zone;
+    ngx_list_part_t   *part;
+    ngx_slab_pool_t   *sp;
+    ngx_atomic_int_t   ap, hn, ac, rq, rd, wr, lh, lm, ph, pm, pr;
 
     if (r->method != NGX_HTTP_GET && r->method != NGX_HTTP_HEAD) {
         return NGX_HTTP_NOT_ALLOWED;
@@ -91,7 +96,36 @@ static ngx_int_t ngx_http_status_handler(ngx_http_request_t *r)
     size = sizeof("Active connections:  \n") + NGX_ATOMIC_T_LEN
            + sizeof("server accepts handled requests\n") - 1
            + 6 + 3 * NGX_ATOMIC_T_LEN
-           + sizeof("Reading:  Writing:  Waiting:  \n") + 3 * NGX_ATOMIC_T_LEN;
+           + sizeof("Reading:  Writing:  Waiting:  \n") + 3 * NGX_ATOMIC_T_LEN
+           + sizeof("Large header buffers: hits  misses  \n")
+           + 2 * NGX_ATOMIC_T_LEN
+           + sizeof("Pool cache: hits  misses  released  \n")
+           + 3 * NGX_ATOMIC_T_LEN;
+
+    if (ngx_accept_mutex_ptr) {
+        size += sizeof("Accept mutex:") - 1
+                + sizeof(" acquires  contended  spins  wait  \n")
+                + 4 * NGX_ATOMIC_T_LEN;
+    }
+
+    part = (ngx_list_part_t *) &ngx_cycle->shared_memory.part;
+    shm_zone = part->elts;
+
+    for (i = 0; /* void */ ; i++) {
+
+        if (i >= part->nelts) {
+            if (part->next == NULL) {
+                break;
+            }
+            part = part->next;
+            shm_zone = part->elts;
+            i = 0;
+        }
+
+        size += sizeof("Zone \"\" mutex:") - 1 + shm_zone[i].shm.name.len
+                + sizeof(" acquires  contended  spins  wait  \n")
+                + 4 * NGX_ATOMIC_T_LEN;
+    }
 
     b = ngx_create_temp_buf(r->pool, size);
     if (b == NULL) {
@@ -107,6 +141,31 @@ static ngx_int_t ngx_http_status_handler(ngx_http_request_t *r)
     rq = *ngx_stat_requests;
     rd = *ngx_stat_reading;
     wr = *ngx_stat_writing;
+    lh = *ngx_stat_large_header_hits;
+    lm = *ngx_stat_large_header_misses;
+
+    if (ngx_stat_pools) {
+        ph = 0;
+        pm = 0;
+        pr = 0;
+
+        for (i = 0; i < NGX_MAX_PROCESSES; i++) {
+            ph += ngx_stat_pools[i].hits;
+            pm += ngx_stat_pools[i].misses;
+            pr += ngx_stat_pools[i].released;
+        }
+
+    } else {
+
+        /*
+         * "master_process off": the shared zone is not allocated,
+         * and the only process counts in its private ngx_pool_stat
+         */
+
+        ph = ngx_pool_stat->hits;
+        pm = ngx_pool_stat->misses;
+        pr = ngx_pool_stat->released;
+    }
 
     b->last = ngx_sprintf(b->last, "Active connections: %uA \n", ac);
 
@@ -118,6 +177,41 @@ static ngx_int_t ngx_http_status_handler(ngx_http_request_t *r)
     b->last = ngx_sprintf(b->last, "Reading: %uA Writing: %uA Waiting: %uA \n",
                           rd, wr, ac - (rd + wr));
 
+    b->last = ngx_sprintf(b->last,
+                          "Large header buffers: hits %uA misses %uA \n",
+                          lh, lm);
+
+    b->last = ngx_sprintf(b->last,
+                          "Pool cache: hits %uA misses %uA released %uA \n",
+                          ph, pm, pr);
+
+    if (ngx_accept_mutex_ptr) {
+        b->last = ngx_cpymem(b->last, "Accept mutex:",
+                             sizeof("Accept mutex:") - 1);
+        b->last = ngx_http_status_mutex(b->last, ngx_accept_mutex.stat);
+    }
+
+    part = (ngx_list_part_t *) &ngx_cycle->shared_memory.part;
+    shm_zone = part->elts;
+
+    for (i = 0; /* void */ ; i++) {
+
+        if (i >= part->nelts) {
+            if (part->next == NULL) {
+                break;
+            }
+            part = part->next;
+            shm_zone = part->elts;
+            i = 0;
+        }
+
+        sp = (ngx_slab_pool_t *) shm_zone[i].shm.addr;
+
+        b->last = ngx_sprintf(b->last, "Zone \"%V\" mutex:",
+                              &shm_zone[i].shm.name);
+        b->last = ngx_http_status_mutex(b->last, sp->mutex.stat);
+    }
+
     r->headers_out.status = NGX_HTTP_OK;
     r->headers_out.content_length_n = b->last - b->pos;
 
@@ -133,6 +227,17 @@ static ngx_int_t ngx_http_status_handler(ngx_http_request_t *r)
 }
 
 
+static u_char *
+ngx_http_status_mutex(u_char *p, ngx_shmtx_stat_t *stat)
+{
+    /* the wait time is in microseconds */
+
+    return ngx_sprintf(p, " acquires %uA contended %uA spins %uA wait %uA \n",
+                       stat->acquires, stat->contended, stat->spins,
+                       stat->wait_time);
+}
+
+
 static char *ngx_http_set_status(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 {
     ngx_http_core_loc_conf_t  *clcf;
@@ -0,0 +1,638 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+typedef struct {
+    ngx_str_t                       upstream;
+    ngx_str_t                       server;
+
+    ngx_int_t                       id;
+    ngx_int_t                       weight;
+    ngx_int_t                       max_fails;
+    time_t                          fail_timeout;
+
+    unsigned                        backup:1;
+    unsigned                        add:1;
+    unsigned                        remove:1;
+    unsigned                        down:1;
+    unsigned                        up:1;
+    unsigned                        drain:1;
+
+    u_char                          sockaddr[NGX_SOCKADDRLEN];
+    socklen_t                       socklen;
+
+    char                           *err;
+} ngx_http_upstream_conf_args_t;
+
+
+static ngx_int_t ngx_http_upstream_conf_handler(ngx_http_request_t *r);
+static ngx_int_t ngx_http_upstream_conf_parse_args(ngx_http_request_t *r,
+    ngx_http_upstream_conf_args_t *args);
+static ngx_int_t ngx_http_upstream_conf_parse_addr(ngx_http_request_t *r,
+    ngx_http_upstream_conf_args_t *args);
+static ngx_int_t ngx_http_upstream_conf_add(
+    ngx_http_upstream_rr_peers_t *peers, ngx_http_upstream_conf_args_t *args);
+static void ngx_http_upstream_conf_modify(ngx_http_upstream_rr_peer_t *peer,
+    ngx_http_upstream_conf_args_t *args);
+static u_char *ngx_http_upstream_conf_peer(u_char *p,
+    ngx_http_upstream_rr_peer_t *peer, ngx_uint_t id);
+static ngx_int_t ngx_http_upstream_conf_send(ngx_http_request_t *r,
+    ngx_uint_t status, ngx_buf_t *b, char *err);
+static char *ngx_http_upstream_conf(ngx_conf_t *cf, ngx_command_t *cmd,
+    void *conf);
+
+
+static ngx_command_t  ngx_http_upstream_conf_commands[] = {
+
+    { ngx_string("upstream_conf"),
+      NGX_HTTP_LOC_CONF|NGX_CONF_NOARGS,
+      ngx_http_upstream_conf,
+      0,
+      0,
+      NULL },
+
+      ngx_null_command
+};
+
+
+static ngx_http_module_t  ngx_http_upstream_conf_module_ctx = {
+    NULL,                                  /* preconfiguration */
+    NULL,                                  /* postconfiguration */
+
+    NULL,                                  /* create main configuration */
+    NULL,                                  /* init main configuration */
+
+    NULL,                                  /* create server configuration */
+    NULL,                                  /* merge server configuration */
+
+    NULL,                                  /* create location configuration */
+    NULL                                   /* merge location configuration */
+};
+
+
+ngx_module_t  ngx_http_upstream_conf_module = {
+    NGX_MODULE_V1,
+    &ngx_http_upstream_conf_module_ctx,    /* module context */
+    ngx_http_upstream_conf_commands,       /* module directives */
+    NGX_HTTP_MODULE,                       /* module type */
+    NULL,                                  /* init master */
+    NULL,                                  /* init module */
+    NULL,                                  /* init process */
+    NULL,                                  /* init thread */
+    NULL,                                  /* exit thread */
+    NULL,                                  /* exit process */
+    NULL,                                  /* exit master */
+    NGX_MODULE_V1_PADDING
+};
+
+
+#define NGX_HTTP_UPSTREAM_CONF_LINE_LEN                                       \
+    (sizeof("server  weight= max_fails= fail_timeout=s down;") - 1            \
+     + NGX_SOCKADDR_STRLEN + 2 * NGX_INT_T_LEN + NGX_TIME_T_LEN               \
+     + sizeof(" # id= conns= draining unhealthy\n") - 1 + 2 * NGX_INT_T_LEN)
+
+
+static ngx_int_t
+ngx_http_upstream_conf_handler(ngx_http_request_t *r)
+{
+    ngx_int_t                        rc, id;
+    ngx_buf_t                       *b;
+    ngx_uint_t                       i, status;
+    ngx_http_upstream_rr_peer_t     *peer;
+    ngx_http_upstream_rr_peers_t    *peers;
+    ngx_http_upstream_srv_conf_t    *uscf, **uscfp;
+    ngx_http_upstream_main_conf_t   *umcf;
+    ngx_http_upstream_conf_args_t    args;
+
+    if (r->method != NGX_HTTP_GET && r->method != NGX_HTTP_HEAD) {
+        return NGX_HTTP_NOT_ALLOWED;
+    }
+
+    rc = ngx_http_discard_request_body(r);
+
+    if (rc != NGX_OK) {
+        return rc;
+    }
+
+    if (ngx_http_upstream_conf_parse_args(r, &args) != NGX_OK) {
+        if (args.err == NULL) {
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
+
+        return ngx_http_upstream_conf_send(r, NGX_HTTP_BAD_REQUEST, NULL,
+                                           args.err);
+    }
+
+    umcf = ngx_http_get_module_main_conf(r, ngx_http_upstream_module);
+
+    uscf = NULL;
+    uscfp = umcf->upstreams.elts;
+
+    for (i = 0; i < umcf->upstreams.nelts; i++) {
+        if (uscfp[i]->host.len == args.upstream.len
+            && ngx_strncasecmp(uscfp[i]->host.data, args.upstream.data,
+                               args.upstream.len)
+               == 0)
+        {
+            uscf = uscfp[i];
+            break;
+        }
+    }
+
+    if (uscf == NULL) {
+        return ngx_http_upstream_conf_send(r, NGX_HTTP_NOT_FOUND, NULL,
+                                           "upstream not found");
+    }
+
+    if (uscf->shm_zone == NULL) {
+        return ngx_http_upstream_conf_send(r, NGX_HTTP_BAD_REQUEST, NULL,
+                                           "upstream is not in shared memory");
+    }
+
+    peers = uscf->peer.data;
+
+    if (args.backup) {
+        peers = peers->next;
+
+        if (peers == NULL) {
+            return ngx_http_upstream_conf_send(r, NGX_HTTP_NOT_FOUND, NULL,
+                                               "no backup servers");
+        }
+    }
+
+    b = ngx_create_temp_buf(r->pool,
+                            peers->number * NGX_HTTP_UPSTREAM_CONF_LINE_LEN);
+    if (b == NULL) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+
+    status = NGX_HTTP_OK;
+    id = args.id;
+
+    ngx_http_upstream_rr_peers_lock(peers);
+
+    if (args.add) {
+        id = ngx_http_upstream_conf_add(peers, &args);
+
+        if (id == NGX_ERROR) {
+            args.err = "no free peers, see \"spare\" of \"zone\"";
+            status = NGX_HTTP_INSUFFICIENT_STORAGE;
+            goto done;
+        }
+
+        goto peer;
+    }
+
+    if (id == NGX_CONF_UNSET) {
+        goto list;
+    }
+
+    if ((ngx_uint_t) id >= peers->number
+        || (peers->peer[id].down & NGX_HTTP_UPSTREAM_PEER_UNUSED))
+    {
+        args.err = "server not found";
+        status = NGX_HTTP_NOT_FOUND;
+        goto done;
+    }
+
+    peer = &peers->peer[id];
+
+    if (args.remove) {
+
+        if (peers->single) {
+            args.err = "the only server cannot be removed";
+            status = NGX_HTTP_BAD_REQUEST;
+            goto done;
+        }
+
+        if (peer->server && peer->server->resolve) {
+            args.err = "server is resolved at run time";
+            status = NGX_HTTP_BAD_REQUEST;
+            goto done;
+        }
+
+        /* the peer is reused only when it is not in use anymore */
+
+        peer->down = NGX_HTTP_UPSTREAM_PEER_FREE;
+        peer->weight = 0;
+        peer->current_weight = 0;
+        peer->server = NULL;
+
+        goto list;
+    }
+
+    ngx_http_upstream_conf_modify(peer, &args);
+
+peer:
+
+    b->last = ngx_http_upstream_conf_peer(b->last, &peers->peer[id], id);
+
+    goto done;
+
+list:
+
+    for (i = 0; i < peers->number; i++) {
+        if (peers->peer[i].down & NGX_HTTP_UPSTREAM_PEER_UNUSED) {
+            continue;
+        }
+
+        b->last = ngx_http_upstream_conf_peer(b->last, &peers->peer[i], i);
+    }
+
+done:
+
+    ngx_http_upstream_rr_peers_unlock(peers);
+
+    if (status == NGX_HTTP_OK
+        && (args.add || args.remove || args.weight != NGX_CONF_UNSET
+            || args.max_fails != NGX_CONF_UNSET
+            || args.fail_timeout != NGX_CONF_UNSET
+            || args.down || args.up || args.drain))
+    {
+        ngx_log_error(NGX_LOG_NOTICE, r->connection->log, 0,
+                      "upstream \"%V\" changed: \"%V\"",
+                      &uscf->host, &r->args);
+    }
+
+    return ngx_http_upstream_conf_send(r, status, b, args.err);
+}
+
+
+static ngx_int_t
+ngx_http_upstream_conf_parse_args(ngx_http_request_t *r,
+    ngx_http_upstream_conf_args_t *args)
+{
+    ngx_str_t  value;
+
+    ngx_memzero(args, sizeof(ngx_http_upstream_conf_args_t));
+
+    args->id = NGX_CONF_UNSET;
+    args->weight = NGX_CONF_UNSET;
+    args->max_fails = NGX_CONF_UNSET;
+    args->fail_timeout = NGX_CONF_UNSET;
+
+    if (ngx_http_arg(r, (u_char *) "upstream", 8, &args->upstream) != NGX_OK
+        || args->upstream.len == 0)
+    {
+        args->err = "upstream is required";
+        return NGX_ERROR;
+    }
+
+    if (ngx_http_arg(r, (u_char *) "id", 2, &value) == NGX_OK) {
+        args->id = ngx_atoi(value.data, value.len);
+
+        if (args->id == NGX_ERROR) {
+            args->err = "invalid id";
+            return NGX_ERROR;
+        }
+    }
+
+    if (ngx_http_arg(r, (u_char *) "weight", 6, &value) == NGX_OK) {
+        args->weight = ngx_atoi(value.data, value.len);
+
+        if (args->weight == NGX_ERROR || args->weight == 0) {
+            args->err = "invalid weight";
+            return NGX_ERROR;
+        }
+    }
+
+    if (ngx_http_arg(r, (u_char *) "max_fails", 9, &value) == NGX_OK) {
+        args->max_fails = ngx_atoi(value.data, value.len);
+
+        if (args->max_fails == NGX_ERROR) {
+            args->err = "invalid max_fails";
+            return NGX_ERROR;
+        }
+    }
+
+    if (ngx_http_arg(r, (u_char *) "fail_timeout", 12, &value) == NGX_OK) {
+        args->fail_timeout = ngx_parse_time(&value, 1);
+
+        if (args->fail_timeout == NGX_ERROR) {
+            args->err = "invalid fail_timeout";
+            return NGX_ERROR;
+        }
+    }
+
+    args->backup = (ngx_http_arg(r, (u_char *) "backup", 6, &value)
+                    == NGX_OK);
+    args->add = (ngx_http_arg(r, (u_char *) "add", 3, &value) == NGX_OK);
+    args->remove = (ngx_http_arg(r, (u_char *) "remove", 6, &value)
+                    == NGX_OK);
+    args->down = (ngx_http_arg(r, (u_char *) "down", 4, &value) == NGX_OK);
+    args->up = (ngx_http_arg(r, (u_char *) "up", 2, &value) == NGX_OK);
+    args->drain = (ngx_http_arg(r, (u_char *) "drain", 5, &value) == NGX_OK);
+
+    if (args->add + args->remove > 1 || args->down + args->up > 1) {
+        args->err = "conflicting parameters";
+        return NGX_ERROR;
+    }
+
+    if (args->add) {
+
+        if (args->id != NGX_CONF_UNSET) {
+            args->err = "id cannot be used to add a server";
+            return NGX_ERROR;
+        }
+
+        if (args->backup) {
+            args->err = "backup servers cannot be added";
+            return NGX_ERROR;
+        }
+
+        if (ngx_http_arg(r, (u_char *) "server", 6, &args->server) != NGX_OK
+            || args->server.len == 0)
+        {
+            args->err = "server is required";
+            return NGX_ERROR;
+        }
+
+        return ngx_http_upstream_conf_parse_addr(r, args);
+    }
+
+    if (args->id == NGX_CONF_UNSET
+        && (args->remove || args->weight != NGX_CONF_UNSET
+            || args->max_fails != NGX_CONF_UNSET
+            || args->fail_timeout != NGX_CONF_UNSET
+            || args->down || args->up || args->drain))
+    {
+        args->err = "id is required";
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_conf_parse_addr(ngx_http_request_t *r,
+    ngx_http_upstream_conf_args_t *args)
+{
+    u_char               *p, *dst;
+    in_addr_t             addr;
+    ngx_url_t             u;
+    struct sockaddr_in   *sin;
+#if (NGX_HAVE_INET6)
+    struct sockaddr_in6  *sin6;
+#endif
+
+    /* "[::1]:80" comes escaped, and the parser expects a null at the end */
+
+    dst = ngx_pnalloc(r->pool, args->server.len + 1);
+    if (dst == NULL) {
+        return NGX_ERROR;
+    }
+
+    p = args->server.data;
+    args->server.data = dst;
+
+    ngx_unescape_uri(&dst, &p, args->server.len, 0);
+
+    args->server.len = dst - args->server.data;
+    *dst = '\0';
+
+    ngx_memzero(&u, sizeof(ngx_url_t));
+
+    u.url = args->server;
+    u.default_port = 80;
+    u.no_resolve = 1;
+
+    if (ngx_parse_url(r->pool, &u) != NGX_OK) {
+        args->err = u.err ? u.err : "invalid server";
+        return NGX_ERROR;
+    }
+
+    /* names are not resolved here so as not to block the worker */
+
+    switch (u.family) {
+
+#if (NGX_HAVE_INET6)
+    case AF_INET6:
+        sin6 = (struct sockaddr_in6 *) u.sockaddr;
+
+        if (u.no_port) {
+            sin6->sin6_port = htons(u.default_port);
+        }
+
+        break;
+#endif
+
+    case AF_INET:
+        addr = ngx_inet_addr(u.host.data, u.host.len);
+
+        if (addr == INADDR_NONE) {
+            args->err = "server must be an address";
+            return NGX_ERROR;
+        }
+
+        sin = (struct sockaddr_in *) u.sockaddr;
+        sin->sin_addr.s_addr = addr;
+
+        if (u.no_port) {
+            sin->sin_port = htons(u.default_port);
+        }
+
+        break;
+
+    default:
+        args->err = "server must be an address";
+        return NGX_ERROR;
+    }
+
+    ngx_memcpy(args->sockaddr, u.sockaddr, u.socklen);
+    args->socklen = u.socklen;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_conf_add(ngx_http_upstream_rr_peers_t *peers,
+    ngx_http_upstream_conf_args_t *args)
+{
+    ngx_uint_t                    i;
+    ngx_http_upstream_rr_peer_t  *peer;
+
+    for (i = 0; i < peers->number; i++) {
+        peer = &peers->peer[i];
+
+        if ((peer->down & NGX_HTTP_UPSTREAM_PEER_FREE) && peer->conns == 0) {
+            break;
+        }
+    }
+
+    if (i == peers->number) {
+        return NGX_ERROR;
+    }
+
+    ngx_memcpy(peer->sockaddr, args->sockaddr, args->socklen);
+    peer->socklen = args->socklen;
+    peer->name.len = ngx_sock_ntop(peer->sockaddr, peer->name.data,
+                                   NGX_SOCKADDR_STRLEN, 1);
+
+    peer->weight = 1;
+    peer->current_weight = 0;
+    peer->max_fails = 1;
+    peer->fail_timeout = 10;
+    peer->slow_start = 0;
+    peer->start = 0;
+    peer->fails = 0;
+    peer->accessed = 0;
+    peer->down = 0;
+    peer->server = NULL;
+
+    ngx_http_upstream_conf_modify(peer, args);
+
+    return i;
+}
+
+
+static void
+ngx_http_upstream_conf_modify(ngx_http_upstream_rr_peer_t *peer,
+    ngx_http_upstream_conf_args_t *args)
+{
+    if (args->weight != NGX_CONF_UNSET) {
+        peer->weight = args->weight;
+        peer->current_weight = 0;
+    }
+
+    if (args->max_fails != NGX_CONF_UNSET) {
+        peer->max_fails = args->max_fails;
+    }
+
+    if (args->fail_timeout != NGX_CONF_UNSET) {
+        peer->fail_timeout = args->fail_timeout;
+    }
+
+    if (args->down) {
+        peer->down |= NGX_HTTP_UPSTREAM_PEER_DOWN;
+    }
+
+    if (args->drain) {
+        peer->down |= NGX_HTTP_UPSTREAM_PEER_DRAIN;
+    }
+
+    if (args->up) {
+
+        if (peer->down & (NGX_HTTP_UPSTREAM_PEER_DOWN
+                          |NGX_HTTP_UPSTREAM_PEER_DRAIN))
+        {
+            peer->start = ngx_current_msec;
+        }
+
+        peer->down &= ~(NGX_HTTP_UPSTREAM_PEER_DOWN
+                        |NGX_HTTP_UPSTREAM_PEER_DRAIN);
+
+        /* a server configured as down has no weight */
+
+        if (peer->weight == 0) {
+            peer->weight = peer->server ? (ngx_int_t) peer->server->weight : 1;
+        }
+
+        peer->fails = 0;
+    }
+}
+
+
+static u_char *
+ngx_http_upstream_conf_peer(u_char *p, ngx_http_upstream_rr_peer_t *peer,
+    ngx_uint_t id)
+{
+    ngx_int_t  weight;
+
+    weight = peer->weight;
+
+    if (weight == 0 && peer->server) {
+        weight = peer->server->weight;
+    }
+
+    p = ngx_sprintf(p, "server %V weight=%i max_fails=%ui fail_timeout=%Ts",
+                    &peer->name, weight, peer->max_fails, peer->fail_timeout);
+
+    if (peer->down & NGX_HTTP_UPSTREAM_PEER_DOWN) {
+        p = ngx_cpymem(p, " down", sizeof(" down") - 1);
+    }
+
+    p = ngx_sprintf(p, "; # id=%ui conns=%ui", id, peer->conns);
+
+    if (peer->down & NGX_HTTP_UPSTREAM_PEER_DRAIN) {
+        if (peer->conns) {
+            p = ngx_cpymem(p, " draining", sizeof(" draining") - 1);
+
+        } else {
+            p = ngx_cpymem(p, " drained", sizeof(" drained") - 1);
+        }
+    }
+
+    if (peer->down & NGX_HTTP_UPSTREAM_PEER_CHECK_DOWN) {
+        p = ngx_cpymem(p, " unhealthy", sizeof(" unhealthy") - 1);
+    }
+
+    *p++ = LF;
+
+    return p;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_conf_send(ngx_http_request_t *r, ngx_uint_t status,
+    ngx_buf_t *b, char *err)
+{
+    size_t       len;
+    ngx_int_t    rc;
+    ngx_chain_t  out;
+
+    if (err) {
+        len = ngx_strlen(err);
+
+        b = ngx_create_temp_buf(r->pool, len + 1);
+        if (b == NULL) {
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
+
+        b->last = ngx_cpymem(b->last, err, len);
+        *b->last++ = LF;
+    }
+
+    ngx_str_set(&r->headers_out.content_type, "text/plain");
+
+    r->headers_out.status = status;
+    r->headers_out.content_length_n = b->last - b->pos;
+
+    if (r->headers_out.content_length_n == 0) {
+        r->header_only = 1;
+    }
+
+    b->last_buf = 1;
+
+    rc = ngx_http_send_header(r);
+
+    if (rc == NGX_ERROR || rc > NGX_OK || r->header_only) {
+        return rc;
+    }
+
+    out.buf = b;
+    out.next = NULL;
+
+    return ngx_http_output_filter(r, &out);
+}
+
+
+static char *
+ngx_http_upstream_conf(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
+{
+    ngx_http_core_loc_conf_t  *clcf;
+
+    clcf = ngx_http_conf_get_module_loc_conf(cf, ngx_http_core_module);
+    clcf->handler = ngx_http_upstream_conf_handler;
+
+    return NGX_CONF_OK;
+}
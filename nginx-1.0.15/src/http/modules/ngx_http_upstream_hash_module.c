@@ -0,0 +1,710 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+typedef struct {
+    uint32_t                            hash;
+    ngx_uint_t                          peer;
+} ngx_http_upstream_chash_point_t;
+
+
+typedef struct {
+    ngx_uint_t                          number;
+    ngx_http_upstream_chash_point_t     point[1];
+} ngx_http_upstream_chash_points_t;
+
+
+typedef struct {
+    ngx_http_complex_value_t            key;
+    ngx_http_upstream_chash_points_t   *points;
+
+    /* maximum load of a peer relative to the average, in percents */
+    ngx_uint_t                          bounded;
+} ngx_http_upstream_hash_srv_conf_t;
+
+
+typedef struct {
+    /* the round robin data must be first */
+    ngx_http_upstream_rr_peer_data_t    rrp;
+
+    ngx_http_upstream_hash_srv_conf_t  *conf;
+    ngx_str_t                           key;
+    ngx_uint_t                          tries;
+    ngx_uint_t                          rehash;
+    uint32_t                            hash;
+
+    ngx_event_get_peer_pt               get_rr_peer;
+} ngx_http_upstream_hash_peer_data_t;
+
+
+static ngx_int_t ngx_http_upstream_init_hash(ngx_conf_t *cf,
+    ngx_http_upstream_srv_conf_t *us);
+static ngx_int_t ngx_http_upstream_init_hash_peer(ngx_http_request_t *r,
+    ngx_http_upstream_srv_conf_t *us);
+static ngx_int_t ngx_http_upstream_get_hash_peer(ngx_peer_connection_t *pc,
+    void *data);
+
+static ngx_int_t ngx_http_upstream_init_chash(ngx_conf_t *cf,
+    ngx_http_upstream_srv_conf_t *us);
+static int ngx_libc_cdecl
+    ngx_http_upstream_chash_cmp_points(const void *one, const void *two);
+static ngx_uint_t ngx_http_upstream_find_chash_point(
+    ngx_http_upstream_chash_points_t *points, uint32_t hash);
+static ngx_int_t ngx_http_upstream_init_chash_peer(ngx_http_request_t *r,
+    ngx_http_upstream_srv_conf_t *us);
+static ngx_int_t ngx_http_upstream_get_chash_peer(ngx_peer_connection_t *pc,
+    void *data);
+
+static void *ngx_http_upstream_hash_create_conf(ngx_conf_t *cf);
+static char *ngx_http_upstream_hash(ngx_conf_t *cf, ngx_command_t *cmd,
+    void *conf);
+
+
+static ngx_command_t  ngx_http_upstream_hash_commands[] = {
+
+    { ngx_string("hash"),
+      NGX_HTTP_UPS_CONF|NGX_CONF_TAKE123,
+      ngx_http_upstream_hash,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      0,
+      NULL },
+
+      ngx_null_command
+};
+
+
+static ngx_http_module_t  ngx_http_upstream_hash_module_ctx = {
+    NULL,                                  /* preconfiguration */
+    NULL,                                  /* postconfiguration */
+
+    NULL,                                  /* create main configuration */
+    NULL,                                  /* init main configuration */
+
+    ngx_http_upstream_hash_create_conf,    /* create server configuration */
+    NULL,                                  /* merge server configuration */
+
+    NULL,                                  /* create location configuration */
+    NULL                                   /* merge location configuration */
+};
+
+
+ngx_module_t  ngx_http_upstream_hash_module = {
+    NGX_MODULE_V1,
+    &ngx_http_upstream_hash_module_ctx,    /* module context */
+    ngx_http_upstream_hash_commands,       /* module directives */
+    NGX_HTTP_MODULE,                       /* module type */
+    NULL,                                  /* init master */
+    NULL,                                  /* init module */
+    NULL,                                  /* init process */
+    NULL,                                  /* init thread */
+    NULL,                                  /* exit thread */
+    NULL,                                  /* exit process */
+    NULL,                                  /* exit master */
+    NGX_MODULE_V1_PADDING
+};
+
+
+static ngx_int_t
+ngx_http_upstream_init_hash(ngx_conf_t *cf, ngx_http_upstream_srv_conf_t *us)
+{
+    if (ngx_http_upstream_init_round_robin(cf, us) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    us->peer.init = ngx_http_upstream_init_hash_peer;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_init_hash_peer(ngx_http_request_t *r,
+    ngx_http_upstream_srv_conf_t *us)
+{
+    ngx_http_upstream_hash_srv_conf_t   *hcf;
+    ngx_http_upstream_hash_peer_data_t  *hp;
+
+    hp = ngx_palloc(r->pool, sizeof(ngx_http_upstream_hash_peer_data_t));
+    if (hp == NULL) {
+        return NGX_ERROR;
+    }
+
+    r->upstream->peer.data = &hp->rrp;
+
+    if (ngx_http_upstream_init_round_robin_peer(r, us) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    r->upstream->peer.get = ngx_http_upstream_get_hash_peer;
+
+    hcf = ngx_http_conf_upstream_srv_conf(us, ngx_http_upstream_hash_module);
+
+    if (ngx_http_complex_value(r, &hcf->key, &hp->key) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                   "upstream hash key:\"%V\"", &hp->key);
+
+    hp->conf = hcf;
+    hp->tries = 0;
+    hp->rehash = 0;
+    hp->hash = 0;
+    hp->get_rr_peer = ngx_http_upstream_get_round_robin_peer;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_get_hash_peer(ngx_peer_connection_t *pc, void *data)
+{
+    ngx_http_upstream_hash_peer_data_t  *hp = data;
+
+    time_t                         now;
+    u_char                         buf[NGX_INT_T_LEN];
+    size_t                         size;
+    uint32_t                       hash;
+    ngx_int_t                      w, total;
+    uintptr_t                      m;
+    ngx_uint_t                     i, n, p;
+    ngx_http_upstream_rr_peer_t   *peer;
+    ngx_http_upstream_rr_peers_t  *peers;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                   "get hash peer, try: %ui", pc->tries);
+
+    if (hp->tries > 20 || hp->rrp.peers->single || hp->key.len == 0) {
+        return hp->get_rr_peer(pc, &hp->rrp);
+    }
+
+    pc->cached = 0;
+    pc->connection = NULL;
+
+    now = ngx_time();
+
+    peers = hp->rrp.peers;
+
+    ngx_http_upstream_rr_peers_lock(peers);
+
+    total = 0;
+
+    for (i = 0; i < peers->number; i++) {
+        total += peers->peer[i].weight;
+    }
+
+    if (total == 0) {
+        ngx_http_upstream_rr_peers_unlock(peers);
+        return hp->get_rr_peer(pc, &hp->rrp);
+    }
+
+    for ( ;; ) {
+
+        /*
+         * Hash expression is compatible with Cache::Memcached:
+         * ((crc32([REHASH] KEY) >> 16) & 0x7fff) + PREV_HASH
+         * with REHASH omitted at the first iteration.
+         */
+
+        ngx_crc32_init(hash);
+
+        if (hp->rehash > 0) {
+            size = ngx_sprintf(buf, "%ui", hp->rehash) - buf;
+            ngx_crc32_update(&hash, buf, size);
+        }
+
+        ngx_crc32_update(&hash, hp->key.data, hp->key.len);
+        ngx_crc32_final(hash);
+
+        hash = (hash >> 16) & 0x7fff;
+
+        hp->hash += hash;
+        hp->rehash++;
+
+        w = hp->hash % total;
+
+        for (p = 0; w >= peers->peer[p].weight; p++) {
+            w -= peers->peer[p].weight;
+        }
+
+        peer = &peers->peer[p];
+
+        n = p / (8 * sizeof(uintptr_t));
+        m = (uintptr_t) 1 << p % (8 * sizeof(uintptr_t));
+
+        ngx_log_debug2(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                       "get hash peer, value:%uD, peer:%ui", hp->hash, p);
+
+        if (!(hp->rrp.tried[n] & m) && !peer->down) {
+
+            if (peer->max_fails == 0 || peer->fails < peer->max_fails) {
+                break;
+            }
+
+            if (now - peer->accessed > peer->fail_timeout) {
+                peer->fails = 0;
+                break;
+            }
+        }
+
+        if (++hp->tries > 20) {
+            ngx_http_upstream_rr_peers_unlock(peers);
+            return hp->get_rr_peer(pc, &hp->rrp);
+        }
+    }
+
+    hp->rrp.current = p;
+    hp->rrp.tried[n] |= m;
+
+    peer->conns++;
+
+    pc->sockaddr = peer->sockaddr;
+    pc->socklen = peer->socklen;
+    pc->name = &peer->name;
+
+    ngx_http_upstream_rr_peers_unlock(peers);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_init_chash(ngx_conf_t *cf, ngx_http_upstream_srv_conf_t *us)
+{
+    size_t                              size;
+    uint32_t                            hash, base_hash;
+    ngx_uint_t                          i, j, k, n, p, npoints;
+    ngx_http_upstream_server_t         *server;
+    ngx_http_upstream_rr_peers_t       *peers;
+    ngx_http_upstream_chash_points_t   *points;
+    ngx_http_upstream_hash_srv_conf_t  *hcf;
+    union {
+        uint32_t                        value;
+        u_char                          byte[4];
+    } prev_hash;
+
+    if (ngx_http_upstream_init_round_robin(cf, us) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    us->peer.init = ngx_http_upstream_init_chash_peer;
+
+    peers = us->peer.data;
+    server = us->servers->elts;
+
+#if (NGX_HTTP_UPSTREAM_ZONE)
+
+    /* the ring is built once, so it cannot follow the changing addresses */
+
+    for (i = 0; i < us->servers->nelts; i++) {
+        if (server[i].resolve) {
+            ngx_log_error(NGX_LOG_EMERG, cf->log, 0,
+                          "consistent hash cannot be used with resolvable "
+                          "servers in upstream \"%V\" in %s:%ui",
+                          &us->host, us->file_name, us->line);
+            return NGX_ERROR;
+        }
+    }
+
+    if (us->spare) {
+        ngx_log_error(NGX_LOG_EMERG, cf->log, 0,
+                      "consistent hash cannot be used with spare peers "
+                      "in upstream \"%V\" in %s:%ui",
+                      &us->host, us->file_name, us->line);
+        return NGX_ERROR;
+    }
+
+#endif
+
+    /*
+     * the points are made from the configured servers rather than from
+     * the peers: the peers are sorted by weight, and a down server
+     * has zero weight, while its points must stay on the ring
+     */
+
+    npoints = 0;
+
+    for (i = 0; i < us->servers->nelts; i++) {
+        npoints += server[i].weight * server[i].naddrs * 160;
+    }
+
+    size = sizeof(ngx_http_upstream_chash_points_t)
+           + sizeof(ngx_http_upstream_chash_point_t) * (npoints - 1);
+
+    points = ngx_palloc(cf->pool, size);
+    if (points == NULL) {
+        return NGX_ERROR;
+    }
+
+    points->number = 0;
+
+    for (i = 0; i < us->servers->nelts; i++) {
+        for (j = 0; j < server[i].naddrs; j++) {
+
+            for (p = 0; p < peers->number; p++) {
+                if (peers->peer[p].sockaddr == server[i].addrs[j].sockaddr) {
+                    break;
+                }
+            }
+
+            /*
+             * Hash expression is compatible with the consistent hash
+             * of Cache::Memcached::Fast:
+             * crc32(ADDR, PREV_HASH), where PREV_HASH is 0 for the
+             * first point of a server
+             */
+
+            ngx_crc32_init(base_hash);
+            ngx_crc32_update(&base_hash, server[i].addrs[j].name.data,
+                             server[i].addrs[j].name.len);
+            ngx_crc32_update(&base_hash, (u_char *) "", 1);
+
+            prev_hash.value = 0;
+            n = server[i].weight * 160;
+
+            for (k = 0; k < n; k++) {
+                hash = base_hash;
+
+                ngx_crc32_update(&hash, prev_hash.byte, 4);
+                ngx_crc32_final(hash);
+
+                points->point[points->number].hash = hash;
+                points->point[points->number].peer = p;
+                points->number++;
+
+#if (NGX_HAVE_LITTLE_ENDIAN)
+                prev_hash.value = hash;
+#else
+                prev_hash.byte[0] = (u_char) (hash & 0xff);
+                prev_hash.byte[1] = (u_char) ((hash >> 8) & 0xff);
+                prev_hash.byte[2] = (u_char) ((hash >> 16) & 0xff);
+                prev_hash.byte[3] = (u_char) ((hash >> 24) & 0xff);
+#endif
+            }
+        }
+    }
+
+    ngx_qsort(points->point, points->number,
+              sizeof(ngx_http_upstream_chash_point_t),
+              ngx_http_upstream_chash_cmp_points);
+
+    for (i = 0, j = 1; j < points->number; j++) {
+        if (points->point[i].hash != points->point[j].hash) {
+            points->point[++i] = points->point[j];
+        }
+    }
+
+    points->number = i + 1;
+
+    hcf = ngx_http_conf_upstream_srv_conf(us, ngx_http_upstream_hash_module);
+    hcf->points = points;
+
+    return NGX_OK;
+}
+
+
+static int ngx_libc_cdecl
+ngx_http_upstream_chash_cmp_points(const void *one, const void *two)
+{
+    ngx_http_upstream_chash_point_t *first =
+                                       (ngx_http_upstream_chash_point_t *) one;
+    ngx_http_upstream_chash_point_t *second =
+                                       (ngx_http_upstream_chash_point_t *) two;
+
+    if (first->hash < second->hash) {
+        return -1;
+
+    } else if (first->hash > second->hash) {
+        return 1;
+
+    } else {
+        return 0;
+    }
+}
+
+
+static ngx_uint_t
+ngx_http_upstream_find_chash_point(ngx_http_upstream_chash_points_t *points,
+    uint32_t hash)
+{
+    ngx_uint_t                        i, j, k;
+    ngx_http_upstream_chash_point_t  *point;
+
+    /* find best match */
+
+    point = &points->point[0];
+
+    i = 0;
+    j = points->number;
+
+    while (i < j) {
+        k = (i + j) / 2;
+
+        if (hash > point[k].hash) {
+            i = k + 1;
+
+        } else if (hash < point[k].hash) {
+            j = k;
+
+        } else {
+            return k;
+        }
+    }
+
+    return i;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_init_chash_peer(ngx_http_request_t *r,
+    ngx_http_upstream_srv_conf_t *us)
+{
+    ngx_http_upstream_hash_peer_data_t  *hp;
+
+    if (ngx_http_upstream_init_hash_peer(r, us) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    hp = r->upstream->peer.data;
+
+    r->upstream->peer.get = ngx_http_upstream_get_chash_peer;
+
+    hp->hash = ngx_crc32_long(hp->key.data, hp->key.len);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_get_chash_peer(ngx_peer_connection_t *pc, void *data)
+{
+    ngx_http_upstream_hash_peer_data_t  *hp = data;
+
+    time_t                              now;
+    uintptr_t                           m;
+    ngx_uint_t                          i, n, p, prev, conns, weight;
+    ngx_http_upstream_rr_peer_t        *peer;
+    ngx_http_upstream_rr_peers_t       *peers;
+    ngx_http_upstream_chash_points_t   *points;
+    ngx_http_upstream_hash_srv_conf_t  *hcf;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                   "get consistent hash peer, try: %ui", pc->tries);
+
+    if (hp->tries > 20 || hp->rrp.peers->single) {
+        return hp->get_rr_peer(pc, &hp->rrp);
+    }
+
+    pc->cached = 0;
+    pc->connection = NULL;
+
+    now = ngx_time();
+
+    hcf = hp->conf;
+    points = hcf->points;
+    peers = hp->rrp.peers;
+
+    ngx_http_upstream_rr_peers_lock(peers);
+
+    conns = 0;
+    weight = 0;
+
+    if (hcf->bounded) {
+        for (i = 0; i < peers->number; i++) {
+            conns += peers->peer[i].conns;
+            weight += peers->peer[i].weight;
+        }
+    }
+
+    n = ngx_http_upstream_find_chash_point(points, hp->hash);
+    prev = peers->number;
+
+    /*
+     * walk the ring clockwise from the point found; as with the plain
+     * hash, after 20 peers tried in all the round-robin balancer is used
+     */
+
+    for (i = 0; i < points->number; i++) {
+
+        p = points->point[(n + i) % points->number].peer;
+
+        if (p == prev) {
+            continue;
+        }
+
+        prev = p;
+
+        if (++hp->tries > 20) {
+            break;
+        }
+
+        ngx_log_debug2(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                       "get consistent hash peer, value:%uD, peer:%ui",
+                       hp->hash, p);
+
+        if (hp->rrp.tried[p / (8 * sizeof(uintptr_t))]
+            & ((uintptr_t) 1 << p % (8 * sizeof(uintptr_t))))
+        {
+            continue;
+        }
+
+        peer = &peers->peer[p];
+
+        if (peer->down) {
+            continue;
+        }
+
+        if (peer->max_fails
+            && peer->fails >= peer->max_fails
+            && now - peer->accessed <= peer->fail_timeout)
+        {
+            continue;
+        }
+
+        /*
+         * bounded loads: a peer may not have more than the given share
+         * of the average number of connections, so hot keys spill over
+         * to the next peers on the ring
+         */
+
+        if (hcf->bounded
+            && peer->conns * 100 * weight
+               >= (conns + 1) * hcf->bounded * (ngx_uint_t) peer->weight)
+        {
+            ngx_log_debug2(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                           "get consistent hash peer, overloaded:%ui %ui",
+                           p, peer->conns);
+            continue;
+        }
+
+        goto found;
+    }
+
+    ngx_http_upstream_rr_peers_unlock(peers);
+
+    return hp->get_rr_peer(pc, &hp->rrp);
+
+found:
+
+    if (peer->max_fails && peer->fails >= peer->max_fails) {
+        peer->fails = 0;
+    }
+
+    hp->rrp.current = p;
+
+    n = p / (8 * sizeof(uintptr_t));
+    m = (uintptr_t) 1 << p % (8 * sizeof(uintptr_t));
+
+    hp->rrp.tried[n] |= m;
+
+    peer->conns++;
+
+    pc->sockaddr = peer->sockaddr;
+    pc->socklen = peer->socklen;
+    pc->name = &peer->name;
+
+    ngx_http_upstream_rr_peers_unlock(peers);
+
+    return NGX_OK;
+}
+
+
+static void *
+ngx_http_upstream_hash_create_conf(ngx_conf_t *cf)
+{
+    ngx_http_upstream_hash_srv_conf_t  *conf;
+
+    conf = ngx_pcalloc(cf->pool, sizeof(ngx_http_upstream_hash_srv_conf_t));
+    if (conf == NULL) {
+        return NULL;
+    }
+
+    /*
+     * set by ngx_pcalloc():
+     *
+     *     conf->key = { 0 };
+     *     conf->points = NULL;
+     *     conf->bounded = 0;
+     */
+
+    return conf;
+}
+
+
+static char *
+ngx_http_upstream_hash(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
+{
+    ngx_http_upstream_hash_srv_conf_t  *hcf = conf;
+
+    ngx_int_t                          bounded;
+    ngx_str_t                         *value;
+    ngx_uint_t                         i;
+    ngx_http_upstream_srv_conf_t      *uscf;
+    ngx_http_compile_complex_value_t   ccv;
+
+    value = cf->args->elts;
+
+    ngx_memzero(&ccv, sizeof(ngx_http_compile_complex_value_t));
+
+    ccv.cf = cf;
+    ccv.value = &value[1];
+    ccv.complex_value = &hcf->key;
+
+    if (ngx_http_compile_complex_value(&ccv) != NGX_OK) {
+        return NGX_CONF_ERROR;
+    }
+
+    uscf = ngx_http_conf_get_module_srv_conf(cf, ngx_http_upstream_module);
+
+    uscf->flags = NGX_HTTP_UPSTREAM_CREATE
+                  |NGX_HTTP_UPSTREAM_WEIGHT
+                  |NGX_HTTP_UPSTREAM_MAX_FAILS
+                  |NGX_HTTP_UPSTREAM_FAIL_TIMEOUT
+                  |NGX_HTTP_UPSTREAM_DOWN;
+
+    uscf->peer.init_upstream = ngx_http_upstream_init_hash;
+
+    for (i = 2; i < cf->args->nelts; i++) {
+
+        if (ngx_strcmp(value[i].data, "consistent") == 0) {
+            uscf->peer.init_upstream = ngx_http_upstream_init_chash;
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "bounded=", 8) == 0) {
+
+            bounded = ngx_atofp(value[i].data + 8, value[i].len - 8, 2);
+
+            if (bounded == NGX_ERROR || bounded < 100) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid load bound \"%V\"", &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            hcf->bounded = bounded;
+            continue;
+        }
+
+        ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                           "invalid parameter \"%V\"", &value[i]);
+        return NGX_CONF_ERROR;
+    }
+
+    if (hcf->bounded
+        && uscf->peer.init_upstream != ngx_http_upstream_init_chash)
+    {
+        ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                           "\"bounded\" requires \"consistent\"");
+        return NGX_CONF_ERROR;
+    }
+
+    return NGX_CONF_OK;
+}
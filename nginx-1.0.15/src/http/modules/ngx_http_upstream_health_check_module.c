@@ -0,0 +1,666 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+typedef struct {
+    ngx_msec_t                           interval;
+    ngx_msec_t                           timeout;
+    ngx_uint_t                           fails;
+    ngx_uint_t                           passes;
+
+    /* empty for tcp checks */
+    ngx_str_t                            request;
+} ngx_http_upstream_check_srv_conf_t;
+
+
+typedef struct {
+    ngx_event_t                          event;
+    ngx_peer_connection_t                pc;
+
+    ngx_http_upstream_rr_peer_t         *peer;
+    ngx_http_upstream_rr_peers_t        *peers;
+    ngx_http_upstream_srv_conf_t        *upstream;
+    ngx_http_upstream_check_srv_conf_t  *conf;
+
+    /* the peer address may be changed by other workers */
+    u_char                               sockaddr[NGX_SOCKADDRLEN];
+
+    u_char                              *sent;
+    size_t                               received;
+    u_char                               status[12];  /* "HTTP/1.x NNN" */
+
+    ngx_uint_t                           fails;
+    ngx_uint_t                           passes;
+} ngx_http_upstream_check_peer_t;
+
+
+static void ngx_http_upstream_check_begin_handler(ngx_event_t *ev);
+static void ngx_http_upstream_check_send_handler(ngx_event_t *wev);
+static void ngx_http_upstream_check_recv_handler(ngx_event_t *rev);
+static ngx_int_t ngx_http_upstream_check_parse_status(
+    ngx_http_upstream_check_peer_t *chk);
+static void ngx_http_upstream_check_finish(ngx_http_upstream_check_peer_t *chk,
+    ngx_uint_t alive);
+
+static void *ngx_http_upstream_check_create_conf(ngx_conf_t *cf);
+static char *ngx_http_upstream_check_init_main_conf(ngx_conf_t *cf,
+    void *conf);
+static char *ngx_http_upstream_check(ngx_conf_t *cf, ngx_command_t *cmd,
+    void *conf);
+static ngx_int_t ngx_http_upstream_check_init_process(ngx_cycle_t *cycle);
+
+
+static ngx_command_t  ngx_http_upstream_health_check_commands[] = {
+
+    { ngx_string("health_check"),
+      NGX_HTTP_UPS_CONF|NGX_CONF_ANY,
+      ngx_http_upstream_check,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      0,
+      NULL },
+
+      ngx_null_command
+};
+
+
+static ngx_http_module_t  ngx_http_upstream_health_check_module_ctx = {
+    NULL,                                  /* preconfiguration */
+    NULL,                                  /* postconfiguration */
+
+    NULL,                                  /* create main configuration */
+    ngx_http_upstream_check_init_main_conf, /* init main configuration */
+
+    ngx_http_upstream_check_create_conf,   /* create server configuration */
+    NULL,                                  /* merge server configuration */
+
+    NULL,                                  /* create location configuration */
+    NULL                                   /* merge location configuration */
+};
+
+
+ngx_module_t  ngx_http_upstream_health_check_module = {
+    NGX_MODULE_V1,
+    &ngx_http_upstream_health_check_module_ctx, /* module context */
+    ngx_http_upstream_health_check_commands, /* module directives */
+    NGX_HTTP_MODULE,                       /* module type */
+    NULL,                                  /* init master */
+    NULL,                                  /* init module */
+    ngx_http_upstream_check_init_process,  /* init process */
+    NULL,                                  /* init thread */
+    NULL,                                  /* exit thread */
+    NULL,                                  /* exit process */
+    NULL,                                  /* exit master */
+    NGX_MODULE_V1_PADDING
+};
+
+
+static void
+ngx_http_upstream_check_begin_handler(ngx_event_t *ev)
+{
+    ngx_int_t                        rc;
+    ngx_connection_t                *c;
+    ngx_http_upstream_check_peer_t  *chk;
+
+    chk = ev->data;
+
+    if (ngx_exiting || ngx_terminate || ngx_quit) {
+        return;
+    }
+
+    ngx_http_upstream_rr_peers_lock(chk->peers);
+
+    /* a peer without a server is not checked */
+
+    if (chk->peer->down & (NGX_HTTP_UPSTREAM_PEER_RESOLVE_DOWN
+                           |NGX_HTTP_UPSTREAM_PEER_FREE))
+    {
+        ngx_http_upstream_rr_peers_unlock(chk->peers);
+        ngx_add_timer(ev, chk->conf->interval);
+        return;
+    }
+
+    ngx_memcpy(chk->sockaddr, chk->peer->sockaddr, chk->peer->socklen);
+    chk->pc.socklen = chk->peer->socklen;
+
+    ngx_http_upstream_rr_peers_unlock(chk->peers);
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ev->log, 0,
+                   "health check begin: %V", &chk->peer->name);
+
+    chk->pc.sockaddr = (struct sockaddr *) chk->sockaddr;
+    chk->pc.name = &chk->peer->name;
+
+    chk->sent = chk->conf->request.data;
+    chk->received = 0;
+
+    rc = ngx_event_connect_peer(&chk->pc);
+
+    if (rc == NGX_ERROR || rc == NGX_DECLINED || rc == NGX_BUSY) {
+        ngx_http_upstream_check_finish(chk, 0);
+        return;
+    }
+
+    /* rc == NGX_OK || rc == NGX_AGAIN */
+
+    c = chk->pc.connection;
+
+    c->data = chk;
+    c->sendfile = 0;
+
+    c->write->handler = ngx_http_upstream_check_send_handler;
+    c->read->handler = ngx_http_upstream_check_recv_handler;
+
+    ngx_add_timer(c->write, chk->conf->timeout);
+
+    if (rc == NGX_OK) {
+        ngx_http_upstream_check_send_handler(c->write);
+    }
+}
+
+
+static void
+ngx_http_upstream_check_send_handler(ngx_event_t *wev)
+{
+    int                              err;
+    ssize_t                          n;
+    socklen_t                        len;
+    ngx_connection_t                *c;
+    ngx_http_upstream_check_peer_t  *chk;
+
+    c = wev->data;
+    chk = c->data;
+
+    if (wev->timedout) {
+        ngx_log_error(NGX_LOG_ERR, c->log, NGX_ETIMEDOUT,
+                      "health check of %V timed out", &chk->peer->name);
+        ngx_http_upstream_check_finish(chk, 0);
+        return;
+    }
+
+    if (chk->sent == chk->conf->request.data) {
+
+        /* test the connection before the first write */
+
+        err = 0;
+        len = sizeof(int);
+
+        if (getsockopt(c->fd, SOL_SOCKET, SO_ERROR, (void *) &err, &len)
+            == -1)
+        {
+            err = ngx_errno;
+        }
+
+        if (err) {
+            ngx_log_error(NGX_LOG_ERR, c->log, err,
+                          "health check connect() to %V failed",
+                          &chk->peer->name);
+            ngx_http_upstream_check_finish(chk, 0);
+            return;
+        }
+
+        if (chk->conf->request.len == 0) {
+            ngx_http_upstream_check_finish(chk, 1);
+            return;
+        }
+    }
+
+    while (chk->sent < chk->conf->request.data + chk->conf->request.len) {
+
+        n = c->send(c, chk->sent,
+                    chk->conf->request.data + chk->conf->request.len
+                    - chk->sent);
+
+        if (n == NGX_ERROR) {
+            ngx_http_upstream_check_finish(chk, 0);
+            return;
+        }
+
+        if (n == NGX_AGAIN) {
+            if (ngx_handle_write_event(wev, 0) != NGX_OK) {
+                ngx_http_upstream_check_finish(chk, 0);
+            }
+
+            return;
+        }
+
+        chk->sent += n;
+    }
+
+    if (wev->timer_set) {
+        ngx_del_timer(wev);
+
+        ngx_add_timer(c->read, chk->conf->timeout);
+    }
+
+    if (c->read->ready) {
+        ngx_http_upstream_check_recv_handler(c->read);
+    }
+}
+
+
+static void
+ngx_http_upstream_check_recv_handler(ngx_event_t *rev)
+{
+    ssize_t                          n;
+    ngx_int_t                        rc;
+    ngx_connection_t                *c;
+    ngx_http_upstream_check_peer_t  *chk;
+
+    c = rev->data;
+    chk = c->data;
+
+    if (rev->timedout) {
+        ngx_log_error(NGX_LOG_ERR, c->log, NGX_ETIMEDOUT,
+                      "health check of %V timed out", &chk->peer->name);
+        ngx_http_upstream_check_finish(chk, 0);
+        return;
+    }
+
+    if (chk->conf->request.len == 0
+        || chk->sent < chk->conf->request.data + chk->conf->request.len)
+    {
+        /* a tcp check or the request is not sent yet */
+        return;
+    }
+
+    while (chk->received < sizeof(chk->status)) {
+
+        n = c->recv(c, chk->status + chk->received,
+                    sizeof(chk->status) - chk->received);
+
+        if (n == NGX_AGAIN) {
+            if (ngx_handle_read_event(rev, 0) != NGX_OK) {
+                ngx_http_upstream_check_finish(chk, 0);
+            }
+
+            return;
+        }
+
+        if (n == NGX_ERROR || n == 0) {
+            ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                          "health check of %V: upstream prematurely "
+                          "closed connection", &chk->peer->name);
+            ngx_http_upstream_check_finish(chk, 0);
+            return;
+        }
+
+        chk->received += n;
+    }
+
+    rc = ngx_http_upstream_check_parse_status(chk);
+
+    if (rc == NGX_ERROR) {
+        ngx_log_error(NGX_LOG_ERR, c->log, 0,
+                      "health check of %V: invalid status line",
+                      &chk->peer->name);
+        ngx_http_upstream_check_finish(chk, 0);
+        return;
+    }
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "health check status: %V %i", &chk->peer->name, rc);
+
+    ngx_http_upstream_check_finish(chk, rc >= 200 && rc < 400);
+}
+
+
+static ngx_int_t
+ngx_http_upstream_check_parse_status(ngx_http_upstream_check_peer_t *chk)
+{
+    u_char  *p;
+
+    p = chk->status;
+
+    if (ngx_strncmp(p, "HTTP/1.", 7) != 0 || p[8] != ' ') {
+        return NGX_ERROR;
+    }
+
+    if (p[9] < '1' || p[9] > '9'
+        || p[10] < '0' || p[10] > '9'
+        || p[11] < '0' || p[11] > '9')
+    {
+        return NGX_ERROR;
+    }
+
+    return (p[9] - '0') * 100 + (p[10] - '0') * 10 + p[11] - '0';
+}
+
+
+static void
+ngx_http_upstream_check_finish(ngx_http_upstream_check_peer_t *chk,
+    ngx_uint_t alive)
+{
+    ngx_http_upstream_rr_peer_t  *peer;
+
+    if (chk->pc.connection) {
+        ngx_close_connection(chk->pc.connection);
+        chk->pc.connection = NULL;
+    }
+
+    peer = chk->peer;
+
+    ngx_http_upstream_rr_peers_lock(chk->peers);
+
+    if (alive) {
+        chk->fails = 0;
+        chk->passes++;
+
+        if ((peer->down & NGX_HTTP_UPSTREAM_PEER_CHECK_DOWN)
+            && chk->passes >= chk->conf->passes)
+        {
+            peer->down &= ~NGX_HTTP_UPSTREAM_PEER_CHECK_DOWN;
+            peer->fails = 0;
+            peer->start = ngx_current_msec;
+
+            ngx_log_error(NGX_LOG_NOTICE, ngx_cycle->log, 0,
+                          "upstream \"%V\" peer %V passed health checks "
+                          "and is up", &chk->upstream->host, &peer->name);
+        }
+
+    } else {
+        chk->passes = 0;
+        chk->fails++;
+
+        if (!(peer->down & NGX_HTTP_UPSTREAM_PEER_CHECK_DOWN)
+            && chk->fails >= chk->conf->fails)
+        {
+            peer->down |= NGX_HTTP_UPSTREAM_PEER_CHECK_DOWN;
+
+            ngx_log_error(NGX_LOG_WARN, ngx_cycle->log, 0,
+                          "upstream \"%V\" peer %V failed health checks "
+                          "and is down", &chk->upstream->host, &peer->name);
+        }
+    }
+
+    ngx_http_upstream_rr_peers_unlock(chk->peers);
+
+    if (ngx_exiting || ngx_terminate || ngx_quit) {
+        return;
+    }
+
+    ngx_add_timer(&chk->event, chk->conf->interval);
+}
+
+
+static ngx_int_t
+ngx_http_upstream_check_init_process(ngx_cycle_t *cycle)
+{
+    ngx_uint_t                           i, n;
+    ngx_http_upstream_rr_peers_t        *peers;
+    ngx_http_upstream_srv_conf_t       **uscfp;
+    ngx_http_upstream_main_conf_t       *umcf;
+    ngx_http_upstream_check_peer_t      *chk;
+    ngx_http_upstream_check_srv_conf_t  *hccf;
+
+    if (ngx_process != NGX_PROCESS_WORKER && ngx_process != NGX_PROCESS_SINGLE)
+    {
+        return NGX_OK;
+    }
+
+    /* the checks are run by the first worker only */
+
+    if (ngx_worker != 0) {
+        return NGX_OK;
+    }
+
+    umcf = ngx_http_cycle_get_module_main_conf(cycle,
+                                               ngx_http_upstream_module);
+
+    if (umcf == NULL) {
+        return NGX_OK;
+    }
+
+    uscfp = umcf->upstreams.elts;
+
+    for (i = 0; i < umcf->upstreams.nelts; i++) {
+
+        if (uscfp[i]->srv_conf == NULL) {
+            continue;
+        }
+
+        hccf = ngx_http_conf_upstream_srv_conf(uscfp[i],
+                                        ngx_http_upstream_health_check_module);
+
+        if (hccf->interval == 0) {
+            continue;
+        }
+
+        for (peers = uscfp[i]->peer.data; peers; peers = peers->next) {
+
+            chk = ngx_pcalloc(cycle->pool, peers->number
+                                      * sizeof(ngx_http_upstream_check_peer_t));
+            if (chk == NULL) {
+                return NGX_ERROR;
+            }
+
+            for (n = 0; n < peers->number; n++, chk++) {
+                chk->peer = &peers->peer[n];
+                chk->peers = peers;
+                chk->upstream = uscfp[i];
+                chk->conf = hccf;
+
+                if (chk->peer->down & NGX_HTTP_UPSTREAM_PEER_CHECK_DOWN) {
+                    chk->fails = hccf->fails;
+                }
+
+                chk->pc.get = ngx_event_get_peer;
+                chk->pc.log = cycle->log;
+                chk->pc.log_error = NGX_ERROR_ERR;
+
+                chk->event.handler = ngx_http_upstream_check_begin_handler;
+                chk->event.data = chk;
+                chk->event.log = cycle->log;
+                chk->event.cancelable = 1;
+
+                /* spread the first checks over the interval */
+
+                ngx_add_timer(&chk->event, ngx_random() % hccf->interval + 1);
+            }
+        }
+    }
+
+    return NGX_OK;
+}
+
+
+static void *
+ngx_http_upstream_check_create_conf(ngx_conf_t *cf)
+{
+    ngx_http_upstream_check_srv_conf_t  *conf;
+
+    conf = ngx_pcalloc(cf->pool, sizeof(ngx_http_upstream_check_srv_conf_t));
+    if (conf == NULL) {
+        return NULL;
+    }
+
+    /*
+     * set by ngx_pcalloc():
+     *
+     *     conf->interval = 0;
+     *     conf->request = { 0, NULL };
+     */
+
+    return conf;
+}
+
+
+static char *
+ngx_http_upstream_check_init_main_conf(ngx_conf_t *cf, void *conf)
+{
+    ngx_uint_t                           i;
+    ngx_http_upstream_srv_conf_t       **uscfp;
+    ngx_http_upstream_main_conf_t       *umcf;
+    ngx_http_upstream_check_srv_conf_t  *hccf;
+
+    umcf = ngx_http_conf_get_module_main_conf(cf, ngx_http_upstream_module);
+
+    uscfp = umcf->upstreams.elts;
+
+    for (i = 0; i < umcf->upstreams.nelts; i++) {
+
+        if (uscfp[i]->srv_conf == NULL) {
+            continue;
+        }
+
+        hccf = ngx_http_conf_upstream_srv_conf(uscfp[i],
+                                        ngx_http_upstream_health_check_module);
+
+        if (hccf->interval == 0) {
+            continue;
+        }
+
+        /* the peer state must be seen by all workers */
+
+        if (uscfp[i]->shm_zone == NULL) {
+            ngx_log_error(NGX_LOG_EMERG, cf->log, 0,
+                          "health check requires \"zone\" in upstream \"%V\" "
+                          "in %s:%ui", &uscfp[i]->host,
+                          uscfp[i]->file_name, uscfp[i]->line);
+            return NGX_CONF_ERROR;
+        }
+    }
+
+    return NGX_CONF_OK;
+}
+
+
+static char *
+ngx_http_upstream_check(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
+{
+    ngx_http_upstream_check_srv_conf_t  *hccf = conf;
+
+    u_char                        *p;
+    size_t                         len;
+    ngx_int_t                      n;
+    ngx_str_t                     *value, s, uri;
+    ngx_uint_t                     i, tcp;
+    ngx_http_upstream_srv_conf_t  *uscf;
+
+    if (hccf->interval) {
+        return "is duplicate";
+    }
+
+    uscf = ngx_http_conf_get_module_srv_conf(cf, ngx_http_upstream_module);
+
+    hccf->interval = 5000;
+    hccf->timeout = 1000;
+    hccf->fails = 1;
+    hccf->passes = 1;
+
+    ngx_str_set(&uri, "/");
+    tcp = 0;
+
+    value = cf->args->elts;
+
+    for (i = 1; i < cf->args->nelts; i++) {
+
+        if (ngx_strncmp(value[i].data, "interval=", 9) == 0) {
+
+            s.len = value[i].len - 9;
+            s.data = &value[i].data[9];
+
+            n = ngx_parse_time(&s, 0);
+            if (n == NGX_ERROR || n == 0) {
+                goto invalid;
+            }
+
+            hccf->interval = (ngx_msec_t) n;
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "timeout=", 8) == 0) {
+
+            s.len = value[i].len - 8;
+            s.data = &value[i].data[8];
+
+            n = ngx_parse_time(&s, 0);
+            if (n == NGX_ERROR || n == 0) {
+                goto invalid;
+            }
+
+            hccf->timeout = (ngx_msec_t) n;
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "fails=", 6) == 0) {
+
+            n = ngx_atoi(&value[i].data[6], value[i].len - 6);
+            if (n == NGX_ERROR || n == 0) {
+                goto invalid;
+            }
+
+            hccf->fails = n;
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "passes=", 7) == 0) {
+
+            n = ngx_atoi(&value[i].data[7], value[i].len - 7);
+            if (n == NGX_ERROR || n == 0) {
+                goto invalid;
+            }
+
+            hccf->passes = n;
+            continue;
+        }
+
+        if (ngx_strcmp(value[i].data, "type=tcp") == 0) {
+            tcp = 1;
+            continue;
+        }
+
+        if (ngx_strcmp(value[i].data, "type=http") == 0) {
+            tcp = 0;
+            continue;
+        }
+
+        if (ngx_strncmp(value[i].data, "uri=", 4) == 0) {
+
+            uri.len = value[i].len - 4;
+            uri.data = &value[i].data[4];
+
+            if (uri.len == 0 || uri.data[0] != '/') {
+                goto invalid;
+            }
+
+            continue;
+        }
+
+        goto invalid;
+    }
+
+    if (tcp) {
+        return NGX_CONF_OK;
+    }
+
+    len = sizeof("GET  HTTP/1.0" CRLF "Host: " CRLF CRLF) - 1
+          + uri.len + uscf->host.len;
+
+    p = ngx_pnalloc(cf->pool, len);
+    if (p == NULL) {
+        return NGX_CONF_ERROR;
+    }
+
+    hccf->request.data = p;
+    hccf->request.len = ngx_sprintf(p, "GET %V HTTP/1.0" CRLF
+                                       "Host: %V" CRLF CRLF,
+                                    &uri, &uscf->host)
+                        - p;
+
+    return NGX_CONF_OK;
+
+invalid:
+
+    ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                       "invalid parameter \"%V\"", &value[i]);
+
+    return NGX_CONF_ERROR;
+}
@@ -139,10 +139,11 @@ ngx_http_upstream_get_ip_hash_peer(ngx_peer_connection_t *pc, void *data)
 {
     ngx_http_upstream_ip_hash_peer_data_t  *iphp = data;
 
-    time_t                        now;
-    uintptr_t                     m;
-    ngx_uint_t                    i, n, p, hash;
-    ngx_http_upstream_rr_peer_t  *peer;
+    time_t                         now;
+    uintptr_t                      m;
+    ngx_uint_t                     i, n, p, k, hash, number;
+    ngx_http_upstream_rr_peer_t   *peer;
+    ngx_http_upstream_rr_peers_t  *peers;
 
     ngx_log_debug1(NGX_LOG_DEBUG_HTTP, pc->log, 0,
                    "get ip hash peer, try: %ui", pc->tries);
@@ -159,6 +160,28 @@ ngx_http_upstream_get_ip_hash_peer(ngx_peer_connection_t *pc, void *data)
     pc->connection = NULL;
 
     hash = iphp->hash;
+    peers = iphp->rrp.peers;
+
+    ngx_http_upstream_rr_peers_lock(peers);
+
+    /*
+     * the address is hashed over the peers that hold a server only,
+     * so the spare slots of the resolved servers and of upstream_conf
+     * do not change the mapping
+     */
+
+    number = 0;
+
+    for (i = 0; i < peers->number; i++) {
+        if (!(peers->peer[i].down & NGX_HTTP_UPSTREAM_PEER_UNUSED)) {
+            number++;
+        }
+    }
+
+    if (number == 0) {
+        ngx_http_upstream_rr_peers_unlock(peers);
+        return iphp->get_rr_peer(pc, &iphp->rrp);
+    }
 
     for ( ;; ) {
 
@@ -166,7 +189,15 @@ ngx_http_upstream_get_ip_hash_peer(ngx_peer_connection_t *pc, void *data)
             hash = (hash * 113 + iphp->addr[i]) % 6271;
         }
 
-        p = hash % iphp->rrp.peers->number;
+        k = hash % number;
+
+        for (p = 0; /* void */ ; p++) {
+            if (!(peers->peer[p].down & NGX_HTTP_UPSTREAM_PEER_UNUSED)
+                && k-- == 0)
+            {
+                break;
+            }
+        }
 
         n = p / (8 * sizeof(uintptr_t));
         m = (uintptr_t) 1 << p % (8 * sizeof(uintptr_t));
@@ -176,9 +207,7 @@ ngx_http_upstream_get_ip_hash_peer(ngx_peer_connection_t *pc, void *data)
             ngx_log_debug2(NGX_LOG_DEBUG_HTTP, pc->log, 0,
                            "get ip hash peer, hash: %ui %04XA", p, m);
 
-            peer = &iphp->rrp.peers->peer[p];
-
-            /* ngx_lock_mutex(iphp->rrp.peers->mutex); */
+            peer = &peers->peer[p];
 
             if (!peer->down) {
 
@@ -194,23 +223,24 @@ ngx_http_upstream_get_ip_hash_peer(ngx_peer_connection_t *pc, void *data)
 
             iphp->rrp.tried[n] |= m;
 
-            /* ngx_unlock_mutex(iphp->rrp.peers->mutex); */
-
             pc->tries--;
         }
 
         if (++iphp->tries >= 20) {
+            ngx_http_upstream_rr_peers_unlock(peers);
             return iphp->get_rr_peer(pc, &iphp->rrp);
         }
     }
 
     iphp->rrp.current = p;
 
+    peer->conns++;
+
     pc->sockaddr = peer->sockaddr;
     pc->socklen = peer->socklen;
     pc->name = &peer->name;
 
-    /* ngx_unlock_mutex(iphp->rrp.peers->mutex); */
+    ngx_http_upstream_rr_peers_unlock(peers);
 
     iphp->rrp.tried[n] |= m;
     iphp->hash = hash;
@@ -0,0 +1,373 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+typedef struct {
+    ngx_uint_t                         two;
+} ngx_http_upstream_random_srv_conf_t;
+
+
+static ngx_int_t ngx_http_upstream_init_random_peer(ngx_http_request_t *r,
+    ngx_http_upstream_srv_conf_t *us);
+static ngx_int_t ngx_http_upstream_get_random_peer(ngx_peer_connection_t *pc,
+    void *data);
+static ngx_int_t ngx_http_upstream_get_random2_peer(ngx_peer_connection_t *pc,
+    void *data);
+static ngx_uint_t ngx_http_upstream_peek_random_peer(
+    ngx_http_upstream_rr_peers_t *peers);
+static void *ngx_http_upstream_random_create_conf(ngx_conf_t *cf);
+static char *ngx_http_upstream_random(ngx_conf_t *cf, ngx_command_t *cmd,
+    void *conf);
+
+
+static ngx_command_t  ngx_http_upstream_random_commands[] = {
+
+    { ngx_string("random"),
+      NGX_HTTP_UPS_CONF|NGX_CONF_NOARGS|NGX_CONF_TAKE12,
+      ngx_http_upstream_random,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      0,
+      NULL },
+
+      ngx_null_command
+};
+
+
+static ngx_http_module_t  ngx_http_upstream_random_module_ctx = {
+    NULL,                                  /* preconfiguration */
+    NULL,                                  /* postconfiguration */
+
+    NULL,                                  /* create main configuration */
+    NULL,                                  /* init main configuration */
+
+    ngx_http_upstream_random_create_conf,  /* create server configuration */
+    NULL,                                  /* merge server configuration */
+
+    NULL,                                  /* create location configuration */
+    NULL                                   /* merge location configuration */
+};
+
+
+ngx_module_t  ngx_http_upstream_random_module = {
+    NGX_MODULE_V1,
+    &ngx_http_upstream_random_module_ctx,  /* module context */
+    ngx_http_upstream_random_commands,     /* module directives */
+    NGX_HTTP_MODULE,                       /* module type */
+    NULL,                                  /* init master */
+    NULL,                                  /* init module */
+    NULL,                                  /* init process */
+    NULL,                                  /* init thread */
+    NULL,                                  /* exit thread */
+    NULL,                                  /* exit process */
+    NULL,                                  /* exit master */
+    NGX_MODULE_V1_PADDING
+};
+
+
+ngx_int_t
+ngx_http_upstream_init_random(ngx_conf_t *cf, ngx_http_upstream_srv_conf_t *us)
+{
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, cf->log, 0, "init random");
+
+    if (ngx_http_upstream_init_round_robin(cf, us) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    us->peer.init = ngx_http_upstream_init_random_peer;
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_init_random_peer(ngx_http_request_t *r,
+    ngx_http_upstream_srv_conf_t *us)
+{
+    ngx_http_upstream_random_srv_conf_t  *rcf;
+
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                   "init random peer");
+
+    if (ngx_http_upstream_init_round_robin_peer(r, us) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    rcf = ngx_http_conf_upstream_srv_conf(us, ngx_http_upstream_random_module);
+
+    if (rcf->two) {
+        r->upstream->peer.get = ngx_http_upstream_get_random2_peer;
+
+    } else {
+        r->upstream->peer.get = ngx_http_upstream_get_random_peer;
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_get_random_peer(ngx_peer_connection_t *pc, void *data)
+{
+    ngx_http_upstream_rr_peer_data_t  *rrp = data;
+
+    time_t                         now;
+    uintptr_t                      m;
+    ngx_uint_t                     i, n, x;
+    ngx_http_upstream_rr_peer_t   *peer;
+    ngx_http_upstream_rr_peers_t  *peers;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                   "get random peer, try: %ui", pc->tries);
+
+    if (rrp->peers->single) {
+        return ngx_http_upstream_get_round_robin_peer(pc, rrp);
+    }
+
+    pc->cached = 0;
+    pc->connection = NULL;
+
+    now = ngx_time();
+
+    peers = rrp->peers;
+
+    ngx_http_upstream_rr_peers_lock(peers);
+
+    for (i = 0; /* void */ ; i++) {
+
+        x = ngx_http_upstream_peek_random_peer(peers);
+
+        n = x / (8 * sizeof(uintptr_t));
+        m = (uintptr_t) 1 << x % (8 * sizeof(uintptr_t));
+
+        peer = &peers->peer[x];
+
+        if (!(rrp->tried[n] & m) && !peer->down) {
+
+            if (peer->max_fails == 0 || peer->fails < peer->max_fails) {
+                break;
+            }
+
+            if (now - peer->accessed > peer->fail_timeout) {
+                peer->fails = 0;
+                break;
+            }
+        }
+
+        if (i >= 20) {
+            ngx_http_upstream_rr_peers_unlock(peers);
+            return ngx_http_upstream_get_round_robin_peer(pc, rrp);
+        }
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                   "get random peer, current: %ui", x);
+
+    rrp->current = x;
+    rrp->tried[n] |= m;
+
+    peer->conns++;
+
+    pc->sockaddr = peer->sockaddr;
+    pc->socklen = peer->socklen;
+    pc->name = &peer->name;
+
+    ngx_http_upstream_rr_peers_unlock(peers);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_get_random2_peer(ngx_peer_connection_t *pc, void *data)
+{
+    ngx_http_upstream_rr_peer_data_t  *rrp = data;
+
+    time_t                         now;
+    uintptr_t                      m;
+    ngx_uint_t                     i, n, x, y;
+    ngx_http_upstream_rr_peer_t   *peer, *prev;
+    ngx_http_upstream_rr_peers_t  *peers;
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                   "get random2 peer, try: %ui", pc->tries);
+
+    if (rrp->peers->single) {
+        return ngx_http_upstream_get_round_robin_peer(pc, rrp);
+    }
+
+    pc->cached = 0;
+    pc->connection = NULL;
+
+    now = ngx_time();
+
+    peers = rrp->peers;
+
+    ngx_http_upstream_rr_peers_lock(peers);
+
+    prev = NULL;
+
+#if (NGX_SUPPRESS_WARN)
+    y = 0;
+#endif
+
+    /* pick two distinct live peers, then use the less loaded one */
+
+    for (i = 0; /* void */ ; i++) {
+
+        x = ngx_http_upstream_peek_random_peer(peers);
+
+        n = x / (8 * sizeof(uintptr_t));
+        m = (uintptr_t) 1 << x % (8 * sizeof(uintptr_t));
+
+        peer = &peers->peer[x];
+
+        if (!(rrp->tried[n] & m) && !peer->down && peer != prev) {
+
+            if (peer->max_fails == 0
+                || peer->fails < peer->max_fails
+                || now - peer->accessed > peer->fail_timeout)
+            {
+                if (prev == NULL) {
+                    prev = peer;
+                    y = x;
+
+                } else {
+                    break;
+                }
+            }
+        }
+
+        if (i >= 20) {
+            ngx_http_upstream_rr_peers_unlock(peers);
+            return ngx_http_upstream_get_round_robin_peer(pc, rrp);
+        }
+    }
+
+    if (peer->conns * prev->weight > prev->conns * peer->weight) {
+        peer = prev;
+        x = y;
+
+        n = x / (8 * sizeof(uintptr_t));
+        m = (uintptr_t) 1 << x % (8 * sizeof(uintptr_t));
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                   "get random2 peer, current: %ui", x);
+
+    if (peer->max_fails && peer->fails >= peer->max_fails) {
+        peer->fails = 0;
+    }
+
+    rrp->current = x;
+    rrp->tried[n] |= m;
+
+    peer->conns++;
+
+    pc->sockaddr = peer->sockaddr;
+    pc->socklen = peer->socklen;
+    pc->name = &peer->name;
+
+    ngx_http_upstream_rr_peers_unlock(peers);
+
+    return NGX_OK;
+}
+
+
+static ngx_uint_t
+ngx_http_upstream_peek_random_peer(ngx_http_upstream_rr_peers_t *peers)
+{
+    ngx_uint_t  i, x, total;
+
+    total = 0;
+
+    for (i = 0; i < peers->number; i++) {
+        total += peers->peer[i].weight;
+    }
+
+    if (total == 0) {
+        return ngx_random() % peers->number;
+    }
+
+    x = ngx_random() % total;
+
+    for (i = 0; /* void */ ; i++) {
+        if (x < (ngx_uint_t) peers->peer[i].weight) {
+            return i;
+        }
+
+        x -= peers->peer[i].weight;
+    }
+}
+
+
+static void *
+ngx_http_upstream_random_create_conf(ngx_conf_t *cf)
+{
+    ngx_http_upstream_random_srv_conf_t  *conf;
+
+    conf = ngx_pcalloc(cf->pool, sizeof(ngx_http_upstream_random_srv_conf_t));
+    if (conf == NULL) {
+        return NULL;
+    }
+
+    /*
+     * set by ngx_pcalloc():
+     *
+     *     conf->two = 0;
+     */
+
+    return conf;
+}
+
+
+static char *
+ngx_http_upstream_random(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
+{
+    ngx_http_upstream_random_srv_conf_t  *rcf = conf;
+
+    ngx_str_t                     *value;
+    ngx_http_upstream_srv_conf_t  *uscf;
+
+    uscf = ngx_http_conf_get_module_srv_conf(cf, ngx_http_upstream_module);
+
+    value = cf->args->elts;
+
+    if (cf->args->nelts > 1) {
+
+        if (ngx_strcmp(value[1].data, "two") != 0) {
+            ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                               "invalid parameter \"%V\"", &value[1]);
+            return NGX_CONF_ERROR;
+        }
+
+        /* least_conn is the only method to compare the two peers */
+
+        if (cf->args->nelts > 2
+            && ngx_strcmp(value[2].data, "least_conn") != 0)
+        {
+            ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                               "invalid parameter \"%V\"", &value[2]);
+            return NGX_CONF_ERROR;
+        }
+
+        rcf->two = 1;
+    }
+
+    uscf->peer.init_upstream = ngx_http_upstream_init_random;
+
+    uscf->flags = NGX_HTTP_UPSTREAM_CREATE
+                  |NGX_HTTP_UPSTREAM_WEIGHT
+                  |NGX_HTTP_UPSTREAM_MAX_FAILS
+                  |NGX_HTTP_UPSTREAM_FAIL_TIMEOUT
+                  |NGX_HTTP_UPSTREAM_DOWN;
+
+    return NGX_CONF_OK;
+}
@@ -0,0 +1,600 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+/* the delay before a name is resolved again after a failure */
+
+#define NGX_HTTP_UPSTREAM_ZONE_RESOLVE_RETRY  10000
+
+
+typedef struct {
+    ngx_event_t                      event;
+
+    ngx_http_upstream_server_t      *server;
+    ngx_http_upstream_rr_peers_t    *peers;
+    ngx_http_upstream_srv_conf_t    *upstream;
+
+    ngx_resolver_t                  *resolver;
+    ngx_msec_t                       timeout;
+} ngx_http_upstream_zone_resolve_t;
+
+
+static char *ngx_http_upstream_zone(ngx_conf_t *cf, ngx_command_t *cmd,
+    void *conf);
+static ngx_int_t ngx_http_upstream_init_zone(ngx_shm_zone_t *shm_zone,
+    void *data);
+static ngx_http_upstream_rr_peers_t *ngx_http_upstream_zone_copy_peers(
+    ngx_slab_pool_t *shpool, ngx_http_upstream_rr_peers_t *peers);
+static ngx_int_t ngx_http_upstream_zone_init_process(ngx_cycle_t *cycle);
+static void ngx_http_upstream_zone_resolve_handler(ngx_event_t *ev);
+static void ngx_http_upstream_zone_resolved(ngx_resolver_ctx_t *ctx);
+static void ngx_http_upstream_zone_update_peers(
+    ngx_http_upstream_zone_resolve_t *rs, in_addr_t *addrs,
+    ngx_uint_t naddrs);
+
+
+static ngx_command_t  ngx_http_upstream_zone_commands[] = {
+
+    { ngx_string("zone"),
+      NGX_HTTP_UPS_CONF|NGX_CONF_TAKE123,
+      ngx_http_upstream_zone,
+      0,
+      0,
+      NULL },
+
+      ngx_null_command
+};
+
+
+static ngx_http_module_t  ngx_http_upstream_zone_module_ctx = {
+    NULL,                                  /* preconfiguration */
+    NULL,                                  /* postconfiguration */
+
+    NULL,                                  /* create main configuration */
+    NULL,                                  /* init main configuration */
+
+    NULL,                                  /* create server configuration */
+    NULL,                                  /* merge server configuration */
+
+    NULL,                                  /* create location configuration */
+    NULL                                   /* merge location configuration */
+};
+
+
+ngx_module_t  ngx_http_upstream_zone_module = {
+    NGX_MODULE_V1,
+    &ngx_http_upstream_zone_module_ctx,    /* module context */
+    ngx_http_upstream_zone_commands,       /* module directives */
+    NGX_HTTP_MODULE,                       /* module type */
+    NULL,                                  /* init master */
+    NULL,                                  /* init module */
+    ngx_http_upstream_zone_init_process,   /* init process */
+    NULL,                                  /* init thread */
+    NULL,                                  /* exit thread */
+    NULL,                                  /* exit process */
+    NULL,                                  /* exit master */
+    NGX_MODULE_V1_PADDING
+};
+
+
+static char *
+ngx_http_upstream_zone(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
+{
+    ssize_t                         size;
+    ngx_int_t                       n;
+    ngx_str_t                      *value, s;
+    ngx_uint_t                      i;
+    ngx_http_upstream_srv_conf_t   *uscf;
+    ngx_http_upstream_main_conf_t  *umcf;
+
+    uscf = ngx_http_conf_get_module_srv_conf(cf, ngx_http_upstream_module);
+    umcf = ngx_http_conf_get_module_main_conf(cf, ngx_http_upstream_module);
+
+    if (uscf->shm_zone) {
+        return "is duplicate";
+    }
+
+    value = cf->args->elts;
+
+    if (!value[1].len) {
+        ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                           "invalid zone name \"%V\"", &value[1]);
+        return NGX_CONF_ERROR;
+    }
+
+    size = 0;
+
+    for (i = 2; i < cf->args->nelts; i++) {
+
+        if (ngx_strncmp(value[i].data, "spare=", 6) == 0) {
+
+            s.len = value[i].len - 6;
+            s.data = value[i].data + 6;
+
+            n = ngx_atoi(s.data, s.len);
+
+            if (n == NGX_ERROR) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid parameter \"%V\"", &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            uscf->spare = n;
+
+            continue;
+        }
+
+        if (i != 2) {
+            ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                               "invalid parameter \"%V\"", &value[i]);
+            return NGX_CONF_ERROR;
+        }
+
+        size = ngx_parse_size(&value[i]);
+
+        if (size == NGX_ERROR) {
+            ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                               "invalid zone size \"%V\"", &value[i]);
+            return NGX_CONF_ERROR;
+        }
+
+        if (size < (ssize_t) (8 * ngx_pagesize)) {
+            ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                               "zone \"%V\" is too small", &value[1]);
+            return NGX_CONF_ERROR;
+        }
+    }
+
+    uscf->shm_zone = ngx_shared_memory_add(cf, &value[1], size,
+                                           &ngx_http_upstream_module);
+    if (uscf->shm_zone == NULL) {
+        return NGX_CONF_ERROR;
+    }
+
+    uscf->shm_zone->init = ngx_http_upstream_init_zone;
+    uscf->shm_zone->data = umcf;
+
+    /*
+     * the peers are copied from the configuration on every start,
+     * so a zone left from the previous cycle is of no use
+     */
+
+    uscf->shm_zone->noreuse = 1;
+
+    return NGX_CONF_OK;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_init_zone(ngx_shm_zone_t *shm_zone, void *data)
+{
+    size_t                          len;
+    ngx_uint_t                      i;
+    ngx_slab_pool_t                *shpool;
+    ngx_http_upstream_rr_peers_t   *peers, **peersp;
+    ngx_http_upstream_srv_conf_t   *uscf, **uscfp;
+    ngx_http_upstream_main_conf_t  *umcf;
+
+    shpool = (ngx_slab_pool_t *) shm_zone->shm.addr;
+    umcf = shm_zone->data;
+    uscfp = umcf->upstreams.elts;
+
+    len = sizeof(" in upstream zone \"\"") + shm_zone->shm.name.len;
+
+    shpool->log_ctx = ngx_slab_alloc(shpool, len);
+    if (shpool->log_ctx == NULL) {
+        return NGX_ERROR;
+    }
+
+    ngx_sprintf(shpool->log_ctx, " in upstream zone \"%V\"%Z",
+                &shm_zone->shm.name);
+
+    /* copy peers to shared memory */
+
+    peersp = (ngx_http_upstream_rr_peers_t **) (void *) &shpool->data;
+
+    for (i = 0; i < umcf->upstreams.nelts; i++) {
+        uscf = uscfp[i];
+
+        if (uscf->shm_zone != shm_zone) {
+            continue;
+        }
+
+        peers = ngx_http_upstream_zone_copy_peers(shpool, uscf->peer.data);
+        if (peers == NULL) {
+            return NGX_ERROR;
+        }
+
+        *peersp = peers;
+        peersp = &peers->zone_next;
+
+        uscf->peer.data = peers;
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_http_upstream_rr_peers_t *
+ngx_http_upstream_zone_copy_peers(ngx_slab_pool_t *shpool,
+    ngx_http_upstream_rr_peers_t *peers)
+{
+    size_t                         size;
+    u_char                        *p;
+    ngx_uint_t                     i;
+    ngx_http_upstream_rr_peer_t   *peer;
+    ngx_http_upstream_rr_peers_t  *copy, *backup;
+
+    backup = NULL;
+
+    if (peers->next) {
+        backup = ngx_http_upstream_zone_copy_peers(shpool, peers->next);
+        if (backup == NULL) {
+            return NULL;
+        }
+    }
+
+    size = sizeof(ngx_http_upstream_rr_peers_t)
+           + sizeof(ngx_http_upstream_rr_peer_t) * (peers->number - 1);
+
+    copy = ngx_slab_alloc(shpool, size);
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    ngx_memcpy(copy, peers, size);
+
+    copy->shpool = shpool;
+    copy->lock = 0;
+    copy->next = backup;
+    copy->zone_next = NULL;
+
+    for (i = 0; i < copy->number; i++) {
+        peer = &copy->peer[i];
+
+        /*
+         * the address is changed in place when a name is resolved again
+         * or a server is added at run time, so there is room for any one
+         */
+
+        p = ngx_slab_alloc(shpool, NGX_SOCKADDRLEN + NGX_SOCKADDR_STRLEN);
+        if (p == NULL) {
+            return NULL;
+        }
+
+        /* a free peer has no address yet */
+
+        if (peer->sockaddr) {
+            ngx_memcpy(p, peer->sockaddr, peer->socklen);
+            ngx_memcpy(p + NGX_SOCKADDRLEN, peer->name.data, peer->name.len);
+        }
+
+        peer->sockaddr = (struct sockaddr *) p;
+        peer->name.data = p + NGX_SOCKADDRLEN;
+
+#if (NGX_HTTP_SSL)
+        peer->ssl_session = NULL;
+#endif
+    }
+
+    return copy;
+}
+
+
+static ngx_int_t
+ngx_http_upstream_zone_init_process(ngx_cycle_t *cycle)
+{
+    ngx_uint_t                          i, j;
+    ngx_http_conf_ctx_t                *ctx;
+    ngx_http_core_loc_conf_t           *clcf;
+    ngx_http_upstream_server_t         *server;
+    ngx_http_upstream_rr_peers_t       *peers;
+    ngx_http_upstream_srv_conf_t      **uscfp;
+    ngx_http_upstream_main_conf_t      *umcf;
+    ngx_http_upstream_zone_resolve_t   *rs;
+
+    if (ngx_process != NGX_PROCESS_WORKER && ngx_process != NGX_PROCESS_SINGLE)
+    {
+        return NGX_OK;
+    }
+
+    /* the names are resolved by the first worker only */
+
+    if (ngx_worker != 0) {
+        return NGX_OK;
+    }
+
+    umcf = ngx_http_cycle_get_module_main_conf(cycle,
+                                               ngx_http_upstream_module);
+
+    if (umcf == NULL) {
+        return NGX_OK;
+    }
+
+    ctx = (ngx_http_conf_ctx_t *) cycle->conf_ctx[ngx_http_module.index];
+    clcf = ctx->loc_conf[ngx_http_core_module.ctx_index];
+
+    uscfp = umcf->upstreams.elts;
+
+    for (i = 0; i < umcf->upstreams.nelts; i++) {
+
+        if (uscfp[i]->shm_zone == NULL || uscfp[i]->servers == NULL) {
+            continue;
+        }
+
+        server = uscfp[i]->servers->elts;
+
+        for (j = 0; j < uscfp[i]->servers->nelts; j++) {
+
+            if (!server[j].resolve) {
+                continue;
+            }
+
+            peers = uscfp[i]->peer.data;
+
+            if (server[j].backup) {
+                peers = peers->next;
+            }
+
+            rs = ngx_pcalloc(cycle->pool,
+                             sizeof(ngx_http_upstream_zone_resolve_t));
+            if (rs == NULL) {
+                return NGX_ERROR;
+            }
+
+            rs->server = &server[j];
+            rs->peers = peers;
+            rs->upstream = uscfp[i];
+            rs->resolver = clcf->resolver;
+            rs->timeout = (clcf->resolver_timeout == NGX_CONF_UNSET_MSEC)
+                          ? 30000 : clcf->resolver_timeout;
+
+            rs->event.handler = ngx_http_upstream_zone_resolve_handler;
+            rs->event.data = rs;
+            rs->event.log = cycle->log;
+            rs->event.cancelable = 1;
+
+            /* the TTL of the addresses found at startup is not known */
+
+            ngx_add_timer(&rs->event, 1);
+        }
+    }
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_http_upstream_zone_resolve_handler(ngx_event_t *ev)
+{
+    ngx_resolver_ctx_t                *ctx;
+    ngx_http_upstream_zone_resolve_t  *rs;
+
+    rs = ev->data;
+
+    if (ngx_exiting || ngx_terminate || ngx_quit) {
+        return;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ev->log, 0,
+                   "upstream resolve: \"%V\"", &rs->server->host);
+
+    if (rs->resolver == NULL) {
+        goto no_resolver;
+    }
+
+    ctx = ngx_resolve_start(rs->resolver, NULL);
+    if (ctx == NULL) {
+        goto failed;
+    }
+
+    if (ctx == NGX_NO_RESOLVER) {
+        goto no_resolver;
+    }
+
+    ctx->name = rs->server->host;
+    ctx->type = NGX_RESOLVE_A;
+    ctx->handler = ngx_http_upstream_zone_resolved;
+    ctx->data = rs;
+    ctx->timeout = rs->timeout;
+
+    if (ngx_resolve_name(ctx) == NGX_OK) {
+        return;
+    }
+
+failed:
+
+    ngx_add_timer(ev, NGX_HTTP_UPSTREAM_ZONE_RESOLVE_RETRY);
+    return;
+
+no_resolver:
+
+    ngx_log_error(NGX_LOG_ERR, ev->log, 0,
+                  "no resolver defined to resolve %V in upstream \"%V\"",
+                  &rs->server->host, &rs->upstream->host);
+}
+
+
+static void
+ngx_http_upstream_zone_resolved(ngx_resolver_ctx_t *ctx)
+{
+    time_t                             valid;
+    ngx_msec_t                         timer;
+    ngx_http_upstream_zone_resolve_t  *rs;
+
+    rs = ctx->data;
+
+    if (ctx->state) {
+        ngx_log_error(NGX_LOG_ERR, rs->event.log, 0,
+                      "%V could not be resolved (%i: %s), "
+                      "upstream \"%V\" keeps the known addresses",
+                      &ctx->name, ctx->state,
+                      ngx_resolver_strerror(ctx->state),
+                      &rs->upstream->host);
+
+        timer = NGX_HTTP_UPSTREAM_ZONE_RESOLVE_RETRY;
+
+    } else {
+        ngx_http_upstream_zone_update_peers(rs, ctx->addrs, ctx->naddrs);
+
+        /* ask again once the cached answer is stale */
+
+        valid = ctx->valid - ngx_time();
+
+        timer = (valid > 0) ? (ngx_msec_t) valid * 1000 + 1000 : 1000;
+    }
+
+    ngx_resolve_name_done(ctx);
+
+    if (ngx_exiting || ngx_terminate || ngx_quit) {
+        return;
+    }
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, rs->event.log, 0,
+                   "upstream resolve: \"%V\" again in %M",
+                   &rs->server->host, timer);
+
+    ngx_add_timer(&rs->event, timer);
+}
+
+
+static void
+ngx_http_upstream_zone_update_peers(ngx_http_upstream_zone_resolve_t *rs,
+    in_addr_t *addrs, ngx_uint_t naddrs)
+{
+    ngx_uint_t                     i, j;
+    struct sockaddr_in            *sin;
+    ngx_http_upstream_rr_peer_t   *peer, *spare;
+    ngx_http_upstream_rr_peers_t  *peers;
+
+    /*
+     * the peers are also changed by the health checks and the upstream_conf
+     * handler in any worker, so the whole update is done under the lock;
+     * it runs only when the answer changes.  A peer gets a new address only
+     * when it is down and not in use by any worker
+     */
+
+    peers = rs->peers;
+
+    ngx_http_upstream_rr_peers_lock(peers);
+
+    for (i = 0; i < peers->number; i++) {
+        peer = &peers->peer[i];
+
+        if (peer->server != rs->server
+            || (peer->down & NGX_HTTP_UPSTREAM_PEER_RESOLVE_DOWN))
+        {
+            continue;
+        }
+
+        sin = (struct sockaddr_in *) peer->sockaddr;
+
+        for (j = 0; j < naddrs; j++) {
+            if (sin->sin_addr.s_addr == addrs[j]) {
+                break;
+            }
+        }
+
+        if (j < naddrs) {
+            continue;
+        }
+
+        /* like a server marked as down, the unused peer has no weight */
+
+        peer->down |= NGX_HTTP_UPSTREAM_PEER_RESOLVE_DOWN;
+        peer->weight = 0;
+        peer->current_weight = 0;
+
+        ngx_log_error(NGX_LOG_NOTICE, rs->event.log, 0,
+                      "upstream \"%V\" server %V: address %V removed",
+                      &rs->upstream->host, &rs->server->host, &peer->name);
+    }
+
+    for (j = 0; j < naddrs; j++) {
+
+        spare = NULL;
+
+        for (i = 0; i < peers->number; i++) {
+            peer = &peers->peer[i];
+
+            if (peer->server != rs->server) {
+                continue;
+            }
+
+            sin = (struct sockaddr_in *) peer->sockaddr;
+
+            if (sin->sin_addr.s_addr != addrs[j]) {
+                continue;
+            }
+
+            if (!(peer->down & NGX_HTTP_UPSTREAM_PEER_RESOLVE_DOWN)) {
+                break;
+            }
+
+            /* the address is back, its old peer is taken again */
+
+            spare = peer;
+        }
+
+        if (i < peers->number) {
+            continue;
+        }
+
+        for (i = 0; spare == NULL && i < peers->number; i++) {
+            peer = &peers->peer[i];
+
+            if (peer->server != rs->server
+                || !(peer->down & NGX_HTTP_UPSTREAM_PEER_RESOLVE_DOWN)
+                || peer->conns)
+            {
+                continue;
+            }
+
+            sin = (struct sockaddr_in *) peer->sockaddr;
+
+            ngx_memzero(sin, sizeof(struct sockaddr_in));
+
+            sin->sin_family = AF_INET;
+            sin->sin_port = htons(rs->server->port);
+            sin->sin_addr.s_addr = addrs[j];
+
+            peer->socklen = sizeof(struct sockaddr_in);
+            peer->name.len = ngx_sock_ntop(peer->sockaddr, peer->name.data,
+                                           NGX_SOCKADDR_STRLEN, 1);
+
+            spare = peer;
+        }
+
+        if (spare) {
+            spare->down &= ~NGX_HTTP_UPSTREAM_PEER_RESOLVE_DOWN;
+            spare->weight = rs->server->down ? 0 : rs->server->weight;
+            spare->current_weight = 0;
+            spare->fails = 0;
+
+            /* a new address is a cold server, ramp it up on slow start */
+            spare->start = ngx_current_msec;
+        }
+
+        if (spare == NULL) {
+            ngx_log_error(NGX_LOG_WARN, rs->event.log, 0,
+                          "upstream \"%V\" server %V: no free peer "
+                          "for a new address", &rs->upstream->host,
+                          &rs->server->host);
+            continue;
+        }
+
+        ngx_log_error(NGX_LOG_NOTICE, rs->event.log, 0,
+                      "upstream \"%V\" server %V: address %V added",
+                      &rs->upstream->host, &rs->server->host, &spare->name);
+    }
+
+    ngx_http_upstream_rr_peers_unlock(peers);
+}
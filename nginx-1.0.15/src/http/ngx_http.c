@@ -35,6 +35,10 @@ static char *ngx_http_merge_locations(ngx_conf_t *cf,
     ngx_uint_t ctx_index);
 static ngx_int_t ngx_http_init_locations(ngx_conf_t *cf,
     ngx_http_core_srv_conf_t *cscf, ngx_http_core_loc_conf_t *pclcf);
+#if (NGX_PCRE)
+static ngx_int_t ngx_http_init_regex_matcher(ngx_conf_t *cf,
+    ngx_http_core_loc_conf_t *pclcf, ngx_uint_t n);
+#endif
 static ngx_int_t ngx_http_init_static_location_trees(ngx_conf_t *cf,
     ngx_http_core_loc_conf_t *pclcf);
 static ngx_int_t ngx_http_cmp_locations(const ngx_queue_t *one,
@@ -803,6 +807,10 @@ ngx_http_init_locations(ngx_conf_t *cf, ngx_http_core_srv_conf_t *cscf,
         *clcfp = NULL;
 
         ngx_queue_split(locations, regex, &tail);
+
+        if (ngx_http_init_regex_matcher(cf, pclcf, r) != NGX_OK) {
+            return NGX_ERROR;
+        }
     }
 
 #endif
@@ -811,6 +819,178 @@ ngx_http_init_locations(ngx_conf_t *cf, ngx_http_core_srv_conf_t *cscf,
 }
 
 
+#if (NGX_PCRE)
+
+static ngx_int_t
+ngx_http_init_regex_matcher(ngx_conf_t *cf, ngx_http_core_loc_conf_t *pclcf,
+    ngx_uint_t n)
+{
+    u_char                      *p;
+    uint32_t                     s, t, *next, *fail, *queue, nstates;
+    ngx_int_t                   *literals;
+    ngx_str_t                    literal, *lits;
+    ngx_uint_t                   i, j, c, nc, nliterals, nregex, max;
+    ngx_uint_t                   head, tail;
+    ngx_http_core_loc_conf_t   **clcfp;
+    ngx_http_regex_matcher_t    *m;
+
+    literals = ngx_palloc(cf->pool, n * sizeof(ngx_int_t));
+    if (literals == NULL) {
+        return NGX_ERROR;
+    }
+
+    lits = ngx_palloc(cf->temp_pool, n * sizeof(ngx_str_t));
+    if (lits == NULL) {
+        return NGX_ERROR;
+    }
+
+    nliterals = 0;
+    nregex = 0;
+    max = 1;
+
+    for (i = 0, clcfp = pclcf->regex_locations; *clcfp; i++, clcfp++) {
+
+        if (ngx_regex_literal(cf->temp_pool, &(*clcfp)->name, &literal)
+            != NGX_OK)
+        {
+            return NGX_ERROR;
+        }
+
+        literals[i] = -1;
+
+        /* a regex without a usable literal is always tested */
+
+        if (literal.len < 2) {
+            continue;
+        }
+
+        nregex++;
+
+        for (j = 0; j < nliterals; j++) {
+            if (lits[j].len == literal.len
+                && ngx_strncasecmp(lits[j].data, literal.data, literal.len)
+                   == 0)
+            {
+                break;
+            }
+        }
+
+        if (j == nliterals) {
+            lits[nliterals++] = literal;
+            max += literal.len;
+        }
+
+        literals[i] = j;
+    }
+
+    if (nregex < 2) {
+        return NGX_OK;
+    }
+
+    m = ngx_pcalloc(cf->pool, sizeof(ngx_http_regex_matcher_t));
+    if (m == NULL) {
+        return NGX_ERROR;
+    }
+
+    m->literals = literals;
+    m->nliterals = nliterals;
+
+    /* the literals are matched case-insensitively */
+
+    nc = 1;
+
+    for (j = 0; j < nliterals; j++) {
+        for (p = lits[j].data; p < lits[j].data + lits[j].len; p++) {
+            c = ngx_tolower(*p);
+
+            if (m->classes[c] == 0) {
+                m->classes[c] = (u_char) nc;
+                m->classes[ngx_toupper(c)] = (u_char) nc;
+                nc++;
+            }
+        }
+    }
+
+    m->nclasses = nc;
+
+    next = ngx_pcalloc(cf->pool, max * nc * sizeof(uint32_t));
+    m->output = ngx_pcalloc(cf->pool, max * sizeof(uint32_t));
+    m->dict = ngx_pcalloc(cf->pool, max * sizeof(uint32_t));
+    fail = ngx_pcalloc(cf->temp_pool, max * sizeof(uint32_t));
+    queue = ngx_palloc(cf->temp_pool, max * sizeof(uint32_t));
+
+    if (next == NULL || m->output == NULL || m->dict == NULL
+        || fail == NULL || queue == NULL)
+    {
+        return NGX_ERROR;
+    }
+
+    m->next = next;
+
+    /* build the trie, the state 0 is the root */
+
+    nstates = 1;
+
+    for (j = 0; j < nliterals; j++) {
+        s = 0;
+
+        for (p = lits[j].data; p < lits[j].data + lits[j].len; p++) {
+            c = m->classes[*p];
+            t = next[s * nc + c];
+
+            if (t == 0) {
+                t = nstates++;
+                next[s * nc + c] = t;
+            }
+
+            s = t;
+        }
+
+        m->output[s] = j + 1;
+    }
+
+    /*
+     * compute failure links in breadth-first order and turn the trie
+     * into a DFA, the class 0 always leads back to the root
+     */
+
+    head = 0;
+    tail = 0;
+
+    for (c = 1; c < nc; c++) {
+        t = next[c];
+
+        if (t) {
+            queue[tail++] = t;
+        }
+    }
+
+    while (head < tail) {
+        s = queue[head++];
+
+        for (c = 1; c < nc; c++) {
+            t = next[s * nc + c];
+
+            if (t == 0) {
+                next[s * nc + c] = next[fail[s] * nc + c];
+                continue;
+            }
+
+            fail[t] = next[fail[s] * nc + c];
+            m->dict[t] = m->output[fail[t]] ? fail[t] : m->dict[fail[t]];
+
+            queue[tail++] = t;
+        }
+    }
+
+    pclcf->regex_matcher = m;
+
+    return NGX_OK;
+}
+
+#endif
+
+
 static ngx_int_t
 ngx_http_init_static_location_trees(ngx_conf_t *cf,
     ngx_http_core_loc_conf_t *pclcf)
@@ -1241,6 +1421,9 @@ ngx_http_add_addresses(ngx_conf_t *cf, ngx_http_core_srv_conf_t *cscf,
 #if (NGX_HTTP_SSL)
     ngx_uint_t             ssl;
 #endif
+#if (NGX_HTTP_V2)
+    ngx_uint_t             http2;
+#endif
 
     /*
      * we cannot compare whole sockaddr struct's as kernel
@@ -1293,6 +1476,9 @@ ngx_http_add_addresses(ngx_conf_t *cf, ngx_http_core_srv_conf_t *cscf,
 #if (NGX_HTTP_SSL)
         ssl = lsopt->ssl || addr[i].opt.ssl;
 #endif
+#if (NGX_HTTP_V2)
+        http2 = lsopt->http2 || addr[i].opt.http2;
+#endif
 
         if (lsopt->set) {
 
@@ -1323,6 +1509,9 @@ ngx_http_add_addresses(ngx_conf_t *cf, ngx_http_core_srv_conf_t *cscf,
 #if (NGX_HTTP_SSL)
         addr[i].opt.ssl = ssl;
 #endif
+#if (NGX_HTTP_V2)
+        addr[i].opt.http2 = http2;
+#endif
 
         return NGX_OK;
     }
@@ -1795,6 +1984,10 @@ ngx_http_add_listening(ngx_conf_t *cf, ngx_http_conf_addr_t *addr)
     ls->setfib = addr->opt.setfib;
 #endif
 
+#if (NGX_HAVE_REUSEPORT)
+    ls->reuseport = addr->opt.reuseport;
+#endif
+
     return ls;
 }
 
@@ -1824,6 +2017,9 @@ ngx_http_add_addrs(ngx_conf_t *cf, ngx_http_port_t *hport,
 #if (NGX_HTTP_SSL)
         addrs[i].conf.ssl = addr[i].opt.ssl;
 #endif
+#if (NGX_HTTP_V2)
+        addrs[i].conf.http2 = addr[i].opt.http2;
+#endif
 
         if (addr[i].hash.buckets == NULL
             && (addr[i].wc_head == NULL
@@ -1885,6 +2081,9 @@ ngx_http_add_addrs6(ngx_conf_t *cf, ngx_http_port_t *hport,
 #if (NGX_HTTP_SSL)
         addrs6[i].conf.ssl = addr[i].opt.ssl;
 #endif
+#if (NGX_HTTP_V2)
+        addrs6[i].conf.http2 = addr[i].opt.http2;
+#endif
 
         if (addr[i].hash.buckets == NULL
             && (addr[i].wc_head == NULL
@@ -31,6 +31,9 @@ typedef struct {
 } ngx_http_cache_valid_t;
 
 
+typedef struct ngx_http_file_cache_memory_s  ngx_http_file_cache_memory_t;
+
+
 typedef struct {
     ngx_rbtree_node_t                node;
     ngx_queue_t                      queue;
@@ -52,9 +55,21 @@ typedef struct {
     time_t                           valid_sec;
     size_t                           body_start;
     off_t                            fs_size;
+
+    ngx_http_file_cache_memory_t    *memory;
 } ngx_http_file_cache_node_t;
 
 
+/* a copy of a small cache file kept in the keys zone */
+
+struct ngx_http_file_cache_memory_s {
+    ngx_queue_t                      queue;
+    ngx_http_file_cache_node_t      *node;
+    size_t                           size;
+    /* u_char                        data[size]; */
+};
+
+
 struct ngx_http_cache_s {
     ngx_file_t                       file;
     ngx_array_t                      keys;
@@ -80,10 +95,19 @@ struct ngx_http_cache_s {
     ngx_http_file_cache_t           *file_cache;
     ngx_http_file_cache_node_t      *node;
 
+    ngx_msec_t                       lock_timeout;
+    ngx_msec_t                       wait_time;
+
+    ngx_event_t                      wait_event;
+
+    unsigned                         lock:1;
+    unsigned                         waiting:1;
+
     unsigned                         updated:1;
     unsigned                         updating:1;
     unsigned                         exists:1;
     unsigned                         temp_file:1;
+    unsigned                         memory:1;
 };
 
 
@@ -102,6 +126,7 @@ typedef struct {
     ngx_rbtree_t                     rbtree;
     ngx_rbtree_node_t                sentinel;
     ngx_queue_t                      queue;
+    ngx_queue_t                      memory;
     ngx_atomic_t                     cold;
     ngx_atomic_t                     loading;
     off_t                            size;
@@ -117,6 +142,8 @@ struct ngx_http_file_cache_s {
     off_t                            max_size;
     size_t                           bsize;
 
+    size_t                           memory_max_file;
+
     time_t                           inactive;
 
     ngx_msec_t                       last;
@@ -131,6 +158,7 @@ ngx_int_t ngx_http_file_cache_create(ngx_http_request_t *r);
 void ngx_http_file_cache_create_key(ngx_http_request_t *r);
 ngx_int_t ngx_http_file_cache_open(ngx_http_request_t *r);
 void ngx_http_file_cache_set_header(ngx_http_request_t *r, u_char *buf);
+ngx_int_t ngx_http_file_cache_lock(ngx_http_request_t *r, ngx_http_cache_t *c);
 void ngx_http_file_cache_update(ngx_http_request_t *r, ngx_temp_file_t *tf);
 ngx_int_t ngx_http_cache_send(ngx_http_request_t *);
 void ngx_http_file_cache_free(ngx_http_cache_t *c, ngx_temp_file_t *tf);
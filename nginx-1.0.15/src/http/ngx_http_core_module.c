@@ -22,6 +22,10 @@ typedef struct {
 
 
 static ngx_int_t ngx_http_core_find_location(ngx_http_request_t *r);
+#if (NGX_PCRE)
+static u_char *ngx_http_core_regex_prefilter(ngx_http_request_t *r,
+    ngx_http_regex_matcher_t *m, u_char *buf, size_t size);
+#endif
 static ngx_int_t ngx_http_core_find_static_location(ngx_http_request_t *r,
     ngx_http_location_tree_node_t *node);
 
@@ -56,6 +60,10 @@ static char *ngx_http_core_limit_except(ngx_conf_t *cf, ngx_command_t *cmd,
     void *conf);
 static char *ngx_http_core_directio(ngx_conf_t *cf, ngx_command_t *cmd,
     void *conf);
+#if (NGX_HAVE_FILE_AIO || NGX_THREAD_POOL)
+static char *ngx_http_core_set_aio(ngx_conf_t *cf, ngx_command_t *cmd,
+    void *conf);
+#endif
 static char *ngx_http_core_error_page(ngx_conf_t *cf, ngx_command_t *cmd,
     void *conf);
 static char *ngx_http_core_try_files(ngx_conf_t *cf, ngx_command_t *cmd,
@@ -107,20 +115,6 @@ static ngx_conf_enum_t  ngx_http_core_request_body_in_file[] = {
 };
 
 
-#if (NGX_HAVE_FILE_AIO)
-
-static ngx_conf_enum_t  ngx_http_core_aio[] = {
-    { ngx_string("off"), NGX_HTTP_AIO_OFF  },
-    { ngx_string("on"), NGX_HTTP_AIO_ON },
-#if (NGX_HAVE_AIO_SENDFILE)
-    { ngx_string("sendfile"), NGX_HTTP_AIO_SENDFILE },
-#endif
-    { ngx_null_string, 0 }
-};
-
-#endif
-
-
 static ngx_conf_enum_t  ngx_http_core_satisfy[] = {
     { ngx_string("all"), NGX_HTTP_SATISFY_ALL },
     { ngx_string("any"), NGX_HTTP_SATISFY_ANY },
@@ -416,14 +410,14 @@ static ngx_command_t  ngx_http_core_commands[] = {
       offsetof(ngx_http_core_loc_conf_t, sendfile_max_chunk),
       NULL },
 
-#if (NGX_HAVE_FILE_AIO)
+#if (NGX_HAVE_FILE_AIO || NGX_THREAD_POOL)
 
     { ngx_string("aio"),
       NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_TAKE1,
-      ngx_conf_set_enum_slot,
+      ngx_http_core_set_aio,
       NGX_HTTP_LOC_CONF_OFFSET,
-      offsetof(ngx_http_core_loc_conf_t, aio),
-      &ngx_http_core_aio },
+      0,
+      NULL },
 
 #endif
 
@@ -1516,8 +1510,9 @@ ngx_http_core_find_location(ngx_http_request_t *r)
     ngx_int_t                  rc;
     ngx_http_core_loc_conf_t  *pclcf;
 #if (NGX_PCRE)
-    ngx_int_t                  n;
-    ngx_uint_t                 noregex;
+    u_char                    *seen, buf[64];
+    ngx_int_t                  n, l;
+    ngx_uint_t                 i, noregex;
     ngx_http_core_loc_conf_t  *clcf, **clcfp;
 
     noregex = 0;
@@ -1550,7 +1545,27 @@ ngx_http_core_find_location(ngx_http_request_t *r)
 
     if (noregex == 0 && pclcf->regex_locations) {
 
-        for (clcfp = pclcf->regex_locations; *clcfp; clcfp++) {
+        seen = NULL;
+
+        if (pclcf->regex_matcher) {
+            seen = ngx_http_core_regex_prefilter(r, pclcf->regex_matcher,
+                                                 buf, sizeof(buf));
+        }
+
+        for (i = 0, clcfp = pclcf->regex_locations; *clcfp; i++, clcfp++) {
+
+            if (seen) {
+                l = pclcf->regex_matcher->literals[i];
+
+                /* the literal required by the regex is not in URI */
+
+                if (l >= 0 && !(seen[l / 8] & (1 << (l % 8)))) {
+                    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                                   "skip location: ~ \"%V\"",
+                                   &(*clcfp)->name);
+                    continue;
+                }
+            }
 
             ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
                            "test location: ~ \"%V\"", &(*clcfp)->name);
@@ -1580,6 +1595,63 @@ ngx_http_core_find_location(ngx_http_request_t *r)
 }
 
 
+#if (NGX_PCRE)
+
+/*
+ * runs the regex locations' literals automaton over URI once and returns
+ * a bitmap of the literals found, or NULL if no filtering is possible
+ */
+
+static u_char *
+ngx_http_core_regex_prefilter(ngx_http_request_t *r,
+    ngx_http_regex_matcher_t *m, u_char *buf, size_t size)
+{
+    u_char    *p, *last, *seen;
+    size_t     len;
+    uint32_t   s, t, n;
+
+    len = (m->nliterals + 7) / 8;
+
+    if (len <= size) {
+        seen = buf;
+        ngx_memzero(seen, len);
+
+    } else {
+        seen = ngx_pcalloc(r->pool, len);
+        if (seen == NULL) {
+            return NULL;
+        }
+    }
+
+    s = 0;
+    last = r->uri.data + r->uri.len;
+
+    for (p = r->uri.data; p < last; p++) {
+
+        s = m->next[s * m->nclasses + m->classes[*p]];
+
+        /*
+         * the rest of a dictionary chain has been marked already
+         * if a literal in the chain is marked
+         */
+
+        for (t = m->output[s] ? s : m->dict[s]; t; t = m->dict[t]) {
+            n = m->output[t] - 1;
+
+            if (seen[n / 8] & (1 << (n % 8))) {
+                break;
+            }
+
+            seen[n / 8] |= (u_char) (1 << (n % 8));
+        }
+    }
+
+    return seen;
+}
+
+#endif
+
+
 /*
  * NGX_OK       - exact match
  * NGX_DONE     - auto redirect
@@ -2400,6 +2472,10 @@ ngx_http_subrequest(ngx_http_request_t *r,
 
     sr->request_body = r->request_body;
 
+#if (NGX_HTTP_V2)
+    sr->stream = r->stream;
+#endif
+
     sr->method = NGX_HTTP_GET;
     sr->http_version = r->http_version;
 
@@ -3316,8 +3392,11 @@ ngx_http_core_create_loc_conf(ngx_conf_t *cf)
     clcf->internal = NGX_CONF_UNSET;
     clcf->sendfile = NGX_CONF_UNSET;
     clcf->sendfile_max_chunk = NGX_CONF_UNSET_SIZE;
-#if (NGX_HAVE_FILE_AIO)
+#if (NGX_HAVE_FILE_AIO || NGX_THREAD_POOL)
     clcf->aio = NGX_CONF_UNSET;
+#endif
+#if (NGX_THREAD_POOL)
+    clcf->thread_pool = NGX_CONF_UNSET_PTR;
 #endif
     clcf->read_ahead = NGX_CONF_UNSET_SIZE;
     clcf->directio = NGX_CONF_UNSET;
@@ -3530,8 +3609,11 @@ ngx_http_core_merge_loc_conf(ngx_conf_t *cf, void *parent, void *child)
     ngx_conf_merge_value(conf->sendfile, prev->sendfile, 0);
     ngx_conf_merge_size_value(conf->sendfile_max_chunk,
                               prev->sendfile_max_chunk, 0);
-#if (NGX_HAVE_FILE_AIO)
+#if (NGX_HAVE_FILE_AIO || NGX_THREAD_POOL)
     ngx_conf_merge_value(conf->aio, prev->aio, NGX_HTTP_AIO_OFF);
+#endif
+#if (NGX_THREAD_POOL)
+    ngx_conf_merge_ptr_value(conf->thread_pool, prev->thread_pool, NULL);
 #endif
     ngx_conf_merge_size_value(conf->read_ahead, prev->read_ahead, 0);
     ngx_conf_merge_off_value(conf->directio, prev->directio,
@@ -3786,6 +3868,19 @@ ngx_http_core_listen(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
             continue;
         }
 
+        if (ngx_strcmp(value[n].data, "reuseport") == 0) {
+#if (NGX_HAVE_REUSEPORT)
+            lsopt.reuseport = 1;
+            lsopt.set = 1;
+            lsopt.bind = 1;
+#else
+            ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                               "reuseport is not supported "
+                               "on this platform, ignored");
+#endif
+            continue;
+        }
+
         if (ngx_strcmp(value[n].data, "deferred") == 0) {
 #if (NGX_HAVE_DEFERRED_ACCEPT && defined TCP_DEFER_ACCEPT)
             lsopt.deferred_accept = 1;
@@ -3850,6 +3945,18 @@ ngx_http_core_listen(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 #endif
         }
 
+        if (ngx_strcmp(value[n].data, "http2") == 0) {
+#if (NGX_HTTP_V2)
+            lsopt.http2 = 1;
+            continue;
+#else
+            ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                               "the \"http2\" parameter requires "
+                               "ngx_http_v2_module");
+            return NGX_CONF_ERROR;
+#endif
+        }
+
         ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
                            "invalid parameter \"%V\"", &value[n]);
         return NGX_CONF_ERROR;
@@ -4211,6 +4318,82 @@ ngx_http_core_directio(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 }
 
 
+#if (NGX_HAVE_FILE_AIO || NGX_THREAD_POOL)
+
+static char *
+ngx_http_core_set_aio(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
+{
+    ngx_http_core_loc_conf_t *clcf = conf;
+
+    ngx_str_t  *value;
+#if (NGX_THREAD_POOL)
+    ngx_str_t   name;
+#endif
+
+    if (clcf->aio != NGX_CONF_UNSET) {
+        return "is duplicate";
+    }
+
+    value = cf->args->elts;
+
+    if (ngx_strcmp(value[1].data, "off") == 0) {
+        clcf->aio = NGX_HTTP_AIO_OFF;
+        return NGX_CONF_OK;
+    }
+
+#if (NGX_HAVE_FILE_AIO)
+
+    if (ngx_strcmp(value[1].data, "on") == 0) {
+        clcf->aio = NGX_HTTP_AIO_ON;
+        return NGX_CONF_OK;
+    }
+
+#if (NGX_HAVE_AIO_SENDFILE)
+
+    if (ngx_strcmp(value[1].data, "sendfile") == 0) {
+        clcf->aio = NGX_HTTP_AIO_SENDFILE;
+        return NGX_CONF_OK;
+    }
+
+#endif
+
+#endif
+
+#if (NGX_THREAD_POOL)
+
+    /* aio threads[=pool] */
+
+    if (ngx_strncmp(value[1].data, "threads", 7) == 0
+        && (value[1].len == 7 || value[1].data[7] == '='))
+    {
+        if (value[1].len > 8) {
+            name.len = value[1].len - 8;
+            name.data = value[1].data + 8;
+
+        } else {
+            ngx_str_set(&name, "default");
+        }
+
+        clcf->thread_pool = ngx_thread_pool_add(cf, &name);
+        if (clcf->thread_pool == NULL) {
+            return NGX_CONF_ERROR;
+        }
+
+        clcf->aio = NGX_HTTP_AIO_THREADS;
+        return NGX_CONF_OK;
+    }
+
+#endif
+
+    ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                       "invalid value \"%V\"", &value[1]);
+
+    return NGX_CONF_ERROR;
+}
+
+#endif
+
+
 static char *
 ngx_http_core_error_page(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 {
@@ -13,6 +13,10 @@
 #include <ngx_core.h>
 #include <ngx_http.h>
 
+#if (NGX_THREAD_POOL)
+#include <ngx_thread_pool.h>
+#endif
+
 
 #define NGX_HTTP_GZIP_PROXIED_OFF       0x0002
 #define NGX_HTTP_GZIP_PROXIED_EXPIRED   0x0004
@@ -28,6 +32,7 @@
 #define NGX_HTTP_AIO_OFF                0
 #define NGX_HTTP_AIO_ON                 1
 #define NGX_HTTP_AIO_SENDFILE           2
+#define NGX_HTTP_AIO_THREADS            3
 
 
 #define NGX_HTTP_SATISFY_ALL            0
@@ -51,6 +56,9 @@
 
 typedef struct ngx_http_location_tree_node_s  ngx_http_location_tree_node_t;
 typedef struct ngx_http_core_loc_conf_s  ngx_http_core_loc_conf_t;
+#if (NGX_PCRE)
+typedef struct ngx_http_regex_matcher_s  ngx_http_regex_matcher_t;
+#endif
 
 
 typedef struct {
@@ -75,9 +83,15 @@ typedef struct {
 #if (NGX_HTTP_SSL)
     unsigned                   ssl:1;
 #endif
+#if (NGX_HTTP_V2)
+    unsigned                   http2:1;
+#endif
 #if (NGX_HAVE_INET6 && defined IPV6_V6ONLY)
     unsigned                   ipv6only:2;
 #endif
+#if (NGX_HAVE_REUSEPORT)
+    unsigned                   reuseport:1;
+#endif
 
     int                        backlog;
     int                        rcvbuf;
@@ -231,7 +245,10 @@ typedef struct {
     ngx_http_virtual_names_t  *virtual_names;
 
 #if (NGX_HTTP_SSL)
-    ngx_uint_t                 ssl;   /* unsigned  ssl:1; */
+    unsigned                   ssl:1;
+#endif
+#if (NGX_HTTP_V2)
+    unsigned                   http2:1;
 #endif
 } ngx_http_addr_conf_t;
 
@@ -348,6 +365,7 @@ struct ngx_http_core_loc_conf_s {
     ngx_http_location_tree_node_t   *static_locations;
 #if (NGX_PCRE)
     ngx_http_core_loc_conf_t       **regex_locations;
+    ngx_http_regex_matcher_t        *regex_matcher;
 #endif
 
     /* pointer to the modules' loc_conf */
@@ -407,8 +425,11 @@ struct ngx_http_core_loc_conf_s {
                                            /* client_body_in_singe_buffer */
     ngx_flag_t    internal;                /* internal */
     ngx_flag_t    sendfile;                /* sendfile */
-#if (NGX_HAVE_FILE_AIO)
+#if (NGX_HAVE_FILE_AIO || NGX_THREAD_POOL)
     ngx_flag_t    aio;                     /* aio */
+#endif
+#if (NGX_THREAD_POOL)
+    ngx_thread_pool_t  *thread_pool;       /* aio threads */
 #endif
     ngx_flag_t    tcp_nopush;              /* tcp_nopush */
     ngx_flag_t    tcp_nodelay;             /* tcp_nodelay */
@@ -491,6 +512,32 @@ struct ngx_http_location_tree_node_s {
 };
 
 
+#if (NGX_PCRE)
+
+/*
+ * the prefilter for regex locations: an Aho-Corasick automaton built from
+ * the literals each regex requires, a regex is tested only if its literal
+ * has been seen in URI
+ */
+
+struct ngx_http_regex_matcher_s {
+    /* DFA transitions, nstates * nclasses */
+    uint32_t                        *next;
+    /* literal index + 1 recognized in the state, 0 if none */
+    uint32_t                        *output;
+    /* the nearest suffix state with output, 0 if none */
+    uint32_t                        *dict;
+    /* literal index of each regex location, -1 if the regex has none */
+    ngx_int_t                       *literals;
+    ngx_uint_t                       nliterals;
+    ngx_uint_t                       nclasses;
+    /* case-insensitive byte classes, 0 for bytes not used in literals */
+    u_char                           classes[256];
+};
+
+#endif
+
+
 void ngx_http_core_run_phases(ngx_http_request_t *r);
 ngx_int_t ngx_http_core_generic_phase(ngx_http_request_t *r,
     ngx_http_phase_handler_t *ph);
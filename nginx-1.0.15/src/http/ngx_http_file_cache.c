@@ -11,6 +11,7 @@
 #include <ngx_md5.h>
 
 
+static void ngx_http_file_cache_lock_wait_handler(ngx_event_t *ev);
 static ngx_int_t ngx_http_file_cache_read(ngx_http_request_t *r,
     ngx_http_cache_t *c);
 static ssize_t ngx_http_file_cache_aio_read(ngx_http_request_t *r,
@@ -18,8 +19,21 @@ static ssize_t ngx_http_file_cache_aio_read(ngx_http_request_t *r,
 #if (NGX_HAVE_FILE_AIO)
 static void ngx_http_cache_aio_event_handler(ngx_event_t *ev);
 #endif
+#if (NGX_THREAD_POOL)
+static ngx_int_t ngx_http_cache_thread_handler(ngx_thread_task_t *task,
+    ngx_file_t *file);
+static void ngx_http_cache_thread_event_handler(ngx_event_t *ev);
+#endif
 static ngx_int_t ngx_http_file_cache_exists(ngx_http_file_cache_t *cache,
     ngx_http_cache_t *c);
+static ngx_int_t ngx_http_file_cache_open_memory(ngx_http_request_t *r,
+    ngx_http_cache_t *c);
+static void ngx_http_file_cache_store_memory(ngx_http_file_cache_t *cache,
+    ngx_http_file_cache_node_t *fcn, u_char *data, size_t size);
+static void *ngx_http_file_cache_alloc_locked(ngx_http_file_cache_t *cache,
+    size_t size);
+static void ngx_http_file_cache_free_memory(ngx_http_file_cache_t *cache,
+    ngx_http_file_cache_node_t *fcn);
 static ngx_int_t ngx_http_file_cache_name(ngx_http_request_t *r,
     ngx_path_t *path);
 static ngx_http_file_cache_node_t *
@@ -123,6 +137,7 @@ ngx_http_file_cache_init(ngx_shm_zone_t *shm_zone, void *data)
                     ngx_http_file_cache_rbtree_insert_value);
 
     ngx_queue_init(&cache->sh->queue);
+    ngx_queue_init(&cache->sh->memory);
 
     cache->sh->cold = 1;
     cache->sh->loading = 0;
@@ -236,6 +251,7 @@ ngx_http_file_cache_create_key(ngx_http_request_t *r)
 ngx_int_t
 ngx_http_file_cache_open(ngx_http_request_t *r)
 {
+    size_t                     size;
     ngx_int_t                  rc, rv;
     ngx_uint_t                 cold, test;
     ngx_http_cache_t          *c;
@@ -246,15 +262,23 @@ ngx_http_file_cache_open(ngx_http_request_t *r)
 
     c = r->cache;
 
+    if (c->waiting) {
+        return NGX_AGAIN;
+    }
+
     if (c->buf) {
         return ngx_http_file_cache_read(r, c);
     }
 
     cache = c->file_cache;
 
-    cln = ngx_pool_cleanup_add(r->pool, 0);
-    if (cln == NULL) {
-        return NGX_ERROR;
+    cln = NULL;
+
+    if (c->node == NULL) {
+        cln = ngx_pool_cleanup_add(r->pool, 0);
+        if (cln == NULL) {
+            return NGX_ERROR;
+        }
     }
 
     rc = ngx_http_file_cache_exists(cache, c);
@@ -266,8 +290,10 @@ ngx_http_file_cache_open(ngx_http_request_t *r)
         return rc;
     }
 
-    cln->handler = ngx_http_file_cache_cleanup;
-    cln->data = c;
+    if (cln) {
+        cln->handler = ngx_http_file_cache_cleanup;
+        cln->data = c;
+    }
 
     if (rc == NGX_AGAIN) {
         return NGX_HTTP_CACHE_SCARCE;
@@ -308,7 +334,15 @@ ngx_http_file_cache_open(ngx_http_request_t *r)
     }
 
     if (!test) {
-        return NGX_DECLINED;
+        goto done;
+    }
+
+    if (c->exists && cache->memory_max_file) {
+        rc = ngx_http_file_cache_open_memory(r, c);
+
+        if (rc != NGX_DECLINED) {
+            return rc;
+        }
     }
 
     clcf = ngx_http_get_module_loc_conf(r, ngx_http_core_module);
@@ -332,7 +366,7 @@ ngx_http_file_cache_open(ngx_http_request_t *r)
 
         case NGX_ENOENT:
         case NGX_ENOTDIR:
-            return rv;
+            goto done;
 
         default:
             ngx_log_error(NGX_LOG_CRIT, r->connection->log, of.err,
@@ -350,12 +384,143 @@ ngx_http_file_cache_open(ngx_http_request_t *r)
     c->length = of.size;
     c->fs_size = (of.fs_size + cache->bsize - 1) / cache->bsize;
 
-    c->buf = ngx_create_temp_buf(r->pool, c->body_start);
+    size = c->body_start;
+
+    if (c->length > (off_t) size
+        && c->length <= (off_t) cache->memory_max_file)
+    {
+        /* read the whole file to keep a copy in memory */
+        size = (size_t) c->length;
+    }
+
+    c->buf = ngx_create_temp_buf(r->pool, size);
     if (c->buf == NULL) {
         return NGX_ERROR;
     }
 
     return ngx_http_file_cache_read(r, c);
+
+done:
+
+    if (rv == NGX_DECLINED) {
+        return ngx_http_file_cache_lock(r, c);
+    }
+
+    return rv;
+}
+
+
+ngx_int_t
+ngx_http_file_cache_lock(ngx_http_request_t *r, ngx_http_cache_t *c)
+{
+    ngx_msec_t              now, timer;
+    ngx_http_file_cache_t  *cache;
+
+    if (!c->lock) {
+        return NGX_DECLINED;
+    }
+
+    cache = c->file_cache;
+
+    ngx_shmtx_lock(&cache->shpool->mutex);
+
+    if (!c->node->updating) {
+        c->node->updating = 1;
+        c->updating = 1;
+    }
+
+    ngx_shmtx_unlock(&cache->shpool->mutex);
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                   "http file cache lock u:%d wt:%M",
+                   c->updating, c->wait_time);
+
+    if (c->updating) {
+        return NGX_DECLINED;
+    }
+
+    if (c->buf) {
+
+        /* the stale response is not used, the entry is reopened later */
+
+        c->buf = NULL;
+        c->memory = 0;
+
+        if (c->file.fd != NGX_INVALID_FILE) {
+            ngx_pool_run_cleanup_file(r->pool, c->file.fd);
+            c->file.fd = NGX_INVALID_FILE;
+        }
+    }
+
+    c->waiting = 1;
+
+    now = ngx_current_msec;
+
+    if (c->wait_time == 0) {
+        c->wait_time = now + c->lock_timeout;
+
+        c->wait_event.handler = ngx_http_file_cache_lock_wait_handler;
+        c->wait_event.data = r;
+        c->wait_event.log = r->connection->log;
+    }
+
+    timer = c->wait_time - now;
+
+    ngx_add_timer(&c->wait_event, (timer > 500) ? 500 : timer);
+
+    r->main->blocked++;
+
+    return NGX_AGAIN;
+}
+
+
+static void
+ngx_http_file_cache_lock_wait_handler(ngx_event_t *ev)
+{
+    ngx_uint_t              wait;
+    ngx_msec_t              now, timer;
+    ngx_http_cache_t       *c;
+    ngx_http_request_t     *r;
+    ngx_http_file_cache_t  *cache;
+
+    r = ev->data;
+    c = r->cache;
+
+    now = ngx_current_msec;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, ev->log, 0,
+                   "http file cache wait handler wt:%M cur:%M",
+                   c->wait_time, now);
+
+    timer = c->wait_time - now;
+
+    if ((ngx_msec_int_t) timer <= 0) {
+        ngx_log_error(NGX_LOG_INFO, ev->log, 0, "cache lock timeout");
+        c->lock = 0;
+        goto wakeup;
+    }
+
+    cache = c->file_cache;
+    wait = 0;
+
+    ngx_shmtx_lock(&cache->shpool->mutex);
+
+    if (c->node->updating) {
+        wait = 1;
+    }
+
+    ngx_shmtx_unlock(&cache->shpool->mutex);
+
+    if (wait) {
+        ngx_add_timer(ev, (timer > 500) ? 500 : timer);
+        return;
+    }
+
+wakeup:
+
+    c->waiting = 0;
+    r->main->blocked--;
+    r->connection->write->handler(r->connection->write);
 }
 
 
@@ -368,10 +533,15 @@ ngx_http_file_cache_read(ngx_http_request_t *r, ngx_http_cache_t *c)
     ngx_http_file_cache_t         *cache;
     ngx_http_file_cache_header_t  *h;
 
-    n = ngx_http_file_cache_aio_read(r, c);
+    if (c->memory) {
+        n = (ssize_t) c->length;
 
-    if (n < 0) {
-        return n;
+    } else {
+        n = ngx_http_file_cache_aio_read(r, c);
+
+        if (n < 0) {
+            return n;
+        }
     }
 
     if ((size_t) n < c->header_start) {
@@ -449,6 +619,24 @@ ngx_http_file_cache_read(ngx_http_request_t *r, ngx_http_cache_t *c)
         return rc;
     }
 
+    if (!c->memory
+        && c->length == n
+        && (size_t) n <= cache->memory_max_file)
+    {
+        /* the whole file has been read, e.g. after the cache was loaded */
+
+        ngx_shmtx_lock(&cache->shpool->mutex);
+
+        if (c->node->memory == NULL
+            && (c->node->uniq == c->uniq || c->node->uniq == 0))
+        {
+            ngx_http_file_cache_store_memory(cache, c->node, c->buf->pos,
+                                             (size_t) n);
+        }
+
+        ngx_shmtx_unlock(&cache->shpool->mutex);
+    }
+
     return NGX_OK;
 }
 
@@ -458,19 +646,37 @@ ngx_http_file_cache_aio_read(ngx_http_request_t *r, ngx_http_cache_t *c)
 {
 #if (NGX_HAVE_FILE_AIO)
     ssize_t                    n;
+#endif
+#if (NGX_HAVE_FILE_AIO || NGX_THREAD_POOL)
     ngx_http_core_loc_conf_t  *clcf;
 
+    clcf = ngx_http_get_module_loc_conf(r, ngx_http_core_module);
+#endif
+
+#if (NGX_THREAD_POOL)
+
+    if (clcf->aio == NGX_HTTP_AIO_THREADS) {
+        c->file.thread_handler = ngx_http_cache_thread_handler;
+        c->file.thread_ctx = r;
+
+        return ngx_thread_read(&c->file, c->buf->pos,
+                               c->buf->end - c->buf->pos, 0, r->pool);
+    }
+
+#endif
+
+#if (NGX_HAVE_FILE_AIO)
+
     if (!ngx_file_aio) {
         goto noaio;
     }
 
-    clcf = ngx_http_get_module_loc_conf(r, ngx_http_core_module);
-
-    if (!clcf->aio) {
+    if (clcf->aio != NGX_HTTP_AIO_ON && clcf->aio != NGX_HTTP_AIO_SENDFILE) {
         goto noaio;
     }
 
-    n = ngx_file_aio_read(&c->file, c->buf->pos, c->body_start, 0, r->pool);
+    n = ngx_file_aio_read(&c->file, c->buf->pos, c->buf->end - c->buf->pos, 0,
+                          r->pool);
 
     if (n != NGX_AGAIN) {
         return n;
@@ -488,7 +694,7 @@ noaio:
 
 #endif
 
-    return ngx_read_file(&c->file, c->buf->pos, c->body_start, 0);
+    return ngx_read_file(&c->file, c->buf->pos, c->buf->end - c->buf->pos, 0);
 }
 
 
@@ -512,6 +718,116 @@ ngx_http_cache_aio_event_handler(ngx_event_t *ev)
 #endif
 
 
+#if (NGX_THREAD_POOL)
+
+static ngx_int_t
+ngx_http_cache_thread_handler(ngx_thread_task_t *task, ngx_file_t *file)
+{
+    ngx_http_request_t        *r;
+    ngx_http_core_loc_conf_t  *clcf;
+
+    r = file->thread_ctx;
+
+    clcf = ngx_http_get_module_loc_conf(r, ngx_http_core_module);
+
+    task->event.data = r;
+    task->event.handler = ngx_http_cache_thread_event_handler;
+
+    if (ngx_thread_task_post(clcf->thread_pool, task) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    r->main->blocked++;
+    r->aio = 1;
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_http_cache_thread_event_handler(ngx_event_t *ev)
+{
+    ngx_http_request_t  *r;
+
+    r = ev->data;
+
+    r->main->blocked--;
+    r->aio = 0;
+
+    r->connection->write->handler(r->connection->write);
+}
+
+#endif
+
+
+static ngx_int_t
+ngx_http_file_cache_open_memory(ngx_http_request_t *r, ngx_http_cache_t *c)
+{
+    size_t                         size;
+    ngx_int_t                      rc;
+    ngx_buf_t                     *b;
+    ngx_http_file_cache_t         *cache;
+    ngx_http_file_cache_memory_t  *m;
+
+    cache = c->file_cache;
+
+    /*
+     * the copy is done under the zone mutex, so the memory may be
+     * freed or replaced by another worker as soon as the mutex is released
+     */
+
+    ngx_shmtx_lock(&cache->shpool->mutex);
+
+    m = c->node->memory;
+
+    if (m == NULL || m->size > cache->memory_max_file) {
+        ngx_shmtx_unlock(&cache->shpool->mutex);
+        return NGX_DECLINED;
+    }
+
+    size = m->size;
+
+    b = ngx_create_temp_buf(r->pool, ngx_max(size, c->body_start));
+    if (b == NULL) {
+        ngx_shmtx_unlock(&cache->shpool->mutex);
+        return NGX_ERROR;
+    }
+
+    ngx_memcpy(b->pos, (u_char *) m + sizeof(ngx_http_file_cache_memory_t),
+               size);
+
+    ngx_queue_remove(&m->queue);
+    ngx_queue_insert_head(&cache->sh->memory, &m->queue);
+
+    c->uniq = c->node->uniq;
+    c->fs_size = c->node->fs_size;
+
+    ngx_shmtx_unlock(&cache->shpool->mutex);
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                   "http file cache memory: %uz", size);
+
+    c->buf = b;
+    c->length = size;
+    c->memory = 1;
+
+    rc = ngx_http_file_cache_read(r, c);
+
+    if (rc == NGX_DECLINED) {
+
+        /*
+         * the copy does not match, e.g. its header is now too long,
+         * so the file is opened and read into a new buffer
+         */
+
+        c->buf = NULL;
+        c->memory = 0;
+    }
+
+    return rc;
+}
+
+
 static ngx_int_t
 ngx_http_file_cache_exists(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
 {
@@ -520,13 +836,19 @@ ngx_http_file_cache_exists(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
 
     ngx_shmtx_lock(&cache->shpool->mutex);
 
-    fcn = ngx_http_file_cache_lookup(cache, c->key);
+    fcn = c->node;
+
+    if (fcn == NULL) {
+        fcn = ngx_http_file_cache_lookup(cache, c->key);
+    }
 
     if (fcn) {
         ngx_queue_remove(&fcn->queue);
 
-        fcn->uses++;
-        fcn->count++;
+        if (c->node == NULL) {
+            fcn->uses++;
+            fcn->count++;
+        }
 
         if (fcn->error) {
 
@@ -556,8 +878,8 @@ ngx_http_file_cache_exists(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
         goto done;
     }
 
-    fcn = ngx_slab_alloc_locked(cache->shpool,
-                                sizeof(ngx_http_file_cache_node_t));
+    fcn = ngx_http_file_cache_alloc_locked(cache,
+                                           sizeof(ngx_http_file_cache_node_t));
     if (fcn == NULL) {
         ngx_shmtx_unlock(&cache->shpool->mutex);
 
@@ -584,11 +906,16 @@ ngx_http_file_cache_exists(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
     fcn->count = 1;
     fcn->updating = 0;
     fcn->deleting = 0;
+    fcn->memory = NULL;
 
 renew:
 
     rc = NGX_DECLINED;
 
+    if (fcn->memory) {
+        ngx_http_file_cache_free_memory(cache, fcn);
+    }
+
     fcn->valid_msec = 0;
     fcn->error = 0;
     fcn->exists = 0;
@@ -773,13 +1100,15 @@ ngx_http_file_cache_set_header(ngx_http_request_t *r, u_char *buf)
 void
 ngx_http_file_cache_update(ngx_http_request_t *r, ngx_temp_file_t *tf)
 {
-    off_t                   fs_size;
-    ngx_int_t               rc;
-    ngx_file_uniq_t         uniq;
-    ngx_file_info_t         fi;
-    ngx_http_cache_t        *c;
-    ngx_ext_rename_file_t   ext;
-    ngx_http_file_cache_t  *cache;
+    off_t                          fs_size;
+    u_char                        *data;
+    size_t                         size;
+    ngx_int_t                      rc;
+    ngx_file_uniq_t                uniq;
+    ngx_file_info_t                fi;
+    ngx_http_cache_t              *c;
+    ngx_ext_rename_file_t          ext;
+    ngx_http_file_cache_t         *cache;
 
     c = r->cache;
 
@@ -797,6 +1126,8 @@ ngx_http_file_cache_update(ngx_http_request_t *r, ngx_temp_file_t *tf)
 
     uniq = 0;
     fs_size = 0;
+    data = NULL;
+    size = 0;
 
     ngx_log_debug2(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
                    "http file cache rename: \"%s\" to \"%s\"",
@@ -822,6 +1153,23 @@ ngx_http_file_cache_update(ngx_http_request_t *r, ngx_temp_file_t *tf)
         } else {
             uniq = ngx_file_uniq(&fi);
             fs_size = (ngx_file_fs_size(&fi) + cache->bsize - 1) / cache->bsize;
+
+            if (cache->memory_max_file
+                && ngx_file_size(&fi) <= (off_t) cache->memory_max_file)
+            {
+                /* the file has just been written and is in the page cache */
+
+                size = (size_t) ngx_file_size(&fi);
+
+                data = ngx_pnalloc(r->pool, size);
+
+                if (data
+                    && ngx_read_file(&tf->file, data, size, 0)
+                       != (ssize_t) size)
+                {
+                    data = NULL;
+                }
+            }
         }
     }
 
@@ -834,8 +1182,16 @@ ngx_http_file_cache_update(ngx_http_request_t *r, ngx_temp_file_t *tf)
     cache->sh->size += fs_size - c->node->fs_size;
     c->node->fs_size = fs_size;
 
+    if (c->node->memory) {
+        ngx_http_file_cache_free_memory(cache, c->node);
+    }
+
     if (rc == NGX_OK) {
         c->node->exists = 1;
+
+        if (data) {
+            ngx_http_file_cache_store_memory(cache, c->node, data, size);
+        }
     }
 
     c->node->updating = 0;
@@ -868,9 +1224,16 @@ ngx_http_cache_send(ngx_http_request_t *r)
         return NGX_HTTP_INTERNAL_SERVER_ERROR;
     }
 
-    b->file = ngx_pcalloc(r->pool, sizeof(ngx_file_t));
-    if (b->file == NULL) {
-        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    if (c->memory) {
+        b->pos = c->buf->start + c->body_start;
+        b->last = c->buf->start + c->length;
+        b->memory = (c->length - c->body_start) ? 1: 0;
+
+    } else {
+        b->file = ngx_pcalloc(r->pool, sizeof(ngx_file_t));
+        if (b->file == NULL) {
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
     }
 
     rc = ngx_http_send_header(r);
@@ -879,17 +1242,20 @@ ngx_http_cache_send(ngx_http_request_t *r)
         return rc;
     }
 
-    b->file_pos = c->body_start;
-    b->file_last = c->length;
+    if (!c->memory) {
+        b->file_pos = c->body_start;
+        b->file_last = c->length;
+
+        b->in_file = (c->length - c->body_start) ? 1: 0;
+
+        b->file->fd = c->file.fd;
+        b->file->name = c->file.name;
+        b->file->log = r->connection->log;
+    }
 
-    b->in_file = (c->length - c->body_start) ? 1: 0;
     b->last_buf = (r == r->main) ? 1: 0;
     b->last_in_chain = 1;
 
-    b->file->fd = c->file.fd;
-    b->file->name = c->file.name;
-    b->file->log = r->connection->log;
-
     out.buf = b;
     out.next = NULL;
 
@@ -1141,6 +1507,10 @@ ngx_http_file_cache_delete(ngx_http_file_cache_t *cache, ngx_queue_t *q,
 
     fcn = ngx_queue_data(q, ngx_http_file_cache_node_t, queue);
 
+    if (fcn->memory) {
+        ngx_http_file_cache_free_memory(cache, fcn);
+    }
+
     if (fcn->exists) {
         cache->sh->size -= fcn->fs_size;
 
@@ -1180,6 +1550,79 @@ ngx_http_file_cache_delete(ngx_http_file_cache_t *cache, ngx_queue_t *q,
 }
 
 
+static void *
+ngx_http_file_cache_alloc_locked(ngx_http_file_cache_t *cache, size_t size)
+{
+    void                          *p;
+    ngx_uint_t                     tries;
+    ngx_queue_t                   *q;
+    ngx_http_file_cache_memory_t  *m;
+
+    /* drop the least recently used memory copies until the allocation fits */
+
+    cache->shpool->log_nomem = 0;
+
+    p = ngx_slab_alloc_locked(cache->shpool, size);
+
+    for (tries = 20; p == NULL && tries; tries--) {
+
+        if (ngx_queue_empty(&cache->sh->memory)) {
+            break;
+        }
+
+        q = ngx_queue_last(&cache->sh->memory);
+        m = ngx_queue_data(q, ngx_http_file_cache_memory_t, queue);
+
+        ngx_http_file_cache_free_memory(cache, m->node);
+
+        p = ngx_slab_alloc_locked(cache->shpool, size);
+    }
+
+    cache->shpool->log_nomem = 1;
+
+    return p;
+}
+
+
+static void
+ngx_http_file_cache_store_memory(ngx_http_file_cache_t *cache,
+    ngx_http_file_cache_node_t *fcn, u_char *data, size_t size)
+{
+    ngx_http_file_cache_memory_t  *m;
+
+    m = ngx_http_file_cache_alloc_locked(cache,
+                                 sizeof(ngx_http_file_cache_memory_t) + size);
+    if (m == NULL) {
+        return;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
+                   "http file cache store memory: %uz", size);
+
+    ngx_memcpy((u_char *) m + sizeof(ngx_http_file_cache_memory_t), data,
+               size);
+
+    m->node = fcn;
+    m->size = size;
+
+    fcn->memory = m;
+    ngx_queue_insert_head(&cache->sh->memory, &m->queue);
+}
+
+
+static void
+ngx_http_file_cache_free_memory(ngx_http_file_cache_t *cache,
+    ngx_http_file_cache_node_t *fcn)
+{
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, ngx_cycle->log, 0,
+                   "http file cache free memory: %uz", fcn->memory->size);
+
+    ngx_queue_remove(&fcn->memory->queue);
+    ngx_slab_free_locked(cache->shpool, fcn->memory);
+    fcn->memory = NULL;
+}
+
+
 static time_t
 ngx_http_file_cache_manager(void *data)
 {
@@ -1402,6 +1845,7 @@ ngx_http_file_cache_add(ngx_http_file_cache_t *cache, ngx_http_cache_t *c)
         fcn->valid_sec = 0;
         fcn->body_start = 0;
         fcn->fs_size = c->fs_size;
+        fcn->memory = NULL;
 
         cache->sh->size += c->fs_size;
 
@@ -1466,7 +1910,7 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     off_t                   max_size;
     u_char                 *last, *p;
     time_t                  inactive;
-    ssize_t                 size;
+    ssize_t                 size, memory_max_file;
     ngx_str_t               s, name, *value;
     ngx_uint_t              i, n;
     ngx_http_file_cache_t  *cache;
@@ -1486,6 +1930,7 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
     name.len = 0;
     size = 0;
     max_size = NGX_MAX_OFF_T_VALUE;
+    memory_max_file = 0;
 
     value = cf->args->elts;
 
@@ -1595,6 +2040,22 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
             continue;
         }
 
+        if (ngx_strncmp(value[i].data, "memory_max_file=", 16) == 0) {
+
+            s.len = value[i].len - 16;
+            s.data = value[i].data + 16;
+
+            memory_max_file = ngx_parse_size(&s);
+            if (memory_max_file == NGX_ERROR) {
+                ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
+                                   "invalid memory_max_file value \"%V\"",
+                                   &value[i]);
+                return NGX_CONF_ERROR;
+            }
+
+            continue;
+        }
+
         ngx_conf_log_error(NGX_LOG_EMERG, cf, 0,
                            "invalid parameter \"%V\"", &value[i]);
         return NGX_CONF_ERROR;
@@ -1634,6 +2095,7 @@ ngx_http_file_cache_set_slot(ngx_conf_t *cf, ngx_command_t *cmd, void *conf)
 
     cache->inactive = inactive;
     cache->max_size = max_size;
+    cache->memory_max_file = memory_max_file;
 
     return NGX_CONF_OK;
 }
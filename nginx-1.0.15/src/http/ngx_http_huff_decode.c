@@ -0,0 +1,1886 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+typedef struct {
+    u_char  next;
+    u_char  sym;
+    u_char  flags;
+} ngx_http_huff_decode_code_t;
+
+
+#define NGX_HTTP_HUFF_EMIT    0x01
+#define NGX_HTTP_HUFF_ACCEPT  0x02
+#define NGX_HTTP_HUFF_FAIL    0x04
+
+
+/*
+ * The decoder walks the Huffman code tree of the HPACK specification
+ * (RFC 7541, Appendix B) four bits at a time.  A state is an inner node
+ * of the tree; for every state and input nibble the table holds the node
+ * reached, the symbol emitted on the way if any, and whether the bits
+ * consumed since the last symbol may be taken as a padding, that is,
+ * as the most significant bits of EOS not longer than 7 bits.
+ */
+
+static ngx_http_huff_decode_code_t  ngx_http_huff_decode_codes[256][16] =
+{
+    /* 0 */
+    {
+        {0x57, 0x00, 0}, {0x58, 0x00, 0}, {0x83, 0x00, 0}, {0x87, 0x00, 0},
+        {0x8f, 0x00, 0}, {0x45, 0x00, 0}, {0x53, 0x00, 0}, {0x5a, 0x00, 0},
+        {0x64, 0x00, 0}, {0x84, 0x00, 0}, {0x8a, 0x00, 0}, {0x5f, 0x00, 0},
+        {0x69, 0x00, 0}, {0x70, 0x00, 0}, {0x77, 0x00, 0}, {0x04, 0x00, 2}
+    },
+    /* 1 */
+    {
+        {0x65, 0x00, 0}, {0x81, 0x00, 0}, {0x85, 0x00, 0}, {0x86, 0x00, 0},
+        {0x8b, 0x00, 0}, {0x8c, 0x00, 0}, {0x8e, 0x00, 0}, {0x60, 0x00, 0},
+        {0x6a, 0x00, 0}, {0x6d, 0x00, 0}, {0x71, 0x00, 0}, {0x74, 0x00, 0},
+        {0x78, 0x00, 0}, {0x88, 0x00, 0}, {0x90, 0x00, 0}, {0x05, 0x00, 2}
+    },
+    /* 2 */
+    {
+        {0x6b, 0x00, 0}, {0x6c, 0x00, 0}, {0x6e, 0x00, 0}, {0x6f, 0x00, 0},
+        {0x72, 0x00, 0}, {0x73, 0x00, 0}, {0x75, 0x00, 0}, {0x76, 0x00, 0},
+        {0x79, 0x00, 0}, {0x7a, 0x00, 0}, {0x89, 0x00, 0}, {0x8d, 0x00, 0},
+        {0x91, 0x00, 0}, {0x92, 0x00, 0}, {0x4b, 0x00, 0}, {0x06, 0x00, 2}
+    },
+    /* 3 */
+    {
+        {0x00, 0x55, 3}, {0x00, 0x56, 3}, {0x00, 0x57, 3}, {0x00, 0x59, 3},
+        {0x00, 0x6a, 3}, {0x00, 0x6b, 3}, {0x00, 0x71, 3}, {0x00, 0x76, 3},
+        {0x00, 0x77, 3}, {0x00, 0x78, 3}, {0x00, 0x79, 3}, {0x00, 0x7a, 3},
+        {0x4c, 0x00, 0}, {0x50, 0x00, 0}, {0x7b, 0x00, 0}, {0x07, 0x00, 2}
+    },
+    /* 4 */
+    {
+        {0x42, 0x77, 1}, {0x01, 0x77, 3}, {0x42, 0x78, 1}, {0x01, 0x78, 3},
+        {0x42, 0x79, 1}, {0x01, 0x79, 3}, {0x42, 0x7a, 1}, {0x01, 0x7a, 3},
+        {0x00, 0x26, 3}, {0x00, 0x2a, 3}, {0x00, 0x2c, 3}, {0x00, 0x3b, 3},
+        {0x00, 0x58, 3}, {0x00, 0x5a, 3}, {0x47, 0x00, 0}, {0x08, 0x00, 0}
+    },
+    /* 5 */
+    {
+        {0x42, 0x26, 1}, {0x01, 0x26, 3}, {0x42, 0x2a, 1}, {0x01, 0x2a, 3},
+        {0x42, 0x2c, 1}, {0x01, 0x2c, 3}, {0x42, 0x3b, 1}, {0x01, 0x3b, 3},
+        {0x42, 0x58, 1}, {0x01, 0x58, 3}, {0x42, 0x5a, 1}, {0x01, 0x5a, 3},
+        {0x48, 0x00, 0}, {0x4f, 0x00, 0}, {0x4d, 0x00, 0}, {0x09, 0x00, 0}
+    },
+    /* 6 */
+    {
+        {0x55, 0x58, 1}, {0x43, 0x58, 1}, {0x5d, 0x58, 1}, {0x02, 0x58, 3},
+        {0x55, 0x5a, 1}, {0x43, 0x5a, 1}, {0x5d, 0x5a, 1}, {0x02, 0x5a, 3},
+        {0x00, 0x21, 3}, {0x00, 0x22, 3}, {0x00, 0x28, 3}, {0x00, 0x29, 3},
+        {0x00, 0x3f, 3}, {0x4e, 0x00, 0}, {0x49, 0x00, 0}, {0x0a, 0x00, 0}
+    },
+    /* 7 */
+    {
+        {0x42, 0x21, 1}, {0x01, 0x21, 3}, {0x42, 0x22, 1}, {0x01, 0x22, 3},
+        {0x42, 0x28, 1}, {0x01, 0x28, 3}, {0x42, 0x29, 1}, {0x01, 0x29, 3},
+        {0x42, 0x3f, 1}, {0x01, 0x3f, 3}, {0x00, 0x27, 3}, {0x00, 0x2b, 3},
+        {0x00, 0x7c, 3}, {0x4a, 0x00, 0}, {0x0b, 0x00, 0}, {0x0d, 0x00, 0}
+    },
+    /* 8 */
+    {
+        {0x55, 0x3f, 1}, {0x43, 0x3f, 1}, {0x5d, 0x3f, 1}, {0x02, 0x3f, 3},
+        {0x42, 0x27, 1}, {0x01, 0x27, 3}, {0x42, 0x2b, 1}, {0x01, 0x2b, 3},
+        {0x42, 0x7c, 1}, {0x01, 0x7c, 3}, {0x00, 0x23, 3}, {0x00, 0x3e, 3},
+        {0x0c, 0x00, 0}, {0x66, 0x00, 0}, {0x7f, 0x00, 0}, {0x0e, 0x00, 0}
+    },
+    /* 9 */
+    {
+        {0x55, 0x7c, 1}, {0x43, 0x7c, 1}, {0x5d, 0x7c, 1}, {0x02, 0x7c, 3},
+        {0x42, 0x23, 1}, {0x01, 0x23, 3}, {0x42, 0x3e, 1}, {0x01, 0x3e, 3},
+        {0x00, 0x00, 3}, {0x00, 0x24, 3}, {0x00, 0x40, 3}, {0x00, 0x5b, 3},
+        {0x00, 0x5d, 3}, {0x00, 0x7e, 3}, {0x80, 0x00, 0}, {0x0f, 0x00, 0}
+    },
+    /* 10 */
+    {
+        {0x42, 0x00, 1}, {0x01, 0x00, 3}, {0x42, 0x24, 1}, {0x01, 0x24, 3},
+        {0x42, 0x40, 1}, {0x01, 0x40, 3}, {0x42, 0x5b, 1}, {0x01, 0x5b, 3},
+        {0x42, 0x5d, 1}, {0x01, 0x5d, 3}, {0x42, 0x7e, 1}, {0x01, 0x7e, 3},
+        {0x00, 0x5e, 3}, {0x00, 0x7d, 3}, {0x62, 0x00, 0}, {0x10, 0x00, 0}
+    },
+    /* 11 */
+    {
+        {0x55, 0x00, 1}, {0x43, 0x00, 1}, {0x5d, 0x00, 1}, {0x02, 0x00, 3},
+        {0x55, 0x24, 1}, {0x43, 0x24, 1}, {0x5d, 0x24, 1}, {0x02, 0x24, 3},
+        {0x55, 0x40, 1}, {0x43, 0x40, 1}, {0x5d, 0x40, 1}, {0x02, 0x40, 3},
+        {0x55, 0x5b, 1}, {0x43, 0x5b, 1}, {0x5d, 0x5b, 1}, {0x02, 0x5b, 3}
+    },
+    /* 12 */
+    {
+        {0x56, 0x00, 1}, {0x82, 0x00, 1}, {0x44, 0x00, 1}, {0x52, 0x00, 1},
+        {0x63, 0x00, 1}, {0x5e, 0x00, 1}, {0x68, 0x00, 1}, {0x03, 0x00, 3},
+        {0x56, 0x24, 1}, {0x82, 0x24, 1}, {0x44, 0x24, 1}, {0x52, 0x24, 1},
+        {0x63, 0x24, 1}, {0x5e, 0x24, 1}, {0x68, 0x24, 1}, {0x03, 0x24, 3}
+    },
+    /* 13 */
+    {
+        {0x55, 0x5d, 1}, {0x43, 0x5d, 1}, {0x5d, 0x5d, 1}, {0x02, 0x5d, 3},
+        {0x55, 0x7e, 1}, {0x43, 0x7e, 1}, {0x5d, 0x7e, 1}, {0x02, 0x7e, 3},
+        {0x42, 0x5e, 1}, {0x01, 0x5e, 3}, {0x42, 0x7d, 1}, {0x01, 0x7d, 3},
+        {0x00, 0x3c, 3}, {0x00, 0x60, 3}, {0x00, 0x7b, 3}, {0x11, 0x00, 0}
+    },
+    /* 14 */
+    {
+        {0x55, 0x5e, 1}, {0x43, 0x5e, 1}, {0x5d, 0x5e, 1}, {0x02, 0x5e, 3},
+        {0x55, 0x7d, 1}, {0x43, 0x7d, 1}, {0x5d, 0x7d, 1}, {0x02, 0x7d, 3},
+        {0x42, 0x3c, 1}, {0x01, 0x3c, 3}, {0x42, 0x60, 1}, {0x01, 0x60, 3},
+        {0x42, 0x7b, 1}, {0x01, 0x7b, 3}, {0x7c, 0x00, 0}, {0x12, 0x00, 0}
+    },
+    /* 15 */
+    {
+        {0x55, 0x3c, 1}, {0x43, 0x3c, 1}, {0x5d, 0x3c, 1}, {0x02, 0x3c, 3},
+        {0x55, 0x60, 1}, {0x43, 0x60, 1}, {0x5d, 0x60, 1}, {0x02, 0x60, 3},
+        {0x55, 0x7b, 1}, {0x43, 0x7b, 1}, {0x5d, 0x7b, 1}, {0x02, 0x7b, 3},
+        {0x7d, 0x00, 0}, {0x9b, 0x00, 0}, {0x96, 0x00, 0}, {0x13, 0x00, 0}
+    },
+    /* 16 */
+    {
+        {0x56, 0x7b, 1}, {0x82, 0x7b, 1}, {0x44, 0x7b, 1}, {0x52, 0x7b, 1},
+        {0x63, 0x7b, 1}, {0x5e, 0x7b, 1}, {0x68, 0x7b, 1}, {0x03, 0x7b, 3},
+        {0x7e, 0x00, 0}, {0x94, 0x00, 0}, {0x9c, 0x00, 0}, {0xaf, 0x00, 0},
+        {0xc4, 0x00, 0}, {0x97, 0x00, 0}, {0x14, 0x00, 0}, {0x19, 0x00, 0}
+    },
+    /* 17 */
+    {
+        {0x00, 0x5c, 3}, {0x00, 0xc3, 3}, {0x00, 0xd0, 3}, {0x95, 0x00, 0},
+        {0x9d, 0x00, 0}, {0xcc, 0x00, 0}, {0xf1, 0x00, 0}, {0xb0, 0x00, 0},
+        {0xc5, 0x00, 0}, {0xeb, 0x00, 0}, {0x98, 0x00, 0}, {0xb2, 0x00, 0},
+        {0xc7, 0x00, 0}, {0x15, 0x00, 0}, {0xa7, 0x00, 0}, {0x1a, 0x00, 0}
+    },
+    /* 18 */
+    {
+        {0xc6, 0x00, 0}, {0xca, 0x00, 0}, {0xec, 0x00, 0}, {0xf2, 0x00, 0},
+        {0x99, 0x00, 0}, {0x9e, 0x00, 0}, {0xb3, 0x00, 0}, {0xb7, 0x00, 0},
+        {0xc8, 0x00, 0}, {0xce, 0x00, 0}, {0xd8, 0x00, 0}, {0x16, 0x00, 0},
+        {0xa8, 0x00, 0}, {0xb9, 0x00, 0}, {0x29, 0x00, 0}, {0x1b, 0x00, 0}
+    },
+    /* 19 */
+    {
+        {0xc9, 0x00, 0}, {0xcd, 0x00, 0}, {0xcf, 0x00, 0}, {0xd2, 0x00, 0},
+        {0xd9, 0x00, 0}, {0xf3, 0x00, 0}, {0x17, 0x00, 0}, {0xa2, 0x00, 0},
+        {0xa9, 0x00, 0}, {0xad, 0x00, 0}, {0xba, 0x00, 0}, {0xc2, 0x00, 0},
+        {0xd0, 0x00, 0}, {0x2a, 0x00, 0}, {0xbf, 0x00, 0}, {0x1c, 0x00, 0}
+    },
+    /* 20 */
+    {
+        {0x00, 0xb2, 3}, {0x00, 0xb5, 3}, {0x00, 0xb9, 3}, {0x00, 0xba, 3},
+        {0x00, 0xbb, 3}, {0x00, 0xbd, 3}, {0x00, 0xbe, 3}, {0x00, 0xc4, 3},
+        {0x00, 0xc6, 3}, {0x00, 0xe4, 3}, {0x00, 0xe8, 3}, {0x00, 0xe9, 3},
+        {0x18, 0x00, 0}, {0xa1, 0x00, 0}, {0xa3, 0x00, 0}, {0xa4, 0x00, 0}
+    },
+    /* 21 */
+    {
+        {0x42, 0xc6, 1}, {0x01, 0xc6, 3}, {0x42, 0xe4, 1}, {0x01, 0xe4, 3},
+        {0x42, 0xe8, 1}, {0x01, 0xe8, 3}, {0x42, 0xe9, 1}, {0x01, 0xe9, 3},
+        {0x00, 0x01, 3}, {0x00, 0x87, 3}, {0x00, 0x89, 3}, {0x00, 0x8a, 3},
+        {0x00, 0x8b, 3}, {0x00, 0x8c, 3}, {0x00, 0x8d, 3}, {0x00, 0x8f, 3}
+    },
+    /* 22 */
+    {
+        {0x42, 0x01, 1}, {0x01, 0x01, 3}, {0x42, 0x87, 1}, {0x01, 0x87, 3},
+        {0x42, 0x89, 1}, {0x01, 0x89, 3}, {0x42, 0x8a, 1}, {0x01, 0x8a, 3},
+        {0x42, 0x8b, 1}, {0x01, 0x8b, 3}, {0x42, 0x8c, 1}, {0x01, 0x8c, 3},
+        {0x42, 0x8d, 1}, {0x01, 0x8d, 3}, {0x42, 0x8f, 1}, {0x01, 0x8f, 3}
+    },
+    /* 23 */
+    {
+        {0x55, 0x01, 1}, {0x43, 0x01, 1}, {0x5d, 0x01, 1}, {0x02, 0x01, 3},
+        {0x55, 0x87, 1}, {0x43, 0x87, 1}, {0x5d, 0x87, 1}, {0x02, 0x87, 3},
+        {0x55, 0x89, 1}, {0x43, 0x89, 1}, {0x5d, 0x89, 1}, {0x02, 0x89, 3},
+        {0x55, 0x8a, 1}, {0x43, 0x8a, 1}, {0x5d, 0x8a, 1}, {0x02, 0x8a, 3}
+    },
+    /* 24 */
+    {
+        {0x56, 0x01, 1}, {0x82, 0x01, 1}, {0x44, 0x01, 1}, {0x52, 0x01, 1},
+        {0x63, 0x01, 1}, {0x5e, 0x01, 1}, {0x68, 0x01, 1}, {0x03, 0x01, 3},
+        {0x56, 0x87, 1}, {0x82, 0x87, 1}, {0x44, 0x87, 1}, {0x52, 0x87, 1},
+        {0x63, 0x87, 1}, {0x5e, 0x87, 1}, {0x68, 0x87, 1}, {0x03, 0x87, 3}
+    },
+    /* 25 */
+    {
+        {0xaa, 0x00, 0}, {0xac, 0x00, 0}, {0xae, 0x00, 0}, {0xb5, 0x00, 0},
+        {0xbb, 0x00, 0}, {0xbd, 0x00, 0}, {0xc3, 0x00, 0}, {0xcb, 0x00, 0},
+        {0xd1, 0x00, 0}, {0xd7, 0x00, 0}, {0x2b, 0x00, 0}, {0xa5, 0x00, 0},
+        {0xc0, 0x00, 0}, {0xda, 0x00, 0}, {0xd3, 0x00, 0}, {0x1d, 0x00, 0}
+    },
+    /* 26 */
+    {
+        {0x00, 0xbc, 3}, {0x00, 0xbf, 3}, {0x00, 0xc5, 3}, {0x00, 0xe7, 3},
+        {0x00, 0xef, 3}, {0x2c, 0x00, 0}, {0xa6, 0x00, 0}, {0xab, 0x00, 0},
+        {0xc1, 0x00, 0}, {0xea, 0x00, 0}, {0xf5, 0x00, 0}, {0xdb, 0x00, 0},
+        {0xd4, 0x00, 0}, {0xe0, 0x00, 0}, {0xe5, 0x00, 0}, {0x1e, 0x00, 0}
+    },
+    /* 27 */
+    {
+        {0x00, 0xab, 3}, {0x00, 0xce, 3}, {0x00, 0xd7, 3}, {0x00, 0xe1, 3},
+        {0x00, 0xec, 3}, {0x00, 0xed, 3}, {0xdc, 0x00, 0}, {0xf4, 0x00, 0},
+        {0xd5, 0x00, 0}, {0xde, 0x00, 0}, {0xed, 0x00, 0}, {0xe1, 0x00, 0},
+        {0xe6, 0x00, 0}, {0xf9, 0x00, 0}, {0x1f, 0x00, 0}, {0x2d, 0x00, 0}
+    },
+    /* 28 */
+    {
+        {0xd6, 0x00, 0}, {0xdd, 0x00, 0}, {0xdf, 0x00, 0}, {0xe4, 0x00, 0},
+        {0xee, 0x00, 0}, {0xf6, 0x00, 0}, {0xf8, 0x00, 0}, {0xe2, 0x00, 0},
+        {0xe7, 0x00, 0}, {0xef, 0x00, 0}, {0xfa, 0x00, 0}, {0xfd, 0x00, 0},
+        {0x20, 0x00, 0}, {0x26, 0x00, 0}, {0x37, 0x00, 0}, {0x2e, 0x00, 0}
+    },
+    /* 29 */
+    {
+        {0xe8, 0x00, 0}, {0xe9, 0x00, 0}, {0xf0, 0x00, 0}, {0xf7, 0x00, 0},
+        {0xfb, 0x00, 0}, {0xfc, 0x00, 0}, {0xfe, 0x00, 0}, {0xff, 0x00, 0},
+        {0x21, 0x00, 0}, {0x23, 0x00, 0}, {0x27, 0x00, 0}, {0x34, 0x00, 0},
+        {0x38, 0x00, 0}, {0x3c, 0x00, 0}, {0x3f, 0x00, 0}, {0x2f, 0x00, 0}
+    },
+    /* 30 */
+    {
+        {0x00, 0xfe, 3}, {0x22, 0x00, 0}, {0x24, 0x00, 0}, {0x25, 0x00, 0},
+        {0x28, 0x00, 0}, {0x33, 0x00, 0}, {0x35, 0x00, 0}, {0x36, 0x00, 0},
+        {0x39, 0x00, 0}, {0x3a, 0x00, 0}, {0x3d, 0x00, 0}, {0x3e, 0x00, 0},
+        {0x40, 0x00, 0}, {0x41, 0x00, 0}, {0x93, 0x00, 0}, {0x30, 0x00, 0}
+    },
+    /* 31 */
+    {
+        {0x42, 0xfe, 1}, {0x01, 0xfe, 3}, {0x00, 0x02, 3}, {0x00, 0x03, 3},
+        {0x00, 0x04, 3}, {0x00, 0x05, 3}, {0x00, 0x06, 3}, {0x00, 0x07, 3},
+        {0x00, 0x08, 3}, {0x00, 0x0b, 3}, {0x00, 0x0c, 3}, {0x00, 0x0e, 3},
+        {0x00, 0x0f, 3}, {0x00, 0x10, 3}, {0x00, 0x11, 3}, {0x00, 0x12, 3}
+    },
+    /* 32 */
+    {
+        {0x55, 0xfe, 1}, {0x43, 0xfe, 1}, {0x5d, 0xfe, 1}, {0x02, 0xfe, 3},
+        {0x42, 0x02, 1}, {0x01, 0x02, 3}, {0x42, 0x03, 1}, {0x01, 0x03, 3},
+        {0x42, 0x04, 1}, {0x01, 0x04, 3}, {0x42, 0x05, 1}, {0x01, 0x05, 3},
+        {0x42, 0x06, 1}, {0x01, 0x06, 3}, {0x42, 0x07, 1}, {0x01, 0x07, 3}
+    },
+    /* 33 */
+    {
+        {0x56, 0xfe, 1}, {0x82, 0xfe, 1}, {0x44, 0xfe, 1}, {0x52, 0xfe, 1},
+        {0x63, 0xfe, 1}, {0x5e, 0xfe, 1}, {0x68, 0xfe, 1}, {0x03, 0xfe, 3},
+        {0x55, 0x02, 1}, {0x43, 0x02, 1}, {0x5d, 0x02, 1}, {0x02, 0x02, 3},
+        {0x55, 0x03, 1}, {0x43, 0x03, 1}, {0x5d, 0x03, 1}, {0x02, 0x03, 3}
+    },
+    /* 34 */
+    {
+        {0x56, 0x02, 1}, {0x82, 0x02, 1}, {0x44, 0x02, 1}, {0x52, 0x02, 1},
+        {0x63, 0x02, 1}, {0x5e, 0x02, 1}, {0x68, 0x02, 1}, {0x03, 0x02, 3},
+        {0x56, 0x03, 1}, {0x82, 0x03, 1}, {0x44, 0x03, 1}, {0x52, 0x03, 1},
+        {0x63, 0x03, 1}, {0x5e, 0x03, 1}, {0x68, 0x03, 1}, {0x03, 0x03, 3}
+    },
+    /* 35 */
+    {
+        {0x55, 0x04, 1}, {0x43, 0x04, 1}, {0x5d, 0x04, 1}, {0x02, 0x04, 3},
+        {0x55, 0x05, 1}, {0x43, 0x05, 1}, {0x5d, 0x05, 1}, {0x02, 0x05, 3},
+        {0x55, 0x06, 1}, {0x43, 0x06, 1}, {0x5d, 0x06, 1}, {0x02, 0x06, 3},
+        {0x55, 0x07, 1}, {0x43, 0x07, 1}, {0x5d, 0x07, 1}, {0x02, 0x07, 3}
+    },
+    /* 36 */
+    {
+        {0x56, 0x04, 1}, {0x82, 0x04, 1}, {0x44, 0x04, 1}, {0x52, 0x04, 1},
+        {0x63, 0x04, 1}, {0x5e, 0x04, 1}, {0x68, 0x04, 1}, {0x03, 0x04, 3},
+        {0x56, 0x05, 1}, {0x82, 0x05, 1}, {0x44, 0x05, 1}, {0x52, 0x05, 1},
+        {0x63, 0x05, 1}, {0x5e, 0x05, 1}, {0x68, 0x05, 1}, {0x03, 0x05, 3}
+    },
+    /* 37 */
+    {
+        {0x56, 0x06, 1}, {0x82, 0x06, 1}, {0x44, 0x06, 1}, {0x52, 0x06, 1},
+        {0x63, 0x06, 1}, {0x5e, 0x06, 1}, {0x68, 0x06, 1}, {0x03, 0x06, 3},
+        {0x56, 0x07, 1}, {0x82, 0x07, 1}, {0x44, 0x07, 1}, {0x52, 0x07, 1},
+        {0x63, 0x07, 1}, {0x5e, 0x07, 1}, {0x68, 0x07, 1}, {0x03, 0x07, 3}
+    },
+    /* 38 */
+    {
+        {0x42, 0x08, 1}, {0x01, 0x08, 3}, {0x42, 0x0b, 1}, {0x01, 0x0b, 3},
+        {0x42, 0x0c, 1}, {0x01, 0x0c, 3}, {0x42, 0x0e, 1}, {0x01, 0x0e, 3},
+        {0x42, 0x0f, 1}, {0x01, 0x0f, 3}, {0x42, 0x10, 1}, {0x01, 0x10, 3},
+        {0x42, 0x11, 1}, {0x01, 0x11, 3}, {0x42, 0x12, 1}, {0x01, 0x12, 3}
+    },
+    /* 39 */
+    {
+        {0x55, 0x08, 1}, {0x43, 0x08, 1}, {0x5d, 0x08, 1}, {0x02, 0x08, 3},
+        {0x55, 0x0b, 1}, {0x43, 0x0b, 1}, {0x5d, 0x0b, 1}, {0x02, 0x0b, 3},
+        {0x55, 0x0c, 1}, {0x43, 0x0c, 1}, {0x5d, 0x0c, 1}, {0x02, 0x0c, 3},
+        {0x55, 0x0e, 1}, {0x43, 0x0e, 1}, {0x5d, 0x0e, 1}, {0x02, 0x0e, 3}
+    },
+    /* 40 */
+    {
+        {0x56, 0x08, 1}, {0x82, 0x08, 1}, {0x44, 0x08, 1}, {0x52, 0x08, 1},
+        {0x63, 0x08, 1}, {0x5e, 0x08, 1}, {0x68, 0x08, 1}, {0x03, 0x08, 3},
+        {0x56, 0x0b, 1}, {0x82, 0x0b, 1}, {0x44, 0x0b, 1}, {0x52, 0x0b, 1},
+        {0x63, 0x0b, 1}, {0x5e, 0x0b, 1}, {0x68, 0x0b, 1}, {0x03, 0x0b, 3}
+    },
+    /* 41 */
+    {
+        {0x42, 0xbc, 1}, {0x01, 0xbc, 3}, {0x42, 0xbf, 1}, {0x01, 0xbf, 3},
+        {0x42, 0xc5, 1}, {0x01, 0xc5, 3}, {0x42, 0xe7, 1}, {0x01, 0xe7, 3},
+        {0x42, 0xef, 1}, {0x01, 0xef, 3}, {0x00, 0x09, 3}, {0x00, 0x8e, 3},
+        {0x00, 0x90, 3}, {0x00, 0x91, 3}, {0x00, 0x94, 3}, {0x00, 0x9f, 3}
+    },
+    /* 42 */
+    {
+        {0x55, 0xef, 1}, {0x43, 0xef, 1}, {0x5d, 0xef, 1}, {0x02, 0xef, 3},
+        {0x42, 0x09, 1}, {0x01, 0x09, 3}, {0x42, 0x8e, 1}, {0x01, 0x8e, 3},
+        {0x42, 0x90, 1}, {0x01, 0x90, 3}, {0x42, 0x91, 1}, {0x01, 0x91, 3},
+        {0x42, 0x94, 1}, {0x01, 0x94, 3}, {0x42, 0x9f, 1}, {0x01, 0x9f, 3}
+    },
+    /* 43 */
+    {
+        {0x56, 0xef, 1}, {0x82, 0xef, 1}, {0x44, 0xef, 1}, {0x52, 0xef, 1},
+        {0x63, 0xef, 1}, {0x5e, 0xef, 1}, {0x68, 0xef, 1}, {0x03, 0xef, 3},
+        {0x55, 0x09, 1}, {0x43, 0x09, 1}, {0x5d, 0x09, 1}, {0x02, 0x09, 3},
+        {0x55, 0x8e, 1}, {0x43, 0x8e, 1}, {0x5d, 0x8e, 1}, {0x02, 0x8e, 3}
+    },
+    /* 44 */
+    {
+        {0x56, 0x09, 1}, {0x82, 0x09, 1}, {0x44, 0x09, 1}, {0x52, 0x09, 1},
+        {0x63, 0x09, 1}, {0x5e, 0x09, 1}, {0x68, 0x09, 1}, {0x03, 0x09, 3},
+        {0x56, 0x8e, 1}, {0x82, 0x8e, 1}, {0x44, 0x8e, 1}, {0x52, 0x8e, 1},
+        {0x63, 0x8e, 1}, {0x5e, 0x8e, 1}, {0x68, 0x8e, 1}, {0x03, 0x8e, 3}
+    },
+    /* 45 */
+    {
+        {0x00, 0x13, 3}, {0x00, 0x14, 3}, {0x00, 0x15, 3}, {0x00, 0x17, 3},
+        {0x00, 0x18, 3}, {0x00, 0x19, 3}, {0x00, 0x1a, 3}, {0x00, 0x1b, 3},
+        {0x00, 0x1c, 3}, {0x00, 0x1d, 3}, {0x00, 0x1e, 3}, {0x00, 0x1f, 3},
+        {0x00, 0x7f, 3}, {0x00, 0xdc, 3}, {0x00, 0xf9, 3}, {0x31, 0x00, 0}
+    },
+    /* 46 */
+    {
+        {0x42, 0x1c, 1}, {0x01, 0x1c, 3}, {0x42, 0x1d, 1}, {0x01, 0x1d, 3},
+        {0x42, 0x1e, 1}, {0x01, 0x1e, 3}, {0x42, 0x1f, 1}, {0x01, 0x1f, 3},
+        {0x42, 0x7f, 1}, {0x01, 0x7f, 3}, {0x42, 0xdc, 1}, {0x01, 0xdc, 3},
+        {0x42, 0xf9, 1}, {0x01, 0xf9, 3}, {0x32, 0x00, 0}, {0x3b, 0x00, 0}
+    },
+    /* 47 */
+    {
+        {0x55, 0x7f, 1}, {0x43, 0x7f, 1}, {0x5d, 0x7f, 1}, {0x02, 0x7f, 3},
+        {0x55, 0xdc, 1}, {0x43, 0xdc, 1}, {0x5d, 0xdc, 1}, {0x02, 0xdc, 3},
+        {0x55, 0xf9, 1}, {0x43, 0xf9, 1}, {0x5d, 0xf9, 1}, {0x02, 0xf9, 3},
+        {0x00, 0x0a, 3}, {0x00, 0x0d, 3}, {0x00, 0x16, 3}, {0x00, 0x00, 4}
+    },
+    /* 48 */
+    {
+        {0x56, 0xf9, 1}, {0x82, 0xf9, 1}, {0x44, 0xf9, 1}, {0x52, 0xf9, 1},
+        {0x63, 0xf9, 1}, {0x5e, 0xf9, 1}, {0x68, 0xf9, 1}, {0x03, 0xf9, 3},
+        {0x42, 0x0a, 1}, {0x01, 0x0a, 3}, {0x42, 0x0d, 1}, {0x01, 0x0d, 3},
+        {0x42, 0x16, 1}, {0x01, 0x16, 3}, {0x00, 0x00, 4}, {0x00, 0x00, 4}
+    },
+    /* 49 */
+    {
+        {0x55, 0x0a, 1}, {0x43, 0x0a, 1}, {0x5d, 0x0a, 1}, {0x02, 0x0a, 3},
+        {0x55, 0x0d, 1}, {0x43, 0x0d, 1}, {0x5d, 0x0d, 1}, {0x02, 0x0d, 3},
+        {0x55, 0x16, 1}, {0x43, 0x16, 1}, {0x5d, 0x16, 1}, {0x02, 0x16, 3},
+        {0x00, 0x00, 4}, {0x00, 0x00, 4}, {0x00, 0x00, 4}, {0x00, 0x00, 4}
+    },
+    /* 50 */
+    {
+        {0x56, 0x0a, 1}, {0x82, 0x0a, 1}, {0x44, 0x0a, 1}, {0x52, 0x0a, 1},
+        {0x63, 0x0a, 1}, {0x5e, 0x0a, 1}, {0x68, 0x0a, 1}, {0x03, 0x0a, 3},
+        {0x56, 0x0d, 1}, {0x82, 0x0d, 1}, {0x44, 0x0d, 1}, {0x52, 0x0d, 1},
+        {0x63, 0x0d, 1}, {0x5e, 0x0d, 1}, {0x68, 0x0d, 1}, {0x03, 0x0d, 3}
+    },
+    /* 51 */
+    {
+        {0x56, 0x0c, 1}, {0x82, 0x0c, 1}, {0x44, 0x0c, 1}, {0x52, 0x0c, 1},
+        {0x63, 0x0c, 1}, {0x5e, 0x0c, 1}, {0x68, 0x0c, 1}, {0x03, 0x0c, 3},
+        {0x56, 0x0e, 1}, {0x82, 0x0e, 1}, {0x44, 0x0e, 1}, {0x52, 0x0e, 1},
+        {0x63, 0x0e, 1}, {0x5e, 0x0e, 1}, {0x68, 0x0e, 1}, {0x03, 0x0e, 3}
+    },
+    /* 52 */
+    {
+        {0x55, 0x0f, 1}, {0x43, 0x0f, 1}, {0x5d, 0x0f, 1}, {0x02, 0x0f, 3},
+        {0x55, 0x10, 1}, {0x43, 0x10, 1}, {0x5d, 0x10, 1}, {0x02, 0x10, 3},
+        {0x55, 0x11, 1}, {0x43, 0x11, 1}, {0x5d, 0x11, 1}, {0x02, 0x11, 3},
+        {0x55, 0x12, 1}, {0x43, 0x12, 1}, {0x5d, 0x12, 1}, {0x02, 0x12, 3}
+    },
+    /* 53 */
+    {
+        {0x56, 0x0f, 1}, {0x82, 0x0f, 1}, {0x44, 0x0f, 1}, {0x52, 0x0f, 1},
+        {0x63, 0x0f, 1}, {0x5e, 0x0f, 1}, {0x68, 0x0f, 1}, {0x03, 0x0f, 3},
+        {0x56, 0x10, 1}, {0x82, 0x10, 1}, {0x44, 0x10, 1}, {0x52, 0x10, 1},
+        {0x63, 0x10, 1}, {0x5e, 0x10, 1}, {0x68, 0x10, 1}, {0x03, 0x10, 3}
+    },
+    /* 54 */
+    {
+        {0x56, 0x11, 1}, {0x82, 0x11, 1}, {0x44, 0x11, 1}, {0x52, 0x11, 1},
+        {0x63, 0x11, 1}, {0x5e, 0x11, 1}, {0x68, 0x11, 1}, {0x03, 0x11, 3},
+        {0x56, 0x12, 1}, {0x82, 0x12, 1}, {0x44, 0x12, 1}, {0x52, 0x12, 1},
+        {0x63, 0x12, 1}, {0x5e, 0x12, 1}, {0x68, 0x12, 1}, {0x03, 0x12, 3}
+    },
+    /* 55 */
+    {
+        {0x42, 0x13, 1}, {0x01, 0x13, 3}, {0x42, 0x14, 1}, {0x01, 0x14, 3},
+        {0x42, 0x15, 1}, {0x01, 0x15, 3}, {0x42, 0x17, 1}, {0x01, 0x17, 3},
+        {0x42, 0x18, 1}, {0x01, 0x18, 3}, {0x42, 0x19, 1}, {0x01, 0x19, 3},
+        {0x42, 0x1a, 1}, {0x01, 0x1a, 3}, {0x42, 0x1b, 1}, {0x01, 0x1b, 3}
+    },
+    /* 56 */
+    {
+        {0x55, 0x13, 1}, {0x43, 0x13, 1}, {0x5d, 0x13, 1}, {0x02, 0x13, 3},
+        {0x55, 0x14, 1}, {0x43, 0x14, 1}, {0x5d, 0x14, 1}, {0x02, 0x14, 3},
+        {0x55, 0x15, 1}, {0x43, 0x15, 1}, {0x5d, 0x15, 1}, {0x02, 0x15, 3},
+        {0x55, 0x17, 1}, {0x43, 0x17, 1}, {0x5d, 0x17, 1}, {0x02, 0x17, 3}
+    },
+    /* 57 */
+    {
+        {0x56, 0x13, 1}, {0x82, 0x13, 1}, {0x44, 0x13, 1}, {0x52, 0x13, 1},
+        {0x63, 0x13, 1}, {0x5e, 0x13, 1}, {0x68, 0x13, 1}, {0x03, 0x13, 3},
+        {0x56, 0x14, 1}, {0x82, 0x14, 1}, {0x44, 0x14, 1}, {0x52, 0x14, 1},
+        {0x63, 0x14, 1}, {0x5e, 0x14, 1}, {0x68, 0x14, 1}, {0x03, 0x14, 3}
+    },
+    /* 58 */
+    {
+        {0x56, 0x15, 1}, {0x82, 0x15, 1}, {0x44, 0x15, 1}, {0x52, 0x15, 1},
+        {0x63, 0x15, 1}, {0x5e, 0x15, 1}, {0x68, 0x15, 1}, {0x03, 0x15, 3},
+        {0x56, 0x17, 1}, {0x82, 0x17, 1}, {0x44, 0x17, 1}, {0x52, 0x17, 1},
+        {0x63, 0x17, 1}, {0x5e, 0x17, 1}, {0x68, 0x17, 1}, {0x03, 0x17, 3}
+    },
+    /* 59 */
+    {
+        {0x56, 0x16, 1}, {0x82, 0x16, 1}, {0x44, 0x16, 1}, {0x52, 0x16, 1},
+        {0x63, 0x16, 1}, {0x5e, 0x16, 1}, {0x68, 0x16, 1}, {0x03, 0x16, 3},
+        {0x00, 0x00, 4}, {0x00, 0x00, 4}, {0x00, 0x00, 4}, {0x00, 0x00, 4},
+        {0x00, 0x00, 4}, {0x00, 0x00, 4}, {0x00, 0x00, 4}, {0x00, 0x00, 4}
+    },
+    /* 60 */
+    {
+        {0x55, 0x18, 1}, {0x43, 0x18, 1}, {0x5d, 0x18, 1}, {0x02, 0x18, 3},
+        {0x55, 0x19, 1}, {0x43, 0x19, 1}, {0x5d, 0x19, 1}, {0x02, 0x19, 3},
+        {0x55, 0x1a, 1}, {0x43, 0x1a, 1}, {0x5d, 0x1a, 1}, {0x02, 0x1a, 3},
+        {0x55, 0x1b, 1}, {0x43, 0x1b, 1}, {0x5d, 0x1b, 1}, {0x02, 0x1b, 3}
+    },
+    /* 61 */
+    {
+        {0x56, 0x18, 1}, {0x82, 0x18, 1}, {0x44, 0x18, 1}, {0x52, 0x18, 1},
+        {0x63, 0x18, 1}, {0x5e, 0x18, 1}, {0x68, 0x18, 1}, {0x03, 0x18, 3},
+        {0x56, 0x19, 1}, {0x82, 0x19, 1}, {0x44, 0x19, 1}, {0x52, 0x19, 1},
+        {0x63, 0x19, 1}, {0x5e, 0x19, 1}, {0x68, 0x19, 1}, {0x03, 0x19, 3}
+    },
+    /* 62 */
+    {
+        {0x56, 0x1a, 1}, {0x82, 0x1a, 1}, {0x44, 0x1a, 1}, {0x52, 0x1a, 1},
+        {0x63, 0x1a, 1}, {0x5e, 0x1a, 1}, {0x68, 0x1a, 1}, {0x03, 0x1a, 3},
+        {0x56, 0x1b, 1}, {0x82, 0x1b, 1}, {0x44, 0x1b, 1}, {0x52, 0x1b, 1},
+        {0x63, 0x1b, 1}, {0x5e, 0x1b, 1}, {0x68, 0x1b, 1}, {0x03, 0x1b, 3}
+    },
+    /* 63 */
+    {
+        {0x55, 0x1c, 1}, {0x43, 0x1c, 1}, {0x5d, 0x1c, 1}, {0x02, 0x1c, 3},
+        {0x55, 0x1d, 1}, {0x43, 0x1d, 1}, {0x5d, 0x1d, 1}, {0x02, 0x1d, 3},
+        {0x55, 0x1e, 1}, {0x43, 0x1e, 1}, {0x5d, 0x1e, 1}, {0x02, 0x1e, 3},
+        {0x55, 0x1f, 1}, {0x43, 0x1f, 1}, {0x5d, 0x1f, 1}, {0x02, 0x1f, 3}
+    },
+    /* 64 */
+    {
+        {0x56, 0x1c, 1}, {0x82, 0x1c, 1}, {0x44, 0x1c, 1}, {0x52, 0x1c, 1},
+        {0x63, 0x1c, 1}, {0x5e, 0x1c, 1}, {0x68, 0x1c, 1}, {0x03, 0x1c, 3},
+        {0x56, 0x1d, 1}, {0x82, 0x1d, 1}, {0x44, 0x1d, 1}, {0x52, 0x1d, 1},
+        {0x63, 0x1d, 1}, {0x5e, 0x1d, 1}, {0x68, 0x1d, 1}, {0x03, 0x1d, 3}
+    },
+    /* 65 */
+    {
+        {0x56, 0x1e, 1}, {0x82, 0x1e, 1}, {0x44, 0x1e, 1}, {0x52, 0x1e, 1},
+        {0x63, 0x1e, 1}, {0x5e, 0x1e, 1}, {0x68, 0x1e, 1}, {0x03, 0x1e, 3},
+        {0x56, 0x1f, 1}, {0x82, 0x1f, 1}, {0x44, 0x1f, 1}, {0x52, 0x1f, 1},
+        {0x63, 0x1f, 1}, {0x5e, 0x1f, 1}, {0x68, 0x1f, 1}, {0x03, 0x1f, 3}
+    },
+    /* 66 */
+    {
+        {0x00, 0x30, 3}, {0x00, 0x31, 3}, {0x00, 0x32, 3}, {0x00, 0x61, 3},
+        {0x00, 0x63, 3}, {0x00, 0x65, 3}, {0x00, 0x69, 3}, {0x00, 0x6f, 3},
+        {0x00, 0x73, 3}, {0x00, 0x74, 3}, {0x46, 0x00, 0}, {0x51, 0x00, 0},
+        {0x54, 0x00, 0}, {0x59, 0x00, 0}, {0x5b, 0x00, 0}, {0x5c, 0x00, 0}
+    },
+    /* 67 */
+    {
+        {0x42, 0x73, 1}, {0x01, 0x73, 3}, {0x42, 0x74, 1}, {0x01, 0x74, 3},
+        {0x00, 0x20, 3}, {0x00, 0x25, 3}, {0x00, 0x2d, 3}, {0x00, 0x2e, 3},
+        {0x00, 0x2f, 3}, {0x00, 0x33, 3}, {0x00, 0x34, 3}, {0x00, 0x35, 3},
+        {0x00, 0x36, 3}, {0x00, 0x37, 3}, {0x00, 0x38, 3}, {0x00, 0x39, 3}
+    },
+    /* 68 */
+    {
+        {0x55, 0x73, 1}, {0x43, 0x73, 1}, {0x5d, 0x73, 1}, {0x02, 0x73, 3},
+        {0x55, 0x74, 1}, {0x43, 0x74, 1}, {0x5d, 0x74, 1}, {0x02, 0x74, 3},
+        {0x42, 0x20, 1}, {0x01, 0x20, 3}, {0x42, 0x25, 1}, {0x01, 0x25, 3},
+        {0x42, 0x2d, 1}, {0x01, 0x2d, 3}, {0x42, 0x2e, 1}, {0x01, 0x2e, 3}
+    },
+    /* 69 */
+    {
+        {0x55, 0x20, 1}, {0x43, 0x20, 1}, {0x5d, 0x20, 1}, {0x02, 0x20, 3},
+        {0x55, 0x25, 1}, {0x43, 0x25, 1}, {0x5d, 0x25, 1}, {0x02, 0x25, 3},
+        {0x55, 0x2d, 1}, {0x43, 0x2d, 1}, {0x5d, 0x2d, 1}, {0x02, 0x2d, 3},
+        {0x55, 0x2e, 1}, {0x43, 0x2e, 1}, {0x5d, 0x2e, 1}, {0x02, 0x2e, 3}
+    },
+    /* 70 */
+    {
+        {0x56, 0x20, 1}, {0x82, 0x20, 1}, {0x44, 0x20, 1}, {0x52, 0x20, 1},
+        {0x63, 0x20, 1}, {0x5e, 0x20, 1}, {0x68, 0x20, 1}, {0x03, 0x20, 3},
+        {0x56, 0x25, 1}, {0x82, 0x25, 1}, {0x44, 0x25, 1}, {0x52, 0x25, 1},
+        {0x63, 0x25, 1}, {0x5e, 0x25, 1}, {0x68, 0x25, 1}, {0x03, 0x25, 3}
+    },
+    /* 71 */
+    {
+        {0x55, 0x21, 1}, {0x43, 0x21, 1}, {0x5d, 0x21, 1}, {0x02, 0x21, 3},
+        {0x55, 0x22, 1}, {0x43, 0x22, 1}, {0x5d, 0x22, 1}, {0x02, 0x22, 3},
+        {0x55, 0x28, 1}, {0x43, 0x28, 1}, {0x5d, 0x28, 1}, {0x02, 0x28, 3},
+        {0x55, 0x29, 1}, {0x43, 0x29, 1}, {0x5d, 0x29, 1}, {0x02, 0x29, 3}
+    },
+    /* 72 */
+    {
+        {0x56, 0x21, 1}, {0x82, 0x21, 1}, {0x44, 0x21, 1}, {0x52, 0x21, 1},
+        {0x63, 0x21, 1}, {0x5e, 0x21, 1}, {0x68, 0x21, 1}, {0x03, 0x21, 3},
+        {0x56, 0x22, 1}, {0x82, 0x22, 1}, {0x44, 0x22, 1}, {0x52, 0x22, 1},
+        {0x63, 0x22, 1}, {0x5e, 0x22, 1}, {0x68, 0x22, 1}, {0x03, 0x22, 3}
+    },
+    /* 73 */
+    {
+        {0x56, 0x7c, 1}, {0x82, 0x7c, 1}, {0x44, 0x7c, 1}, {0x52, 0x7c, 1},
+        {0x63, 0x7c, 1}, {0x5e, 0x7c, 1}, {0x68, 0x7c, 1}, {0x03, 0x7c, 3},
+        {0x55, 0x23, 1}, {0x43, 0x23, 1}, {0x5d, 0x23, 1}, {0x02, 0x23, 3},
+        {0x55, 0x3e, 1}, {0x43, 0x3e, 1}, {0x5d, 0x3e, 1}, {0x02, 0x3e, 3}
+    },
+    /* 74 */
+    {
+        {0x56, 0x23, 1}, {0x82, 0x23, 1}, {0x44, 0x23, 1}, {0x52, 0x23, 1},
+        {0x63, 0x23, 1}, {0x5e, 0x23, 1}, {0x68, 0x23, 1}, {0x03, 0x23, 3},
+        {0x56, 0x3e, 1}, {0x82, 0x3e, 1}, {0x44, 0x3e, 1}, {0x52, 0x3e, 1},
+        {0x63, 0x3e, 1}, {0x5e, 0x3e, 1}, {0x68, 0x3e, 1}, {0x03, 0x3e, 3}
+    },
+    /* 75 */
+    {
+        {0x55, 0x26, 1}, {0x43, 0x26, 1}, {0x5d, 0x26, 1}, {0x02, 0x26, 3},
+        {0x55, 0x2a, 1}, {0x43, 0x2a, 1}, {0x5d, 0x2a, 1}, {0x02, 0x2a, 3},
+        {0x55, 0x2c, 1}, {0x43, 0x2c, 1}, {0x5d, 0x2c, 1}, {0x02, 0x2c, 3},
+        {0x55, 0x3b, 1}, {0x43, 0x3b, 1}, {0x5d, 0x3b, 1}, {0x02, 0x3b, 3}
+    },
+    /* 76 */
+    {
+        {0x56, 0x26, 1}, {0x82, 0x26, 1}, {0x44, 0x26, 1}, {0x52, 0x26, 1},
+        {0x63, 0x26, 1}, {0x5e, 0x26, 1}, {0x68, 0x26, 1}, {0x03, 0x26, 3},
+        {0x56, 0x2a, 1}, {0x82, 0x2a, 1}, {0x44, 0x2a, 1}, {0x52, 0x2a, 1},
+        {0x63, 0x2a, 1}, {0x5e, 0x2a, 1}, {0x68, 0x2a, 1}, {0x03, 0x2a, 3}
+    },
+    /* 77 */
+    {
+        {0x56, 0x3f, 1}, {0x82, 0x3f, 1}, {0x44, 0x3f, 1}, {0x52, 0x3f, 1},
+        {0x63, 0x3f, 1}, {0x5e, 0x3f, 1}, {0x68, 0x3f, 1}, {0x03, 0x3f, 3},
+        {0x55, 0x27, 1}, {0x43, 0x27, 1}, {0x5d, 0x27, 1}, {0x02, 0x27, 3},
+        {0x55, 0x2b, 1}, {0x43, 0x2b, 1}, {0x5d, 0x2b, 1}, {0x02, 0x2b, 3}
+    },
+    /* 78 */
+    {
+        {0x56, 0x27, 1}, {0x82, 0x27, 1}, {0x44, 0x27, 1}, {0x52, 0x27, 1},
+        {0x63, 0x27, 1}, {0x5e, 0x27, 1}, {0x68, 0x27, 1}, {0x03, 0x27, 3},
+        {0x56, 0x2b, 1}, {0x82, 0x2b, 1}, {0x44, 0x2b, 1}, {0x52, 0x2b, 1},
+        {0x63, 0x2b, 1}, {0x5e, 0x2b, 1}, {0x68, 0x2b, 1}, {0x03, 0x2b, 3}
+    },
+    /* 79 */
+    {
+        {0x56, 0x28, 1}, {0x82, 0x28, 1}, {0x44, 0x28, 1}, {0x52, 0x28, 1},
+        {0x63, 0x28, 1}, {0x5e, 0x28, 1}, {0x68, 0x28, 1}, {0x03, 0x28, 3},
+        {0x56, 0x29, 1}, {0x82, 0x29, 1}, {0x44, 0x29, 1}, {0x52, 0x29, 1},
+        {0x63, 0x29, 1}, {0x5e, 0x29, 1}, {0x68, 0x29, 1}, {0x03, 0x29, 3}
+    },
+    /* 80 */
+    {
+        {0x56, 0x2c, 1}, {0x82, 0x2c, 1}, {0x44, 0x2c, 1}, {0x52, 0x2c, 1},
+        {0x63, 0x2c, 1}, {0x5e, 0x2c, 1}, {0x68, 0x2c, 1}, {0x03, 0x2c, 3},
+        {0x56, 0x3b, 1}, {0x82, 0x3b, 1}, {0x44, 0x3b, 1}, {0x52, 0x3b, 1},
+        {0x63, 0x3b, 1}, {0x5e, 0x3b, 1}, {0x68, 0x3b, 1}, {0x03, 0x3b, 3}
+    },
+    /* 81 */
+    {
+        {0x56, 0x2d, 1}, {0x82, 0x2d, 1}, {0x44, 0x2d, 1}, {0x52, 0x2d, 1},
+        {0x63, 0x2d, 1}, {0x5e, 0x2d, 1}, {0x68, 0x2d, 1}, {0x03, 0x2d, 3},
+        {0x56, 0x2e, 1}, {0x82, 0x2e, 1}, {0x44, 0x2e, 1}, {0x52, 0x2e, 1},
+        {0x63, 0x2e, 1}, {0x5e, 0x2e, 1}, {0x68, 0x2e, 1}, {0x03, 0x2e, 3}
+    },
+    /* 82 */
+    {
+        {0x42, 0x2f, 1}, {0x01, 0x2f, 3}, {0x42, 0x33, 1}, {0x01, 0x33, 3},
+        {0x42, 0x34, 1}, {0x01, 0x34, 3}, {0x42, 0x35, 1}, {0x01, 0x35, 3},
+        {0x42, 0x36, 1}, {0x01, 0x36, 3}, {0x42, 0x37, 1}, {0x01, 0x37, 3},
+        {0x42, 0x38, 1}, {0x01, 0x38, 3}, {0x42, 0x39, 1}, {0x01, 0x39, 3}
+    },
+    /* 83 */
+    {
+        {0x55, 0x2f, 1}, {0x43, 0x2f, 1}, {0x5d, 0x2f, 1}, {0x02, 0x2f, 3},
+        {0x55, 0x33, 1}, {0x43, 0x33, 1}, {0x5d, 0x33, 1}, {0x02, 0x33, 3},
+        {0x55, 0x34, 1}, {0x43, 0x34, 1}, {0x5d, 0x34, 1}, {0x02, 0x34, 3},
+        {0x55, 0x35, 1}, {0x43, 0x35, 1}, {0x5d, 0x35, 1}, {0x02, 0x35, 3}
+    },
+    /* 84 */
+    {
+        {0x56, 0x2f, 1}, {0x82, 0x2f, 1}, {0x44, 0x2f, 1}, {0x52, 0x2f, 1},
+        {0x63, 0x2f, 1}, {0x5e, 0x2f, 1}, {0x68, 0x2f, 1}, {0x03, 0x2f, 3},
+        {0x56, 0x33, 1}, {0x82, 0x33, 1}, {0x44, 0x33, 1}, {0x52, 0x33, 1},
+        {0x63, 0x33, 1}, {0x5e, 0x33, 1}, {0x68, 0x33, 1}, {0x03, 0x33, 3}
+    },
+    /* 85 */
+    {
+        {0x42, 0x30, 1}, {0x01, 0x30, 3}, {0x42, 0x31, 1}, {0x01, 0x31, 3},
+        {0x42, 0x32, 1}, {0x01, 0x32, 3}, {0x42, 0x61, 1}, {0x01, 0x61, 3},
+        {0x42, 0x63, 1}, {0x01, 0x63, 3}, {0x42, 0x65, 1}, {0x01, 0x65, 3},
+        {0x42, 0x69, 1}, {0x01, 0x69, 3}, {0x42, 0x6f, 1}, {0x01, 0x6f, 3}
+    },
+    /* 86 */
+    {
+        {0x55, 0x30, 1}, {0x43, 0x30, 1}, {0x5d, 0x30, 1}, {0x02, 0x30, 3},
+        {0x55, 0x31, 1}, {0x43, 0x31, 1}, {0x5d, 0x31, 1}, {0x02, 0x31, 3},
+        {0x55, 0x32, 1}, {0x43, 0x32, 1}, {0x5d, 0x32, 1}, {0x02, 0x32, 3},
+        {0x55, 0x61, 1}, {0x43, 0x61, 1}, {0x5d, 0x61, 1}, {0x02, 0x61, 3}
+    },
+    /* 87 */
+    {
+        {0x56, 0x30, 1}, {0x82, 0x30, 1}, {0x44, 0x30, 1}, {0x52, 0x30, 1},
+        {0x63, 0x30, 1}, {0x5e, 0x30, 1}, {0x68, 0x30, 1}, {0x03, 0x30, 3},
+        {0x56, 0x31, 1}, {0x82, 0x31, 1}, {0x44, 0x31, 1}, {0x52, 0x31, 1},
+        {0x63, 0x31, 1}, {0x5e, 0x31, 1}, {0x68, 0x31, 1}, {0x03, 0x31, 3}
+    },
+    /* 88 */
+    {
+        {0x56, 0x32, 1}, {0x82, 0x32, 1}, {0x44, 0x32, 1}, {0x52, 0x32, 1},
+        {0x63, 0x32, 1}, {0x5e, 0x32, 1}, {0x68, 0x32, 1}, {0x03, 0x32, 3},
+        {0x56, 0x61, 1}, {0x82, 0x61, 1}, {0x44, 0x61, 1}, {0x52, 0x61, 1},
+        {0x63, 0x61, 1}, {0x5e, 0x61, 1}, {0x68, 0x61, 1}, {0x03, 0x61, 3}
+    },
+    /* 89 */
+    {
+        {0x56, 0x34, 1}, {0x82, 0x34, 1}, {0x44, 0x34, 1}, {0x52, 0x34, 1},
+        {0x63, 0x34, 1}, {0x5e, 0x34, 1}, {0x68, 0x34, 1}, {0x03, 0x34, 3},
+        {0x56, 0x35, 1}, {0x82, 0x35, 1}, {0x44, 0x35, 1}, {0x52, 0x35, 1},
+        {0x63, 0x35, 1}, {0x5e, 0x35, 1}, {0x68, 0x35, 1}, {0x03, 0x35, 3}
+    },
+    /* 90 */
+    {
+        {0x55, 0x36, 1}, {0x43, 0x36, 1}, {0x5d, 0x36, 1}, {0x02, 0x36, 3},
+        {0x55, 0x37, 1}, {0x43, 0x37, 1}, {0x5d, 0x37, 1}, {0x02, 0x37, 3},
+        {0x55, 0x38, 1}, {0x43, 0x38, 1}, {0x5d, 0x38, 1}, {0x02, 0x38, 3},
+        {0x55, 0x39, 1}, {0x43, 0x39, 1}, {0x5d, 0x39, 1}, {0x02, 0x39, 3}
+    },
+    /* 91 */
+    {
+        {0x56, 0x36, 1}, {0x82, 0x36, 1}, {0x44, 0x36, 1}, {0x52, 0x36, 1},
+        {0x63, 0x36, 1}, {0x5e, 0x36, 1}, {0x68, 0x36, 1}, {0x03, 0x36, 3},
+        {0x56, 0x37, 1}, {0x82, 0x37, 1}, {0x44, 0x37, 1}, {0x52, 0x37, 1},
+        {0x63, 0x37, 1}, {0x5e, 0x37, 1}, {0x68, 0x37, 1}, {0x03, 0x37, 3}
+    },
+    /* 92 */
+    {
+        {0x56, 0x38, 1}, {0x82, 0x38, 1}, {0x44, 0x38, 1}, {0x52, 0x38, 1},
+        {0x63, 0x38, 1}, {0x5e, 0x38, 1}, {0x68, 0x38, 1}, {0x03, 0x38, 3},
+        {0x56, 0x39, 1}, {0x82, 0x39, 1}, {0x44, 0x39, 1}, {0x52, 0x39, 1},
+        {0x63, 0x39, 1}, {0x5e, 0x39, 1}, {0x68, 0x39, 1}, {0x03, 0x39, 3}
+    },
+    /* 93 */
+    {
+        {0x00, 0x3d, 3}, {0x00, 0x41, 3}, {0x00, 0x5f, 3}, {0x00, 0x62, 3},
+        {0x00, 0x64, 3}, {0x00, 0x66, 3}, {0x00, 0x67, 3}, {0x00, 0x68, 3},
+        {0x00, 0x6c, 3}, {0x00, 0x6d, 3}, {0x00, 0x6e, 3}, {0x00, 0x70, 3},
+        {0x00, 0x72, 3}, {0x00, 0x75, 3}, {0x61, 0x00, 0}, {0x67, 0x00, 0}
+    },
+    /* 94 */
+    {
+        {0x42, 0x6c, 1}, {0x01, 0x6c, 3}, {0x42, 0x6d, 1}, {0x01, 0x6d, 3},
+        {0x42, 0x6e, 1}, {0x01, 0x6e, 3}, {0x42, 0x70, 1}, {0x01, 0x70, 3},
+        {0x42, 0x72, 1}, {0x01, 0x72, 3}, {0x42, 0x75, 1}, {0x01, 0x75, 3},
+        {0x00, 0x3a, 3}, {0x00, 0x42, 3}, {0x00, 0x43, 3}, {0x00, 0x44, 3}
+    },
+    /* 95 */
+    {
+        {0x55, 0x72, 1}, {0x43, 0x72, 1}, {0x5d, 0x72, 1}, {0x02, 0x72, 3},
+        {0x55, 0x75, 1}, {0x43, 0x75, 1}, {0x5d, 0x75, 1}, {0x02, 0x75, 3},
+        {0x42, 0x3a, 1}, {0x01, 0x3a, 3}, {0x42, 0x42, 1}, {0x01, 0x42, 3},
+        {0x42, 0x43, 1}, {0x01, 0x43, 3}, {0x42, 0x44, 1}, {0x01, 0x44, 3}
+    },
+    /* 96 */
+    {
+        {0x55, 0x3a, 1}, {0x43, 0x3a, 1}, {0x5d, 0x3a, 1}, {0x02, 0x3a, 3},
+        {0x55, 0x42, 1}, {0x43, 0x42, 1}, {0x5d, 0x42, 1}, {0x02, 0x42, 3},
+        {0x55, 0x43, 1}, {0x43, 0x43, 1}, {0x5d, 0x43, 1}, {0x02, 0x43, 3},
+        {0x55, 0x44, 1}, {0x43, 0x44, 1}, {0x5d, 0x44, 1}, {0x02, 0x44, 3}
+    },
+    /* 97 */
+    {
+        {0x56, 0x3a, 1}, {0x82, 0x3a, 1}, {0x44, 0x3a, 1}, {0x52, 0x3a, 1},
+        {0x63, 0x3a, 1}, {0x5e, 0x3a, 1}, {0x68, 0x3a, 1}, {0x03, 0x3a, 3},
+        {0x56, 0x42, 1}, {0x82, 0x42, 1}, {0x44, 0x42, 1}, {0x52, 0x42, 1},
+        {0x63, 0x42, 1}, {0x5e, 0x42, 1}, {0x68, 0x42, 1}, {0x03, 0x42, 3}
+    },
+    /* 98 */
+    {
+        {0x56, 0x3c, 1}, {0x82, 0x3c, 1}, {0x44, 0x3c, 1}, {0x52, 0x3c, 1},
+        {0x63, 0x3c, 1}, {0x5e, 0x3c, 1}, {0x68, 0x3c, 1}, {0x03, 0x3c, 3},
+        {0x56, 0x60, 1}, {0x82, 0x60, 1}, {0x44, 0x60, 1}, {0x52, 0x60, 1},
+        {0x63, 0x60, 1}, {0x5e, 0x60, 1}, {0x68, 0x60, 1}, {0x03, 0x60, 3}
+    },
+    /* 99 */
+    {
+        {0x42, 0x3d, 1}, {0x01, 0x3d, 3}, {0x42, 0x41, 1}, {0x01, 0x41, 3},
+        {0x42, 0x5f, 1}, {0x01, 0x5f, 3}, {0x42, 0x62, 1}, {0x01, 0x62, 3},
+        {0x42, 0x64, 1}, {0x01, 0x64, 3}, {0x42, 0x66, 1}, {0x01, 0x66, 3},
+        {0x42, 0x67, 1}, {0x01, 0x67, 3}, {0x42, 0x68, 1}, {0x01, 0x68, 3}
+    },
+    /* 100 */
+    {
+        {0x55, 0x3d, 1}, {0x43, 0x3d, 1}, {0x5d, 0x3d, 1}, {0x02, 0x3d, 3},
+        {0x55, 0x41, 1}, {0x43, 0x41, 1}, {0x5d, 0x41, 1}, {0x02, 0x41, 3},
+        {0x55, 0x5f, 1}, {0x43, 0x5f, 1}, {0x5d, 0x5f, 1}, {0x02, 0x5f, 3},
+        {0x55, 0x62, 1}, {0x43, 0x62, 1}, {0x5d, 0x62, 1}, {0x02, 0x62, 3}
+    },
+    /* 101 */
+    {
+        {0x56, 0x3d, 1}, {0x82, 0x3d, 1}, {0x44, 0x3d, 1}, {0x52, 0x3d, 1},
+        {0x63, 0x3d, 1}, {0x5e, 0x3d, 1}, {0x68, 0x3d, 1}, {0x03, 0x3d, 3},
+        {0x56, 0x41, 1}, {0x82, 0x41, 1}, {0x44, 0x41, 1}, {0x52, 0x41, 1},
+        {0x63, 0x41, 1}, {0x5e, 0x41, 1}, {0x68, 0x41, 1}, {0x03, 0x41, 3}
+    },
+    /* 102 */
+    {
+        {0x56, 0x40, 1}, {0x82, 0x40, 1}, {0x44, 0x40, 1}, {0x52, 0x40, 1},
+        {0x63, 0x40, 1}, {0x5e, 0x40, 1}, {0x68, 0x40, 1}, {0x03, 0x40, 3},
+        {0x56, 0x5b, 1}, {0x82, 0x5b, 1}, {0x44, 0x5b, 1}, {0x52, 0x5b, 1},
+        {0x63, 0x5b, 1}, {0x5e, 0x5b, 1}, {0x68, 0x5b, 1}, {0x03, 0x5b, 3}
+    },
+    /* 103 */
+    {
+        {0x56, 0x43, 1}, {0x82, 0x43, 1}, {0x44, 0x43, 1}, {0x52, 0x43, 1},
+        {0x63, 0x43, 1}, {0x5e, 0x43, 1}, {0x68, 0x43, 1}, {0x03, 0x43, 3},
+        {0x56, 0x44, 1}, {0x82, 0x44, 1}, {0x44, 0x44, 1}, {0x52, 0x44, 1},
+        {0x63, 0x44, 1}, {0x5e, 0x44, 1}, {0x68, 0x44, 1}, {0x03, 0x44, 3}
+    },
+    /* 104 */
+    {
+        {0x00, 0x45, 3}, {0x00, 0x46, 3}, {0x00, 0x47, 3}, {0x00, 0x48, 3},
+        {0x00, 0x49, 3}, {0x00, 0x4a, 3}, {0x00, 0x4b, 3}, {0x00, 0x4c, 3},
+        {0x00, 0x4d, 3}, {0x00, 0x4e, 3}, {0x00, 0x4f, 3}, {0x00, 0x50, 3},
+        {0x00, 0x51, 3}, {0x00, 0x52, 3}, {0x00, 0x53, 3}, {0x00, 0x54, 3}
+    },
+    /* 105 */
+    {
+        {0x42, 0x45, 1}, {0x01, 0x45, 3}, {0x42, 0x46, 1}, {0x01, 0x46, 3},
+        {0x42, 0x47, 1}, {0x01, 0x47, 3}, {0x42, 0x48, 1}, {0x01, 0x48, 3},
+        {0x42, 0x49, 1}, {0x01, 0x49, 3}, {0x42, 0x4a, 1}, {0x01, 0x4a, 3},
+        {0x42, 0x4b, 1}, {0x01, 0x4b, 3}, {0x42, 0x4c, 1}, {0x01, 0x4c, 3}
+    },
+    /* 106 */
+    {
+        {0x55, 0x45, 1}, {0x43, 0x45, 1}, {0x5d, 0x45, 1}, {0x02, 0x45, 3},
+        {0x55, 0x46, 1}, {0x43, 0x46, 1}, {0x5d, 0x46, 1}, {0x02, 0x46, 3},
+        {0x55, 0x47, 1}, {0x43, 0x47, 1}, {0x5d, 0x47, 1}, {0x02, 0x47, 3},
+        {0x55, 0x48, 1}, {0x43, 0x48, 1}, {0x5d, 0x48, 1}, {0x02, 0x48, 3}
+    },
+    /* 107 */
+    {
+        {0x56, 0x45, 1}, {0x82, 0x45, 1}, {0x44, 0x45, 1}, {0x52, 0x45, 1},
+        {0x63, 0x45, 1}, {0x5e, 0x45, 1}, {0x68, 0x45, 1}, {0x03, 0x45, 3},
+        {0x56, 0x46, 1}, {0x82, 0x46, 1}, {0x44, 0x46, 1}, {0x52, 0x46, 1},
+        {0x63, 0x46, 1}, {0x5e, 0x46, 1}, {0x68, 0x46, 1}, {0x03, 0x46, 3}
+    },
+    /* 108 */
+    {
+        {0x56, 0x47, 1}, {0x82, 0x47, 1}, {0x44, 0x47, 1}, {0x52, 0x47, 1},
+        {0x63, 0x47, 1}, {0x5e, 0x47, 1}, {0x68, 0x47, 1}, {0x03, 0x47, 3},
+        {0x56, 0x48, 1}, {0x82, 0x48, 1}, {0x44, 0x48, 1}, {0x52, 0x48, 1},
+        {0x63, 0x48, 1}, {0x5e, 0x48, 1}, {0x68, 0x48, 1}, {0x03, 0x48, 3}
+    },
+    /* 109 */
+    {
+        {0x55, 0x49, 1}, {0x43, 0x49, 1}, {0x5d, 0x49, 1}, {0x02, 0x49, 3},
+        {0x55, 0x4a, 1}, {0x43, 0x4a, 1}, {0x5d, 0x4a, 1}, {0x02, 0x4a, 3},
+        {0x55, 0x4b, 1}, {0x43, 0x4b, 1}, {0x5d, 0x4b, 1}, {0x02, 0x4b, 3},
+        {0x55, 0x4c, 1}, {0x43, 0x4c, 1}, {0x5d, 0x4c, 1}, {0x02, 0x4c, 3}
+    },
+    /* 110 */
+    {
+        {0x56, 0x49, 1}, {0x82, 0x49, 1}, {0x44, 0x49, 1}, {0x52, 0x49, 1},
+        {0x63, 0x49, 1}, {0x5e, 0x49, 1}, {0x68, 0x49, 1}, {0x03, 0x49, 3},
+        {0x56, 0x4a, 1}, {0x82, 0x4a, 1}, {0x44, 0x4a, 1}, {0x52, 0x4a, 1},
+        {0x63, 0x4a, 1}, {0x5e, 0x4a, 1}, {0x68, 0x4a, 1}, {0x03, 0x4a, 3}
+    },
+    /* 111 */
+    {
+        {0x56, 0x4b, 1}, {0x82, 0x4b, 1}, {0x44, 0x4b, 1}, {0x52, 0x4b, 1},
+        {0x63, 0x4b, 1}, {0x5e, 0x4b, 1}, {0x68, 0x4b, 1}, {0x03, 0x4b, 3},
+        {0x56, 0x4c, 1}, {0x82, 0x4c, 1}, {0x44, 0x4c, 1}, {0x52, 0x4c, 1},
+        {0x63, 0x4c, 1}, {0x5e, 0x4c, 1}, {0x68, 0x4c, 1}, {0x03, 0x4c, 3}
+    },
+    /* 112 */
+    {
+        {0x42, 0x4d, 1}, {0x01, 0x4d, 3}, {0x42, 0x4e, 1}, {0x01, 0x4e, 3},
+        {0x42, 0x4f, 1}, {0x01, 0x4f, 3}, {0x42, 0x50, 1}, {0x01, 0x50, 3},
+        {0x42, 0x51, 1}, {0x01, 0x51, 3}, {0x42, 0x52, 1}, {0x01, 0x52, 3},
+        {0x42, 0x53, 1}, {0x01, 0x53, 3}, {0x42, 0x54, 1}, {0x01, 0x54, 3}
+    },
+    /* 113 */
+    {
+        {0x55, 0x4d, 1}, {0x43, 0x4d, 1}, {0x5d, 0x4d, 1}, {0x02, 0x4d, 3},
+        {0x55, 0x4e, 1}, {0x43, 0x4e, 1}, {0x5d, 0x4e, 1}, {0x02, 0x4e, 3},
+        {0x55, 0x4f, 1}, {0x43, 0x4f, 1}, {0x5d, 0x4f, 1}, {0x02, 0x4f, 3},
+        {0x55, 0x50, 1}, {0x43, 0x50, 1}, {0x5d, 0x50, 1}, {0x02, 0x50, 3}
+    },
+    /* 114 */
+    {
+        {0x56, 0x4d, 1}, {0x82, 0x4d, 1}, {0x44, 0x4d, 1}, {0x52, 0x4d, 1},
+        {0x63, 0x4d, 1}, {0x5e, 0x4d, 1}, {0x68, 0x4d, 1}, {0x03, 0x4d, 3},
+        {0x56, 0x4e, 1}, {0x82, 0x4e, 1}, {0x44, 0x4e, 1}, {0x52, 0x4e, 1},
+        {0x63, 0x4e, 1}, {0x5e, 0x4e, 1}, {0x68, 0x4e, 1}, {0x03, 0x4e, 3}
+    },
+    /* 115 */
+    {
+        {0x56, 0x4f, 1}, {0x82, 0x4f, 1}, {0x44, 0x4f, 1}, {0x52, 0x4f, 1},
+        {0x63, 0x4f, 1}, {0x5e, 0x4f, 1}, {0x68, 0x4f, 1}, {0x03, 0x4f, 3},
+        {0x56, 0x50, 1}, {0x82, 0x50, 1}, {0x44, 0x50, 1}, {0x52, 0x50, 1},
+        {0x63, 0x50, 1}, {0x5e, 0x50, 1}, {0x68, 0x50, 1}, {0x03, 0x50, 3}
+    },
+    /* 116 */
+    {
+        {0x55, 0x51, 1}, {0x43, 0x51, 1}, {0x5d, 0x51, 1}, {0x02, 0x51, 3},
+        {0x55, 0x52, 1}, {0x43, 0x52, 1}, {0x5d, 0x52, 1}, {0x02, 0x52, 3},
+        {0x55, 0x53, 1}, {0x43, 0x53, 1}, {0x5d, 0x53, 1}, {0x02, 0x53, 3},
+        {0x55, 0x54, 1}, {0x43, 0x54, 1}, {0x5d, 0x54, 1}, {0x02, 0x54, 3}
+    },
+    /* 117 */
+    {
+        {0x56, 0x51, 1}, {0x82, 0x51, 1}, {0x44, 0x51, 1}, {0x52, 0x51, 1},
+        {0x63, 0x51, 1}, {0x5e, 0x51, 1}, {0x68, 0x51, 1}, {0x03, 0x51, 3},
+        {0x56, 0x52, 1}, {0x82, 0x52, 1}, {0x44, 0x52, 1}, {0x52, 0x52, 1},
+        {0x63, 0x52, 1}, {0x5e, 0x52, 1}, {0x68, 0x52, 1}, {0x03, 0x52, 3}
+    },
+    /* 118 */
+    {
+        {0x56, 0x53, 1}, {0x82, 0x53, 1}, {0x44, 0x53, 1}, {0x52, 0x53, 1},
+        {0x63, 0x53, 1}, {0x5e, 0x53, 1}, {0x68, 0x53, 1}, {0x03, 0x53, 3},
+        {0x56, 0x54, 1}, {0x82, 0x54, 1}, {0x44, 0x54, 1}, {0x52, 0x54, 1},
+        {0x63, 0x54, 1}, {0x5e, 0x54, 1}, {0x68, 0x54, 1}, {0x03, 0x54, 3}
+    },
+    /* 119 */
+    {
+        {0x42, 0x55, 1}, {0x01, 0x55, 3}, {0x42, 0x56, 1}, {0x01, 0x56, 3},
+        {0x42, 0x57, 1}, {0x01, 0x57, 3}, {0x42, 0x59, 1}, {0x01, 0x59, 3},
+        {0x42, 0x6a, 1}, {0x01, 0x6a, 3}, {0x42, 0x6b, 1}, {0x01, 0x6b, 3},
+        {0x42, 0x71, 1}, {0x01, 0x71, 3}, {0x42, 0x76, 1}, {0x01, 0x76, 3}
+    },
+    /* 120 */
+    {
+        {0x55, 0x55, 1}, {0x43, 0x55, 1}, {0x5d, 0x55, 1}, {0x02, 0x55, 3},
+        {0x55, 0x56, 1}, {0x43, 0x56, 1}, {0x5d, 0x56, 1}, {0x02, 0x56, 3},
+        {0x55, 0x57, 1}, {0x43, 0x57, 1}, {0x5d, 0x57, 1}, {0x02, 0x57, 3},
+        {0x55, 0x59, 1}, {0x43, 0x59, 1}, {0x5d, 0x59, 1}, {0x02, 0x59, 3}
+    },
+    /* 121 */
+    {
+        {0x56, 0x55, 1}, {0x82, 0x55, 1}, {0x44, 0x55, 1}, {0x52, 0x55, 1},
+        {0x63, 0x55, 1}, {0x5e, 0x55, 1}, {0x68, 0x55, 1}, {0x03, 0x55, 3},
+        {0x56, 0x56, 1}, {0x82, 0x56, 1}, {0x44, 0x56, 1}, {0x52, 0x56, 1},
+        {0x63, 0x56, 1}, {0x5e, 0x56, 1}, {0x68, 0x56, 1}, {0x03, 0x56, 3}
+    },
+    /* 122 */
+    {
+        {0x56, 0x57, 1}, {0x82, 0x57, 1}, {0x44, 0x57, 1}, {0x52, 0x57, 1},
+        {0x63, 0x57, 1}, {0x5e, 0x57, 1}, {0x68, 0x57, 1}, {0x03, 0x57, 3},
+        {0x56, 0x59, 1}, {0x82, 0x59, 1}, {0x44, 0x59, 1}, {0x52, 0x59, 1},
+        {0x63, 0x59, 1}, {0x5e, 0x59, 1}, {0x68, 0x59, 1}, {0x03, 0x59, 3}
+    },
+    /* 123 */
+    {
+        {0x56, 0x58, 1}, {0x82, 0x58, 1}, {0x44, 0x58, 1}, {0x52, 0x58, 1},
+        {0x63, 0x58, 1}, {0x5e, 0x58, 1}, {0x68, 0x58, 1}, {0x03, 0x58, 3},
+        {0x56, 0x5a, 1}, {0x82, 0x5a, 1}, {0x44, 0x5a, 1}, {0x52, 0x5a, 1},
+        {0x63, 0x5a, 1}, {0x5e, 0x5a, 1}, {0x68, 0x5a, 1}, {0x03, 0x5a, 3}
+    },
+    /* 124 */
+    {
+        {0x42, 0x5c, 1}, {0x01, 0x5c, 3}, {0x42, 0xc3, 1}, {0x01, 0xc3, 3},
+        {0x42, 0xd0, 1}, {0x01, 0xd0, 3}, {0x00, 0x80, 3}, {0x00, 0x82, 3},
+        {0x00, 0x83, 3}, {0x00, 0xa2, 3}, {0x00, 0xb8, 3}, {0x00, 0xc2, 3},
+        {0x00, 0xe0, 3}, {0x00, 0xe2, 3}, {0xb1, 0x00, 0}, {0xbc, 0x00, 0}
+    },
+    /* 125 */
+    {
+        {0x55, 0x5c, 1}, {0x43, 0x5c, 1}, {0x5d, 0x5c, 1}, {0x02, 0x5c, 3},
+        {0x55, 0xc3, 1}, {0x43, 0xc3, 1}, {0x5d, 0xc3, 1}, {0x02, 0xc3, 3},
+        {0x55, 0xd0, 1}, {0x43, 0xd0, 1}, {0x5d, 0xd0, 1}, {0x02, 0xd0, 3},
+        {0x42, 0x80, 1}, {0x01, 0x80, 3}, {0x42, 0x82, 1}, {0x01, 0x82, 3}
+    },
+    /* 126 */
+    {
+        {0x56, 0x5c, 1}, {0x82, 0x5c, 1}, {0x44, 0x5c, 1}, {0x52, 0x5c, 1},
+        {0x63, 0x5c, 1}, {0x5e, 0x5c, 1}, {0x68, 0x5c, 1}, {0x03, 0x5c, 3},
+        {0x56, 0xc3, 1}, {0x82, 0xc3, 1}, {0x44, 0xc3, 1}, {0x52, 0xc3, 1},
+        {0x63, 0xc3, 1}, {0x5e, 0xc3, 1}, {0x68, 0xc3, 1}, {0x03, 0xc3, 3}
+    },
+    /* 127 */
+    {
+        {0x56, 0x5d, 1}, {0x82, 0x5d, 1}, {0x44, 0x5d, 1}, {0x52, 0x5d, 1},
+        {0x63, 0x5d, 1}, {0x5e, 0x5d, 1}, {0x68, 0x5d, 1}, {0x03, 0x5d, 3},
+        {0x56, 0x7e, 1}, {0x82, 0x7e, 1}, {0x44, 0x7e, 1}, {0x52, 0x7e, 1},
+        {0x63, 0x7e, 1}, {0x5e, 0x7e, 1}, {0x68, 0x7e, 1}, {0x03, 0x7e, 3}
+    },
+    /* 128 */
+    {
+        {0x56, 0x5e, 1}, {0x82, 0x5e, 1}, {0x44, 0x5e, 1}, {0x52, 0x5e, 1},
+        {0x63, 0x5e, 1}, {0x5e, 0x5e, 1}, {0x68, 0x5e, 1}, {0x03, 0x5e, 3},
+        {0x56, 0x7d, 1}, {0x82, 0x7d, 1}, {0x44, 0x7d, 1}, {0x52, 0x7d, 1},
+        {0x63, 0x7d, 1}, {0x5e, 0x7d, 1}, {0x68, 0x7d, 1}, {0x03, 0x7d, 3}
+    },
+    /* 129 */
+    {
+        {0x56, 0x5f, 1}, {0x82, 0x5f, 1}, {0x44, 0x5f, 1}, {0x52, 0x5f, 1},
+        {0x63, 0x5f, 1}, {0x5e, 0x5f, 1}, {0x68, 0x5f, 1}, {0x03, 0x5f, 3},
+        {0x56, 0x62, 1}, {0x82, 0x62, 1}, {0x44, 0x62, 1}, {0x52, 0x62, 1},
+        {0x63, 0x62, 1}, {0x5e, 0x62, 1}, {0x68, 0x62, 1}, {0x03, 0x62, 3}
+    },
+    /* 130 */
+    {
+        {0x55, 0x63, 1}, {0x43, 0x63, 1}, {0x5d, 0x63, 1}, {0x02, 0x63, 3},
+        {0x55, 0x65, 1}, {0x43, 0x65, 1}, {0x5d, 0x65, 1}, {0x02, 0x65, 3},
+        {0x55, 0x69, 1}, {0x43, 0x69, 1}, {0x5d, 0x69, 1}, {0x02, 0x69, 3},
+        {0x55, 0x6f, 1}, {0x43, 0x6f, 1}, {0x5d, 0x6f, 1}, {0x02, 0x6f, 3}
+    },
+    /* 131 */
+    {
+        {0x56, 0x63, 1}, {0x82, 0x63, 1}, {0x44, 0x63, 1}, {0x52, 0x63, 1},
+        {0x63, 0x63, 1}, {0x5e, 0x63, 1}, {0x68, 0x63, 1}, {0x03, 0x63, 3},
+        {0x56, 0x65, 1}, {0x82, 0x65, 1}, {0x44, 0x65, 1}, {0x52, 0x65, 1},
+        {0x63, 0x65, 1}, {0x5e, 0x65, 1}, {0x68, 0x65, 1}, {0x03, 0x65, 3}
+    },
+    /* 132 */
+    {
+        {0x55, 0x64, 1}, {0x43, 0x64, 1}, {0x5d, 0x64, 1}, {0x02, 0x64, 3},
+        {0x55, 0x66, 1}, {0x43, 0x66, 1}, {0x5d, 0x66, 1}, {0x02, 0x66, 3},
+        {0x55, 0x67, 1}, {0x43, 0x67, 1}, {0x5d, 0x67, 1}, {0x02, 0x67, 3},
+        {0x55, 0x68, 1}, {0x43, 0x68, 1}, {0x5d, 0x68, 1}, {0x02, 0x68, 3}
+    },
+    /* 133 */
+    {
+        {0x56, 0x64, 1}, {0x82, 0x64, 1}, {0x44, 0x64, 1}, {0x52, 0x64, 1},
+        {0x63, 0x64, 1}, {0x5e, 0x64, 1}, {0x68, 0x64, 1}, {0x03, 0x64, 3},
+        {0x56, 0x66, 1}, {0x82, 0x66, 1}, {0x44, 0x66, 1}, {0x52, 0x66, 1},
+        {0x63, 0x66, 1}, {0x5e, 0x66, 1}, {0x68, 0x66, 1}, {0x03, 0x66, 3}
+    },
+    /* 134 */
+    {
+        {0x56, 0x67, 1}, {0x82, 0x67, 1}, {0x44, 0x67, 1}, {0x52, 0x67, 1},
+        {0x63, 0x67, 1}, {0x5e, 0x67, 1}, {0x68, 0x67, 1}, {0x03, 0x67, 3},
+        {0x56, 0x68, 1}, {0x82, 0x68, 1}, {0x44, 0x68, 1}, {0x52, 0x68, 1},
+        {0x63, 0x68, 1}, {0x5e, 0x68, 1}, {0x68, 0x68, 1}, {0x03, 0x68, 3}
+    },
+    /* 135 */
+    {
+        {0x56, 0x69, 1}, {0x82, 0x69, 1}, {0x44, 0x69, 1}, {0x52, 0x69, 1},
+        {0x63, 0x69, 1}, {0x5e, 0x69, 1}, {0x68, 0x69, 1}, {0x03, 0x69, 3},
+        {0x56, 0x6f, 1}, {0x82, 0x6f, 1}, {0x44, 0x6f, 1}, {0x52, 0x6f, 1},
+        {0x63, 0x6f, 1}, {0x5e, 0x6f, 1}, {0x68, 0x6f, 1}, {0x03, 0x6f, 3}
+    },
+    /* 136 */
+    {
+        {0x55, 0x6a, 1}, {0x43, 0x6a, 1}, {0x5d, 0x6a, 1}, {0x02, 0x6a, 3},
+        {0x55, 0x6b, 1}, {0x43, 0x6b, 1}, {0x5d, 0x6b, 1}, {0x02, 0x6b, 3},
+        {0x55, 0x71, 1}, {0x43, 0x71, 1}, {0x5d, 0x71, 1}, {0x02, 0x71, 3},
+        {0x55, 0x76, 1}, {0x43, 0x76, 1}, {0x5d, 0x76, 1}, {0x02, 0x76, 3}
+    },
+    /* 137 */
+    {
+        {0x56, 0x6a, 1}, {0x82, 0x6a, 1}, {0x44, 0x6a, 1}, {0x52, 0x6a, 1},
+        {0x63, 0x6a, 1}, {0x5e, 0x6a, 1}, {0x68, 0x6a, 1}, {0x03, 0x6a, 3},
+        {0x56, 0x6b, 1}, {0x82, 0x6b, 1}, {0x44, 0x6b, 1}, {0x52, 0x6b, 1},
+        {0x63, 0x6b, 1}, {0x5e, 0x6b, 1}, {0x68, 0x6b, 1}, {0x03, 0x6b, 3}
+    },
+    /* 138 */
+    {
+        {0x55, 0x6c, 1}, {0x43, 0x6c, 1}, {0x5d, 0x6c, 1}, {0x02, 0x6c, 3},
+        {0x55, 0x6d, 1}, {0x43, 0x6d, 1}, {0x5d, 0x6d, 1}, {0x02, 0x6d, 3},
+        {0x55, 0x6e, 1}, {0x43, 0x6e, 1}, {0x5d, 0x6e, 1}, {0x02, 0x6e, 3},
+        {0x55, 0x70, 1}, {0x43, 0x70, 1}, {0x5d, 0x70, 1}, {0x02, 0x70, 3}
+    },
+    /* 139 */
+    {
+        {0x56, 0x6c, 1}, {0x82, 0x6c, 1}, {0x44, 0x6c, 1}, {0x52, 0x6c, 1},
+        {0x63, 0x6c, 1}, {0x5e, 0x6c, 1}, {0x68, 0x6c, 1}, {0x03, 0x6c, 3},
+        {0x56, 0x6d, 1}, {0x82, 0x6d, 1}, {0x44, 0x6d, 1}, {0x52, 0x6d, 1},
+        {0x63, 0x6d, 1}, {0x5e, 0x6d, 1}, {0x68, 0x6d, 1}, {0x03, 0x6d, 3}
+    },
+    /* 140 */
+    {
+        {0x56, 0x6e, 1}, {0x82, 0x6e, 1}, {0x44, 0x6e, 1}, {0x52, 0x6e, 1},
+        {0x63, 0x6e, 1}, {0x5e, 0x6e, 1}, {0x68, 0x6e, 1}, {0x03, 0x6e, 3},
+        {0x56, 0x70, 1}, {0x82, 0x70, 1}, {0x44, 0x70, 1}, {0x52, 0x70, 1},
+        {0x63, 0x70, 1}, {0x5e, 0x70, 1}, {0x68, 0x70, 1}, {0x03, 0x70, 3}
+    },
+    /* 141 */
+    {
+        {0x56, 0x71, 1}, {0x82, 0x71, 1}, {0x44, 0x71, 1}, {0x52, 0x71, 1},
+        {0x63, 0x71, 1}, {0x5e, 0x71, 1}, {0x68, 0x71, 1}, {0x03, 0x71, 3},
+        {0x56, 0x76, 1}, {0x82, 0x76, 1}, {0x44, 0x76, 1}, {0x52, 0x76, 1},
+        {0x63, 0x76, 1}, {0x5e, 0x76, 1}, {0x68, 0x76, 1}, {0x03, 0x76, 3}
+    },
+    /* 142 */
+    {
+        {0x56, 0x72, 1}, {0x82, 0x72, 1}, {0x44, 0x72, 1}, {0x52, 0x72, 1},
+        {0x63, 0x72, 1}, {0x5e, 0x72, 1}, {0x68, 0x72, 1}, {0x03, 0x72, 3},
+        {0x56, 0x75, 1}, {0x82, 0x75, 1}, {0x44, 0x75, 1}, {0x52, 0x75, 1},
+        {0x63, 0x75, 1}, {0x5e, 0x75, 1}, {0x68, 0x75, 1}, {0x03, 0x75, 3}
+    },
+    /* 143 */
+    {
+        {0x56, 0x73, 1}, {0x82, 0x73, 1}, {0x44, 0x73, 1}, {0x52, 0x73, 1},
+        {0x63, 0x73, 1}, {0x5e, 0x73, 1}, {0x68, 0x73, 1}, {0x03, 0x73, 3},
+        {0x56, 0x74, 1}, {0x82, 0x74, 1}, {0x44, 0x74, 1}, {0x52, 0x74, 1},
+        {0x63, 0x74, 1}, {0x5e, 0x74, 1}, {0x68, 0x74, 1}, {0x03, 0x74, 3}
+    },
+    /* 144 */
+    {
+        {0x55, 0x77, 1}, {0x43, 0x77, 1}, {0x5d, 0x77, 1}, {0x02, 0x77, 3},
+        {0x55, 0x78, 1}, {0x43, 0x78, 1}, {0x5d, 0x78, 1}, {0x02, 0x78, 3},
+        {0x55, 0x79, 1}, {0x43, 0x79, 1}, {0x5d, 0x79, 1}, {0x02, 0x79, 3},
+        {0x55, 0x7a, 1}, {0x43, 0x7a, 1}, {0x5d, 0x7a, 1}, {0x02, 0x7a, 3}
+    },
+    /* 145 */
+    {
+        {0x56, 0x77, 1}, {0x82, 0x77, 1}, {0x44, 0x77, 1}, {0x52, 0x77, 1},
+        {0x63, 0x77, 1}, {0x5e, 0x77, 1}, {0x68, 0x77, 1}, {0x03, 0x77, 3},
+        {0x56, 0x78, 1}, {0x82, 0x78, 1}, {0x44, 0x78, 1}, {0x52, 0x78, 1},
+        {0x63, 0x78, 1}, {0x5e, 0x78, 1}, {0x68, 0x78, 1}, {0x03, 0x78, 3}
+    },
+    /* 146 */
+    {
+        {0x56, 0x79, 1}, {0x82, 0x79, 1}, {0x44, 0x79, 1}, {0x52, 0x79, 1},
+        {0x63, 0x79, 1}, {0x5e, 0x79, 1}, {0x68, 0x79, 1}, {0x03, 0x79, 3},
+        {0x56, 0x7a, 1}, {0x82, 0x7a, 1}, {0x44, 0x7a, 1}, {0x52, 0x7a, 1},
+        {0x63, 0x7a, 1}, {0x5e, 0x7a, 1}, {0x68, 0x7a, 1}, {0x03, 0x7a, 3}
+    },
+    /* 147 */
+    {
+        {0x56, 0x7f, 1}, {0x82, 0x7f, 1}, {0x44, 0x7f, 1}, {0x52, 0x7f, 1},
+        {0x63, 0x7f, 1}, {0x5e, 0x7f, 1}, {0x68, 0x7f, 1}, {0x03, 0x7f, 3},
+        {0x56, 0xdc, 1}, {0x82, 0xdc, 1}, {0x44, 0xdc, 1}, {0x52, 0xdc, 1},
+        {0x63, 0xdc, 1}, {0x5e, 0xdc, 1}, {0x68, 0xdc, 1}, {0x03, 0xdc, 3}
+    },
+    /* 148 */
+    {
+        {0x56, 0xd0, 1}, {0x82, 0xd0, 1}, {0x44, 0xd0, 1}, {0x52, 0xd0, 1},
+        {0x63, 0xd0, 1}, {0x5e, 0xd0, 1}, {0x68, 0xd0, 1}, {0x03, 0xd0, 3},
+        {0x55, 0x80, 1}, {0x43, 0x80, 1}, {0x5d, 0x80, 1}, {0x02, 0x80, 3},
+        {0x55, 0x82, 1}, {0x43, 0x82, 1}, {0x5d, 0x82, 1}, {0x02, 0x82, 3}
+    },
+    /* 149 */
+    {
+        {0x56, 0x80, 1}, {0x82, 0x80, 1}, {0x44, 0x80, 1}, {0x52, 0x80, 1},
+        {0x63, 0x80, 1}, {0x5e, 0x80, 1}, {0x68, 0x80, 1}, {0x03, 0x80, 3},
+        {0x56, 0x82, 1}, {0x82, 0x82, 1}, {0x44, 0x82, 1}, {0x52, 0x82, 1},
+        {0x63, 0x82, 1}, {0x5e, 0x82, 1}, {0x68, 0x82, 1}, {0x03, 0x82, 3}
+    },
+    /* 150 */
+    {
+        {0x00, 0xb0, 3}, {0x00, 0xb1, 3}, {0x00, 0xb3, 3}, {0x00, 0xd1, 3},
+        {0x00, 0xd8, 3}, {0x00, 0xd9, 3}, {0x00, 0xe3, 3}, {0x00, 0xe5, 3},
+        {0x00, 0xe6, 3}, {0x9a, 0x00, 0}, {0x9f, 0x00, 0}, {0xa0, 0x00, 0},
+        {0xb4, 0x00, 0}, {0xb6, 0x00, 0}, {0xb8, 0x00, 0}, {0xbe, 0x00, 0}
+    },
+    /* 151 */
+    {
+        {0x42, 0xe6, 1}, {0x01, 0xe6, 3}, {0x00, 0x81, 3}, {0x00, 0x84, 3},
+        {0x00, 0x85, 3}, {0x00, 0x86, 3}, {0x00, 0x88, 3}, {0x00, 0x92, 3},
+        {0x00, 0x9a, 3}, {0x00, 0x9c, 3}, {0x00, 0xa0, 3}, {0x00, 0xa3, 3},
+        {0x00, 0xa4, 3}, {0x00, 0xa9, 3}, {0x00, 0xaa, 3}, {0x00, 0xad, 3}
+    },
+    /* 152 */
+    {
+        {0x55, 0xe6, 1}, {0x43, 0xe6, 1}, {0x5d, 0xe6, 1}, {0x02, 0xe6, 3},
+        {0x42, 0x81, 1}, {0x01, 0x81, 3}, {0x42, 0x84, 1}, {0x01, 0x84, 3},
+        {0x42, 0x85, 1}, {0x01, 0x85, 3}, {0x42, 0x86, 1}, {0x01, 0x86, 3},
+        {0x42, 0x88, 1}, {0x01, 0x88, 3}, {0x42, 0x92, 1}, {0x01, 0x92, 3}
+    },
+    /* 153 */
+    {
+        {0x56, 0xe6, 1}, {0x82, 0xe6, 1}, {0x44, 0xe6, 1}, {0x52, 0xe6, 1},
+        {0x63, 0xe6, 1}, {0x5e, 0xe6, 1}, {0x68, 0xe6, 1}, {0x03, 0xe6, 3},
+        {0x55, 0x81, 1}, {0x43, 0x81, 1}, {0x5d, 0x81, 1}, {0x02, 0x81, 3},
+        {0x55, 0x84, 1}, {0x43, 0x84, 1}, {0x5d, 0x84, 1}, {0x02, 0x84, 3}
+    },
+    /* 154 */
+    {
+        {0x56, 0x81, 1}, {0x82, 0x81, 1}, {0x44, 0x81, 1}, {0x52, 0x81, 1},
+        {0x63, 0x81, 1}, {0x5e, 0x81, 1}, {0x68, 0x81, 1}, {0x03, 0x81, 3},
+        {0x56, 0x84, 1}, {0x82, 0x84, 1}, {0x44, 0x84, 1}, {0x52, 0x84, 1},
+        {0x63, 0x84, 1}, {0x5e, 0x84, 1}, {0x68, 0x84, 1}, {0x03, 0x84, 3}
+    },
+    /* 155 */
+    {
+        {0x42, 0x83, 1}, {0x01, 0x83, 3}, {0x42, 0xa2, 1}, {0x01, 0xa2, 3},
+        {0x42, 0xb8, 1}, {0x01, 0xb8, 3}, {0x42, 0xc2, 1}, {0x01, 0xc2, 3},
+        {0x42, 0xe0, 1}, {0x01, 0xe0, 3}, {0x42, 0xe2, 1}, {0x01, 0xe2, 3},
+        {0x00, 0x99, 3}, {0x00, 0xa1, 3}, {0x00, 0xa7, 3}, {0x00, 0xac, 3}
+    },
+    /* 156 */
+    {
+        {0x55, 0x83, 1}, {0x43, 0x83, 1}, {0x5d, 0x83, 1}, {0x02, 0x83, 3},
+        {0x55, 0xa2, 1}, {0x43, 0xa2, 1}, {0x5d, 0xa2, 1}, {0x02, 0xa2, 3},
+        {0x55, 0xb8, 1}, {0x43, 0xb8, 1}, {0x5d, 0xb8, 1}, {0x02, 0xb8, 3},
+        {0x55, 0xc2, 1}, {0x43, 0xc2, 1}, {0x5d, 0xc2, 1}, {0x02, 0xc2, 3}
+    },
+    /* 157 */
+    {
+        {0x56, 0x83, 1}, {0x82, 0x83, 1}, {0x44, 0x83, 1}, {0x52, 0x83, 1},
+        {0x63, 0x83, 1}, {0x5e, 0x83, 1}, {0x68, 0x83, 1}, {0x03, 0x83, 3},
+        {0x56, 0xa2, 1}, {0x82, 0xa2, 1}, {0x44, 0xa2, 1}, {0x52, 0xa2, 1},
+        {0x63, 0xa2, 1}, {0x5e, 0xa2, 1}, {0x68, 0xa2, 1}, {0x03, 0xa2, 3}
+    },
+    /* 158 */
+    {
+        {0x55, 0x85, 1}, {0x43, 0x85, 1}, {0x5d, 0x85, 1}, {0x02, 0x85, 3},
+        {0x55, 0x86, 1}, {0x43, 0x86, 1}, {0x5d, 0x86, 1}, {0x02, 0x86, 3},
+        {0x55, 0x88, 1}, {0x43, 0x88, 1}, {0x5d, 0x88, 1}, {0x02, 0x88, 3},
+        {0x55, 0x92, 1}, {0x43, 0x92, 1}, {0x5d, 0x92, 1}, {0x02, 0x92, 3}
+    },
+    /* 159 */
+    {
+        {0x56, 0x85, 1}, {0x82, 0x85, 1}, {0x44, 0x85, 1}, {0x52, 0x85, 1},
+        {0x63, 0x85, 1}, {0x5e, 0x85, 1}, {0x68, 0x85, 1}, {0x03, 0x85, 3},
+        {0x56, 0x86, 1}, {0x82, 0x86, 1}, {0x44, 0x86, 1}, {0x52, 0x86, 1},
+        {0x63, 0x86, 1}, {0x5e, 0x86, 1}, {0x68, 0x86, 1}, {0x03, 0x86, 3}
+    },
+    /* 160 */
+    {
+        {0x56, 0x88, 1}, {0x82, 0x88, 1}, {0x44, 0x88, 1}, {0x52, 0x88, 1},
+        {0x63, 0x88, 1}, {0x5e, 0x88, 1}, {0x68, 0x88, 1}, {0x03, 0x88, 3},
+        {0x56, 0x92, 1}, {0x82, 0x92, 1}, {0x44, 0x92, 1}, {0x52, 0x92, 1},
+        {0x63, 0x92, 1}, {0x5e, 0x92, 1}, {0x68, 0x92, 1}, {0x03, 0x92, 3}
+    },
+    /* 161 */
+    {
+        {0x56, 0x89, 1}, {0x82, 0x89, 1}, {0x44, 0x89, 1}, {0x52, 0x89, 1},
+        {0x63, 0x89, 1}, {0x5e, 0x89, 1}, {0x68, 0x89, 1}, {0x03, 0x89, 3},
+        {0x56, 0x8a, 1}, {0x82, 0x8a, 1}, {0x44, 0x8a, 1}, {0x52, 0x8a, 1},
+        {0x63, 0x8a, 1}, {0x5e, 0x8a, 1}, {0x68, 0x8a, 1}, {0x03, 0x8a, 3}
+    },
+    /* 162 */
+    {
+        {0x55, 0x8b, 1}, {0x43, 0x8b, 1}, {0x5d, 0x8b, 1}, {0x02, 0x8b, 3},
+        {0x55, 0x8c, 1}, {0x43, 0x8c, 1}, {0x5d, 0x8c, 1}, {0x02, 0x8c, 3},
+        {0x55, 0x8d, 1}, {0x43, 0x8d, 1}, {0x5d, 0x8d, 1}, {0x02, 0x8d, 3},
+        {0x55, 0x8f, 1}, {0x43, 0x8f, 1}, {0x5d, 0x8f, 1}, {0x02, 0x8f, 3}
+    },
+    /* 163 */
+    {
+        {0x56, 0x8b, 1}, {0x82, 0x8b, 1}, {0x44, 0x8b, 1}, {0x52, 0x8b, 1},
+        {0x63, 0x8b, 1}, {0x5e, 0x8b, 1}, {0x68, 0x8b, 1}, {0x03, 0x8b, 3},
+        {0x56, 0x8c, 1}, {0x82, 0x8c, 1}, {0x44, 0x8c, 1}, {0x52, 0x8c, 1},
+        {0x63, 0x8c, 1}, {0x5e, 0x8c, 1}, {0x68, 0x8c, 1}, {0x03, 0x8c, 3}
+    },
+    /* 164 */
+    {
+        {0x56, 0x8d, 1}, {0x82, 0x8d, 1}, {0x44, 0x8d, 1}, {0x52, 0x8d, 1},
+        {0x63, 0x8d, 1}, {0x5e, 0x8d, 1}, {0x68, 0x8d, 1}, {0x03, 0x8d, 3},
+        {0x56, 0x8f, 1}, {0x82, 0x8f, 1}, {0x44, 0x8f, 1}, {0x52, 0x8f, 1},
+        {0x63, 0x8f, 1}, {0x5e, 0x8f, 1}, {0x68, 0x8f, 1}, {0x03, 0x8f, 3}
+    },
+    /* 165 */
+    {
+        {0x55, 0x90, 1}, {0x43, 0x90, 1}, {0x5d, 0x90, 1}, {0x02, 0x90, 3},
+        {0x55, 0x91, 1}, {0x43, 0x91, 1}, {0x5d, 0x91, 1}, {0x02, 0x91, 3},
+        {0x55, 0x94, 1}, {0x43, 0x94, 1}, {0x5d, 0x94, 1}, {0x02, 0x94, 3},
+        {0x55, 0x9f, 1}, {0x43, 0x9f, 1}, {0x5d, 0x9f, 1}, {0x02, 0x9f, 3}
+    },
+    /* 166 */
+    {
+        {0x56, 0x90, 1}, {0x82, 0x90, 1}, {0x44, 0x90, 1}, {0x52, 0x90, 1},
+        {0x63, 0x90, 1}, {0x5e, 0x90, 1}, {0x68, 0x90, 1}, {0x03, 0x90, 3},
+        {0x56, 0x91, 1}, {0x82, 0x91, 1}, {0x44, 0x91, 1}, {0x52, 0x91, 1},
+        {0x63, 0x91, 1}, {0x5e, 0x91, 1}, {0x68, 0x91, 1}, {0x03, 0x91, 3}
+    },
+    /* 167 */
+    {
+        {0x00, 0x93, 3}, {0x00, 0x95, 3}, {0x00, 0x96, 3}, {0x00, 0x97, 3},
+        {0x00, 0x98, 3}, {0x00, 0x9b, 3}, {0x00, 0x9d, 3}, {0x00, 0x9e, 3},
+        {0x00, 0xa5, 3}, {0x00, 0xa6, 3}, {0x00, 0xa8, 3}, {0x00, 0xae, 3},
+        {0x00, 0xaf, 3}, {0x00, 0xb4, 3}, {0x00, 0xb6, 3}, {0x00, 0xb7, 3}
+    },
+    /* 168 */
+    {
+        {0x42, 0x93, 1}, {0x01, 0x93, 3}, {0x42, 0x95, 1}, {0x01, 0x95, 3},
+        {0x42, 0x96, 1}, {0x01, 0x96, 3}, {0x42, 0x97, 1}, {0x01, 0x97, 3},
+        {0x42, 0x98, 1}, {0x01, 0x98, 3}, {0x42, 0x9b, 1}, {0x01, 0x9b, 3},
+        {0x42, 0x9d, 1}, {0x01, 0x9d, 3}, {0x42, 0x9e, 1}, {0x01, 0x9e, 3}
+    },
+    /* 169 */
+    {
+        {0x55, 0x93, 1}, {0x43, 0x93, 1}, {0x5d, 0x93, 1}, {0x02, 0x93, 3},
+        {0x55, 0x95, 1}, {0x43, 0x95, 1}, {0x5d, 0x95, 1}, {0x02, 0x95, 3},
+        {0x55, 0x96, 1}, {0x43, 0x96, 1}, {0x5d, 0x96, 1}, {0x02, 0x96, 3},
+        {0x55, 0x97, 1}, {0x43, 0x97, 1}, {0x5d, 0x97, 1}, {0x02, 0x97, 3}
+    },
+    /* 170 */
+    {
+        {0x56, 0x93, 1}, {0x82, 0x93, 1}, {0x44, 0x93, 1}, {0x52, 0x93, 1},
+        {0x63, 0x93, 1}, {0x5e, 0x93, 1}, {0x68, 0x93, 1}, {0x03, 0x93, 3},
+        {0x56, 0x95, 1}, {0x82, 0x95, 1}, {0x44, 0x95, 1}, {0x52, 0x95, 1},
+        {0x63, 0x95, 1}, {0x5e, 0x95, 1}, {0x68, 0x95, 1}, {0x03, 0x95, 3}
+    },
+    /* 171 */
+    {
+        {0x56, 0x94, 1}, {0x82, 0x94, 1}, {0x44, 0x94, 1}, {0x52, 0x94, 1},
+        {0x63, 0x94, 1}, {0x5e, 0x94, 1}, {0x68, 0x94, 1}, {0x03, 0x94, 3},
+        {0x56, 0x9f, 1}, {0x82, 0x9f, 1}, {0x44, 0x9f, 1}, {0x52, 0x9f, 1},
+        {0x63, 0x9f, 1}, {0x5e, 0x9f, 1}, {0x68, 0x9f, 1}, {0x03, 0x9f, 3}
+    },
+    /* 172 */
+    {
+        {0x56, 0x96, 1}, {0x82, 0x96, 1}, {0x44, 0x96, 1}, {0x52, 0x96, 1},
+        {0x63, 0x96, 1}, {0x5e, 0x96, 1}, {0x68, 0x96, 1}, {0x03, 0x96, 3},
+        {0x56, 0x97, 1}, {0x82, 0x97, 1}, {0x44, 0x97, 1}, {0x52, 0x97, 1},
+        {0x63, 0x97, 1}, {0x5e, 0x97, 1}, {0x68, 0x97, 1}, {0x03, 0x97, 3}
+    },
+    /* 173 */
+    {
+        {0x55, 0x98, 1}, {0x43, 0x98, 1}, {0x5d, 0x98, 1}, {0x02, 0x98, 3},
+        {0x55, 0x9b, 1}, {0x43, 0x9b, 1}, {0x5d, 0x9b, 1}, {0x02, 0x9b, 3},
+        {0x55, 0x9d, 1}, {0x43, 0x9d, 1}, {0x5d, 0x9d, 1}, {0x02, 0x9d, 3},
+        {0x55, 0x9e, 1}, {0x43, 0x9e, 1}, {0x5d, 0x9e, 1}, {0x02, 0x9e, 3}
+    },
+    /* 174 */
+    {
+        {0x56, 0x98, 1}, {0x82, 0x98, 1}, {0x44, 0x98, 1}, {0x52, 0x98, 1},
+        {0x63, 0x98, 1}, {0x5e, 0x98, 1}, {0x68, 0x98, 1}, {0x03, 0x98, 3},
+        {0x56, 0x9b, 1}, {0x82, 0x9b, 1}, {0x44, 0x9b, 1}, {0x52, 0x9b, 1},
+        {0x63, 0x9b, 1}, {0x5e, 0x9b, 1}, {0x68, 0x9b, 1}, {0x03, 0x9b, 3}
+    },
+    /* 175 */
+    {
+        {0x55, 0xe0, 1}, {0x43, 0xe0, 1}, {0x5d, 0xe0, 1}, {0x02, 0xe0, 3},
+        {0x55, 0xe2, 1}, {0x43, 0xe2, 1}, {0x5d, 0xe2, 1}, {0x02, 0xe2, 3},
+        {0x42, 0x99, 1}, {0x01, 0x99, 3}, {0x42, 0xa1, 1}, {0x01, 0xa1, 3},
+        {0x42, 0xa7, 1}, {0x01, 0xa7, 3}, {0x42, 0xac, 1}, {0x01, 0xac, 3}
+    },
+    /* 176 */
+    {
+        {0x55, 0x99, 1}, {0x43, 0x99, 1}, {0x5d, 0x99, 1}, {0x02, 0x99, 3},
+        {0x55, 0xa1, 1}, {0x43, 0xa1, 1}, {0x5d, 0xa1, 1}, {0x02, 0xa1, 3},
+        {0x55, 0xa7, 1}, {0x43, 0xa7, 1}, {0x5d, 0xa7, 1}, {0x02, 0xa7, 3},
+        {0x55, 0xac, 1}, {0x43, 0xac, 1}, {0x5d, 0xac, 1}, {0x02, 0xac, 3}
+    },
+    /* 177 */
+    {
+        {0x56, 0x99, 1}, {0x82, 0x99, 1}, {0x44, 0x99, 1}, {0x52, 0x99, 1},
+        {0x63, 0x99, 1}, {0x5e, 0x99, 1}, {0x68, 0x99, 1}, {0x03, 0x99, 3},
+        {0x56, 0xa1, 1}, {0x82, 0xa1, 1}, {0x44, 0xa1, 1}, {0x52, 0xa1, 1},
+        {0x63, 0xa1, 1}, {0x5e, 0xa1, 1}, {0x68, 0xa1, 1}, {0x03, 0xa1, 3}
+    },
+    /* 178 */
+    {
+        {0x42, 0x9a, 1}, {0x01, 0x9a, 3}, {0x42, 0x9c, 1}, {0x01, 0x9c, 3},
+        {0x42, 0xa0, 1}, {0x01, 0xa0, 3}, {0x42, 0xa3, 1}, {0x01, 0xa3, 3},
+        {0x42, 0xa4, 1}, {0x01, 0xa4, 3}, {0x42, 0xa9, 1}, {0x01, 0xa9, 3},
+        {0x42, 0xaa, 1}, {0x01, 0xaa, 3}, {0x42, 0xad, 1}, {0x01, 0xad, 3}
+    },
+    /* 179 */
+    {
+        {0x55, 0x9a, 1}, {0x43, 0x9a, 1}, {0x5d, 0x9a, 1}, {0x02, 0x9a, 3},
+        {0x55, 0x9c, 1}, {0x43, 0x9c, 1}, {0x5d, 0x9c, 1}, {0x02, 0x9c, 3},
+        {0x55, 0xa0, 1}, {0x43, 0xa0, 1}, {0x5d, 0xa0, 1}, {0x02, 0xa0, 3},
+        {0x55, 0xa3, 1}, {0x43, 0xa3, 1}, {0x5d, 0xa3, 1}, {0x02, 0xa3, 3}
+    },
+    /* 180 */
+    {
+        {0x56, 0x9a, 1}, {0x82, 0x9a, 1}, {0x44, 0x9a, 1}, {0x52, 0x9a, 1},
+        {0x63, 0x9a, 1}, {0x5e, 0x9a, 1}, {0x68, 0x9a, 1}, {0x03, 0x9a, 3},
+        {0x56, 0x9c, 1}, {0x82, 0x9c, 1}, {0x44, 0x9c, 1}, {0x52, 0x9c, 1},
+        {0x63, 0x9c, 1}, {0x5e, 0x9c, 1}, {0x68, 0x9c, 1}, {0x03, 0x9c, 3}
+    },
+    /* 181 */
+    {
+        {0x56, 0x9d, 1}, {0x82, 0x9d, 1}, {0x44, 0x9d, 1}, {0x52, 0x9d, 1},
+        {0x63, 0x9d, 1}, {0x5e, 0x9d, 1}, {0x68, 0x9d, 1}, {0x03, 0x9d, 3},
+        {0x56, 0x9e, 1}, {0x82, 0x9e, 1}, {0x44, 0x9e, 1}, {0x52, 0x9e, 1},
+        {0x63, 0x9e, 1}, {0x5e, 0x9e, 1}, {0x68, 0x9e, 1}, {0x03, 0x9e, 3}
+    },
+    /* 182 */
+    {
+        {0x56, 0xa0, 1}, {0x82, 0xa0, 1}, {0x44, 0xa0, 1}, {0x52, 0xa0, 1},
+        {0x63, 0xa0, 1}, {0x5e, 0xa0, 1}, {0x68, 0xa0, 1}, {0x03, 0xa0, 3},
+        {0x56, 0xa3, 1}, {0x82, 0xa3, 1}, {0x44, 0xa3, 1}, {0x52, 0xa3, 1},
+        {0x63, 0xa3, 1}, {0x5e, 0xa3, 1}, {0x68, 0xa3, 1}, {0x03, 0xa3, 3}
+    },
+    /* 183 */
+    {
+        {0x55, 0xa4, 1}, {0x43, 0xa4, 1}, {0x5d, 0xa4, 1}, {0x02, 0xa4, 3},
+        {0x55, 0xa9, 1}, {0x43, 0xa9, 1}, {0x5d, 0xa9, 1}, {0x02, 0xa9, 3},
+        {0x55, 0xaa, 1}, {0x43, 0xaa, 1}, {0x5d, 0xaa, 1}, {0x02, 0xaa, 3},
+        {0x55, 0xad, 1}, {0x43, 0xad, 1}, {0x5d, 0xad, 1}, {0x02, 0xad, 3}
+    },
+    /* 184 */
+    {
+        {0x56, 0xa4, 1}, {0x82, 0xa4, 1}, {0x44, 0xa4, 1}, {0x52, 0xa4, 1},
+        {0x63, 0xa4, 1}, {0x5e, 0xa4, 1}, {0x68, 0xa4, 1}, {0x03, 0xa4, 3},
+        {0x56, 0xa9, 1}, {0x82, 0xa9, 1}, {0x44, 0xa9, 1}, {0x52, 0xa9, 1},
+        {0x63, 0xa9, 1}, {0x5e, 0xa9, 1}, {0x68, 0xa9, 1}, {0x03, 0xa9, 3}
+    },
+    /* 185 */
+    {
+        {0x42, 0xa5, 1}, {0x01, 0xa5, 3}, {0x42, 0xa6, 1}, {0x01, 0xa6, 3},
+        {0x42, 0xa8, 1}, {0x01, 0xa8, 3}, {0x42, 0xae, 1}, {0x01, 0xae, 3},
+        {0x42, 0xaf, 1}, {0x01, 0xaf, 3}, {0x42, 0xb4, 1}, {0x01, 0xb4, 3},
+        {0x42, 0xb6, 1}, {0x01, 0xb6, 3}, {0x42, 0xb7, 1}, {0x01, 0xb7, 3}
+    },
+    /* 186 */
+    {
+        {0x55, 0xa5, 1}, {0x43, 0xa5, 1}, {0x5d, 0xa5, 1}, {0x02, 0xa5, 3},
+        {0x55, 0xa6, 1}, {0x43, 0xa6, 1}, {0x5d, 0xa6, 1}, {0x02, 0xa6, 3},
+        {0x55, 0xa8, 1}, {0x43, 0xa8, 1}, {0x5d, 0xa8, 1}, {0x02, 0xa8, 3},
+        {0x55, 0xae, 1}, {0x43, 0xae, 1}, {0x5d, 0xae, 1}, {0x02, 0xae, 3}
+    },
+    /* 187 */
+    {
+        {0x56, 0xa5, 1}, {0x82, 0xa5, 1}, {0x44, 0xa5, 1}, {0x52, 0xa5, 1},
+        {0x63, 0xa5, 1}, {0x5e, 0xa5, 1}, {0x68, 0xa5, 1}, {0x03, 0xa5, 3},
+        {0x56, 0xa6, 1}, {0x82, 0xa6, 1}, {0x44, 0xa6, 1}, {0x52, 0xa6, 1},
+        {0x63, 0xa6, 1}, {0x5e, 0xa6, 1}, {0x68, 0xa6, 1}, {0x03, 0xa6, 3}
+    },
+    /* 188 */
+    {
+        {0x56, 0xa7, 1}, {0x82, 0xa7, 1}, {0x44, 0xa7, 1}, {0x52, 0xa7, 1},
+        {0x63, 0xa7, 1}, {0x5e, 0xa7, 1}, {0x68, 0xa7, 1}, {0x03, 0xa7, 3},
+        {0x56, 0xac, 1}, {0x82, 0xac, 1}, {0x44, 0xac, 1}, {0x52, 0xac, 1},
+        {0x63, 0xac, 1}, {0x5e, 0xac, 1}, {0x68, 0xac, 1}, {0x03, 0xac, 3}
+    },
+    /* 189 */
+    {
+        {0x56, 0xa8, 1}, {0x82, 0xa8, 1}, {0x44, 0xa8, 1}, {0x52, 0xa8, 1},
+        {0x63, 0xa8, 1}, {0x5e, 0xa8, 1}, {0x68, 0xa8, 1}, {0x03, 0xa8, 3},
+        {0x56, 0xae, 1}, {0x82, 0xae, 1}, {0x44, 0xae, 1}, {0x52, 0xae, 1},
+        {0x63, 0xae, 1}, {0x5e, 0xae, 1}, {0x68, 0xae, 1}, {0x03, 0xae, 3}
+    },
+    /* 190 */
+    {
+        {0x56, 0xaa, 1}, {0x82, 0xaa, 1}, {0x44, 0xaa, 1}, {0x52, 0xaa, 1},
+        {0x63, 0xaa, 1}, {0x5e, 0xaa, 1}, {0x68, 0xaa, 1}, {0x03, 0xaa, 3},
+        {0x56, 0xad, 1}, {0x82, 0xad, 1}, {0x44, 0xad, 1}, {0x52, 0xad, 1},
+        {0x63, 0xad, 1}, {0x5e, 0xad, 1}, {0x68, 0xad, 1}, {0x03, 0xad, 3}
+    },
+    /* 191 */
+    {
+        {0x42, 0xab, 1}, {0x01, 0xab, 3}, {0x42, 0xce, 1}, {0x01, 0xce, 3},
+        {0x42, 0xd7, 1}, {0x01, 0xd7, 3}, {0x42, 0xe1, 1}, {0x01, 0xe1, 3},
+        {0x42, 0xec, 1}, {0x01, 0xec, 3}, {0x42, 0xed, 1}, {0x01, 0xed, 3},
+        {0x00, 0xc7, 3}, {0x00, 0xcf, 3}, {0x00, 0xea, 3}, {0x00, 0xeb, 3}
+    },
+    /* 192 */
+    {
+        {0x55, 0xab, 1}, {0x43, 0xab, 1}, {0x5d, 0xab, 1}, {0x02, 0xab, 3},
+        {0x55, 0xce, 1}, {0x43, 0xce, 1}, {0x5d, 0xce, 1}, {0x02, 0xce, 3},
+        {0x55, 0xd7, 1}, {0x43, 0xd7, 1}, {0x5d, 0xd7, 1}, {0x02, 0xd7, 3},
+        {0x55, 0xe1, 1}, {0x43, 0xe1, 1}, {0x5d, 0xe1, 1}, {0x02, 0xe1, 3}
+    },
+    /* 193 */
+    {
+        {0x56, 0xab, 1}, {0x82, 0xab, 1}, {0x44, 0xab, 1}, {0x52, 0xab, 1},
+        {0x63, 0xab, 1}, {0x5e, 0xab, 1}, {0x68, 0xab, 1}, {0x03, 0xab, 3},
+        {0x56, 0xce, 1}, {0x82, 0xce, 1}, {0x44, 0xce, 1}, {0x52, 0xce, 1},
+        {0x63, 0xce, 1}, {0x5e, 0xce, 1}, {0x68, 0xce, 1}, {0x03, 0xce, 3}
+    },
+    /* 194 */
+    {
+        {0x55, 0xaf, 1}, {0x43, 0xaf, 1}, {0x5d, 0xaf, 1}, {0x02, 0xaf, 3},
+        {0x55, 0xb4, 1}, {0x43, 0xb4, 1}, {0x5d, 0xb4, 1}, {0x02, 0xb4, 3},
+        {0x55, 0xb6, 1}, {0x43, 0xb6, 1}, {0x5d, 0xb6, 1}, {0x02, 0xb6, 3},
+        {0x55, 0xb7, 1}, {0x43, 0xb7, 1}, {0x5d, 0xb7, 1}, {0x02, 0xb7, 3}
+    },
+    /* 195 */
+    {
+        {0x56, 0xaf, 1}, {0x82, 0xaf, 1}, {0x44, 0xaf, 1}, {0x52, 0xaf, 1},
+        {0x63, 0xaf, 1}, {0x5e, 0xaf, 1}, {0x68, 0xaf, 1}, {0x03, 0xaf, 3},
+        {0x56, 0xb4, 1}, {0x82, 0xb4, 1}, {0x44, 0xb4, 1}, {0x52, 0xb4, 1},
+        {0x63, 0xb4, 1}, {0x5e, 0xb4, 1}, {0x68, 0xb4, 1}, {0x03, 0xb4, 3}
+    },
+    /* 196 */
+    {
+        {0x42, 0xb0, 1}, {0x01, 0xb0, 3}, {0x42, 0xb1, 1}, {0x01, 0xb1, 3},
+        {0x42, 0xb3, 1}, {0x01, 0xb3, 3}, {0x42, 0xd1, 1}, {0x01, 0xd1, 3},
+        {0x42, 0xd8, 1}, {0x01, 0xd8, 3}, {0x42, 0xd9, 1}, {0x01, 0xd9, 3},
+        {0x42, 0xe3, 1}, {0x01, 0xe3, 3}, {0x42, 0xe5, 1}, {0x01, 0xe5, 3}
+    },
+    /* 197 */
+    {
+        {0x55, 0xb0, 1}, {0x43, 0xb0, 1}, {0x5d, 0xb0, 1}, {0x02, 0xb0, 3},
+        {0x55, 0xb1, 1}, {0x43, 0xb1, 1}, {0x5d, 0xb1, 1}, {0x02, 0xb1, 3},
+        {0x55, 0xb3, 1}, {0x43, 0xb3, 1}, {0x5d, 0xb3, 1}, {0x02, 0xb3, 3},
+        {0x55, 0xd1, 1}, {0x43, 0xd1, 1}, {0x5d, 0xd1, 1}, {0x02, 0xd1, 3}
+    },
+    /* 198 */
+    {
+        {0x56, 0xb0, 1}, {0x82, 0xb0, 1}, {0x44, 0xb0, 1}, {0x52, 0xb0, 1},
+        {0x63, 0xb0, 1}, {0x5e, 0xb0, 1}, {0x68, 0xb0, 1}, {0x03, 0xb0, 3},
+        {0x56, 0xb1, 1}, {0x82, 0xb1, 1}, {0x44, 0xb1, 1}, {0x52, 0xb1, 1},
+        {0x63, 0xb1, 1}, {0x5e, 0xb1, 1}, {0x68, 0xb1, 1}, {0x03, 0xb1, 3}
+    },
+    /* 199 */
+    {
+        {0x42, 0xb2, 1}, {0x01, 0xb2, 3}, {0x42, 0xb5, 1}, {0x01, 0xb5, 3},
+        {0x42, 0xb9, 1}, {0x01, 0xb9, 3}, {0x42, 0xba, 1}, {0x01, 0xba, 3},
+        {0x42, 0xbb, 1}, {0x01, 0xbb, 3}, {0x42, 0xbd, 1}, {0x01, 0xbd, 3},
+        {0x42, 0xbe, 1}, {0x01, 0xbe, 3}, {0x42, 0xc4, 1}, {0x01, 0xc4, 3}
+    },
+    /* 200 */
+    {
+        {0x55, 0xb2, 1}, {0x43, 0xb2, 1}, {0x5d, 0xb2, 1}, {0x02, 0xb2, 3},
+        {0x55, 0xb5, 1}, {0x43, 0xb5, 1}, {0x5d, 0xb5, 1}, {0x02, 0xb5, 3},
+        {0x55, 0xb9, 1}, {0x43, 0xb9, 1}, {0x5d, 0xb9, 1}, {0x02, 0xb9, 3},
+        {0x55, 0xba, 1}, {0x43, 0xba, 1}, {0x5d, 0xba, 1}, {0x02, 0xba, 3}
+    },
+    /* 201 */
+    {
+        {0x56, 0xb2, 1}, {0x82, 0xb2, 1}, {0x44, 0xb2, 1}, {0x52, 0xb2, 1},
+        {0x63, 0xb2, 1}, {0x5e, 0xb2, 1}, {0x68, 0xb2, 1}, {0x03, 0xb2, 3},
+        {0x56, 0xb5, 1}, {0x82, 0xb5, 1}, {0x44, 0xb5, 1}, {0x52, 0xb5, 1},
+        {0x63, 0xb5, 1}, {0x5e, 0xb5, 1}, {0x68, 0xb5, 1}, {0x03, 0xb5, 3}
+    },
+    /* 202 */
+    {
+        {0x56, 0xb3, 1}, {0x82, 0xb3, 1}, {0x44, 0xb3, 1}, {0x52, 0xb3, 1},
+        {0x63, 0xb3, 1}, {0x5e, 0xb3, 1}, {0x68, 0xb3, 1}, {0x03, 0xb3, 3},
+        {0x56, 0xd1, 1}, {0x82, 0xd1, 1}, {0x44, 0xd1, 1}, {0x52, 0xd1, 1},
+        {0x63, 0xd1, 1}, {0x5e, 0xd1, 1}, {0x68, 0xd1, 1}, {0x03, 0xd1, 3}
+    },
+    /* 203 */
+    {
+        {0x56, 0xb6, 1}, {0x82, 0xb6, 1}, {0x44, 0xb6, 1}, {0x52, 0xb6, 1},
+        {0x63, 0xb6, 1}, {0x5e, 0xb6, 1}, {0x68, 0xb6, 1}, {0x03, 0xb6, 3},
+        {0x56, 0xb7, 1}, {0x82, 0xb7, 1}, {0x44, 0xb7, 1}, {0x52, 0xb7, 1},
+        {0x63, 0xb7, 1}, {0x5e, 0xb7, 1}, {0x68, 0xb7, 1}, {0x03, 0xb7, 3}
+    },
+    /* 204 */
+    {
+        {0x56, 0xb8, 1}, {0x82, 0xb8, 1}, {0x44, 0xb8, 1}, {0x52, 0xb8, 1},
+        {0x63, 0xb8, 1}, {0x5e, 0xb8, 1}, {0x68, 0xb8, 1}, {0x03, 0xb8, 3},
+        {0x56, 0xc2, 1}, {0x82, 0xc2, 1}, {0x44, 0xc2, 1}, {0x52, 0xc2, 1},
+        {0x63, 0xc2, 1}, {0x5e, 0xc2, 1}, {0x68, 0xc2, 1}, {0x03, 0xc2, 3}
+    },
+    /* 205 */
+    {
+        {0x56, 0xb9, 1}, {0x82, 0xb9, 1}, {0x44, 0xb9, 1}, {0x52, 0xb9, 1},
+        {0x63, 0xb9, 1}, {0x5e, 0xb9, 1}, {0x68, 0xb9, 1}, {0x03, 0xb9, 3},
+        {0x56, 0xba, 1}, {0x82, 0xba, 1}, {0x44, 0xba, 1}, {0x52, 0xba, 1},
+        {0x63, 0xba, 1}, {0x5e, 0xba, 1}, {0x68, 0xba, 1}, {0x03, 0xba, 3}
+    },
+    /* 206 */
+    {
+        {0x55, 0xbb, 1}, {0x43, 0xbb, 1}, {0x5d, 0xbb, 1}, {0x02, 0xbb, 3},
+        {0x55, 0xbd, 1}, {0x43, 0xbd, 1}, {0x5d, 0xbd, 1}, {0x02, 0xbd, 3},
+        {0x55, 0xbe, 1}, {0x43, 0xbe, 1}, {0x5d, 0xbe, 1}, {0x02, 0xbe, 3},
+        {0x55, 0xc4, 1}, {0x43, 0xc4, 1}, {0x5d, 0xc4, 1}, {0x02, 0xc4, 3}
+    },
+    /* 207 */
+    {
+        {0x56, 0xbb, 1}, {0x82, 0xbb, 1}, {0x44, 0xbb, 1}, {0x52, 0xbb, 1},
+        {0x63, 0xbb, 1}, {0x5e, 0xbb, 1}, {0x68, 0xbb, 1}, {0x03, 0xbb, 3},
+        {0x56, 0xbd, 1}, {0x82, 0xbd, 1}, {0x44, 0xbd, 1}, {0x52, 0xbd, 1},
+        {0x63, 0xbd, 1}, {0x5e, 0xbd, 1}, {0x68, 0xbd, 1}, {0x03, 0xbd, 3}
+    },
+    /* 208 */
+    {
+        {0x55, 0xbc, 1}, {0x43, 0xbc, 1}, {0x5d, 0xbc, 1}, {0x02, 0xbc, 3},
+        {0x55, 0xbf, 1}, {0x43, 0xbf, 1}, {0x5d, 0xbf, 1}, {0x02, 0xbf, 3},
+        {0x55, 0xc5, 1}, {0x43, 0xc5, 1}, {0x5d, 0xc5, 1}, {0x02, 0xc5, 3},
+        {0x55, 0xe7, 1}, {0x43, 0xe7, 1}, {0x5d, 0xe7, 1}, {0x02, 0xe7, 3}
+    },
+    /* 209 */
+    {
+        {0x56, 0xbc, 1}, {0x82, 0xbc, 1}, {0x44, 0xbc, 1}, {0x52, 0xbc, 1},
+        {0x63, 0xbc, 1}, {0x5e, 0xbc, 1}, {0x68, 0xbc, 1}, {0x03, 0xbc, 3},
+        {0x56, 0xbf, 1}, {0x82, 0xbf, 1}, {0x44, 0xbf, 1}, {0x52, 0xbf, 1},
+        {0x63, 0xbf, 1}, {0x5e, 0xbf, 1}, {0x68, 0xbf, 1}, {0x03, 0xbf, 3}
+    },
+    /* 210 */
+    {
+        {0x56, 0xbe, 1}, {0x82, 0xbe, 1}, {0x44, 0xbe, 1}, {0x52, 0xbe, 1},
+        {0x63, 0xbe, 1}, {0x5e, 0xbe, 1}, {0x68, 0xbe, 1}, {0x03, 0xbe, 3},
+        {0x56, 0xc4, 1}, {0x82, 0xc4, 1}, {0x44, 0xc4, 1}, {0x52, 0xc4, 1},
+        {0x63, 0xc4, 1}, {0x5e, 0xc4, 1}, {0x68, 0xc4, 1}, {0x03, 0xc4, 3}
+    },
+    /* 211 */
+    {
+        {0x00, 0xc0, 3}, {0x00, 0xc1, 3}, {0x00, 0xc8, 3}, {0x00, 0xc9, 3},
+        {0x00, 0xca, 3}, {0x00, 0xcd, 3}, {0x00, 0xd2, 3}, {0x00, 0xd5, 3},
+        {0x00, 0xda, 3}, {0x00, 0xdb, 3}, {0x00, 0xee, 3}, {0x00, 0xf0, 3},
+        {0x00, 0xf2, 3}, {0x00, 0xf3, 3}, {0x00, 0xff, 3}, {0xe3, 0x00, 0}
+    },
+    /* 212 */
+    {
+        {0x42, 0xc0, 1}, {0x01, 0xc0, 3}, {0x42, 0xc1, 1}, {0x01, 0xc1, 3},
+        {0x42, 0xc8, 1}, {0x01, 0xc8, 3}, {0x42, 0xc9, 1}, {0x01, 0xc9, 3},
+        {0x42, 0xca, 1}, {0x01, 0xca, 3}, {0x42, 0xcd, 1}, {0x01, 0xcd, 3},
+        {0x42, 0xd2, 1}, {0x01, 0xd2, 3}, {0x42, 0xd5, 1}, {0x01, 0xd5, 3}
+    },
+    /* 213 */
+    {
+        {0x55, 0xc0, 1}, {0x43, 0xc0, 1}, {0x5d, 0xc0, 1}, {0x02, 0xc0, 3},
+        {0x55, 0xc1, 1}, {0x43, 0xc1, 1}, {0x5d, 0xc1, 1}, {0x02, 0xc1, 3},
+        {0x55, 0xc8, 1}, {0x43, 0xc8, 1}, {0x5d, 0xc8, 1}, {0x02, 0xc8, 3},
+        {0x55, 0xc9, 1}, {0x43, 0xc9, 1}, {0x5d, 0xc9, 1}, {0x02, 0xc9, 3}
+    },
+    /* 214 */
+    {
+        {0x56, 0xc0, 1}, {0x82, 0xc0, 1}, {0x44, 0xc0, 1}, {0x52, 0xc0, 1},
+        {0x63, 0xc0, 1}, {0x5e, 0xc0, 1}, {0x68, 0xc0, 1}, {0x03, 0xc0, 3},
+        {0x56, 0xc1, 1}, {0x82, 0xc1, 1}, {0x44, 0xc1, 1}, {0x52, 0xc1, 1},
+        {0x63, 0xc1, 1}, {0x5e, 0xc1, 1}, {0x68, 0xc1, 1}, {0x03, 0xc1, 3}
+    },
+    /* 215 */
+    {
+        {0x56, 0xc5, 1}, {0x82, 0xc5, 1}, {0x44, 0xc5, 1}, {0x52, 0xc5, 1},
+        {0x63, 0xc5, 1}, {0x5e, 0xc5, 1}, {0x68, 0xc5, 1}, {0x03, 0xc5, 3},
+        {0x56, 0xe7, 1}, {0x82, 0xe7, 1}, {0x44, 0xe7, 1}, {0x52, 0xe7, 1},
+        {0x63, 0xe7, 1}, {0x5e, 0xe7, 1}, {0x68, 0xe7, 1}, {0x03, 0xe7, 3}
+    },
+    /* 216 */
+    {
+        {0x55, 0xc6, 1}, {0x43, 0xc6, 1}, {0x5d, 0xc6, 1}, {0x02, 0xc6, 3},
+        {0x55, 0xe4, 1}, {0x43, 0xe4, 1}, {0x5d, 0xe4, 1}, {0x02, 0xe4, 3},
+        {0x55, 0xe8, 1}, {0x43, 0xe8, 1}, {0x5d, 0xe8, 1}, {0x02, 0xe8, 3},
+        {0x55, 0xe9, 1}, {0x43, 0xe9, 1}, {0x5d, 0xe9, 1}, {0x02, 0xe9, 3}
+    },
+    /* 217 */
+    {
+        {0x56, 0xc6, 1}, {0x82, 0xc6, 1}, {0x44, 0xc6, 1}, {0x52, 0xc6, 1},
+        {0x63, 0xc6, 1}, {0x5e, 0xc6, 1}, {0x68, 0xc6, 1}, {0x03, 0xc6, 3},
+        {0x56, 0xe4, 1}, {0x82, 0xe4, 1}, {0x44, 0xe4, 1}, {0x52, 0xe4, 1},
+        {0x63, 0xe4, 1}, {0x5e, 0xe4, 1}, {0x68, 0xe4, 1}, {0x03, 0xe4, 3}
+    },
+    /* 218 */
+    {
+        {0x55, 0xec, 1}, {0x43, 0xec, 1}, {0x5d, 0xec, 1}, {0x02, 0xec, 3},
+        {0x55, 0xed, 1}, {0x43, 0xed, 1}, {0x5d, 0xed, 1}, {0x02, 0xed, 3},
+        {0x42, 0xc7, 1}, {0x01, 0xc7, 3}, {0x42, 0xcf, 1}, {0x01, 0xcf, 3},
+        {0x42, 0xea, 1}, {0x01, 0xea, 3}, {0x42, 0xeb, 1}, {0x01, 0xeb, 3}
+    },
+    /* 219 */
+    {
+        {0x55, 0xc7, 1}, {0x43, 0xc7, 1}, {0x5d, 0xc7, 1}, {0x02, 0xc7, 3},
+        {0x55, 0xcf, 1}, {0x43, 0xcf, 1}, {0x5d, 0xcf, 1}, {0x02, 0xcf, 3},
+        {0x55, 0xea, 1}, {0x43, 0xea, 1}, {0x5d, 0xea, 1}, {0x02, 0xea, 3},
+        {0x55, 0xeb, 1}, {0x43, 0xeb, 1}, {0x5d, 0xeb, 1}, {0x02, 0xeb, 3}
+    },
+    /* 220 */
+    {
+        {0x56, 0xc7, 1}, {0x82, 0xc7, 1}, {0x44, 0xc7, 1}, {0x52, 0xc7, 1},
+        {0x63, 0xc7, 1}, {0x5e, 0xc7, 1}, {0x68, 0xc7, 1}, {0x03, 0xc7, 3},
+        {0x56, 0xcf, 1}, {0x82, 0xcf, 1}, {0x44, 0xcf, 1}, {0x52, 0xcf, 1},
+        {0x63, 0xcf, 1}, {0x5e, 0xcf, 1}, {0x68, 0xcf, 1}, {0x03, 0xcf, 3}
+    },
+    /* 221 */
+    {
+        {0x56, 0xc8, 1}, {0x82, 0xc8, 1}, {0x44, 0xc8, 1}, {0x52, 0xc8, 1},
+        {0x63, 0xc8, 1}, {0x5e, 0xc8, 1}, {0x68, 0xc8, 1}, {0x03, 0xc8, 3},
+        {0x56, 0xc9, 1}, {0x82, 0xc9, 1}, {0x44, 0xc9, 1}, {0x52, 0xc9, 1},
+        {0x63, 0xc9, 1}, {0x5e, 0xc9, 1}, {0x68, 0xc9, 1}, {0x03, 0xc9, 3}
+    },
+    /* 222 */
+    {
+        {0x55, 0xca, 1}, {0x43, 0xca, 1}, {0x5d, 0xca, 1}, {0x02, 0xca, 3},
+        {0x55, 0xcd, 1}, {0x43, 0xcd, 1}, {0x5d, 0xcd, 1}, {0x02, 0xcd, 3},
+        {0x55, 0xd2, 1}, {0x43, 0xd2, 1}, {0x5d, 0xd2, 1}, {0x02, 0xd2, 3},
+        {0x55, 0xd5, 1}, {0x43, 0xd5, 1}, {0x5d, 0xd5, 1}, {0x02, 0xd5, 3}
+    },
+    /* 223 */
+    {
+        {0x56, 0xca, 1}, {0x82, 0xca, 1}, {0x44, 0xca, 1}, {0x52, 0xca, 1},
+        {0x63, 0xca, 1}, {0x5e, 0xca, 1}, {0x68, 0xca, 1}, {0x03, 0xca, 3},
+        {0x56, 0xcd, 1}, {0x82, 0xcd, 1}, {0x44, 0xcd, 1}, {0x52, 0xcd, 1},
+        {0x63, 0xcd, 1}, {0x5e, 0xcd, 1}, {0x68, 0xcd, 1}, {0x03, 0xcd, 3}
+    },
+    /* 224 */
+    {
+        {0x42, 0xda, 1}, {0x01, 0xda, 3}, {0x42, 0xdb, 1}, {0x01, 0xdb, 3},
+        {0x42, 0xee, 1}, {0x01, 0xee, 3}, {0x42, 0xf0, 1}, {0x01, 0xf0, 3},
+        {0x42, 0xf2, 1}, {0x01, 0xf2, 3}, {0x42, 0xf3, 1}, {0x01, 0xf3, 3},
+        {0x42, 0xff, 1}, {0x01, 0xff, 3}, {0x00, 0xcb, 3}, {0x00, 0xcc, 3}
+    },
+    /* 225 */
+    {
+        {0x55, 0xf2, 1}, {0x43, 0xf2, 1}, {0x5d, 0xf2, 1}, {0x02, 0xf2, 3},
+        {0x55, 0xf3, 1}, {0x43, 0xf3, 1}, {0x5d, 0xf3, 1}, {0x02, 0xf3, 3},
+        {0x55, 0xff, 1}, {0x43, 0xff, 1}, {0x5d, 0xff, 1}, {0x02, 0xff, 3},
+        {0x42, 0xcb, 1}, {0x01, 0xcb, 3}, {0x42, 0xcc, 1}, {0x01, 0xcc, 3}
+    },
+    /* 226 */
+    {
+        {0x56, 0xff, 1}, {0x82, 0xff, 1}, {0x44, 0xff, 1}, {0x52, 0xff, 1},
+        {0x63, 0xff, 1}, {0x5e, 0xff, 1}, {0x68, 0xff, 1}, {0x03, 0xff, 3},
+        {0x55, 0xcb, 1}, {0x43, 0xcb, 1}, {0x5d, 0xcb, 1}, {0x02, 0xcb, 3},
+        {0x55, 0xcc, 1}, {0x43, 0xcc, 1}, {0x5d, 0xcc, 1}, {0x02, 0xcc, 3}
+    },
+    /* 227 */
+    {
+        {0x56, 0xcb, 1}, {0x82, 0xcb, 1}, {0x44, 0xcb, 1}, {0x52, 0xcb, 1},
+        {0x63, 0xcb, 1}, {0x5e, 0xcb, 1}, {0x68, 0xcb, 1}, {0x03, 0xcb, 3},
+        {0x56, 0xcc, 1}, {0x82, 0xcc, 1}, {0x44, 0xcc, 1}, {0x52, 0xcc, 1},
+        {0x63, 0xcc, 1}, {0x5e, 0xcc, 1}, {0x68, 0xcc, 1}, {0x03, 0xcc, 3}
+    },
+    /* 228 */
+    {
+        {0x56, 0xd2, 1}, {0x82, 0xd2, 1}, {0x44, 0xd2, 1}, {0x52, 0xd2, 1},
+        {0x63, 0xd2, 1}, {0x5e, 0xd2, 1}, {0x68, 0xd2, 1}, {0x03, 0xd2, 3},
+        {0x56, 0xd5, 1}, {0x82, 0xd5, 1}, {0x44, 0xd5, 1}, {0x52, 0xd5, 1},
+        {0x63, 0xd5, 1}, {0x5e, 0xd5, 1}, {0x68, 0xd5, 1}, {0x03, 0xd5, 3}
+    },
+    /* 229 */
+    {
+        {0x00, 0xd3, 3}, {0x00, 0xd4, 3}, {0x00, 0xd6, 3}, {0x00, 0xdd, 3},
+        {0x00, 0xde, 3}, {0x00, 0xdf, 3}, {0x00, 0xf1, 3}, {0x00, 0xf4, 3},
+        {0x00, 0xf5, 3}, {0x00, 0xf6, 3}, {0x00, 0xf7, 3}, {0x00, 0xf8, 3},
+        {0x00, 0xfa, 3}, {0x00, 0xfb, 3}, {0x00, 0xfc, 3}, {0x00, 0xfd, 3}
+    },
+    /* 230 */
+    {
+        {0x42, 0xd3, 1}, {0x01, 0xd3, 3}, {0x42, 0xd4, 1}, {0x01, 0xd4, 3},
+        {0x42, 0xd6, 1}, {0x01, 0xd6, 3}, {0x42, 0xdd, 1}, {0x01, 0xdd, 3},
+        {0x42, 0xde, 1}, {0x01, 0xde, 3}, {0x42, 0xdf, 1}, {0x01, 0xdf, 3},
+        {0x42, 0xf1, 1}, {0x01, 0xf1, 3}, {0x42, 0xf4, 1}, {0x01, 0xf4, 3}
+    },
+    /* 231 */
+    {
+        {0x55, 0xd3, 1}, {0x43, 0xd3, 1}, {0x5d, 0xd3, 1}, {0x02, 0xd3, 3},
+        {0x55, 0xd4, 1}, {0x43, 0xd4, 1}, {0x5d, 0xd4, 1}, {0x02, 0xd4, 3},
+        {0x55, 0xd6, 1}, {0x43, 0xd6, 1}, {0x5d, 0xd6, 1}, {0x02, 0xd6, 3},
+        {0x55, 0xdd, 1}, {0x43, 0xdd, 1}, {0x5d, 0xdd, 1}, {0x02, 0xdd, 3}
+    },
+    /* 232 */
+    {
+        {0x56, 0xd3, 1}, {0x82, 0xd3, 1}, {0x44, 0xd3, 1}, {0x52, 0xd3, 1},
+        {0x63, 0xd3, 1}, {0x5e, 0xd3, 1}, {0x68, 0xd3, 1}, {0x03, 0xd3, 3},
+        {0x56, 0xd4, 1}, {0x82, 0xd4, 1}, {0x44, 0xd4, 1}, {0x52, 0xd4, 1},
+        {0x63, 0xd4, 1}, {0x5e, 0xd4, 1}, {0x68, 0xd4, 1}, {0x03, 0xd4, 3}
+    },
+    /* 233 */
+    {
+        {0x56, 0xd6, 1}, {0x82, 0xd6, 1}, {0x44, 0xd6, 1}, {0x52, 0xd6, 1},
+        {0x63, 0xd6, 1}, {0x5e, 0xd6, 1}, {0x68, 0xd6, 1}, {0x03, 0xd6, 3},
+        {0x56, 0xdd, 1}, {0x82, 0xdd, 1}, {0x44, 0xdd, 1}, {0x52, 0xdd, 1},
+        {0x63, 0xdd, 1}, {0x5e, 0xdd, 1}, {0x68, 0xdd, 1}, {0x03, 0xdd, 3}
+    },
+    /* 234 */
+    {
+        {0x56, 0xd7, 1}, {0x82, 0xd7, 1}, {0x44, 0xd7, 1}, {0x52, 0xd7, 1},
+        {0x63, 0xd7, 1}, {0x5e, 0xd7, 1}, {0x68, 0xd7, 1}, {0x03, 0xd7, 3},
+        {0x56, 0xe1, 1}, {0x82, 0xe1, 1}, {0x44, 0xe1, 1}, {0x52, 0xe1, 1},
+        {0x63, 0xe1, 1}, {0x5e, 0xe1, 1}, {0x68, 0xe1, 1}, {0x03, 0xe1, 3}
+    },
+    /* 235 */
+    {
+        {0x55, 0xd8, 1}, {0x43, 0xd8, 1}, {0x5d, 0xd8, 1}, {0x02, 0xd8, 3},
+        {0x55, 0xd9, 1}, {0x43, 0xd9, 1}, {0x5d, 0xd9, 1}, {0x02, 0xd9, 3},
+        {0x55, 0xe3, 1}, {0x43, 0xe3, 1}, {0x5d, 0xe3, 1}, {0x02, 0xe3, 3},
+        {0x55, 0xe5, 1}, {0x43, 0xe5, 1}, {0x5d, 0xe5, 1}, {0x02, 0xe5, 3}
+    },
+    /* 236 */
+    {
+        {0x56, 0xd8, 1}, {0x82, 0xd8, 1}, {0x44, 0xd8, 1}, {0x52, 0xd8, 1},
+        {0x63, 0xd8, 1}, {0x5e, 0xd8, 1}, {0x68, 0xd8, 1}, {0x03, 0xd8, 3},
+        {0x56, 0xd9, 1}, {0x82, 0xd9, 1}, {0x44, 0xd9, 1}, {0x52, 0xd9, 1},
+        {0x63, 0xd9, 1}, {0x5e, 0xd9, 1}, {0x68, 0xd9, 1}, {0x03, 0xd9, 3}
+    },
+    /* 237 */
+    {
+        {0x55, 0xda, 1}, {0x43, 0xda, 1}, {0x5d, 0xda, 1}, {0x02, 0xda, 3},
+        {0x55, 0xdb, 1}, {0x43, 0xdb, 1}, {0x5d, 0xdb, 1}, {0x02, 0xdb, 3},
+        {0x55, 0xee, 1}, {0x43, 0xee, 1}, {0x5d, 0xee, 1}, {0x02, 0xee, 3},
+        {0x55, 0xf0, 1}, {0x43, 0xf0, 1}, {0x5d, 0xf0, 1}, {0x02, 0xf0, 3}
+    },
+    /* 238 */
+    {
+        {0x56, 0xda, 1}, {0x82, 0xda, 1}, {0x44, 0xda, 1}, {0x52, 0xda, 1},
+        {0x63, 0xda, 1}, {0x5e, 0xda, 1}, {0x68, 0xda, 1}, {0x03, 0xda, 3},
+        {0x56, 0xdb, 1}, {0x82, 0xdb, 1}, {0x44, 0xdb, 1}, {0x52, 0xdb, 1},
+        {0x63, 0xdb, 1}, {0x5e, 0xdb, 1}, {0x68, 0xdb, 1}, {0x03, 0xdb, 3}
+    },
+    /* 239 */
+    {
+        {0x55, 0xde, 1}, {0x43, 0xde, 1}, {0x5d, 0xde, 1}, {0x02, 0xde, 3},
+        {0x55, 0xdf, 1}, {0x43, 0xdf, 1}, {0x5d, 0xdf, 1}, {0x02, 0xdf, 3},
+        {0x55, 0xf1, 1}, {0x43, 0xf1, 1}, {0x5d, 0xf1, 1}, {0x02, 0xf1, 3},
+        {0x55, 0xf4, 1}, {0x43, 0xf4, 1}, {0x5d, 0xf4, 1}, {0x02, 0xf4, 3}
+    },
+    /* 240 */
+    {
+        {0x56, 0xde, 1}, {0x82, 0xde, 1}, {0x44, 0xde, 1}, {0x52, 0xde, 1},
+        {0x63, 0xde, 1}, {0x5e, 0xde, 1}, {0x68, 0xde, 1}, {0x03, 0xde, 3},
+        {0x56, 0xdf, 1}, {0x82, 0xdf, 1}, {0x44, 0xdf, 1}, {0x52, 0xdf, 1},
+        {0x63, 0xdf, 1}, {0x5e, 0xdf, 1}, {0x68, 0xdf, 1}, {0x03, 0xdf, 3}
+    },
+    /* 241 */
+    {
+        {0x56, 0xe0, 1}, {0x82, 0xe0, 1}, {0x44, 0xe0, 1}, {0x52, 0xe0, 1},
+        {0x63, 0xe0, 1}, {0x5e, 0xe0, 1}, {0x68, 0xe0, 1}, {0x03, 0xe0, 3},
+        {0x56, 0xe2, 1}, {0x82, 0xe2, 1}, {0x44, 0xe2, 1}, {0x52, 0xe2, 1},
+        {0x63, 0xe2, 1}, {0x5e, 0xe2, 1}, {0x68, 0xe2, 1}, {0x03, 0xe2, 3}
+    },
+    /* 242 */
+    {
+        {0x56, 0xe3, 1}, {0x82, 0xe3, 1}, {0x44, 0xe3, 1}, {0x52, 0xe3, 1},
+        {0x63, 0xe3, 1}, {0x5e, 0xe3, 1}, {0x68, 0xe3, 1}, {0x03, 0xe3, 3},
+        {0x56, 0xe5, 1}, {0x82, 0xe5, 1}, {0x44, 0xe5, 1}, {0x52, 0xe5, 1},
+        {0x63, 0xe5, 1}, {0x5e, 0xe5, 1}, {0x68, 0xe5, 1}, {0x03, 0xe5, 3}
+    },
+    /* 243 */
+    {
+        {0x56, 0xe8, 1}, {0x82, 0xe8, 1}, {0x44, 0xe8, 1}, {0x52, 0xe8, 1},
+        {0x63, 0xe8, 1}, {0x5e, 0xe8, 1}, {0x68, 0xe8, 1}, {0x03, 0xe8, 3},
+        {0x56, 0xe9, 1}, {0x82, 0xe9, 1}, {0x44, 0xe9, 1}, {0x52, 0xe9, 1},
+        {0x63, 0xe9, 1}, {0x5e, 0xe9, 1}, {0x68, 0xe9, 1}, {0x03, 0xe9, 3}
+    },
+    /* 244 */
+    {
+        {0x56, 0xea, 1}, {0x82, 0xea, 1}, {0x44, 0xea, 1}, {0x52, 0xea, 1},
+        {0x63, 0xea, 1}, {0x5e, 0xea, 1}, {0x68, 0xea, 1}, {0x03, 0xea, 3},
+        {0x56, 0xeb, 1}, {0x82, 0xeb, 1}, {0x44, 0xeb, 1}, {0x52, 0xeb, 1},
+        {0x63, 0xeb, 1}, {0x5e, 0xeb, 1}, {0x68, 0xeb, 1}, {0x03, 0xeb, 3}
+    },
+    /* 245 */
+    {
+        {0x56, 0xec, 1}, {0x82, 0xec, 1}, {0x44, 0xec, 1}, {0x52, 0xec, 1},
+        {0x63, 0xec, 1}, {0x5e, 0xec, 1}, {0x68, 0xec, 1}, {0x03, 0xec, 3},
+        {0x56, 0xed, 1}, {0x82, 0xed, 1}, {0x44, 0xed, 1}, {0x52, 0xed, 1},
+        {0x63, 0xed, 1}, {0x5e, 0xed, 1}, {0x68, 0xed, 1}, {0x03, 0xed, 3}
+    },
+    /* 246 */
+    {
+        {0x56, 0xee, 1}, {0x82, 0xee, 1}, {0x44, 0xee, 1}, {0x52, 0xee, 1},
+        {0x63, 0xee, 1}, {0x5e, 0xee, 1}, {0x68, 0xee, 1}, {0x03, 0xee, 3},
+        {0x56, 0xf0, 1}, {0x82, 0xf0, 1}, {0x44, 0xf0, 1}, {0x52, 0xf0, 1},
+        {0x63, 0xf0, 1}, {0x5e, 0xf0, 1}, {0x68, 0xf0, 1}, {0x03, 0xf0, 3}
+    },
+    /* 247 */
+    {
+        {0x56, 0xf1, 1}, {0x82, 0xf1, 1}, {0x44, 0xf1, 1}, {0x52, 0xf1, 1},
+        {0x63, 0xf1, 1}, {0x5e, 0xf1, 1}, {0x68, 0xf1, 1}, {0x03, 0xf1, 3},
+        {0x56, 0xf4, 1}, {0x82, 0xf4, 1}, {0x44, 0xf4, 1}, {0x52, 0xf4, 1},
+        {0x63, 0xf4, 1}, {0x5e, 0xf4, 1}, {0x68, 0xf4, 1}, {0x03, 0xf4, 3}
+    },
+    /* 248 */
+    {
+        {0x56, 0xf2, 1}, {0x82, 0xf2, 1}, {0x44, 0xf2, 1}, {0x52, 0xf2, 1},
+        {0x63, 0xf2, 1}, {0x5e, 0xf2, 1}, {0x68, 0xf2, 1}, {0x03, 0xf2, 3},
+        {0x56, 0xf3, 1}, {0x82, 0xf3, 1}, {0x44, 0xf3, 1}, {0x52, 0xf3, 1},
+        {0x63, 0xf3, 1}, {0x5e, 0xf3, 1}, {0x68, 0xf3, 1}, {0x03, 0xf3, 3}
+    },
+    /* 249 */
+    {
+        {0x42, 0xf5, 1}, {0x01, 0xf5, 3}, {0x42, 0xf6, 1}, {0x01, 0xf6, 3},
+        {0x42, 0xf7, 1}, {0x01, 0xf7, 3}, {0x42, 0xf8, 1}, {0x01, 0xf8, 3},
+        {0x42, 0xfa, 1}, {0x01, 0xfa, 3}, {0x42, 0xfb, 1}, {0x01, 0xfb, 3},
+        {0x42, 0xfc, 1}, {0x01, 0xfc, 3}, {0x42, 0xfd, 1}, {0x01, 0xfd, 3}
+    },
+    /* 250 */
+    {
+        {0x55, 0xf5, 1}, {0x43, 0xf5, 1}, {0x5d, 0xf5, 1}, {0x02, 0xf5, 3},
+        {0x55, 0xf6, 1}, {0x43, 0xf6, 1}, {0x5d, 0xf6, 1}, {0x02, 0xf6, 3},
+        {0x55, 0xf7, 1}, {0x43, 0xf7, 1}, {0x5d, 0xf7, 1}, {0x02, 0xf7, 3},
+        {0x55, 0xf8, 1}, {0x43, 0xf8, 1}, {0x5d, 0xf8, 1}, {0x02, 0xf8, 3}
+    },
+    /* 251 */
+    {
+        {0x56, 0xf5, 1}, {0x82, 0xf5, 1}, {0x44, 0xf5, 1}, {0x52, 0xf5, 1},
+        {0x63, 0xf5, 1}, {0x5e, 0xf5, 1}, {0x68, 0xf5, 1}, {0x03, 0xf5, 3},
+        {0x56, 0xf6, 1}, {0x82, 0xf6, 1}, {0x44, 0xf6, 1}, {0x52, 0xf6, 1},
+        {0x63, 0xf6, 1}, {0x5e, 0xf6, 1}, {0x68, 0xf6, 1}, {0x03, 0xf6, 3}
+    },
+    /* 252 */
+    {
+        {0x56, 0xf7, 1}, {0x82, 0xf7, 1}, {0x44, 0xf7, 1}, {0x52, 0xf7, 1},
+        {0x63, 0xf7, 1}, {0x5e, 0xf7, 1}, {0x68, 0xf7, 1}, {0x03, 0xf7, 3},
+        {0x56, 0xf8, 1}, {0x82, 0xf8, 1}, {0x44, 0xf8, 1}, {0x52, 0xf8, 1},
+        {0x63, 0xf8, 1}, {0x5e, 0xf8, 1}, {0x68, 0xf8, 1}, {0x03, 0xf8, 3}
+    },
+    /* 253 */
+    {
+        {0x55, 0xfa, 1}, {0x43, 0xfa, 1}, {0x5d, 0xfa, 1}, {0x02, 0xfa, 3},
+        {0x55, 0xfb, 1}, {0x43, 0xfb, 1}, {0x5d, 0xfb, 1}, {0x02, 0xfb, 3},
+        {0x55, 0xfc, 1}, {0x43, 0xfc, 1}, {0x5d, 0xfc, 1}, {0x02, 0xfc, 3},
+        {0x55, 0xfd, 1}, {0x43, 0xfd, 1}, {0x5d, 0xfd, 1}, {0x02, 0xfd, 3}
+    },
+    /* 254 */
+    {
+        {0x56, 0xfa, 1}, {0x82, 0xfa, 1}, {0x44, 0xfa, 1}, {0x52, 0xfa, 1},
+        {0x63, 0xfa, 1}, {0x5e, 0xfa, 1}, {0x68, 0xfa, 1}, {0x03, 0xfa, 3},
+        {0x56, 0xfb, 1}, {0x82, 0xfb, 1}, {0x44, 0xfb, 1}, {0x52, 0xfb, 1},
+        {0x63, 0xfb, 1}, {0x5e, 0xfb, 1}, {0x68, 0xfb, 1}, {0x03, 0xfb, 3}
+    },
+    /* 255 */
+    {
+        {0x56, 0xfc, 1}, {0x82, 0xfc, 1}, {0x44, 0xfc, 1}, {0x52, 0xfc, 1},
+        {0x63, 0xfc, 1}, {0x5e, 0xfc, 1}, {0x68, 0xfc, 1}, {0x03, 0xfc, 3},
+        {0x56, 0xfd, 1}, {0x82, 0xfd, 1}, {0x44, 0xfd, 1}, {0x52, 0xfd, 1},
+        {0x63, 0xfd, 1}, {0x5e, 0xfd, 1}, {0x68, 0xfd, 1}, {0x03, 0xfd, 3}
+    }
+};
+
+
+ngx_int_t
+ngx_http_huff_decode(u_char *state, u_char *src, size_t len, u_char **dst,
+    ngx_uint_t last, ngx_log_t *log)
+{
+    u_char                        *end, ch;
+    ngx_uint_t                     ending;
+    ngx_http_huff_decode_code_t   *code;
+
+    ending = (*state == 0);
+    end = src + len;
+
+    while (src != end) {
+        ch = *src++;
+
+        code = &ngx_http_huff_decode_codes[*state][ch >> 4];
+
+        if (code->flags & NGX_HTTP_HUFF_FAIL) {
+            goto failed;
+        }
+
+        if (code->flags & NGX_HTTP_HUFF_EMIT) {
+            *(*dst)++ = code->sym;
+        }
+
+        code = &ngx_http_huff_decode_codes[code->next][ch & 0xf];
+
+        if (code->flags & NGX_HTTP_HUFF_FAIL) {
+            goto failed;
+        }
+
+        if (code->flags & NGX_HTTP_HUFF_EMIT) {
+            *(*dst)++ = code->sym;
+        }
+
+        *state = code->next;
+        ending = code->flags & NGX_HTTP_HUFF_ACCEPT;
+    }
+
+    if (last && !ending) {
+        ngx_log_debug1(NGX_LOG_DEBUG_HTTP, log, 0,
+                       "http2 huffman decoding error at state %d: "
+                       "bad ending", *state);
+
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+
+failed:
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, log, 0,
+                   "http2 huffman decoding error at state %d: "
+                   "EOS symbol", *state);
+
+    return NGX_ERROR;
+}
@@ -10,6 +10,23 @@
 #include <ngx_http.h>
 
 
+#if (NGX_HAVE_SSE2)
+
+#include <emmintrin.h>
+
+#define NGX_HTTP_PARSE_SKIP_VALUE      0
+#define NGX_HTTP_PARSE_SKIP_URI        1
+#define NGX_HTTP_PARSE_SKIP_CHECK_URI  2
+
+static ngx_inline int ngx_http_parse_mask(__m128i v, ngx_uint_t set);
+static ngx_inline u_char *ngx_http_parse_skip(u_char *p, u_char *last,
+    ngx_uint_t set);
+static ngx_inline u_char *ngx_http_parse_copy_usual(u_char *dst,
+    u_char **src, u_char *last);
+
+#endif
+
+
 static uint32_t  usual[] = {
     0xffffdbfe, /* 1111 1111 1111 1111  1101 1011 1111 1110 */
 
@@ -478,6 +495,11 @@ ngx_http_parse_request_line(ngx_http_request_t *r, ngx_buf_t *b)
         /* check "/", "%" and "\" (Win32) in URI */
         case sw_check_uri:
 
+#if (NGX_HAVE_SSE2)
+            p = ngx_http_parse_skip(p, b->last, NGX_HTTP_PARSE_SKIP_CHECK_URI);
+            ch = *p;
+#endif
+
             if (usual[ch >> 5] & (1 << (ch & 0x1f))) {
                 break;
             }
@@ -556,6 +578,11 @@ ngx_http_parse_request_line(ngx_http_request_t *r, ngx_buf_t *b)
         /* URI */
         case sw_uri:
 
+#if (NGX_HAVE_SSE2)
+            p = ngx_http_parse_skip(p, b->last, NGX_HTTP_PARSE_SKIP_URI);
+            ch = *p;
+#endif
+
             if (usual[ch >> 5] & (1 << (ch & 0x1f))) {
                 break;
             }
@@ -915,6 +942,12 @@ ngx_http_parse_header_line(ngx_http_request_t *r, ngx_buf_t *b,
 
         /* header value */
         case sw_value:
+
+#if (NGX_HAVE_SSE2)
+            p = ngx_http_parse_skip(p, b->last, NGX_HTTP_PARSE_SKIP_VALUE);
+            ch = *p;
+#endif
+
             switch (ch) {
             case ' ':
                 r->header_end = p;
@@ -1052,6 +1085,11 @@ ngx_http_parse_complex_uri(ngx_http_request_t *r, ngx_uint_t merge_slashes)
 
             if (usual[ch >> 5] & (1 << (ch & 0x1f))) {
                 *u++ = ch;
+
+#if (NGX_HAVE_SSE2)
+                u = ngx_http_parse_copy_usual(u, &p, r->uri_end);
+#endif
+
                 ch = *p++;
                 break;
             }
@@ -1420,6 +1458,7 @@ ngx_http_parse_status_line(ngx_http_request_t *r, ngx_buf_t *b,
                 return NGX_ERROR;
             }
 
+            r->http_major = ch - '0';
             state = sw_major_digit;
             break;
 
@@ -1434,6 +1473,11 @@ ngx_http_parse_status_line(ngx_http_request_t *r, ngx_buf_t *b,
                 return NGX_ERROR;
             }
 
+            if (r->http_major > 99) {
+                return NGX_ERROR;
+            }
+
+            r->http_major = r->http_major * 10 + ch - '0';
             break;
 
         /* the first digit of minor HTTP version */
@@ -1442,6 +1486,7 @@ ngx_http_parse_status_line(ngx_http_request_t *r, ngx_buf_t *b,
                 return NGX_ERROR;
             }
 
+            r->http_minor = ch - '0';
             state = sw_minor_digit;
             break;
 
@@ -1456,6 +1501,11 @@ ngx_http_parse_status_line(ngx_http_request_t *r, ngx_buf_t *b,
                 return NGX_ERROR;
             }
 
+            if (r->http_minor > 99) {
+                return NGX_ERROR;
+            }
+
+            r->http_minor = r->http_minor * 10 + ch - '0';
             break;
 
         /* HTTP status code */
@@ -1533,6 +1583,7 @@ done:
         status->end = p;
     }
 
+    status->http_version = r->http_major * 1000 + r->http_minor;
     r->state = sw_start;
 
     return NGX_OK;
@@ -1734,3 +1785,368 @@ ngx_http_split_args(ngx_http_request_t *r, ngx_str_t *uri, ngx_str_t *args)
         args->len = 0;
     }
 }
+
+/*
+ * 解析chunked编码的包体,ctx保存了跨缓冲区的解析状态
+ * 返回NGX_OK表示b->pos开始的ctx->size字节是一个chunk的数据,
+ * NGX_DONE表示整个包体已经解析完毕,NGX_AGAIN表示需要更多数据,
+ * 此时ctx->length为最少还需要的字节数
+ */
+
+ngx_int_t
+ngx_http_parse_chunked(ngx_http_request_t *r, ngx_buf_t *b,
+    ngx_http_chunked_t *ctx)
+{
+    u_char     *pos, ch, c;
+    ngx_int_t   rc;
+    enum {
+        sw_chunk_start = 0,
+        sw_chunk_size,
+        sw_chunk_extension,
+        sw_chunk_extension_almost_done,
+        sw_chunk_data,
+        sw_after_data,
+        sw_after_data_almost_done,
+        sw_last_chunk_extension,
+        sw_last_chunk_extension_almost_done,
+        sw_trailer,
+        sw_trailer_almost_done,
+        sw_trailer_header,
+        sw_trailer_header_almost_done
+    } state;
+
+    state = ctx->state;
+
+    if (state == sw_chunk_data && ctx->size == 0) {
+        state = sw_after_data;
+    }
+
+    rc = NGX_AGAIN;
+
+    for (pos = b->pos; pos < b->last; pos++) {
+
+        ch = *pos;
+
+        ngx_log_debug2(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                       "http chunked byte: %02Xd s:%d", ch, state);
+
+        switch (state) {
+
+        case sw_chunk_start:
+            if (ch >= '0' && ch <= '9') {
+                state = sw_chunk_size;
+                ctx->size = ch - '0';
+                break;
+            }
+
+            c = (u_char) (ch | 0x20);
+
+            if (c >= 'a' && c <= 'f') {
+                state = sw_chunk_size;
+                ctx->size = c - 'a' + 10;
+                break;
+            }
+
+            goto invalid;
+
+        case sw_chunk_size:
+            if (ctx->size > NGX_MAX_OFF_T_VALUE / 16) {
+                goto invalid;
+            }
+
+            if (ch >= '0' && ch <= '9') {
+                ctx->size = ctx->size * 16 + (ch - '0');
+                break;
+            }
+
+            c = (u_char) (ch | 0x20);
+
+            if (c >= 'a' && c <= 'f') {
+                ctx->size = ctx->size * 16 + (c - 'a' + 10);
+                break;
+            }
+
+            if (ctx->size == 0) {
+
+                switch (ch) {
+                case CR:
+                    state = sw_last_chunk_extension_almost_done;
+                    break;
+                case LF:
+                    state = sw_trailer;
+                    break;
+                case ';':
+                case ' ':
+                case '\t':
+                    state = sw_last_chunk_extension;
+                    break;
+                default:
+                    goto invalid;
+                }
+
+                break;
+            }
+
+            switch (ch) {
+            case CR:
+                state = sw_chunk_extension_almost_done;
+                break;
+            case LF:
+                state = sw_chunk_data;
+                break;
+            case ';':
+            case ' ':
+            case '\t':
+                state = sw_chunk_extension;
+                break;
+            default:
+                goto invalid;
+            }
+
+            break;
+
+        case sw_chunk_extension:
+            switch (ch) {
+            case CR:
+                state = sw_chunk_extension_almost_done;
+                break;
+            case LF:
+                state = sw_chunk_data;
+            }
+            break;
+
+        case sw_chunk_extension_almost_done:
+            if (ch == LF) {
+                state = sw_chunk_data;
+                break;
+            }
+            goto invalid;
+
+        case sw_chunk_data:
+            rc = NGX_OK;
+            goto data;
+
+        case sw_after_data:
+            switch (ch) {
+            case CR:
+                state = sw_after_data_almost_done;
+                break;
+            case LF:
+                state = sw_chunk_start;
+            }
+            break;
+
+        case sw_after_data_almost_done:
+            if (ch == LF) {
+                state = sw_chunk_start;
+                break;
+            }
+            goto invalid;
+
+        case sw_last_chunk_extension:
+            switch (ch) {
+            case CR:
+                state = sw_last_chunk_extension_almost_done;
+                break;
+            case LF:
+                state = sw_trailer;
+            }
+            break;
+
+        case sw_last_chunk_extension_almost_done:
+            if (ch == LF) {
+                state = sw_trailer;
+                break;
+            }
+            goto invalid;
+
+        case sw_trailer:
+            switch (ch) {
+            case CR:
+                state = sw_trailer_almost_done;
+                break;
+            case LF:
+                goto done;
+            default:
+                state = sw_trailer_header;
+            }
+            break;
+
+        case sw_trailer_almost_done:
+            if (ch == LF) {
+                goto done;
+            }
+            goto invalid;
+
+        case sw_trailer_header:
+            switch (ch) {
+            case CR:
+                state = sw_trailer_header_almost_done;
+                break;
+            case LF:
+                state = sw_trailer;
+            }
+            break;
+
+        case sw_trailer_header_almost_done:
+            if (ch == LF) {
+                state = sw_trailer;
+                break;
+            }
+            goto invalid;
+
+        }
+    }
+
+data:
+
+    ctx->state = state;
+    b->pos = pos;
+
+    switch (state) {
+
+    case sw_chunk_start:
+        ctx->length = 3 /* "0" LF LF */;
+        break;
+    case sw_chunk_size:
+        ctx->length = 2 /* LF LF */
+                      + (ctx->size ? ctx->size + 4 /* LF "0" LF LF */ : 0);
+        break;
+    case sw_chunk_extension:
+    case sw_chunk_extension_almost_done:
+        ctx->length = 1 /* LF */ + ctx->size + 4 /* LF "0" LF LF */;
+        break;
+    case sw_chunk_data:
+        ctx->length = ctx->size + 4 /* LF "0" LF LF */;
+        break;
+    case sw_after_data:
+    case sw_after_data_almost_done:
+        ctx->length = 4 /* LF "0" LF LF */;
+        break;
+    case sw_last_chunk_extension:
+    case sw_last_chunk_extension_almost_done:
+        ctx->length = 2 /* LF LF */;
+        break;
+    case sw_trailer:
+    case sw_trailer_almost_done:
+        ctx->length = 1 /* LF */;
+        break;
+    case sw_trailer_header:
+    case sw_trailer_header_almost_done:
+        ctx->length = 2 /* LF LF */;
+        break;
+
+    }
+
+    if (ctx->size < 0 || ctx->length < 0) {
+        goto invalid;
+    }
+
+    return rc;
+
+done:
+
+    ctx->state = 0;
+    b->pos = pos + 1;
+
+    return NGX_DONE;
+
+invalid:
+
+    return NGX_ERROR;
+}
+
+
+#if (NGX_HAVE_SSE2)
+
+/*
+ * skips 16 bytes at a time up to the first byte the state acts upon;
+ * at least one byte is always left for the scalar state machine
+ */
+
+#define ngx_http_parse_eq(v, c)  _mm_cmpeq_epi8(v, _mm_set1_epi8((char) c))
+
+static ngx_inline int
+ngx_http_parse_mask(__m128i v, ngx_uint_t set)
+{
+    __m128i  m;
+
+    m = _mm_or_si128(_mm_or_si128(ngx_http_parse_eq(v, ' '),
+                                  ngx_http_parse_eq(v, '\0')),
+                     _mm_or_si128(ngx_http_parse_eq(v, CR),
+                                  ngx_http_parse_eq(v, LF)));
+
+    if (set != NGX_HTTP_PARSE_SKIP_VALUE) {
+        m = _mm_or_si128(m, ngx_http_parse_eq(v, '#'));
+    }
+
+    if (set == NGX_HTTP_PARSE_SKIP_CHECK_URI) {
+        m = _mm_or_si128(m,
+                _mm_or_si128(_mm_or_si128(ngx_http_parse_eq(v, '/'),
+                                          ngx_http_parse_eq(v, '.')),
+                             _mm_or_si128(ngx_http_parse_eq(v, '%'),
+                                          ngx_http_parse_eq(v, '?'))));
+        m = _mm_or_si128(m, ngx_http_parse_eq(v, '+'));
+    }
+
+    return _mm_movemask_epi8(m);
+}
+
+
+static ngx_inline u_char *
+ngx_http_parse_skip(u_char *p, u_char *last, ngx_uint_t set)
+{
+    int  mask;
+
+    while (last - p > 16) {
+        mask = ngx_http_parse_mask(_mm_loadu_si128((__m128i *) p), set);
+
+        if (mask) {
+            return p + __builtin_ctz(mask);
+        }
+
+        p += 16;
+    }
+
+    return p;
+}
+
+
+/*
+ * copies the run of usual characters at *src to dst; a whole block
+ * is stored only if it has no "?", so the copy never goes past
+ * the space allocated for the URI without arguments
+ */
+
+static ngx_inline u_char *
+ngx_http_parse_copy_usual(u_char *dst, u_char **src, u_char *last)
+{
+    int       mask;
+    u_char   *p;
+    __m128i   v;
+
+    p = *src;
+
+    while (last - p > 16) {
+        v = _mm_loadu_si128((__m128i *) p);
+        mask = ngx_http_parse_mask(v, NGX_HTTP_PARSE_SKIP_CHECK_URI);
+
+        if (mask) {
+            for (mask = __builtin_ctz(mask); mask; mask--) {
+                *dst++ = *p++;
+            }
+
+            break;
+        }
+
+        _mm_storeu_si128((__m128i *) dst, v);
+        dst += 16;
+        p += 16;
+    }
+
+    *src = p;
+
+    return dst;
+}
+
+#endif
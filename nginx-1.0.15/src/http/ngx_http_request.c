@@ -16,6 +16,10 @@ static void ngx_http_process_request_headers(ngx_event_t *rev);
 static ssize_t ngx_http_read_request_header(ngx_http_request_t *r);
 static ngx_int_t ngx_http_alloc_large_header_buffer(ngx_http_request_t *r,
     ngx_uint_t request_line);
+static ngx_buf_t *ngx_http_get_large_header_buffer(size_t size,
+    ngx_log_t *log);
+static void ngx_http_free_large_header_buffer(ngx_buf_t *b);
+static void ngx_http_large_header_cleanup(void *data);
 
 static ngx_int_t ngx_http_process_header_line(ngx_http_request_t *r,
     ngx_table_elt_t *h, ngx_uint_t offset);
@@ -30,8 +34,6 @@ static ngx_int_t ngx_http_process_user_agent(ngx_http_request_t *r,
 static ngx_int_t ngx_http_process_cookie(ngx_http_request_t *r,
     ngx_table_elt_t *h, ngx_uint_t offset);
 
-static ngx_int_t ngx_http_process_request_header(ngx_http_request_t *r);
-static void ngx_http_process_request(ngx_http_request_t *r);
 static ssize_t ngx_http_validate_host(ngx_http_request_t *r, u_char **host,
     size_t len, ngx_uint_t alloc);
 static ngx_int_t ngx_http_find_virtual_server(ngx_http_request_t *r,
@@ -50,14 +52,9 @@ static void ngx_http_keepalive_handler(ngx_event_t *ev);
 static void ngx_http_set_lingering_close(ngx_http_request_t *r);
 static void ngx_http_lingering_close_handler(ngx_event_t *ev);
 static ngx_int_t ngx_http_post_action(ngx_http_request_t *r);
-static void ngx_http_close_request(ngx_http_request_t *r, ngx_int_t error);
-static void ngx_http_free_request(ngx_http_request_t *r, ngx_int_t error);
 static void ngx_http_log_request(ngx_http_request_t *r);
-static void ngx_http_close_connection(ngx_connection_t *c);
 
 static u_char *ngx_http_log_error(ngx_log_t *log, u_char *buf, size_t len);
-static u_char *ngx_http_log_error_handler(ngx_http_request_t *r,
-    ngx_http_request_t *sr, u_char *buf, size_t len);
 
 #if (NGX_HTTP_SSL)
 static void ngx_http_ssl_handshake(ngx_event_t *rev);
@@ -65,6 +62,18 @@ static void ngx_http_ssl_handshake_handler(ngx_connection_t *c);
 #endif
 
 
+/*
+ * the large header buffers are allocated outside the connection pools
+ * and are recycled by a worker; the buffers of different sizes are
+ * linked together through b->shadow
+ */
+
+#define NGX_HTTP_LARGE_HEADER_CACHE  64
+
+static ngx_buf_t   *ngx_http_large_header_cache;
+static ngx_uint_t   ngx_http_large_header_ncached;
+
+
 static char *ngx_http_client_errors[] = {
 
     /* NGX_HTTP_PARSE_INVALID_METHOD */
@@ -428,6 +437,12 @@ ngx_http_init_request(ngx_event_t *rev)
                 return;
             }
 
+#if (NGX_HTTP_V2 && defined TLSEXT_TYPE_application_layer_protocol_negotiation)
+            if (addr_conf->http2) {
+                ngx_str_set(&c->ssl->alpn, NGX_HTTP_V2_ALPN_ADVERTISE);
+            }
+#endif
+
             rev->handler = ngx_http_ssl_handshake;
         }
 
@@ -523,6 +538,13 @@ ngx_http_init_request(ngx_event_t *rev)
     (void) ngx_atomic_fetch_add(ngx_stat_requests, 1);
 #endif
 
+#if (NGX_HTTP_V2)
+    if (addr_conf->http2 && rev->handler == ngx_http_process_request_line) {
+        ngx_http_v2_init(rev);
+        return;
+    }
+#endif
+
     rev->handler(rev);
 }
 
@@ -619,6 +641,20 @@ ngx_http_ssl_handshake_handler(ngx_connection_t *c)
 
         c->ssl->no_wait_shutdown = 1;
 
+#if (NGX_HTTP_V2 && defined TLSEXT_TYPE_application_layer_protocol_negotiation)
+        {
+        unsigned int          len;
+        const unsigned char  *data;
+
+        SSL_get0_alpn_selected(c->ssl->connection, &data, &len);
+
+        if (len == 2 && data[0] == 'h' && data[1] == '2') {
+            ngx_http_v2_init(c->read);
+            return;
+        }
+        }
+#endif
+
         c->read->handler = ngx_http_process_request_line;
         /* STUB: epoll edge */ c->write->handler = ngx_http_empty_handler;
 
@@ -717,7 +753,6 @@ ngx_http_process_request_line(ngx_event_t *rev)
     ngx_int_t                  rc, rv;
     ngx_connection_t          *c;
     ngx_http_request_t        *r;
-    ngx_http_core_srv_conf_t  *cscf;
 
     c = rev->data;
     r = c->data;
@@ -753,102 +788,17 @@ ngx_http_process_request_line(ngx_event_t *rev)
             r->request_line.len = r->request_end - r->request_start;
             r->request_line.data = r->request_start;
 
-
-            if (r->args_start) {
-                r->uri.len = r->args_start - 1 - r->uri_start;
-            } else {
-                r->uri.len = r->uri_end - r->uri_start;
-            }
-
-
-            if (r->complex_uri || r->quoted_uri) {
-
-                r->uri.data = ngx_pnalloc(r->pool, r->uri.len + 1);
-                if (r->uri.data == NULL) {
-                    ngx_http_close_request(r, NGX_HTTP_INTERNAL_SERVER_ERROR);
-                    return;
-                }
-
-                cscf = ngx_http_get_module_srv_conf(r, ngx_http_core_module);
-
-                rc = ngx_http_parse_complex_uri(r, cscf->merge_slashes);
-
-                if (rc == NGX_HTTP_PARSE_INVALID_REQUEST) {
-                    ngx_log_error(NGX_LOG_INFO, c->log, 0,
-                                  "client sent invalid request");
-                    ngx_http_finalize_request(r, NGX_HTTP_BAD_REQUEST);
-                    return;
-                }
-
-            } else {
-                r->uri.data = r->uri_start;
-            }
-
-
-            r->unparsed_uri.len = r->uri_end - r->uri_start;
-            r->unparsed_uri.data = r->uri_start;
-
-            r->valid_unparsed_uri = r->space_in_uri ? 0 : 1;
-
             r->method_name.len = r->method_end - r->request_start + 1;
             r->method_name.data = r->request_line.data;
 
-
             if (r->http_protocol.data) {
                 r->http_protocol.len = r->request_end - r->http_protocol.data;
             }
 
-
-            if (r->uri_ext) {
-                if (r->args_start) {
-                    r->exten.len = r->args_start - 1 - r->uri_ext;
-                } else {
-                    r->exten.len = r->uri_end - r->uri_ext;
-                }
-
-                r->exten.data = r->uri_ext;
-            }
-
-
-            if (r->args_start && r->uri_end > r->args_start) {
-                r->args.len = r->uri_end - r->args_start;
-                r->args.data = r->args_start;
-            }
-
-#if (NGX_WIN32)
-            {
-            u_char  *p;
-
-            p = r->uri.data + r->uri.len - 1;
-
-            while (p > r->uri.data) {
-
-                if (*p == ' ') {
-                    p--;
-                    continue;
-                }
-
-                if (*p == '.') {
-                    p--;
-                    continue;
-                }
-
-                if (ngx_strncasecmp(p - 6, (u_char *) "::$data", 7) == 0) {
-                    p -= 7;
-                    continue;
-                }
-
-                break;
-            }
-
-            if (p != r->uri.data + r->uri.len - 1) {
-                r->uri.len = p + 1 - r->uri.data;
-                ngx_http_set_exten(r);
+            if (ngx_http_process_request_uri(r) != NGX_OK) {
+                return;
             }
 
-            }
-#endif
-
             ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
                            "http request line: \"%V\"", &r->request_line);
 
@@ -957,6 +907,98 @@ ngx_http_process_request_line(ngx_event_t *rev)
     }
 }
 
+
+ngx_int_t
+ngx_http_process_request_uri(ngx_http_request_t *r)
+{
+    ngx_http_core_srv_conf_t  *cscf;
+
+    if (r->args_start) {
+        r->uri.len = r->args_start - 1 - r->uri_start;
+    } else {
+        r->uri.len = r->uri_end - r->uri_start;
+    }
+
+    if (r->complex_uri || r->quoted_uri) {
+
+        r->uri.data = ngx_pnalloc(r->pool, r->uri.len + 1);
+        if (r->uri.data == NULL) {
+            ngx_http_close_request(r, NGX_HTTP_INTERNAL_SERVER_ERROR);
+            return NGX_ERROR;
+        }
+
+        cscf = ngx_http_get_module_srv_conf(r, ngx_http_core_module);
+
+        if (ngx_http_parse_complex_uri(r, cscf->merge_slashes)
+            == NGX_HTTP_PARSE_INVALID_REQUEST)
+        {
+            ngx_log_error(NGX_LOG_INFO, r->connection->log, 0,
+                          "client sent invalid request");
+            ngx_http_finalize_request(r, NGX_HTTP_BAD_REQUEST);
+            return NGX_ERROR;
+        }
+
+    } else {
+        r->uri.data = r->uri_start;
+    }
+
+    r->unparsed_uri.len = r->uri_end - r->uri_start;
+    r->unparsed_uri.data = r->uri_start;
+
+    r->valid_unparsed_uri = r->space_in_uri ? 0 : 1;
+
+    if (r->uri_ext) {
+        if (r->args_start) {
+            r->exten.len = r->args_start - 1 - r->uri_ext;
+        } else {
+            r->exten.len = r->uri_end - r->uri_ext;
+        }
+
+        r->exten.data = r->uri_ext;
+    }
+
+    if (r->args_start && r->uri_end > r->args_start) {
+        r->args.len = r->uri_end - r->args_start;
+        r->args.data = r->args_start;
+    }
+
+#if (NGX_WIN32)
+    {
+    u_char  *p;
+
+    p = r->uri.data + r->uri.len - 1;
+
+    while (p > r->uri.data) {
+
+        if (*p == ' ') {
+            p--;
+            continue;
+        }
+
+        if (*p == '.') {
+            p--;
+            continue;
+        }
+
+        if (ngx_strncasecmp(p - 6, (u_char *) "::$data", 7) == 0) {
+            p -= 7;
+            continue;
+        }
+
+        break;
+    }
+
+    if (p != r->uri.data + r->uri.len - 1) {
+        r->uri.len = p + 1 - r->uri.data;
+        ngx_http_set_exten(r);
+    }
+
+    }
+#endif
+
+    return NGX_OK;
+}
+
 /*
  * 接收HTTP头部
  */
@@ -1209,6 +1251,7 @@ ngx_http_alloc_large_header_buffer(ngx_http_request_t *r,
 {
     u_char                    *old, *new;
     ngx_buf_t                 *b;
+    ngx_pool_cleanup_t        *cln;
     ngx_http_connection_t     *hc;
     ngx_http_core_srv_conf_t  *cscf;
 
@@ -1255,10 +1298,18 @@ ngx_http_alloc_large_header_buffer(ngx_http_request_t *r,
             if (hc->busy == NULL) {
                 return NGX_ERROR;
             }
+
+            cln = ngx_pool_cleanup_add(r->connection->pool, 0);
+            if (cln == NULL) {
+                return NGX_ERROR;
+            }
+
+            cln->handler = ngx_http_large_header_cleanup;
+            cln->data = hc;
         }
 
-        b = ngx_create_temp_buf(r->connection->pool,
-                                cscf->large_client_header_buffers.size);
+        b = ngx_http_get_large_header_buffer(
+                   cscf->large_client_header_buffers.size, r->connection->log);
         if (b == NULL) {
             return NGX_ERROR;
         }
@@ -1353,6 +1404,88 @@ ngx_http_alloc_large_header_buffer(ngx_http_request_t *r,
 }
 
 
+static ngx_buf_t *
+ngx_http_get_large_header_buffer(size_t size, ngx_log_t *log)
+{
+    ngx_buf_t  *b, **bp;
+
+    for (bp = &ngx_http_large_header_cache; *bp; bp = &(*bp)->shadow) {
+        b = *bp;
+
+        if ((size_t) (b->end - b->start) != size) {
+            continue;
+        }
+
+        *bp = b->shadow;
+        ngx_http_large_header_ncached--;
+
+#if (NGX_STAT_STUB)
+        (void) ngx_atomic_fetch_add(ngx_stat_large_header_hits, 1);
+#endif
+
+        b->pos = b->start;
+        b->last = b->start;
+        b->shadow = NULL;
+
+        return b;
+    }
+
+#if (NGX_STAT_STUB)
+    (void) ngx_atomic_fetch_add(ngx_stat_large_header_misses, 1);
+#endif
+
+    b = ngx_alloc(sizeof(ngx_buf_t) + size, log);
+    if (b == NULL) {
+        return NULL;
+    }
+
+    ngx_memzero(b, sizeof(ngx_buf_t));
+
+    b->start = (u_char *) b + sizeof(ngx_buf_t);
+    b->pos = b->start;
+    b->last = b->start;
+    b->end = b->start + size;
+    b->temporary = 1;
+
+    return b;
+}
+
+
+static void
+ngx_http_free_large_header_buffer(ngx_buf_t *b)
+{
+    if (ngx_http_large_header_ncached == NGX_HTTP_LARGE_HEADER_CACHE) {
+        ngx_free(b);
+        return;
+    }
+
+    b->shadow = ngx_http_large_header_cache;
+    ngx_http_large_header_cache = b;
+    ngx_http_large_header_ncached++;
+}
+
+
+static void
+ngx_http_large_header_cleanup(void *data)
+{
+    ngx_http_connection_t  *hc = data;
+
+    ngx_int_t  i;
+
+    for (i = 0; i < hc->nfree; i++) {
+        ngx_http_free_large_header_buffer(hc->free[i]);
+    }
+
+    hc->nfree = 0;
+
+    for (i = 0; i < hc->nbusy; i++) {
+        ngx_http_free_large_header_buffer(hc->busy[i]);
+    }
+
+    hc->nbusy = 0;
+}
+
+
 static ngx_int_t
 ngx_http_process_header_line(ngx_http_request_t *r, ngx_table_elt_t *h,
     ngx_uint_t offset)
@@ -1534,7 +1667,7 @@ ngx_http_process_cookie(ngx_http_request_t *r, ngx_table_elt_t *h,
 }
 
 /* 处理请求头部 */
-static ngx_int_t
+ngx_int_t
 ngx_http_process_request_header(ngx_http_request_t *r)
 {
     /* ngx_http_find_virtual_server找到对应的虚拟主机的配置块 */
@@ -1605,7 +1738,7 @@ ngx_http_process_request_header(ngx_http_request_t *r)
 /*
  * 处理请求
  */
-static void
+void
 ngx_http_process_request(ngx_http_request_t *r)
 {
     ngx_connection_t  *c;
@@ -2157,6 +2290,13 @@ ngx_http_finalize_connection(ngx_http_request_t *r)
 {
     ngx_http_core_loc_conf_t  *clcf;
 
+#if (NGX_HTTP_V2)
+    if (r->stream) {
+        ngx_http_close_request(r, 0);
+        return;
+    }
+#endif
+
     clcf = ngx_http_get_module_loc_conf(r, ngx_http_core_module);
 	/* 查看原始请求的引用计数,如果不等于1 ,表示还有多个动作在操作着 */
     if (r->main->count != 1) {
@@ -2359,6 +2499,19 @@ ngx_http_test_reading(ngx_http_request_t *r)
 
     ngx_log_debug0(NGX_LOG_DEBUG_HTTP, c->log, 0, "http test reading");
 
+#if (NGX_HTTP_V2)
+
+    if (r->stream) {
+        if (c->error) {
+            err = 0;
+            goto closed;
+        }
+
+        return;
+    }
+
+#endif
+
 #if (NGX_HAVE_KQUEUE)
 
     if (ngx_event_flags & NGX_USE_KQUEUE_EVENT) {
@@ -2376,7 +2529,16 @@ ngx_http_test_reading(ngx_http_request_t *r)
 
 #endif
 
+#if (NGX_HAVE_IO_URING)
+    n = (ngx_event_flags & NGX_USE_IOURING_EVENT) ? ngx_iouring_pending(c)
+                                                   : NGX_DECLINED;
+
+    if (n == NGX_DECLINED) {
+        n = recv(c->fd, buf, 1, MSG_PEEK);
+    }
+#else
     n = recv(c->fd, buf, 1, MSG_PEEK);
+#endif
 
     if (n == 0) {
         rev->eof = 1;
@@ -2528,7 +2690,7 @@ ngx_http_set_keepalive(ngx_http_request_t *r)
      * keepalive connection we try to free the ngx_http_request_t and
      * c->buffer's memory if they were allocated outside the c->pool.
      * The large header buffers are always allocated outside the c->pool and
-     * are freed too.
+     * are returned to the worker's cache.
      */
 
     if (ngx_pfree(c->pool, r) == NGX_OK) {
@@ -2556,7 +2718,7 @@ ngx_http_set_keepalive(ngx_http_request_t *r)
 
     if (hc->free) {
         for (i = 0; i < hc->nfree; i++) {
-            ngx_pfree(c->pool, hc->free[i]->start);
+            ngx_http_free_large_header_buffer(hc->free[i]);
             hc->free[i] = NULL;
         }
 
@@ -2568,7 +2730,7 @@ ngx_http_set_keepalive(ngx_http_request_t *r)
 
     if (hc->busy) {
         for (i = 0; i < hc->nbusy; i++) {
-            ngx_pfree(c->pool, hc->busy[i]->start);
+            ngx_http_free_large_header_buffer(hc->busy[i]);
             hc->busy[i] = NULL;
         }
 
@@ -2944,7 +3106,7 @@ ngx_http_post_action(ngx_http_request_t *r)
 }
 
 
-static void
+void
 ngx_http_close_request(ngx_http_request_t *r, ngx_int_t rc)
 {
     ngx_connection_t  *c;
@@ -2965,12 +3127,19 @@ ngx_http_close_request(ngx_http_request_t *r, ngx_int_t rc)
         return;
     }
 
+#if (NGX_HTTP_V2)
+    if (r->stream) {
+        ngx_http_v2_close_stream(r->stream, rc);
+        return;
+    }
+#endif
+
     ngx_http_free_request(r, rc);
     ngx_http_close_connection(c);
 }
 
 /* 释放请求对应的ngx_http_request_t结构体 */
-static void
+void
 ngx_http_free_request(ngx_http_request_t *r, ngx_int_t rc)
 {
     ngx_log_t                 *log;
@@ -3016,7 +3185,7 @@ ngx_http_free_request(ngx_http_request_t *r, ngx_int_t rc)
 
     log->action = "closing request";
 
-    if (r->connection->timedout) {
+    if (r->connection->timedout && r->connection->fd != (ngx_socket_t) -1) {
         clcf = ngx_http_get_module_loc_conf(r, ngx_http_core_module);
 
         if (clcf->reset_timedout_connection) {
@@ -3062,7 +3231,7 @@ ngx_http_log_request(ngx_http_request_t *r)
 }
 
 
-static void
+void
 ngx_http_close_connection(ngx_connection_t *c)
 {
     ngx_pool_t  *pool;
@@ -3127,7 +3296,7 @@ ngx_http_log_error(ngx_log_t *log, u_char *buf, size_t len)
 }
 
 
-static u_char *
+u_char *
 ngx_http_log_error_handler(ngx_http_request_t *r, ngx_http_request_t *sr,
     u_char *buf, size_t len)
 {
@@ -23,6 +23,7 @@
 #define NGX_HTTP_VERSION_9                 9
 #define NGX_HTTP_VERSION_10                1000
 #define NGX_HTTP_VERSION_11                1001
+#define NGX_HTTP_VERSION_20                2000
 
 #define NGX_HTTP_UNKNOWN                   0x0001
 #define NGX_HTTP_GET                       0x0002
@@ -377,6 +378,11 @@ struct ngx_http_request_s {
     ngx_http_upstream_t              *upstream;
     ngx_array_t                      *upstream_states;
                                          /* of ngx_http_upstream_state_t */
+
+#if (NGX_HTTP_V2)
+    ngx_http_v2_stream_t             *stream;
+#endif
+
     /* 表示这个请求的内存池,在ngx_http_free_request方法中销毁,它与ngx_connection_t中的内存池意义不一样
     * 当请求释放时,TCP连接可能并没有关闭,这是请求的内存池会销毁,但是ngx_connection_t的内存池不会销毁 */
     ngx_pool_t                       *pool;
@@ -90,9 +90,18 @@ typedef struct {
     ngx_uint_t                       weight;
     ngx_uint_t                       max_fails;
     time_t                           fail_timeout;
+    ngx_msec_t                       slow_start;
 
     unsigned                         down:1;
     unsigned                         backup:1;
+
+#if (NGX_HTTP_UPSTREAM_ZONE)
+    unsigned                         resolve:1;
+
+    /* the name and port to re-resolve at run time */
+    ngx_str_t                        host;
+    in_port_t                        port;
+#endif
 } ngx_http_upstream_server_t;
 
 
@@ -102,6 +111,7 @@ typedef struct {
 #define NGX_HTTP_UPSTREAM_FAIL_TIMEOUT  0x0008
 #define NGX_HTTP_UPSTREAM_DOWN          0x0010
 #define NGX_HTTP_UPSTREAM_BACKUP        0x0020
+#define NGX_HTTP_UPSTREAM_SLOW_START    0x0040
 
 
 struct ngx_http_upstream_srv_conf_s {
@@ -116,6 +126,13 @@ struct ngx_http_upstream_srv_conf_s {
     ngx_uint_t                       line;
     in_port_t                        port;
     in_port_t                        default_port;
+
+#if (NGX_HTTP_UPSTREAM_ZONE)
+    ngx_shm_zone_t                  *shm_zone;
+
+    /* free peers to add servers to at run time */
+    ngx_uint_t                       spare;
+#endif
 };
 
 
@@ -179,6 +196,9 @@ typedef struct {
     ngx_array_t                     *cache_valid;
     ngx_array_t                     *cache_bypass;
     ngx_array_t                     *no_cache;
+
+    ngx_flag_t                       cache_lock;
+    ngx_msec_t                       cache_lock_timeout;
 #endif
 
     ngx_array_t                     *store_lengths;
@@ -231,6 +251,7 @@ typedef struct {
     ngx_table_elt_t                 *location;
     ngx_table_elt_t                 *accept_ranges;
     ngx_table_elt_t                 *www_authenticate;
+    ngx_table_elt_t                 *transfer_encoding;
 
 #if (NGX_HTTP_GZIP)
     ngx_table_elt_t                 *content_encoding;
@@ -239,6 +260,9 @@ typedef struct {
     off_t                            content_length_n;
 
     ngx_array_t                      cache_control;
+
+    unsigned                         connection_close:1;
+    unsigned                         chunked:1;
 } ngx_http_upstream_headers_in_t;
 
 
@@ -290,8 +314,8 @@ struct ngx_http_upstream_s {
      * 3.当buffering标志为0时,buffer缓冲区会被用于反复地接收上游的包体,进而向下游转发
      * 4.当upstream并不用于转发上游包体时,buffer会被用于反复接收上游的包体 */
     ngx_buf_t                        buffer;
-	/* 表示来自上游服务器的响应包体的长度 */
-    size_t                           length;
+	/* 表示来自上游服务器的响应包体的剩余长度,-1表示长度未知 */
+    off_t                            length;
 	/* out_bufs在两种场景下有不同的意义,1.当不需要转发包体,且使用默认的input_filter方法处理包体时
 	 * out_bufs会指向响应包体,事实上,out_bufs链表中会产生多个ngx_buf_t缓冲区,每个缓冲区都指向buffer
 	 * 缓存中的一部分,而这里的一部分就是每次调用recv方法接收到的一段TCP流.
@@ -346,6 +370,8 @@ struct ngx_http_upstream_s {
 #if (NGX_HTTP_CACHE)
     unsigned                         cache_status:3;
 #endif
+    /* 上游连接在本次请求结束后可以被保持,以便复用 */
+    unsigned                         keepalive:1;
     /* 在向客户端转发上游服务器的包体时才有用,当buffering为1时,表示使用多个缓冲区以及磁盘文件
      * 来转发上游的响应包体,当Nginx与上游间的网速远大于Nginx与下游客户端之间的网速时,让Nginx开辟
      * 更多的内存甚至使用磁盘文件来缓存上游的响应包体,这是有意义的,它可以减轻上游服务器的并发压力.
@@ -12,8 +12,10 @@
 
 static ngx_int_t ngx_http_upstream_cmp_servers(const void *one,
     const void *two);
-static ngx_uint_t
-ngx_http_upstream_get_peer(ngx_http_upstream_rr_peers_t *peers);
+static ngx_http_upstream_rr_peer_t *ngx_http_upstream_get_peer(
+    ngx_http_upstream_rr_peer_data_t *rrp, time_t now);
+static ngx_uint_t ngx_http_upstream_rr_npeers(
+    ngx_http_upstream_server_t *server);
 
 #if (NGX_HTTP_SSL)
 
@@ -25,12 +27,17 @@ static void ngx_http_upstream_empty_save_session(ngx_peer_connection_t *pc,
 #endif
 
 
+/* the weights are scaled to ramp a peer up by 1% steps on slow start */
+
+#define NGX_HTTP_UPSTREAM_RR_SCALE  100
+
+
 ngx_int_t
 ngx_http_upstream_init_round_robin(ngx_conf_t *cf,
     ngx_http_upstream_srv_conf_t *us)
 {
     ngx_url_t                      u;
-    ngx_uint_t                     i, j, n;
+    ngx_uint_t                     i, j, k, n;
     ngx_http_upstream_server_t    *server;
     ngx_http_upstream_rr_peers_t  *peers, *backup;
 
@@ -39,6 +46,20 @@ ngx_http_upstream_init_round_robin(ngx_conf_t *cf,
     if (us->servers) {
         server = us->servers->elts;
 
+#if (NGX_HTTP_UPSTREAM_ZONE)
+
+        for (i = 0; i < us->servers->nelts; i++) {
+            if (server[i].resolve && us->shm_zone == NULL) {
+                ngx_log_error(NGX_LOG_EMERG, cf->log, 0,
+                              "resolving names at run time requires "
+                              "\"zone\" in upstream \"%V\" in %s:%ui",
+                              &us->host, us->file_name, us->line);
+                return NGX_ERROR;
+            }
+        }
+
+#endif
+
         n = 0;
 
         for (i = 0; i < us->servers->nelts; i++) {
@@ -46,9 +67,13 @@ ngx_http_upstream_init_round_robin(ngx_conf_t *cf,
                 continue;
             }
 
-            n += server[i].naddrs;
+            n += ngx_http_upstream_rr_npeers(&server[i]);
         }
 
+#if (NGX_HTTP_UPSTREAM_ZONE)
+        n += us->spare;
+#endif
+
         peers = ngx_pcalloc(cf->pool, sizeof(ngx_http_upstream_rr_peers_t)
                               + sizeof(ngx_http_upstream_rr_peer_t) * (n - 1));
         if (peers == NULL) {
@@ -62,23 +87,45 @@ ngx_http_upstream_init_round_robin(ngx_conf_t *cf,
         n = 0;
 
         for (i = 0; i < us->servers->nelts; i++) {
-            for (j = 0; j < server[i].naddrs; j++) {
+            for (j = 0; j < ngx_http_upstream_rr_npeers(&server[i]); j++) {
                 if (server[i].backup) {
                     continue;
                 }
 
-                peers->peer[n].sockaddr = server[i].addrs[j].sockaddr;
-                peers->peer[n].socklen = server[i].addrs[j].socklen;
-                peers->peer[n].name = server[i].addrs[j].name;
+                k = (j < server[i].naddrs) ? j : 0;
+
+                peers->peer[n].sockaddr = server[i].addrs[k].sockaddr;
+                peers->peer[n].socklen = server[i].addrs[k].socklen;
+                peers->peer[n].name = server[i].addrs[k].name;
                 peers->peer[n].max_fails = server[i].max_fails;
                 peers->peer[n].fail_timeout = server[i].fail_timeout;
+                peers->peer[n].slow_start = server[i].slow_start;
                 peers->peer[n].down = server[i].down;
                 peers->peer[n].weight = server[i].down ? 0 : server[i].weight;
                 peers->peer[n].current_weight = peers->peer[n].weight;
+
+#if (NGX_HTTP_UPSTREAM_ZONE)
+                peers->peer[n].server = &server[i];
+
+                if (j != k) {
+                    peers->peer[n].down |= NGX_HTTP_UPSTREAM_PEER_RESOLVE_DOWN;
+                    peers->peer[n].weight = 0;
+                    peers->peer[n].current_weight = 0;
+                }
+#endif
+
                 n++;
             }
         }
 
+#if (NGX_HTTP_UPSTREAM_ZONE)
+
+        for (i = 0; i < us->spare; i++) {
+            peers->peer[n++].down = NGX_HTTP_UPSTREAM_PEER_FREE;
+        }
+
+#endif
+
         us->peer.data = peers;
 
         ngx_sort(&peers->peer[0], (size_t) n,
@@ -94,7 +141,7 @@ ngx_http_upstream_init_round_robin(ngx_conf_t *cf,
                 continue;
             }
 
-            n += server[i].naddrs;
+            n += ngx_http_upstream_rr_npeers(&server[i]);
         }
 
         if (n == 0) {
@@ -115,19 +162,34 @@ ngx_http_upstream_init_round_robin(ngx_conf_t *cf,
         n = 0;
 
         for (i = 0; i < us->servers->nelts; i++) {
-            for (j = 0; j < server[i].naddrs; j++) {
+            for (j = 0; j < ngx_http_upstream_rr_npeers(&server[i]); j++) {
                 if (!server[i].backup) {
                     continue;
                 }
 
-                backup->peer[n].sockaddr = server[i].addrs[j].sockaddr;
-                backup->peer[n].socklen = server[i].addrs[j].socklen;
-                backup->peer[n].name = server[i].addrs[j].name;
+                k = (j < server[i].naddrs) ? j : 0;
+
+                backup->peer[n].sockaddr = server[i].addrs[k].sockaddr;
+                backup->peer[n].socklen = server[i].addrs[k].socklen;
+                backup->peer[n].name = server[i].addrs[k].name;
                 backup->peer[n].weight = server[i].weight;
                 backup->peer[n].current_weight = server[i].weight;
                 backup->peer[n].max_fails = server[i].max_fails;
                 backup->peer[n].fail_timeout = server[i].fail_timeout;
+                backup->peer[n].slow_start = server[i].slow_start;
                 backup->peer[n].down = server[i].down;
+
+#if (NGX_HTTP_UPSTREAM_ZONE)
+                backup->peer[n].server = &server[i];
+
+                if (j != k) {
+                    backup->peer[n].down |=
+                                          NGX_HTTP_UPSTREAM_PEER_RESOLVE_DOWN;
+                    backup->peer[n].weight = 0;
+                    backup->peer[n].current_weight = 0;
+                }
+#endif
+
                 n++;
             }
         }
@@ -196,6 +258,26 @@ ngx_http_upstream_init_round_robin(ngx_conf_t *cf,
 }
 
 
+static ngx_uint_t
+ngx_http_upstream_rr_npeers(ngx_http_upstream_server_t *server)
+{
+#if (NGX_HTTP_UPSTREAM_ZONE)
+
+    /*
+     * a name resolved at run time gets spare peers to take the addresses
+     * that replace the current ones while those are still in use
+     */
+
+    if (server->resolve) {
+        return ngx_max(2 * server->naddrs, NGX_HTTP_UPSTREAM_RESOLVE_SLOTS);
+    }
+
+#endif
+
+    return server->naddrs;
+}
+
+
 static ngx_int_t
 ngx_http_upstream_cmp_servers(const void *one, const void *two)
 {
@@ -384,7 +466,9 @@ ngx_http_upstream_get_round_robin_peer(ngx_peer_connection_t *pc, void *data)
 
     now = ngx_time();
 
-    /* ngx_lock_mutex(rrp->peers->mutex); */
+    peers = rrp->peers;
+
+    ngx_http_upstream_rr_peers_lock(peers);
 
     if (rrp->peers->last_cached) {
 
@@ -393,7 +477,7 @@ ngx_http_upstream_get_round_robin_peer(ngx_peer_connection_t *pc, void *data)
         c = rrp->peers->cached[rrp->peers->last_cached];
         rrp->peers->last_cached--;
 
-        /* ngx_unlock_mutex(ppr->peers->mutex); */
+        ngx_http_upstream_rr_peers_unlock(peers);
 
 #if (NGX_THREADS)
         c->read->lock = c->read->own_lock;
@@ -411,6 +495,7 @@ ngx_http_upstream_get_round_robin_peer(ngx_peer_connection_t *pc, void *data)
 
     if (rrp->peers->single) {
         peer = &rrp->peers->peer[0];
+        rrp->current = 0;
 
     } else {
 
@@ -420,57 +505,18 @@ ngx_http_upstream_get_round_robin_peer(ngx_peer_connection_t *pc, void *data)
 
             /* it's a first try - get a current peer */
 
-            i = pc->tries;
-
-            for ( ;; ) {
-                rrp->current = ngx_http_upstream_get_peer(rrp->peers);
-
-                ngx_log_debug2(NGX_LOG_DEBUG_HTTP, pc->log, 0,
-                               "get rr peer, current: %ui %i",
-                               rrp->current,
-                               rrp->peers->peer[rrp->current].current_weight);
-
-                n = rrp->current / (8 * sizeof(uintptr_t));
-                m = (uintptr_t) 1 << rrp->current % (8 * sizeof(uintptr_t));
-
-                if (!(rrp->tried[n] & m)) {
-                    peer = &rrp->peers->peer[rrp->current];
-
-                    if (!peer->down) {
-
-                        if (peer->max_fails == 0
-                            || peer->fails < peer->max_fails)
-                        {
-                            break;
-                        }
-
-                        if (now - peer->accessed > peer->fail_timeout) {
-                            peer->fails = 0;
-                            break;
-                        }
-
-                        peer->current_weight = 0;
-
-                    } else {
-                        rrp->tried[n] |= m;
-                    }
-
-                    pc->tries--;
-                }
-
-                if (pc->tries == 0) {
-                    goto failed;
-                }
+            peer = ngx_http_upstream_get_peer(rrp, now);
 
-                if (--i == 0) {
-                    ngx_log_error(NGX_LOG_ALERT, pc->log, 0,
-                                  "round robin upstream stuck on %ui tries",
-                                  pc->tries);
-                    goto failed;
-                }
+            if (peer == NULL) {
+                goto failed;
             }
 
-            peer->current_weight--;
+            ngx_log_debug2(NGX_LOG_DEBUG_HTTP, pc->log, 0,
+                           "get rr peer, current: %ui %i",
+                           rrp->current, peer->current_weight);
+
+            n = rrp->current / (8 * sizeof(uintptr_t));
+            m = (uintptr_t) 1 << rrp->current % (8 * sizeof(uintptr_t));
 
         } else {
 
@@ -494,11 +540,10 @@ ngx_http_upstream_get_round_robin_peer(ngx_peer_connection_t *pc, void *data)
 
                         if (now - peer->accessed > peer->fail_timeout) {
                             peer->fails = 0;
+                            peer->start = ngx_current_msec;
                             break;
                         }
 
-                        peer->current_weight = 0;
-
                     } else {
                         rrp->tried[n] |= m;
                     }
@@ -523,18 +568,18 @@ ngx_http_upstream_get_round_robin_peer(ngx_peer_connection_t *pc, void *data)
                     goto failed;
                 }
             }
-
-            peer->current_weight--;
         }
 
         rrp->tried[n] |= m;
     }
 
+    peer->conns++;
+
     pc->sockaddr = peer->sockaddr;
     pc->socklen = peer->socklen;
     pc->name = &peer->name;
 
-    /* ngx_unlock_mutex(rrp->peers->mutex); */
+    ngx_http_upstream_rr_peers_unlock(peers);
 
     if (pc->tries == 1 && rrp->peers->next) {
         pc->tries += rrp->peers->next->number;
@@ -549,11 +594,9 @@ ngx_http_upstream_get_round_robin_peer(ngx_peer_connection_t *pc, void *data)
 
 failed:
 
-    peers = rrp->peers;
-
     if (peers->next) {
 
-        /* ngx_unlock_mutex(peers->mutex); */
+        ngx_http_upstream_rr_peers_unlock(peers);
 
         ngx_log_debug0(NGX_LOG_DEBUG_HTTP, pc->log, 0, "backup servers");
 
@@ -571,7 +614,7 @@ failed:
             return rc;
         }
 
-        /* ngx_lock_mutex(peers->mutex); */
+        ngx_http_upstream_rr_peers_lock(peers);
     }
 
     /* all peers failed, mark them as live for quick recovery */
@@ -580,7 +623,7 @@ failed:
         peers->peer[i].fails = 0;
     }
 
-    /* ngx_unlock_mutex(peers->mutex); */
+    ngx_http_upstream_rr_peers_unlock(peers);
 
     pc->name = peers->name;
 
@@ -588,56 +631,103 @@ failed:
 }
 
 
-static ngx_uint_t
-ngx_http_upstream_get_peer(ngx_http_upstream_rr_peers_t *peers)
+static ngx_http_upstream_rr_peer_t *
+ngx_http_upstream_get_peer(ngx_http_upstream_rr_peer_data_t *rrp, time_t now)
 {
-    ngx_uint_t                    i, n, reset = 0;
-    ngx_http_upstream_rr_peer_t  *peer;
+    uintptr_t                      m;
+    ngx_int_t                      w, total;
+    ngx_uint_t                     i, n, p;
+    ngx_http_upstream_rr_peer_t   *peer, *best;
+    ngx_http_upstream_rr_peers_t  *peers;
 
-    peer = &peers->peer[0];
+    peers = rrp->peers;
 
-    for ( ;; ) {
+    best = NULL;
+    total = 0;
 
-        for (i = 0; i < peers->number; i++) {
+#if (NGX_SUPPRESS_WARN)
+    p = 0;
+#endif
 
-            if (peer[i].current_weight <= 0) {
-                continue;
-            }
+    /* a smooth weighted round-robin over the peers not tried yet */
 
-            n = i;
+    for (i = 0; i < peers->number; i++) {
 
-            while (i < peers->number - 1) {
+        n = i / (8 * sizeof(uintptr_t));
+        m = (uintptr_t) 1 << i % (8 * sizeof(uintptr_t));
 
-                i++;
+        if (rrp->tried[n] & m) {
+            continue;
+        }
 
-                if (peer[i].current_weight <= 0) {
-                    continue;
-                }
+        peer = &peers->peer[i];
 
-                if (peer[n].current_weight * 1000 / peer[i].current_weight
-                    > peer[n].weight * 1000 / peer[i].weight)
-                {
-                    return n;
-                }
+        if (peer->down) {
+            continue;
+        }
 
-                n = i;
-            }
+        if (peer->max_fails && peer->fails >= peer->max_fails) {
 
-            if (peer[i].current_weight > 0) {
-                n = i;
+            if (now - peer->accessed <= peer->fail_timeout) {
+                continue;
             }
 
-            return n;
-        }
+            /* the failed peer comes back, ramp it up on slow start */
 
-        if (reset++) {
-            return 0;
+            peer->fails = 0;
+            peer->start = ngx_current_msec;
         }
 
-        for (i = 0; i < peers->number; i++) {
-            peer[i].current_weight = peer[i].weight;
+        w = ngx_http_upstream_rr_peer_weight(peer);
+
+        peer->current_weight += w;
+        total += w;
+
+        if (best == NULL || peer->current_weight > best->current_weight) {
+            best = peer;
+            p = i;
         }
     }
+
+    if (best == NULL) {
+        return NULL;
+    }
+
+    rrp->current = p;
+
+    best->current_weight -= total;
+
+    return best;
+}
+
+
+ngx_int_t
+ngx_http_upstream_rr_peer_weight(ngx_http_upstream_rr_peer_t *peer)
+{
+    ngx_int_t       w;
+    ngx_msec_int_t  elapsed;
+
+    w = peer->weight * NGX_HTTP_UPSTREAM_RR_SCALE;
+
+    if (peer->start == 0) {
+        return w;
+    }
+
+    /*
+     * ngx_current_msec is wall clock time, so the ramp of a peer
+     * in a shared zone is the same in all worker processes
+     */
+
+    elapsed = (ngx_msec_int_t) (ngx_current_msec - peer->start);
+
+    if (elapsed < 0 || elapsed >= (ngx_msec_int_t) peer->slow_start) {
+        peer->start = 0;
+        return w;
+    }
+
+    w = (ngx_int_t) ((int64_t) w * elapsed / peer->slow_start);
+
+    return w ? w : 1;
 }
 
 
@@ -653,7 +743,14 @@ ngx_http_upstream_free_round_robin_peer(ngx_peer_connection_t *pc, void *data,
     ngx_log_debug2(NGX_LOG_DEBUG_HTTP, pc->log, 0,
                    "free rr peer %ui %ui", pc->tries, state);
 
+    peer = &rrp->peers->peer[rrp->current];
+
+    ngx_http_upstream_rr_peers_lock(rrp->peers);
+
+    peer->conns--;
+
     if (state == 0 && pc->tries == 0) {
+        ngx_http_upstream_rr_peers_unlock(rrp->peers);
         return;
     }
 
@@ -661,32 +758,24 @@ ngx_http_upstream_free_round_robin_peer(ngx_peer_connection_t *pc, void *data,
 
     if (rrp->peers->single) {
         pc->tries = 0;
+        ngx_http_upstream_rr_peers_unlock(rrp->peers);
         return;
     }
 
     if (state & NGX_PEER_FAILED) {
         now = ngx_time();
 
-        peer = &rrp->peers->peer[rrp->current];
-
-        /* ngx_lock_mutex(rrp->peers->mutex); */
-
         peer->fails++;
         peer->accessed = now;
 
         if (peer->max_fails) {
-            peer->current_weight -= peer->weight / peer->max_fails;
+            peer->current_weight -= peer->weight * NGX_HTTP_UPSTREAM_RR_SCALE
+                                    / peer->max_fails;
         }
 
         ngx_log_debug2(NGX_LOG_DEBUG_HTTP, pc->log, 0,
                        "free rr peer failed: %ui %i",
                        rrp->current, peer->current_weight);
-
-        if (peer->current_weight < 0) {
-            peer->current_weight = 0;
-        }
-
-        /* ngx_unlock_mutex(rrp->peers->mutex); */
     }
 
     rrp->current++;
@@ -699,7 +788,7 @@ ngx_http_upstream_free_round_robin_peer(ngx_peer_connection_t *pc, void *data,
         pc->tries--;
     }
 
-    /* ngx_unlock_mutex(rrp->peers->mutex); */
+    ngx_http_upstream_rr_peers_unlock(rrp->peers);
 }
 
 
@@ -715,6 +804,13 @@ ngx_http_upstream_set_round_robin_peer_session(ngx_peer_connection_t *pc,
     ngx_ssl_session_t            *ssl_session;
     ngx_http_upstream_rr_peer_t  *peer;
 
+#if (NGX_HTTP_UPSTREAM_ZONE)
+    if (rrp->peers->shpool) {
+        /* sessions are local to a process and cannot be kept in a zone */
+        return NGX_OK;
+    }
+#endif
+
     peer = &rrp->peers->peer[rrp->current];
 
     /* TODO: threads only mutex */
@@ -743,6 +839,12 @@ ngx_http_upstream_save_round_robin_peer_session(ngx_peer_connection_t *pc,
     ngx_ssl_session_t            *old_ssl_session, *ssl_session;
     ngx_http_upstream_rr_peer_t  *peer;
 
+#if (NGX_HTTP_UPSTREAM_ZONE)
+    if (rrp->peers->shpool) {
+        return;
+    }
+#endif
+
     ssl_session = ngx_ssl_get_session(pc->connection);
 
     if (ssl_session == NULL) {
@@ -22,20 +22,48 @@ typedef struct {
     ngx_int_t                       current_weight;
     ngx_int_t                       weight;
 
+    ngx_uint_t                      conns;
+
     ngx_uint_t                      fails;
     time_t                          accessed;
 
     ngx_uint_t                      max_fails;
     time_t                          fail_timeout;
 
-    ngx_uint_t                      down;          /* unsigned  down:1; */
+    ngx_msec_t                      slow_start;
+    ngx_msec_t                      start;         /* of the slow start */
+
+    ngx_uint_t                      down;
 
 #if (NGX_HTTP_SSL)
     ngx_ssl_session_t              *ssl_session;   /* local to a process */
 #endif
+
+#if (NGX_HTTP_UPSTREAM_ZONE)
+    ngx_http_upstream_server_t     *server;
+#endif
 } ngx_http_upstream_rr_peer_t;
 
 
+/* the peer->down bits; any of them takes the peer out of balancing */
+
+#define NGX_HTTP_UPSTREAM_PEER_DOWN          0x01
+#define NGX_HTTP_UPSTREAM_PEER_CHECK_DOWN    0x02
+#define NGX_HTTP_UPSTREAM_PEER_RESOLVE_DOWN  0x04
+#define NGX_HTTP_UPSTREAM_PEER_FREE          0x08
+#define NGX_HTTP_UPSTREAM_PEER_DRAIN         0x10
+
+/* the spare peers of resolved servers and the free slots hold no server */
+
+#define NGX_HTTP_UPSTREAM_PEER_UNUSED                                         \
+    (NGX_HTTP_UPSTREAM_PEER_RESOLVE_DOWN|NGX_HTTP_UPSTREAM_PEER_FREE)
+
+
+/* the least number of peers kept for a server with "resolve" */
+
+#define NGX_HTTP_UPSTREAM_RESOLVE_SLOTS      8
+
+
 typedef struct ngx_http_upstream_rr_peers_s  ngx_http_upstream_rr_peers_t;
 
 struct ngx_http_upstream_rr_peers_s {
@@ -50,10 +78,40 @@ struct ngx_http_upstream_rr_peers_s {
 
     ngx_http_upstream_rr_peers_t   *next;
 
+#if (NGX_HTTP_UPSTREAM_ZONE)
+    ngx_slab_pool_t                *shpool;
+    ngx_atomic_t                    lock;
+    ngx_http_upstream_rr_peers_t   *zone_next;
+#endif
+
     ngx_http_upstream_rr_peer_t     peer[1];
 };
 
 
+#if (NGX_HTTP_UPSTREAM_ZONE)
+
+#define ngx_http_upstream_rr_peers_lock(peers)                                \
+    do {                                                                      \
+        if ((peers)->shpool) {                                                \
+            ngx_spinlock(&(peers)->lock, ngx_pid, 1024);                      \
+        }                                                                     \
+    } while (0)
+
+#define ngx_http_upstream_rr_peers_unlock(peers)                              \
+    do {                                                                      \
+        if ((peers)->shpool) {                                                \
+            ngx_unlock(&(peers)->lock);                                       \
+        }                                                                     \
+    } while (0)
+
+#else
+
+#define ngx_http_upstream_rr_peers_lock(peers)
+#define ngx_http_upstream_rr_peers_unlock(peers)
+
+#endif
+
+
 typedef struct {
     ngx_http_upstream_rr_peers_t   *peers;
     ngx_uint_t                      current;
@@ -68,6 +126,7 @@ ngx_int_t ngx_http_upstream_init_round_robin_peer(ngx_http_request_t *r,
     ngx_http_upstream_srv_conf_t *us);
 ngx_int_t ngx_http_upstream_create_round_robin_peer(ngx_http_request_t *r,
     ngx_http_upstream_resolved_t *ur);
+ngx_int_t ngx_http_upstream_rr_peer_weight(ngx_http_upstream_rr_peer_t *peer);
 ngx_int_t ngx_http_upstream_get_round_robin_peer(ngx_peer_connection_t *pc,
     void *data);
 void ngx_http_upstream_free_round_robin_peer(ngx_peer_connection_t *pc,
@@ -0,0 +1,3620 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+#define NGX_HTTP_V2_PREFACE              "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"
+#define NGX_HTTP_V2_PREFACE_LEN          (sizeof(NGX_HTTP_V2_PREFACE) - 1)
+
+/* settings parameters */
+#define NGX_HTTP_V2_HEADER_TABLE_SIZE    0x1
+#define NGX_HTTP_V2_ENABLE_PUSH          0x2
+#define NGX_HTTP_V2_MAX_STREAMS          0x3
+#define NGX_HTTP_V2_INIT_WINDOW_SIZE     0x4
+#define NGX_HTTP_V2_MAX_FRAME_SIZE_PARAM 0x5
+
+#define NGX_HTTP_V2_SETTINGS_PARAM_SIZE  6
+
+/* the largest payload of a frame that is not a DATA or HEADERS one */
+#define NGX_HTTP_V2_CONTROL_FRAME_SIZE   16
+
+/* DATA frames of a stream allowed in the output queue at once */
+#define NGX_HTTP_V2_MAX_QUEUED           4
+
+#define NGX_HTTP_V2_FRAME_BUFFER_SIZE                                         \
+    (NGX_HTTP_V2_FRAME_HEADER_SIZE + NGX_HTTP_V2_DEFAULT_FRAME_SIZE)
+
+
+typedef struct {
+    ngx_connection_t                 connection;
+    ngx_event_t                      read;
+    ngx_event_t                      write;
+    ngx_log_t                        log;
+    ngx_http_log_ctx_t               ctx;
+} ngx_http_v2_fake_connection_t;
+
+
+typedef struct {
+    ngx_http_request_t              *request;
+    ngx_pool_t                      *pool;
+
+    ngx_str_t                        method;
+    ngx_str_t                        scheme;
+    ngx_str_t                        path;
+    ngx_str_t                        authority;
+    ngx_array_t                      cookies;
+
+    size_t                           size;
+    ngx_uint_t                       status;
+
+    unsigned                         regular:1;
+} ngx_http_v2_header_block_t;
+
+
+static void ngx_http_v2_read_handler(ngx_event_t *rev);
+static void ngx_http_v2_write_handler(ngx_event_t *wev);
+static void ngx_http_v2_handle_connection(ngx_http_v2_connection_t *h2c);
+
+static u_char *ngx_http_v2_process_frames(ngx_http_v2_connection_t *h2c,
+    u_char *pos, u_char *end);
+static ngx_int_t ngx_http_v2_state_data(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t flags, ngx_uint_t sid, u_char *pos, size_t size);
+static ngx_int_t ngx_http_v2_state_headers(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t flags, ngx_uint_t sid, u_char *pos, size_t size);
+static ngx_int_t ngx_http_v2_state_continuation(
+    ngx_http_v2_connection_t *h2c, ngx_uint_t flags, ngx_uint_t sid,
+    u_char *pos, size_t size);
+static ngx_int_t ngx_http_v2_state_rst_stream(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t sid, u_char *pos, size_t size);
+static ngx_int_t ngx_http_v2_state_settings(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t flags, ngx_uint_t sid, u_char *pos, size_t size);
+static ngx_int_t ngx_http_v2_state_ping(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t flags, ngx_uint_t sid, u_char *pos, size_t size);
+static ngx_int_t ngx_http_v2_state_window_update(
+    ngx_http_v2_connection_t *h2c, ngx_uint_t sid, u_char *pos, size_t size);
+static ngx_int_t ngx_http_v2_connection_error(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t status);
+
+static ngx_int_t ngx_http_v2_process_header_block(
+    ngx_http_v2_connection_t *h2c);
+static ngx_uint_t ngx_http_v2_parse_header_block(
+    ngx_http_v2_connection_t *h2c, ngx_http_v2_header_block_t *hb,
+    u_char *pos, u_char *end);
+static ngx_int_t ngx_http_v2_parse_int(u_char **pos, u_char *end,
+    ngx_uint_t prefix, ngx_uint_t *value);
+static ngx_uint_t ngx_http_v2_parse_string(ngx_http_v2_connection_t *h2c,
+    u_char **pos, u_char *end, ngx_pool_t *pool, ngx_str_t *str);
+static ngx_int_t ngx_http_v2_process_field(ngx_http_v2_header_block_t *hb,
+    ngx_http_v2_header_t *header);
+static ngx_int_t ngx_http_v2_pseudo_header(ngx_http_v2_header_block_t *hb,
+    ngx_http_v2_header_t *header);
+static void ngx_http_v2_run_request(ngx_http_v2_header_block_t *hb);
+static ngx_int_t ngx_http_v2_construct_request_line(
+    ngx_http_v2_header_block_t *hb);
+static ngx_int_t ngx_http_v2_construct_headers(
+    ngx_http_v2_header_block_t *hb);
+
+static ngx_http_v2_stream_t *ngx_http_v2_create_stream(
+    ngx_http_v2_connection_t *h2c, ngx_uint_t sid);
+static ngx_http_v2_stream_t *ngx_http_v2_get_stream(
+    ngx_http_v2_connection_t *h2c, ngx_uint_t sid);
+static void ngx_http_v2_terminate_stream(ngx_http_v2_connection_t *h2c,
+    ngx_http_v2_stream_t *stream, ngx_uint_t status);
+static void ngx_http_v2_close_stream_handler(ngx_event_t *ev);
+static ssize_t ngx_http_v2_recv(ngx_connection_t *fc, u_char *buf,
+    size_t size);
+
+static ngx_int_t ngx_http_v2_process_request_body(ngx_http_request_t *r,
+    u_char *pos, size_t size, ngx_uint_t last);
+static void ngx_http_v2_read_client_request_body_handler(
+    ngx_http_request_t *r);
+static ngx_int_t ngx_http_v2_update_stream_window(
+    ngx_http_v2_connection_t *h2c, ngx_http_v2_stream_t *stream);
+
+static ngx_http_v2_out_frame_t *ngx_http_v2_get_frame(
+    ngx_http_v2_connection_t *h2c, size_t length, ngx_uint_t type,
+    ngx_uint_t flags, ngx_uint_t sid);
+static ngx_int_t ngx_http_v2_send_settings(ngx_http_v2_connection_t *h2c);
+static ngx_int_t ngx_http_v2_send_window_update(
+    ngx_http_v2_connection_t *h2c, ngx_uint_t sid, size_t window);
+static ngx_int_t ngx_http_v2_send_rst_stream(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t sid, ngx_uint_t status);
+static ngx_int_t ngx_http_v2_send_goaway(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t status);
+static void ngx_http_v2_frame_sent(ngx_http_v2_connection_t *h2c,
+    ngx_http_v2_out_frame_t *frame);
+static void ngx_http_v2_wake_streams(ngx_http_v2_connection_t *h2c);
+
+static void ngx_http_v2_finalize_connection(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t status);
+static void ngx_http_v2_pool_cleanup(void *data);
+
+static ngx_int_t ngx_http_v2_add_variables(ngx_conf_t *cf);
+static ngx_int_t ngx_http_v2_variable(ngx_http_request_t *r,
+    ngx_http_variable_value_t *v, uintptr_t data);
+static void *ngx_http_v2_create_main_conf(ngx_conf_t *cf);
+static char *ngx_http_v2_init_main_conf(ngx_conf_t *cf, void *conf);
+static void *ngx_http_v2_create_srv_conf(ngx_conf_t *cf);
+static char *ngx_http_v2_merge_srv_conf(ngx_conf_t *cf, void *parent,
+    void *child);
+static void *ngx_http_v2_create_loc_conf(ngx_conf_t *cf);
+static char *ngx_http_v2_merge_loc_conf(ngx_conf_t *cf, void *parent,
+    void *child);
+static char *ngx_http_v2_recv_buffer_size(ngx_conf_t *cf, void *post,
+    void *data);
+static char *ngx_http_v2_preread_size(ngx_conf_t *cf, void *post,
+    void *data);
+static char *ngx_http_v2_chunk_size(ngx_conf_t *cf, void *post, void *data);
+
+
+static ngx_conf_post_t  ngx_http_v2_recv_buffer_size_post =
+    { ngx_http_v2_recv_buffer_size };
+static ngx_conf_post_t  ngx_http_v2_preread_size_post =
+    { ngx_http_v2_preread_size };
+static ngx_conf_post_t  ngx_http_v2_chunk_size_post =
+    { ngx_http_v2_chunk_size };
+
+
+static ngx_command_t  ngx_http_v2_commands[] = {
+
+    { ngx_string("http2_recv_buffer_size"),
+      NGX_HTTP_MAIN_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_size_slot,
+      NGX_HTTP_MAIN_CONF_OFFSET,
+      offsetof(ngx_http_v2_main_conf_t, recv_buffer_size),
+      &ngx_http_v2_recv_buffer_size_post },
+
+    { ngx_string("http2_max_concurrent_streams"),
+      NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_num_slot,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      offsetof(ngx_http_v2_srv_conf_t, concurrent_streams),
+      NULL },
+
+    { ngx_string("http2_body_preread_size"),
+      NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_size_slot,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      offsetof(ngx_http_v2_srv_conf_t, preread_size),
+      &ngx_http_v2_preread_size_post },
+
+    { ngx_string("http2_max_field_size"),
+      NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_size_slot,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      offsetof(ngx_http_v2_srv_conf_t, max_field_size),
+      NULL },
+
+    { ngx_string("http2_max_header_size"),
+      NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_size_slot,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      offsetof(ngx_http_v2_srv_conf_t, max_header_size),
+      NULL },
+
+    { ngx_string("http2_recv_timeout"),
+      NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_msec_slot,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      offsetof(ngx_http_v2_srv_conf_t, recv_timeout),
+      NULL },
+
+    { ngx_string("http2_idle_timeout"),
+      NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_msec_slot,
+      NGX_HTTP_SRV_CONF_OFFSET,
+      offsetof(ngx_http_v2_srv_conf_t, idle_timeout),
+      NULL },
+
+    { ngx_string("http2_chunk_size"),
+      NGX_HTTP_MAIN_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_LOC_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_size_slot,
+      NGX_HTTP_LOC_CONF_OFFSET,
+      offsetof(ngx_http_v2_loc_conf_t, chunk_size),
+      &ngx_http_v2_chunk_size_post },
+
+      ngx_null_command
+};
+
+
+static ngx_http_module_t  ngx_http_v2_module_ctx = {
+    ngx_http_v2_add_variables,             /* preconfiguration */
+    NULL,                                  /* postconfiguration */
+
+    ngx_http_v2_create_main_conf,          /* create main configuration */
+    ngx_http_v2_init_main_conf,            /* init main configuration */
+
+    ngx_http_v2_create_srv_conf,           /* create server configuration */
+    ngx_http_v2_merge_srv_conf,            /* merge server configuration */
+
+    ngx_http_v2_create_loc_conf,           /* create location configuration */
+    ngx_http_v2_merge_loc_conf             /* merge location configuration */
+};
+
+
+ngx_module_t  ngx_http_v2_module = {
+    NGX_MODULE_V1,
+    &ngx_http_v2_module_ctx,               /* module context */
+    ngx_http_v2_commands,                  /* module directives */
+    NGX_HTTP_MODULE,                       /* module type */
+    NULL,                                  /* init master */
+    NULL,                                  /* init module */
+    NULL,                                  /* init process */
+    NULL,                                  /* init thread */
+    NULL,                                  /* exit thread */
+    NULL,                                  /* exit process */
+    NULL,                                  /* exit master */
+    NGX_MODULE_V1_PADDING
+};
+
+
+static ngx_http_variable_t  ngx_http_v2_vars[] = {
+
+    { ngx_string("http2"), NULL, ngx_http_v2_variable, 0, 0, 0 },
+
+    { ngx_null_string, NULL, NULL, 0, 0, 0 }
+};
+
+
+void
+ngx_http_v2_init(ngx_event_t *rev)
+{
+    int                        tcp_nodelay;
+    ngx_connection_t          *c;
+    ngx_pool_cleanup_t        *cln;
+    ngx_http_log_ctx_t        *ctx;
+    ngx_http_request_t        *r;
+    ngx_http_v2_connection_t  *h2c;
+    ngx_http_core_loc_conf_t  *clcf;
+
+    c = rev->data;
+    r = c->data;
+
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, c->log, 0, "init http2 connection");
+
+    h2c = ngx_pcalloc(c->pool, sizeof(ngx_http_v2_connection_t));
+    if (h2c == NULL) {
+        ngx_http_close_request(r, NGX_HTTP_INTERNAL_SERVER_ERROR);
+        return;
+    }
+
+    h2c->connection = c;
+    h2c->http_connection = r->http_connection;
+
+    h2c->main_conf = r->main_conf;
+    h2c->srv_conf = r->srv_conf;
+    h2c->virtual_names = r->virtual_names;
+
+    h2c->send_window = NGX_HTTP_V2_DEFAULT_WINDOW;
+    h2c->recv_window = NGX_HTTP_V2_MAX_WINDOW;
+    h2c->init_window = NGX_HTTP_V2_DEFAULT_WINDOW;
+    h2c->frame_size = NGX_HTTP_V2_DEFAULT_FRAME_SIZE;
+
+    h2c->hpack.max = NGX_HTTP_V2_TABLE_SIZE;
+
+    ngx_queue_init(&h2c->waiting);
+
+    h2c->last_out = &h2c->out;
+
+    h2c->streams_index = ngx_pcalloc(c->pool, sizeof(ngx_http_v2_stream_t *)
+                                              * NGX_HTTP_V2_STREAMS_INDEX);
+    if (h2c->streams_index == NULL) {
+        ngx_http_close_request(r, NGX_HTTP_INTERNAL_SERVER_ERROR);
+        return;
+    }
+
+    cln = ngx_pool_cleanup_add(c->pool, 0);
+    if (cln == NULL) {
+        ngx_http_close_request(r, NGX_HTTP_INTERNAL_SERVER_ERROR);
+        return;
+    }
+
+    cln->handler = ngx_http_v2_pool_cleanup;
+    cln->data = h2c;
+
+    if (ngx_http_v2_send_settings(h2c) != NGX_OK
+        || ngx_http_v2_send_window_update(h2c, 0, NGX_HTTP_V2_MAX_WINDOW
+                                                  - NGX_HTTP_V2_DEFAULT_WINDOW)
+           != NGX_OK)
+    {
+        ngx_http_close_request(r, NGX_HTTP_INTERNAL_SERVER_ERROR);
+        return;
+    }
+
+    /* the frames of all streams are sent without delay */
+
+    clcf = ngx_http_get_module_loc_conf(r, ngx_http_core_module);
+
+    if (clcf->tcp_nodelay && c->tcp_nodelay == NGX_TCP_NODELAY_UNSET) {
+        ngx_log_debug0(NGX_LOG_DEBUG_HTTP, c->log, 0, "tcp_nodelay");
+
+        tcp_nodelay = 1;
+
+        if (setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY,
+                       (const void *) &tcp_nodelay, sizeof(int))
+            == -1)
+        {
+            ngx_connection_error(c, ngx_socket_errno,
+                                 "setsockopt(TCP_NODELAY) failed");
+
+            ngx_http_close_request(r, 0);
+            return;
+        }
+
+        c->tcp_nodelay = NGX_TCP_NODELAY_SET;
+    }
+
+    /* the request created for HTTP/1.x is not needed anymore */
+
+#if (NGX_STAT_STUB)
+    if (r->stat_reading) {
+        (void) ngx_atomic_fetch_add(ngx_stat_reading, -1);
+    }
+
+    (void) ngx_atomic_fetch_add(ngx_stat_requests, -1);
+#endif
+
+    ctx = c->log->data;
+    ctx->request = NULL;
+    ctx->current_request = NULL;
+
+    ngx_destroy_pool(r->pool);
+    r->pool = NULL;
+
+    c->log->action = "processing HTTP/2 connection";
+
+    c->data = h2c;
+
+    rev->handler = ngx_http_v2_read_handler;
+    c->write->handler = ngx_http_v2_write_handler;
+
+    ngx_http_v2_read_handler(rev);
+}
+
+
+static void
+ngx_http_v2_read_handler(ngx_event_t *rev)
+{
+    u_char                    *p, *pos, *end;
+    size_t                     len;
+    ssize_t                    n;
+    ngx_connection_t          *c;
+    ngx_http_v2_main_conf_t   *h2mcf;
+    ngx_http_v2_connection_t  *h2c;
+
+    c = rev->data;
+    h2c = c->data;
+
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, c->log, 0, "http2 read handler");
+
+    if (h2c->closing) {
+        return;
+    }
+
+    if (rev->timedout) {
+
+        if (h2c->processing == 0 && h2c->preface
+            && h2c->buffer_len == 0 && h2c->header_sid == 0)
+        {
+            /* the idle timeout */
+            ngx_http_v2_finalize_connection(h2c, NGX_HTTP_V2_NO_ERROR);
+            return;
+        }
+
+        ngx_log_error(NGX_LOG_INFO, c->log, NGX_ETIMEDOUT, "client timed out");
+
+        c->timedout = 1;
+        ngx_http_v2_finalize_connection(h2c, NGX_HTTP_V2_PROTOCOL_ERROR);
+        return;
+    }
+
+    if (c->close) {
+        c->close = 0;
+        ngx_http_v2_finalize_connection(h2c, NGX_HTTP_V2_NO_ERROR);
+        return;
+    }
+
+    h2mcf = ngx_http_v2_get_module_main_conf(h2c, ngx_http_v2_module);
+
+    if (h2mcf->recv_buffer == NULL) {
+        h2mcf->recv_buffer = ngx_palloc(ngx_cycle->pool,
+                                        h2mcf->recv_buffer_size);
+        if (h2mcf->recv_buffer == NULL) {
+            ngx_http_v2_finalize_connection(h2c,
+                                            NGX_HTTP_V2_INTERNAL_ERROR);
+            return;
+        }
+    }
+
+    /*
+     * the buffer is shared by all connections of the worker,
+     * so an incomplete frame is copied out before returning
+     */
+
+    do {
+        p = h2mcf->recv_buffer;
+        len = h2c->buffer_len;
+
+        if (len) {
+            ngx_memcpy(p, h2c->buffer, len);
+        }
+
+        n = c->recv(c, p + len, h2mcf->recv_buffer_size - len);
+
+        ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                       "http2 recv: %z", n);
+
+        if (n == NGX_AGAIN) {
+            break;
+        }
+
+        if (n == 0 || n == NGX_ERROR) {
+            c->error = 1;
+            ngx_http_v2_finalize_connection(h2c, 0);
+            return;
+        }
+
+        if (len) {
+            ngx_free(h2c->buffer);
+            h2c->buffer = NULL;
+            h2c->buffer_len = 0;
+        }
+
+        end = p + len + n;
+
+        pos = ngx_http_v2_process_frames(h2c, p, end);
+
+        if (pos == NULL) {
+            return;
+        }
+
+        if (pos != end) {
+            h2c->buffer = ngx_alloc(end - pos, c->log);
+            if (h2c->buffer == NULL) {
+                ngx_http_v2_finalize_connection(h2c,
+                                                NGX_HTTP_V2_INTERNAL_ERROR);
+                return;
+            }
+
+            h2c->buffer_len = end - pos;
+            ngx_memcpy(h2c->buffer, pos, h2c->buffer_len);
+        }
+
+    } while (rev->ready);
+
+    if (ngx_handle_read_event(rev, 0) != NGX_OK) {
+        ngx_http_v2_finalize_connection(h2c, NGX_HTTP_V2_INTERNAL_ERROR);
+        return;
+    }
+
+    if (ngx_http_v2_send_output_queue(h2c) == NGX_ERROR) {
+        ngx_http_v2_finalize_connection(h2c, 0);
+        return;
+    }
+
+    ngx_http_v2_handle_connection(h2c);
+}
+
+
+static void
+ngx_http_v2_write_handler(ngx_event_t *wev)
+{
+    ngx_connection_t          *c;
+    ngx_http_v2_connection_t  *h2c;
+
+    c = wev->data;
+    h2c = c->data;
+
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, c->log, 0, "http2 write handler");
+
+    if (h2c->closing) {
+
+        if (h2c->processing == 0) {
+            ngx_http_close_connection(c);
+        }
+
+        return;
+    }
+
+    if (wev->timedout) {
+        ngx_log_error(NGX_LOG_INFO, c->log, NGX_ETIMEDOUT, "client timed out");
+
+        c->timedout = 1;
+        ngx_http_v2_finalize_connection(h2c, 0);
+        return;
+    }
+
+    if (c->error || ngx_http_v2_send_output_queue(h2c) == NGX_ERROR) {
+        ngx_http_v2_finalize_connection(h2c, 0);
+        return;
+    }
+
+    ngx_http_v2_handle_connection(h2c);
+}
+
+
+static void
+ngx_http_v2_handle_connection(ngx_http_v2_connection_t *h2c)
+{
+    ngx_uint_t                 partial;
+    ngx_connection_t          *c;
+    ngx_http_v2_srv_conf_t    *h2scf;
+
+    c = h2c->connection;
+
+    h2scf = ngx_http_v2_get_module_srv_conf(h2c, ngx_http_v2_module);
+
+    partial = (h2c->buffer_len || h2c->header_sid || !h2c->preface);
+
+    if (h2c->processing) {
+
+        if (partial) {
+            ngx_add_timer(c->read, h2scf->recv_timeout);
+
+        } else if (c->read->timer_set) {
+            ngx_del_timer(c->read);
+        }
+
+        return;
+    }
+
+    if (h2c->out) {
+        /* the write handler is called once the output is sent */
+        return;
+    }
+
+    if (h2c->goaway || ngx_exiting || ngx_terminate) {
+        ngx_http_v2_finalize_connection(h2c, NGX_HTTP_V2_NO_ERROR);
+        return;
+    }
+
+    c->idle = 1;
+    ngx_reusable_connection(c, 1);
+
+    ngx_add_timer(c->read, partial ? h2scf->recv_timeout
+                                   : h2scf->idle_timeout);
+}
+
+
+static u_char *
+ngx_http_v2_process_frames(ngx_http_v2_connection_t *h2c, u_char *pos,
+    u_char *end)
+{
+    size_t      size, length;
+    ngx_int_t   rc;
+    ngx_uint_t  type, flags, sid;
+
+    if (!h2c->preface) {
+        size = ngx_min((size_t) (end - pos), NGX_HTTP_V2_PREFACE_LEN);
+
+        if (ngx_memcmp(pos, NGX_HTTP_V2_PREFACE, size) != 0) {
+            ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                          "client sent invalid http2 connection preface");
+
+            ngx_http_v2_finalize_connection(h2c, NGX_HTTP_V2_PROTOCOL_ERROR);
+            return NULL;
+        }
+
+        if (size < NGX_HTTP_V2_PREFACE_LEN) {
+            return pos;
+        }
+
+        pos += NGX_HTTP_V2_PREFACE_LEN;
+        h2c->preface = 1;
+    }
+
+    while ((size_t) (end - pos) >= NGX_HTTP_V2_FRAME_HEADER_SIZE) {
+
+        length = ngx_http_v2_parse_length(pos);
+        type = pos[3];
+        flags = pos[4];
+        sid = ngx_http_v2_parse_sid(&pos[5]);
+
+        if (length > NGX_HTTP_V2_DEFAULT_FRAME_SIZE) {
+            ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                          "client sent too large frame: %uz", length);
+
+            ngx_http_v2_finalize_connection(h2c, NGX_HTTP_V2_SIZE_ERROR);
+            return NULL;
+        }
+
+        if ((size_t) (end - pos) < NGX_HTTP_V2_FRAME_HEADER_SIZE + length) {
+            break;
+        }
+
+        pos += NGX_HTTP_V2_FRAME_HEADER_SIZE;
+
+        ngx_log_debug4(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                       "http2 frame type:%ui f:%Xi l:%uz sid:%ui",
+                       type, flags, length, sid);
+
+        if (h2c->header_sid && type != NGX_HTTP_V2_CONTINUATION_FRAME) {
+            ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                          "client sent frame of type %ui instead of "
+                          "CONTINUATION", type);
+
+            ngx_http_v2_finalize_connection(h2c, NGX_HTTP_V2_PROTOCOL_ERROR);
+            return NULL;
+        }
+
+        switch (type) {
+
+        case NGX_HTTP_V2_DATA_FRAME:
+            rc = ngx_http_v2_state_data(h2c, flags, sid, pos, length);
+            break;
+
+        case NGX_HTTP_V2_HEADERS_FRAME:
+            rc = ngx_http_v2_state_headers(h2c, flags, sid, pos, length);
+            break;
+
+        case NGX_HTTP_V2_PRIORITY_FRAME:
+
+            /* priorities are not supported */
+
+            if (sid == 0) {
+                rc = ngx_http_v2_connection_error(h2c,
+                                                  NGX_HTTP_V2_PROTOCOL_ERROR);
+                break;
+            }
+
+            rc = (length == 5) ? NGX_OK
+                 : ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_SIZE_ERROR);
+            break;
+
+        case NGX_HTTP_V2_RST_STREAM_FRAME:
+            rc = ngx_http_v2_state_rst_stream(h2c, sid, pos, length);
+            break;
+
+        case NGX_HTTP_V2_SETTINGS_FRAME:
+            rc = ngx_http_v2_state_settings(h2c, flags, sid, pos, length);
+            break;
+
+        case NGX_HTTP_V2_PUSH_PROMISE_FRAME:
+            ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                          "client sent PUSH_PROMISE frame");
+
+            rc = ngx_http_v2_connection_error(h2c,
+                                              NGX_HTTP_V2_PROTOCOL_ERROR);
+            break;
+
+        case NGX_HTTP_V2_PING_FRAME:
+            rc = ngx_http_v2_state_ping(h2c, flags, sid, pos, length);
+            break;
+
+        case NGX_HTTP_V2_GOAWAY_FRAME:
+
+            if (sid != 0 || length < 8) {
+                rc = ngx_http_v2_connection_error(h2c,
+                                                  NGX_HTTP_V2_PROTOCOL_ERROR);
+                break;
+            }
+
+            ngx_log_debug1(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                           "http2 GOAWAY with error code %uD",
+                           ngx_http_v2_parse_uint32(&pos[4]));
+
+            h2c->goaway = 1;
+            rc = NGX_OK;
+            break;
+
+        case NGX_HTTP_V2_WINDOW_UPDATE_FRAME:
+            rc = ngx_http_v2_state_window_update(h2c, sid, pos, length);
+            break;
+
+        case NGX_HTTP_V2_CONTINUATION_FRAME:
+            rc = ngx_http_v2_state_continuation(h2c, flags, sid, pos, length);
+            break;
+
+        default:
+            /* unknown frame types are ignored */
+            rc = NGX_OK;
+        }
+
+        if (rc == NGX_ERROR) {
+            return NULL;
+        }
+
+        pos += length;
+    }
+
+    return pos;
+}
+
+
+static ngx_int_t
+ngx_http_v2_state_data(ngx_http_v2_connection_t *h2c, ngx_uint_t flags,
+    ngx_uint_t sid, u_char *pos, size_t size)
+{
+    size_t                 padding;
+    ngx_int_t              rc;
+    ngx_connection_t      *fc;
+    ngx_http_request_t    *r;
+    ngx_http_v2_stream_t  *stream;
+
+    if (sid == 0) {
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_PROTOCOL_ERROR);
+    }
+
+    if (size > h2c->recv_window) {
+        ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                      "client violated connection flow control: "
+                      "received DATA frame length %uz, available window %uz",
+                      size, h2c->recv_window);
+
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_FLOW_CTRL_ERROR);
+    }
+
+    h2c->recv_window -= size;
+
+    if (h2c->recv_window < NGX_HTTP_V2_MAX_WINDOW / 4) {
+
+        if (ngx_http_v2_send_window_update(h2c, 0, NGX_HTTP_V2_MAX_WINDOW
+                                                   - h2c->recv_window)
+            != NGX_OK)
+        {
+            return ngx_http_v2_connection_error(h2c,
+                                                NGX_HTTP_V2_INTERNAL_ERROR);
+        }
+
+        h2c->recv_window = NGX_HTTP_V2_MAX_WINDOW;
+    }
+
+    stream = ngx_http_v2_get_stream(h2c, sid);
+
+    if (stream == NULL) {
+
+        if (sid > h2c->last_sid) {
+            return ngx_http_v2_connection_error(h2c,
+                                                NGX_HTTP_V2_PROTOCOL_ERROR);
+        }
+
+        /* the stream is already closed */
+
+        return NGX_OK;
+    }
+
+    if (stream->in_closed) {
+        ngx_http_v2_terminate_stream(h2c, stream, NGX_HTTP_V2_STREAM_CLOSED);
+        return NGX_OK;
+    }
+
+    if (size > stream->recv_window) {
+        ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                      "client violated flow control for stream %ui: "
+                      "received DATA frame length %uz, available window %uz",
+                      sid, size, stream->recv_window);
+
+        ngx_http_v2_terminate_stream(h2c, stream,
+                                     NGX_HTTP_V2_FLOW_CTRL_ERROR);
+        return NGX_OK;
+    }
+
+    stream->recv_window -= size;
+
+    if (flags & NGX_HTTP_V2_PADDED_FLAG) {
+
+        if (size == 0) {
+            return ngx_http_v2_connection_error(h2c,
+                                                NGX_HTTP_V2_PROTOCOL_ERROR);
+        }
+
+        padding = *pos++;
+        size--;
+
+        if (padding > size) {
+            ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                          "client sent padded DATA frame with incorrect "
+                          "length: %uz, padding: %uz", size, padding);
+
+            return ngx_http_v2_connection_error(h2c,
+                                                NGX_HTTP_V2_PROTOCOL_ERROR);
+        }
+
+        size -= padding;
+    }
+
+    if (flags & NGX_HTTP_V2_END_STREAM_FLAG) {
+        stream->in_closed = 1;
+    }
+
+    if (stream->skip_data) {
+
+        if (ngx_http_v2_update_stream_window(h2c, stream) != NGX_OK) {
+            return ngx_http_v2_connection_error(h2c,
+                                                NGX_HTTP_V2_INTERNAL_ERROR);
+        }
+
+        return NGX_OK;
+    }
+
+    r = stream->request;
+    fc = r->connection;
+
+    if (r->request_body == NULL) {
+
+        /* the body is not requested yet, the window limits the preread */
+
+        if (size == 0) {
+            return NGX_OK;
+        }
+
+        if (stream->preread == NULL) {
+            stream->preread = ngx_create_temp_buf(r->pool, stream->recv_window
+                                                           + size);
+            if (stream->preread == NULL) {
+                return ngx_http_v2_connection_error(h2c,
+                                                  NGX_HTTP_V2_INTERNAL_ERROR);
+            }
+        }
+
+        if ((size_t) (stream->preread->end - stream->preread->last) < size) {
+            ngx_http_v2_terminate_stream(h2c, stream,
+                                         NGX_HTTP_V2_FLOW_CTRL_ERROR);
+            return NGX_OK;
+        }
+
+        stream->preread->last = ngx_cpymem(stream->preread->last, pos, size);
+
+        return NGX_OK;
+    }
+
+    rc = ngx_http_v2_process_request_body(r, pos, size, stream->in_closed);
+
+    if (rc >= NGX_HTTP_SPECIAL_RESPONSE) {
+        stream->skip_data = 1;
+        ngx_http_finalize_request(r, rc);
+        return NGX_OK;
+    }
+
+    if (rc == NGX_ERROR) {
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_INTERNAL_ERROR);
+    }
+
+    if (rc == NGX_OK) {
+        ngx_http_run_posted_requests(fc);
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_state_headers(ngx_http_v2_connection_t *h2c, ngx_uint_t flags,
+    ngx_uint_t sid, u_char *pos, size_t size)
+{
+    size_t                   padding;
+    ngx_http_v2_srv_conf_t  *h2scf;
+
+    if (sid == 0 || sid % 2 == 0) {
+        ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                      "client sent HEADERS frame with incorrect identifier "
+                      "%ui", sid);
+
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_PROTOCOL_ERROR);
+    }
+
+    padding = 0;
+
+    if (flags & NGX_HTTP_V2_PADDED_FLAG) {
+
+        if (size == 0) {
+            return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_SIZE_ERROR);
+        }
+
+        padding = *pos++;
+        size--;
+    }
+
+    if (flags & NGX_HTTP_V2_PRIORITY_FLAG) {
+
+        /* priorities are not supported */
+
+        if (size < 5) {
+            return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_SIZE_ERROR);
+        }
+
+        pos += 5;
+        size -= 5;
+    }
+
+    if (padding > size) {
+        ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                      "client sent padded HEADERS frame with incorrect "
+                      "length: %uz, padding: %uz", size, padding);
+
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_PROTOCOL_ERROR);
+    }
+
+    size -= padding;
+
+    h2scf = ngx_http_v2_get_module_srv_conf(h2c, ngx_http_v2_module);
+
+    if (size > h2scf->max_header_size) {
+        ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                      "client exceeded http2_max_header_size limit");
+
+        return ngx_http_v2_connection_error(h2c,
+                                            NGX_HTTP_V2_ENHANCE_YOUR_CALM);
+    }
+
+    h2c->header_block = ngx_alloc(h2scf->max_header_size,
+                                  h2c->connection->log);
+    if (h2c->header_block == NULL) {
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_INTERNAL_ERROR);
+    }
+
+    ngx_memcpy(h2c->header_block, pos, size);
+
+    h2c->header_block_len = size;
+    h2c->header_sid = sid;
+    h2c->header_flags = flags;
+
+    if (flags & NGX_HTTP_V2_END_HEADERS_FLAG) {
+        return ngx_http_v2_process_header_block(h2c);
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_state_continuation(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t flags, ngx_uint_t sid, u_char *pos, size_t size)
+{
+    ngx_http_v2_srv_conf_t  *h2scf;
+
+    if (h2c->header_sid == 0 || sid != h2c->header_sid) {
+        ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                      "client sent unexpected CONTINUATION frame");
+
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_PROTOCOL_ERROR);
+    }
+
+    h2scf = ngx_http_v2_get_module_srv_conf(h2c, ngx_http_v2_module);
+
+    if (size > h2scf->max_header_size - h2c->header_block_len) {
+        ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                      "client exceeded http2_max_header_size limit");
+
+        return ngx_http_v2_connection_error(h2c,
+                                            NGX_HTTP_V2_ENHANCE_YOUR_CALM);
+    }
+
+    ngx_memcpy(h2c->header_block + h2c->header_block_len, pos, size);
+    h2c->header_block_len += size;
+
+    if (flags & NGX_HTTP_V2_END_HEADERS_FLAG) {
+        return ngx_http_v2_process_header_block(h2c);
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_state_rst_stream(ngx_http_v2_connection_t *h2c, ngx_uint_t sid,
+    u_char *pos, size_t size)
+{
+    ngx_connection_t      *fc;
+    ngx_http_v2_stream_t  *stream;
+
+    if (size != 4) {
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_SIZE_ERROR);
+    }
+
+    if (sid == 0 || sid > h2c->last_sid) {
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_PROTOCOL_ERROR);
+    }
+
+    stream = ngx_http_v2_get_stream(h2c, sid);
+
+    if (stream == NULL) {
+        return NGX_OK;
+    }
+
+    fc = stream->request->connection;
+
+    ngx_log_error(NGX_LOG_INFO, fc->log, 0,
+                  "client terminated stream %ui with status %uD",
+                  sid, ngx_http_v2_parse_uint32(pos));
+
+    stream->rst_sent = 1;
+
+    ngx_http_v2_terminate_stream(h2c, stream, 0);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_state_settings(ngx_http_v2_connection_t *h2c, ngx_uint_t flags,
+    ngx_uint_t sid, u_char *pos, size_t size)
+{
+    u_char                   *end;
+    ssize_t                   delta;
+    ngx_uint_t                id, value, i;
+    ngx_http_v2_stream_t     *stream;
+    ngx_http_v2_out_frame_t  *frame;
+
+    if (sid != 0) {
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_PROTOCOL_ERROR);
+    }
+
+    if (flags & NGX_HTTP_V2_ACK_FLAG) {
+        return (size == 0) ? NGX_OK
+               : ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_SIZE_ERROR);
+    }
+
+    if (size % NGX_HTTP_V2_SETTINGS_PARAM_SIZE) {
+        ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                      "client sent SETTINGS frame with incorrect length %uz",
+                      size);
+
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_SIZE_ERROR);
+    }
+
+    for (end = pos + size;
+         pos < end;
+         pos += NGX_HTTP_V2_SETTINGS_PARAM_SIZE)
+    {
+        id = ngx_http_v2_parse_uint16(pos);
+        value = ngx_http_v2_parse_uint32(&pos[2]);
+
+        ngx_log_debug2(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                       "http2 setting %ui:%ui", id, value);
+
+        switch (id) {
+
+        case NGX_HTTP_V2_INIT_WINDOW_SIZE:
+
+            if (value > NGX_HTTP_V2_MAX_WINDOW) {
+                ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                              "client sent SETTINGS frame with incorrect "
+                              "INITIAL_WINDOW_SIZE value %ui", value);
+
+                return ngx_http_v2_connection_error(h2c,
+                                                 NGX_HTTP_V2_FLOW_CTRL_ERROR);
+            }
+
+            delta = (ssize_t) value - (ssize_t) h2c->init_window;
+            h2c->init_window = value;
+
+            for (i = 0; i < NGX_HTTP_V2_STREAMS_INDEX; i++) {
+                for (stream = h2c->streams_index[i];
+                     stream;
+                     stream = stream->index)
+                {
+                    if (delta > 0
+                        && stream->send_window
+                           > (ssize_t) (NGX_HTTP_V2_MAX_WINDOW - delta))
+                    {
+                        return ngx_http_v2_connection_error(h2c,
+                                                 NGX_HTTP_V2_FLOW_CTRL_ERROR);
+                    }
+
+                    stream->send_window += delta;
+                }
+            }
+
+            if (delta > 0) {
+                ngx_http_v2_wake_streams(h2c);
+            }
+
+            break;
+
+        case NGX_HTTP_V2_MAX_FRAME_SIZE_PARAM:
+
+            if (value < NGX_HTTP_V2_DEFAULT_FRAME_SIZE
+                || value > NGX_HTTP_V2_MAX_FRAME_SIZE)
+            {
+                ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                              "client sent SETTINGS frame with incorrect "
+                              "MAX_FRAME_SIZE value %ui", value);
+
+                return ngx_http_v2_connection_error(h2c,
+                                                  NGX_HTTP_V2_PROTOCOL_ERROR);
+            }
+
+            h2c->frame_size = value;
+            break;
+
+        case NGX_HTTP_V2_ENABLE_PUSH:
+
+            if (value > 1) {
+                return ngx_http_v2_connection_error(h2c,
+                                                  NGX_HTTP_V2_PROTOCOL_ERROR);
+            }
+
+            break;
+
+        default:
+            /* the dynamic table is not used for encoding */
+            break;
+        }
+    }
+
+    frame = ngx_http_v2_get_frame(h2c, 0, NGX_HTTP_V2_SETTINGS_FRAME,
+                                  NGX_HTTP_V2_ACK_FLAG, 0);
+    if (frame == NULL) {
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_INTERNAL_ERROR);
+    }
+
+    ngx_http_v2_queue_frame(h2c, frame);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_state_ping(ngx_http_v2_connection_t *h2c, ngx_uint_t flags,
+    ngx_uint_t sid, u_char *pos, size_t size)
+{
+    ngx_http_v2_out_frame_t  *frame;
+
+    if (size != 8) {
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_SIZE_ERROR);
+    }
+
+    if (sid != 0) {
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_PROTOCOL_ERROR);
+    }
+
+    if (flags & NGX_HTTP_V2_ACK_FLAG) {
+        return NGX_OK;
+    }
+
+    frame = ngx_http_v2_get_frame(h2c, 8, NGX_HTTP_V2_PING_FRAME,
+                                  NGX_HTTP_V2_ACK_FLAG, 0);
+    if (frame == NULL) {
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_INTERNAL_ERROR);
+    }
+
+    frame->buf.last = ngx_cpymem(frame->buf.last, pos, 8);
+
+    ngx_http_v2_queue_frame(h2c, frame);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_state_window_update(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t sid, u_char *pos, size_t size)
+{
+    size_t                 window;
+    ngx_http_v2_stream_t  *stream;
+
+    if (size != 4) {
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_SIZE_ERROR);
+    }
+
+    window = ngx_http_v2_parse_uint32(pos) & 0x7fffffff;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                   "http2 WINDOW_UPDATE sid:%ui window:%uz", sid, window);
+
+    if (sid == 0) {
+
+        if (window == 0) {
+            return ngx_http_v2_connection_error(h2c,
+                                                NGX_HTTP_V2_PROTOCOL_ERROR);
+        }
+
+        if (window > NGX_HTTP_V2_MAX_WINDOW - h2c->send_window) {
+            return ngx_http_v2_connection_error(h2c,
+                                                NGX_HTTP_V2_FLOW_CTRL_ERROR);
+        }
+
+        h2c->send_window += window;
+
+        ngx_http_v2_wake_streams(h2c);
+
+        return NGX_OK;
+    }
+
+    if (sid > h2c->last_sid) {
+        return ngx_http_v2_connection_error(h2c, NGX_HTTP_V2_PROTOCOL_ERROR);
+    }
+
+    stream = ngx_http_v2_get_stream(h2c, sid);
+
+    if (stream == NULL) {
+        return NGX_OK;
+    }
+
+    if (window == 0) {
+        ngx_http_v2_terminate_stream(h2c, stream, NGX_HTTP_V2_PROTOCOL_ERROR);
+        return NGX_OK;
+    }
+
+    if (stream->send_window > (ssize_t) (NGX_HTTP_V2_MAX_WINDOW - window)) {
+        ngx_http_v2_terminate_stream(h2c, stream,
+                                     NGX_HTTP_V2_FLOW_CTRL_ERROR);
+        return NGX_OK;
+    }
+
+    stream->send_window += window;
+
+    if (stream->waiting && stream->send_window > 0) {
+        ngx_queue_remove(&stream->queue);
+        stream->waiting = 0;
+
+        ngx_post_event(stream->request->connection->write,
+                       &ngx_posted_events);
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_connection_error(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t status)
+{
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                   "http2 connection error: %ui", status);
+
+    ngx_http_v2_finalize_connection(h2c, status);
+
+    return NGX_ERROR;
+}
+
+
+static ngx_int_t
+ngx_http_v2_process_header_block(ngx_http_v2_connection_t *h2c)
+{
+    ngx_int_t                    rc;
+    ngx_uint_t                   sid, flags, refused, status;
+    ngx_http_request_t          *r;
+    ngx_http_v2_stream_t        *stream;
+    ngx_http_v2_srv_conf_t      *h2scf;
+    ngx_http_v2_header_block_t   hb;
+
+    sid = h2c->header_sid;
+    flags = h2c->header_flags;
+
+    h2c->header_sid = 0;
+
+    h2scf = ngx_http_v2_get_module_srv_conf(h2c, ngx_http_v2_module);
+
+    ngx_memzero(&hb, sizeof(ngx_http_v2_header_block_t));
+
+    stream = NULL;
+    refused = 0;
+
+    if (sid <= h2c->last_sid) {
+
+        /* trailers */
+
+        stream = ngx_http_v2_get_stream(h2c, sid);
+
+        if (stream == NULL) {
+            ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                          "client sent HEADERS frame for closed stream %ui",
+                          sid);
+
+            ngx_free(h2c->header_block);
+            h2c->header_block = NULL;
+
+            return ngx_http_v2_connection_error(h2c,
+                                                NGX_HTTP_V2_STREAM_CLOSED);
+        }
+
+    } else {
+        h2c->last_sid = sid;
+
+        if (h2c->goaway || h2c->processing >= h2scf->concurrent_streams) {
+
+            if (!h2c->goaway) {
+                ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                              "concurrent streams exceeded %ui",
+                              h2c->processing);
+            }
+
+            refused = 1;
+
+        } else {
+            stream = ngx_http_v2_create_stream(h2c, sid);
+            if (stream == NULL) {
+                ngx_free(h2c->header_block);
+                h2c->header_block = NULL;
+
+                return ngx_http_v2_connection_error(h2c,
+                                                  NGX_HTTP_V2_INTERNAL_ERROR);
+            }
+
+            hb.request = stream->request;
+        }
+    }
+
+    /* the fields not kept are decoded to keep the dynamic table in sync */
+
+    hb.pool = ngx_create_pool(NGX_DEFAULT_POOL_SIZE, h2c->connection->log);
+    if (hb.pool == NULL) {
+        status = NGX_HTTP_V2_INTERNAL_ERROR;
+
+    } else {
+        status = ngx_http_v2_parse_header_block(h2c, &hb, h2c->header_block,
+                                                h2c->header_block
+                                                + h2c->header_block_len);
+        ngx_destroy_pool(hb.pool);
+    }
+
+    ngx_free(h2c->header_block);
+    h2c->header_block = NULL;
+
+    if (status != NGX_HTTP_V2_NO_ERROR) {
+        return ngx_http_v2_connection_error(h2c, status);
+    }
+
+    if (refused) {
+        if (ngx_http_v2_send_rst_stream(h2c, sid, NGX_HTTP_V2_REFUSED_STREAM)
+            != NGX_OK)
+        {
+            return ngx_http_v2_connection_error(h2c,
+                                                NGX_HTTP_V2_INTERNAL_ERROR);
+        }
+
+        return NGX_OK;
+    }
+
+    r = stream->request;
+
+    if (hb.request == NULL) {
+
+        /* the trailer fields are ignored */
+
+        if (stream->in_closed) {
+            ngx_http_v2_terminate_stream(h2c, stream,
+                                         NGX_HTTP_V2_STREAM_CLOSED);
+            return NGX_OK;
+        }
+
+        if (!(flags & NGX_HTTP_V2_END_STREAM_FLAG)) {
+            ngx_log_error(NGX_LOG_INFO, r->connection->log, 0,
+                          "client sent trailers without END_STREAM flag");
+
+            ngx_http_v2_terminate_stream(h2c, stream,
+                                         NGX_HTTP_V2_PROTOCOL_ERROR);
+            return NGX_OK;
+        }
+
+        stream->in_closed = 1;
+
+        if (stream->skip_data || r->request_body == NULL) {
+            return NGX_OK;
+        }
+
+        rc = ngx_http_v2_process_request_body(r, NULL, 0, 1);
+
+        if (rc >= NGX_HTTP_SPECIAL_RESPONSE) {
+            stream->skip_data = 1;
+            ngx_http_finalize_request(r, rc);
+            return NGX_OK;
+        }
+
+        if (rc == NGX_ERROR) {
+            return ngx_http_v2_connection_error(h2c,
+                                                NGX_HTTP_V2_INTERNAL_ERROR);
+        }
+
+        if (rc == NGX_OK) {
+            ngx_http_run_posted_requests(r->connection);
+        }
+
+        return NGX_OK;
+    }
+
+    if (flags & NGX_HTTP_V2_END_STREAM_FLAG) {
+        stream->in_closed = 1;
+    }
+
+    r->request_length = h2c->header_block_len;
+
+    if (hb.status) {
+        ngx_http_finalize_request(r, hb.status);
+        return NGX_OK;
+    }
+
+    ngx_http_v2_run_request(&hb);
+
+    return NGX_OK;
+}
+
+
+static ngx_uint_t
+ngx_http_v2_parse_header_block(ngx_http_v2_connection_t *h2c,
+    ngx_http_v2_header_block_t *hb, u_char *pos, u_char *end)
+{
+    u_char                   ch;
+    ngx_int_t                rc;
+    ngx_uint_t               index, indexed, status;
+    ngx_pool_t              *pool;
+    ngx_http_v2_header_t     header;
+    ngx_http_v2_srv_conf_t  *h2scf;
+
+    h2scf = ngx_http_v2_get_module_srv_conf(h2c, ngx_http_v2_module);
+
+    while (pos < end) {
+
+        if (hb->request && hb->status == 0) {
+            pool = hb->request->pool;
+
+        } else {
+            pool = hb->pool;
+            ngx_reset_pool(pool);
+        }
+
+        ch = *pos;
+        indexed = 0;
+
+        if (ch & 0x80) {
+
+            /* indexed header field */
+
+            if (ngx_http_v2_parse_int(&pos, end, 7, &index) != NGX_OK) {
+                return NGX_HTTP_V2_COMP_ERROR;
+            }
+
+            rc = ngx_http_v2_get_indexed_header(h2c, index, 0, pool, &header);
+
+            if (rc == NGX_ERROR) {
+                return NGX_HTTP_V2_INTERNAL_ERROR;
+            }
+
+            if (rc == NGX_DECLINED) {
+                return NGX_HTTP_V2_COMP_ERROR;
+            }
+
+        } else if (ch & 0x20 && !(ch & 0x40)) {
+
+            /* dynamic table size update */
+
+            if (ngx_http_v2_parse_int(&pos, end, 5, &index) != NGX_OK
+                || ngx_http_v2_table_size(h2c, index) != NGX_OK)
+            {
+                return NGX_HTTP_V2_COMP_ERROR;
+            }
+
+            continue;
+
+        } else {
+
+            /* literal header field, with or without indexing */
+
+            indexed = ch & 0x40;
+
+            if (ngx_http_v2_parse_int(&pos, end, indexed ? 6 : 4, &index)
+                != NGX_OK)
+            {
+                return NGX_HTTP_V2_COMP_ERROR;
+            }
+
+            if (index) {
+                rc = ngx_http_v2_get_indexed_header(h2c, index, 1, pool,
+                                                    &header);
+
+                if (rc == NGX_ERROR) {
+                    return NGX_HTTP_V2_INTERNAL_ERROR;
+                }
+
+                if (rc == NGX_DECLINED) {
+                    return NGX_HTTP_V2_COMP_ERROR;
+                }
+
+            } else {
+                status = ngx_http_v2_parse_string(h2c, &pos, end, pool,
+                                                  &header.name);
+                if (status != NGX_HTTP_V2_NO_ERROR) {
+                    return status;
+                }
+            }
+
+            status = ngx_http_v2_parse_string(h2c, &pos, end, pool,
+                                              &header.value);
+            if (status != NGX_HTTP_V2_NO_ERROR) {
+                return status;
+            }
+
+            if (indexed && ngx_http_v2_add_header(h2c, &header) != NGX_OK) {
+                return NGX_HTTP_V2_INTERNAL_ERROR;
+            }
+        }
+
+        ngx_log_debug2(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                       "http2 header: \"%V: %V\"",
+                       &header.name, &header.value);
+
+        if (hb->request == NULL || hb->status) {
+            continue;
+        }
+
+        hb->size += header.name.len + header.value.len;
+
+        if (hb->size > h2scf->max_header_size) {
+            ngx_log_error(NGX_LOG_INFO, hb->request->connection->log, 0,
+                          "client exceeded http2_max_header_size limit");
+
+            hb->status = NGX_HTTP_REQUEST_HEADER_TOO_LARGE;
+            continue;
+        }
+
+        rc = ngx_http_v2_process_field(hb, &header);
+
+        if (rc == NGX_ERROR) {
+            hb->status = NGX_HTTP_INTERNAL_SERVER_ERROR;
+
+        } else if (rc == NGX_DECLINED) {
+            hb->status = NGX_HTTP_BAD_REQUEST;
+        }
+    }
+
+    return NGX_HTTP_V2_NO_ERROR;
+}
+
+
+static ngx_int_t
+ngx_http_v2_parse_int(u_char **pos, u_char *end, ngx_uint_t prefix,
+    ngx_uint_t *value)
+{
+    u_char      *p, octet;
+    ngx_uint_t   mask, v, shift;
+
+    p = *pos;
+
+    if (p == end) {
+        return NGX_ERROR;
+    }
+
+    mask = (1 << prefix) - 1;
+    v = *p++ & mask;
+
+    if (v == mask) {
+
+        for (shift = 0; /* void */; shift += 7) {
+
+            /* larger values are never used by the sane clients */
+
+            if (p == end || shift > 21) {
+                return NGX_ERROR;
+            }
+
+            octet = *p++;
+            v += (ngx_uint_t) (octet & 0x7f) << shift;
+
+            if (!(octet & 0x80)) {
+                break;
+            }
+        }
+    }
+
+    *pos = p;
+    *value = v;
+
+    return NGX_OK;
+}
+
+
+static ngx_uint_t
+ngx_http_v2_parse_string(ngx_http_v2_connection_t *h2c, u_char **pos,
+    u_char *end, ngx_pool_t *pool, ngx_str_t *str)
+{
+    u_char                  *p, *dst, state;
+    ngx_uint_t               huff, len;
+    ngx_http_v2_srv_conf_t  *h2scf;
+
+    p = *pos;
+
+    if (p == end) {
+        return NGX_HTTP_V2_COMP_ERROR;
+    }
+
+    huff = *p & 0x80;
+
+    if (ngx_http_v2_parse_int(&p, end, 7, &len) != NGX_OK) {
+        return NGX_HTTP_V2_COMP_ERROR;
+    }
+
+    if (len > (ngx_uint_t) (end - p)) {
+        return NGX_HTTP_V2_COMP_ERROR;
+    }
+
+    h2scf = ngx_http_v2_get_module_srv_conf(h2c, ngx_http_v2_module);
+
+    if (len > h2scf->max_field_size) {
+        ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                      "client exceeded http2_max_field_size limit");
+
+        return NGX_HTTP_V2_ENHANCE_YOUR_CALM;
+    }
+
+    if (huff) {
+        str->data = ngx_pnalloc(pool, len * 8 / 5 + 1);
+        if (str->data == NULL) {
+            return NGX_HTTP_V2_INTERNAL_ERROR;
+        }
+
+        state = 0;
+        dst = str->data;
+
+        if (ngx_http_huff_decode(&state, p, len, &dst, 1,
+                                 h2c->connection->log)
+            != NGX_OK)
+        {
+            ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                          "client sent invalid encoded header field");
+
+            return NGX_HTTP_V2_COMP_ERROR;
+        }
+
+        str->len = dst - str->data;
+
+    } else {
+        str->data = ngx_pnalloc(pool, len + 1);
+        if (str->data == NULL) {
+            return NGX_HTTP_V2_INTERNAL_ERROR;
+        }
+
+        ngx_memcpy(str->data, p, len);
+        str->len = len;
+    }
+
+    str->data[str->len] = '\0';
+
+    *pos = p + len;
+
+    return NGX_HTTP_V2_NO_ERROR;
+}
+
+
+static ngx_int_t
+ngx_http_v2_process_field(ngx_http_v2_header_block_t *hb,
+    ngx_http_v2_header_t *header)
+{
+    u_char                    ch;
+    ngx_str_t                *cookie;
+    ngx_uint_t                i;
+    ngx_table_elt_t          *h;
+    ngx_http_request_t       *r;
+    ngx_http_core_srv_conf_t *cscf;
+
+    r = hb->request;
+
+    for (i = 0; i < header->value.len; i++) {
+        ch = header->value.data[i];
+
+        if (ch == '\0' || ch == CR || ch == LF) {
+            ngx_log_error(NGX_LOG_INFO, r->connection->log, 0,
+                          "client sent invalid header value: \"%V\"",
+                          &header->value);
+
+            return NGX_DECLINED;
+        }
+    }
+
+    if (header->name.len == 0) {
+        ngx_log_error(NGX_LOG_INFO, r->connection->log, 0,
+                      "client sent empty header name");
+
+        return NGX_DECLINED;
+    }
+
+    if (header->name.data[0] == ':') {
+
+        if (hb->regular) {
+            ngx_log_error(NGX_LOG_INFO, r->connection->log, 0,
+                          "client sent pseudo-header \"%V\" after "
+                          "regular header", &header->name);
+
+            return NGX_DECLINED;
+        }
+
+        return ngx_http_v2_pseudo_header(hb, header);
+    }
+
+    hb->regular = 1;
+
+    cscf = ngx_http_get_module_srv_conf(r, ngx_http_core_module);
+
+    for (i = 0; i < header->name.len; i++) {
+        ch = header->name.data[i];
+
+        if ((ch >= 'a' && ch <= 'z')
+            || (ch >= '0' && ch <= '9')
+            || ch == '-'
+            || (ch == '_' && cscf->underscores_in_headers))
+        {
+            continue;
+        }
+
+        if (ch <= 0x20 || ch == 0x7f || ch == ':'
+            || (ch >= 'A' && ch <= 'Z'))
+        {
+            ngx_log_error(NGX_LOG_INFO, r->connection->log, 0,
+                          "client sent invalid header name: \"%V\"",
+                          &header->name);
+
+            return NGX_DECLINED;
+        }
+
+        if (cscf->ignore_invalid_headers) {
+            ngx_log_error(NGX_LOG_INFO, r->connection->log, 0,
+                          "client sent invalid header line: \"%V: %V\"",
+                          &header->name, &header->value);
+
+            return NGX_OK;
+        }
+    }
+
+    /* the connection-specific header fields are not allowed */
+
+    if ((header->name.len == 10
+         && ngx_strncmp(header->name.data, "connection", 10) == 0)
+        || (header->name.len == 10
+            && ngx_strncmp(header->name.data, "keep-alive", 10) == 0)
+        || (header->name.len == 16
+            && ngx_strncmp(header->name.data, "proxy-connection", 16) == 0)
+        || (header->name.len == 17
+            && ngx_strncmp(header->name.data, "transfer-encoding", 17) == 0)
+        || (header->name.len == 7
+            && ngx_strncmp(header->name.data, "upgrade", 7) == 0)
+        || (header->name.len == 2
+            && ngx_strncmp(header->name.data, "te", 2) == 0
+            && (header->value.len != 8
+                || ngx_strncasecmp(header->value.data, (u_char *) "trailers",
+                                   8) != 0)))
+    {
+        ngx_log_error(NGX_LOG_INFO, r->connection->log, 0,
+                      "client sent invalid header field \"%V\"",
+                      &header->name);
+
+        return NGX_DECLINED;
+    }
+
+    if (header->name.len == 6
+        && ngx_strncmp(header->name.data, "cookie", 6) == 0)
+    {
+        if (hb->cookies.elts == NULL
+            && ngx_array_init(&hb->cookies, r->pool, 2, sizeof(ngx_str_t))
+               != NGX_OK)
+        {
+            return NGX_ERROR;
+        }
+
+        cookie = ngx_array_push(&hb->cookies);
+        if (cookie == NULL) {
+            return NGX_ERROR;
+        }
+
+        *cookie = header->value;
+
+        return NGX_OK;
+    }
+
+    h = ngx_list_push(&r->headers_in.headers);
+    if (h == NULL) {
+        return NGX_ERROR;
+    }
+
+    h->key = header->name;
+    h->value = header->value;
+    h->lowcase_key = header->name.data;
+    h->hash = ngx_hash_key(h->key.data, h->key.len);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_pseudo_header(ngx_http_v2_header_block_t *hb,
+    ngx_http_v2_header_t *header)
+{
+    ngx_str_t  *field;
+
+    header->name.len--;
+    header->name.data++;
+
+    switch (header->name.len) {
+
+    case 4:
+        if (ngx_strncmp(header->name.data, "path", 4) == 0) {
+            field = &hb->path;
+            break;
+        }
+
+        goto invalid;
+
+    case 6:
+        if (ngx_strncmp(header->name.data, "method", 6) == 0) {
+            field = &hb->method;
+            break;
+        }
+
+        if (ngx_strncmp(header->name.data, "scheme", 6) == 0) {
+            field = &hb->scheme;
+            break;
+        }
+
+        goto invalid;
+
+    case 9:
+        if (ngx_strncmp(header->name.data, "authority", 9) == 0) {
+            field = &hb->authority;
+            break;
+        }
+
+        goto invalid;
+
+    default:
+        goto invalid;
+    }
+
+    if (field->data) {
+        ngx_log_error(NGX_LOG_INFO, hb->request->connection->log, 0,
+                      "client sent duplicate :%V header", &header->name);
+
+        return NGX_DECLINED;
+    }
+
+    if (header->value.len == 0) {
+        ngx_log_error(NGX_LOG_INFO, hb->request->connection->log, 0,
+                      "client sent empty :%V header", &header->name);
+
+        return NGX_DECLINED;
+    }
+
+    *field = header->value;
+
+    return NGX_OK;
+
+invalid:
+
+    ngx_log_error(NGX_LOG_INFO, hb->request->connection->log, 0,
+                  "client sent unknown pseudo-header \":%V\"",
+                  &header->name);
+
+    return NGX_DECLINED;
+}
+
+
+static void
+ngx_http_v2_run_request(ngx_http_v2_header_block_t *hb)
+{
+    ngx_uint_t                  i;
+    ngx_list_part_t            *part;
+    ngx_table_elt_t            *h;
+    ngx_http_header_t          *hh;
+    ngx_http_request_t         *r;
+    ngx_http_core_main_conf_t  *cmcf;
+
+    r = hb->request;
+
+    if (ngx_http_v2_construct_request_line(hb) != NGX_OK) {
+        return;
+    }
+
+    if (ngx_http_process_request_uri(r) != NGX_OK) {
+        return;
+    }
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                   "http2 request line: \"%V\"", &r->request_line);
+
+    if (ngx_http_v2_construct_headers(hb) != NGX_OK) {
+        ngx_http_close_request(r, NGX_HTTP_INTERNAL_SERVER_ERROR);
+        return;
+    }
+
+    cmcf = ngx_http_get_module_main_conf(r, ngx_http_core_module);
+
+    part = &r->headers_in.headers.part;
+    h = part->elts;
+
+    for (i = 0; /* void */; i++) {
+
+        if (i >= part->nelts) {
+            if (part->next == NULL) {
+                break;
+            }
+
+            part = part->next;
+            h = part->elts;
+            i = 0;
+        }
+
+        hh = ngx_hash_find(&cmcf->headers_in_hash, h[i].hash,
+                           h[i].lowcase_key, h[i].key.len);
+
+        if (hh && hh->handler(r, &h[i], hh->offset) != NGX_OK) {
+            return;
+        }
+    }
+
+    r->http_state = NGX_HTTP_PROCESS_REQUEST_STATE;
+
+    if (ngx_http_process_request_header(r) != NGX_OK) {
+        return;
+    }
+
+    if (r->headers_in.content_length_n > 0 && r->stream->in_closed) {
+        ngx_log_error(NGX_LOG_INFO, r->connection->log, 0,
+                      "client prematurely closed stream");
+
+        r->stream->skip_data = 1;
+
+        ngx_http_finalize_request(r, NGX_HTTP_BAD_REQUEST);
+        return;
+    }
+
+    ngx_http_process_request(r);
+}
+
+
+static ngx_int_t
+ngx_http_v2_construct_request_line(ngx_http_v2_header_block_t *hb)
+{
+    u_char              *p;
+    size_t               len;
+    ngx_int_t            rc;
+    ngx_uint_t           i;
+    ngx_http_request_t  *r;
+
+    static const u_char ending[] = " HTTP/2.0" CRLF;
+
+    r = hb->request;
+
+    if (hb->method.len == 0 || hb->scheme.len == 0 || hb->path.len == 0) {
+        ngx_log_error(NGX_LOG_INFO, r->connection->log, 0,
+                      "client sent no :method, :scheme or :path header");
+
+        ngx_http_finalize_request(r, NGX_HTTP_BAD_REQUEST);
+        return NGX_ERROR;
+    }
+
+    for (i = 0; i < hb->path.len; i++) {
+        if (hb->path.data[i] <= 0x20 || hb->path.data[i] == 0x7f) {
+            ngx_log_error(NGX_LOG_INFO, r->connection->log, 0,
+                          "client sent invalid :path header: \"%V\"",
+                          &hb->path);
+
+            ngx_http_finalize_request(r, NGX_HTTP_BAD_REQUEST);
+            return NGX_ERROR;
+        }
+    }
+
+    len = hb->method.len + 1 + hb->path.len + sizeof(ending) - 1;
+
+    r->header_in = ngx_create_temp_buf(r->pool, len);
+    if (r->header_in == NULL) {
+        ngx_http_close_request(r, NGX_HTTP_INTERNAL_SERVER_ERROR);
+        return NGX_ERROR;
+    }
+
+    p = r->header_in->last;
+
+    p = ngx_cpymem(p, hb->method.data, hb->method.len);
+    *p++ = ' ';
+    p = ngx_cpymem(p, hb->path.data, hb->path.len);
+    p = ngx_cpymem(p, ending, sizeof(ending) - 1);
+
+    r->header_in->last = p;
+
+    rc = ngx_http_parse_request_line(r, r->header_in);
+
+    if (rc != NGX_OK) {
+        ngx_log_error(NGX_LOG_INFO, r->connection->log, 0,
+                      "client sent invalid request: \"%*s\"",
+                      len - 2, r->header_in->pos);
+
+        ngx_http_finalize_request(r, NGX_HTTP_BAD_REQUEST);
+        return NGX_ERROR;
+    }
+
+    r->request_line.len = r->request_end - r->request_start;
+    r->request_line.data = r->request_start;
+
+    r->method_name.len = r->method_end - r->request_start + 1;
+    r->method_name.data = r->request_line.data;
+
+    if (r->http_protocol.data) {
+        r->http_protocol.len = r->request_end - r->http_protocol.data;
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_construct_headers(ngx_http_v2_header_block_t *hb)
+{
+    u_char              *p;
+    size_t               len;
+    ngx_str_t           *cookie;
+    ngx_uint_t           i, host;
+    ngx_list_part_t     *part;
+    ngx_table_elt_t     *h;
+    ngx_http_request_t  *r;
+
+    r = hb->request;
+
+    if (hb->cookies.nelts) {
+        cookie = hb->cookies.elts;
+
+        len = 0;
+
+        for (i = 0; i < hb->cookies.nelts; i++) {
+            len += cookie[i].len + 2;
+        }
+
+        p = ngx_pnalloc(r->pool, len - 1);
+        if (p == NULL) {
+            return NGX_ERROR;
+        }
+
+        h = ngx_list_push(&r->headers_in.headers);
+        if (h == NULL) {
+            return NGX_ERROR;
+        }
+
+        ngx_str_set(&h->key, "cookie");
+        h->lowcase_key = h->key.data;
+        h->hash = ngx_hash_key(h->key.data, h->key.len);
+
+        h->value.data = p;
+
+        for (i = 0; i < hb->cookies.nelts; i++) {
+            if (i) {
+                *p++ = ';'; *p++ = ' ';
+            }
+
+            p = ngx_cpymem(p, cookie[i].data, cookie[i].len);
+        }
+
+        *p = '\0';
+        h->value.len = p - h->value.data;
+    }
+
+    if (hb->authority.len == 0) {
+        return NGX_OK;
+    }
+
+    host = 0;
+    part = &r->headers_in.headers.part;
+    h = part->elts;
+
+    for (i = 0; /* void */; i++) {
+
+        if (i >= part->nelts) {
+            if (part->next == NULL) {
+                break;
+            }
+
+            part = part->next;
+            h = part->elts;
+            i = 0;
+        }
+
+        if (h[i].key.len == 4 && ngx_strncmp(h[i].key.data, "host", 4) == 0) {
+            host = 1;
+            break;
+        }
+    }
+
+    if (host) {
+        return NGX_OK;
+    }
+
+    h = ngx_list_push(&r->headers_in.headers);
+    if (h == NULL) {
+        return NGX_ERROR;
+    }
+
+    ngx_str_set(&h->key, "host");
+    h->lowcase_key = h->key.data;
+    h->hash = ngx_hash_key(h->key.data, h->key.len);
+    h->value = hb->authority;
+
+    return NGX_OK;
+}
+
+
+static ngx_http_v2_stream_t *
+ngx_http_v2_create_stream(ngx_http_v2_connection_t *h2c, ngx_uint_t sid)
+{
+    ngx_log_t                      *log;
+    ngx_pool_t                     *pool;
+    ngx_time_t                     *tp;
+    ngx_event_t                    *rev, *wev;
+    ngx_connection_t               *c, *fc;
+    ngx_http_log_ctx_t             *ctx;
+    ngx_http_request_t             *r;
+    ngx_http_v2_stream_t           *stream, **index;
+    ngx_http_v2_srv_conf_t         *h2scf;
+    ngx_http_core_srv_conf_t       *cscf;
+    ngx_http_core_main_conf_t      *cmcf;
+    ngx_http_v2_fake_connection_t  *fake;
+
+    c = h2c->connection;
+
+    cscf = ngx_http_v2_get_module_srv_conf(h2c, ngx_http_core_module);
+    cmcf = ngx_http_v2_get_module_main_conf(h2c, ngx_http_core_module);
+    h2scf = ngx_http_v2_get_module_srv_conf(h2c, ngx_http_v2_module);
+
+    fc = h2c->free_fake_connections;
+
+    if (fc) {
+        h2c->free_fake_connections = fc->data;
+
+    } else {
+        fc = ngx_palloc(c->pool, sizeof(ngx_http_v2_fake_connection_t));
+        if (fc == NULL) {
+            return NULL;
+        }
+    }
+
+    fake = (ngx_http_v2_fake_connection_t *) fc;
+
+    pool = ngx_create_pool(cscf->request_pool_size, c->log);
+    if (pool == NULL) {
+        goto failed;
+    }
+
+    r = ngx_pcalloc(pool, sizeof(ngx_http_request_t));
+    if (r == NULL) {
+        goto failed;
+    }
+
+    stream = ngx_pcalloc(pool, sizeof(ngx_http_v2_stream_t));
+    if (stream == NULL) {
+        goto failed;
+    }
+
+    /* the fake connection stands for the stream in the request */
+
+    log = &fake->log;
+    ctx = &fake->ctx;
+    rev = &fake->read;
+    wev = &fake->write;
+
+    *log = *c->log;
+    log->data = ctx;
+    log->action = "reading client request headers";
+
+    ctx->connection = fc;
+    ctx->request = r;
+    ctx->current_request = r;
+
+    ngx_memzero(rev, sizeof(ngx_event_t));
+
+    rev->data = fc;
+    rev->ready = 1;
+    rev->handler = ngx_http_v2_close_stream_handler;
+    rev->log = log;
+
+    *wev = *rev;
+    wev->write = 1;
+
+    *fc = *c;
+
+    fc->data = r;
+    fc->pool = pool;
+    fc->read = rev;
+    fc->write = wev;
+    fc->log = log;
+    fc->fd = (ngx_socket_t) -1;
+    fc->recv = ngx_http_v2_recv;
+    fc->send_chain = ngx_http_v2_send_chain;
+    fc->buffer = NULL;
+    fc->sent = 0;
+    fc->buffered = 0;
+    fc->sendfile = 0;
+    fc->sndlowat = 1;
+    fc->tcp_nodelay = NGX_TCP_NODELAY_DISABLED;
+    fc->need_last_buf = 1;
+    fc->error = 0;
+    fc->timedout = 0;
+    fc->destroyed = 0;
+    fc->close = 0;
+    fc->idle = 0;
+    fc->reusable = 0;
+
+    r->pool = pool;
+    r->signature = NGX_HTTP_MODULE;
+    r->connection = fc;
+    r->http_connection = h2c->http_connection;
+
+    r->main_conf = h2c->main_conf;
+    r->srv_conf = h2c->srv_conf;
+    r->loc_conf = cscf->ctx->loc_conf;
+    r->virtual_names = h2c->virtual_names;
+
+    r->read_event_handler = ngx_http_block_reading;
+
+    if (ngx_list_init(&r->headers_in.headers, pool, 20,
+                      sizeof(ngx_table_elt_t))
+        != NGX_OK)
+    {
+        goto failed;
+    }
+
+    if (ngx_array_init(&r->headers_in.cookies, pool, 2,
+                       sizeof(ngx_table_elt_t *))
+        != NGX_OK)
+    {
+        goto failed;
+    }
+
+    if (ngx_list_init(&r->headers_out.headers, pool, 20,
+                      sizeof(ngx_table_elt_t))
+        != NGX_OK)
+    {
+        goto failed;
+    }
+
+    r->ctx = ngx_pcalloc(pool, sizeof(void *) * ngx_http_max_module);
+    if (r->ctx == NULL) {
+        goto failed;
+    }
+
+    r->variables = ngx_pcalloc(pool, cmcf->variables.nelts
+                                     * sizeof(ngx_http_variable_value_t));
+    if (r->variables == NULL) {
+        goto failed;
+    }
+
+    r->main = r;
+    r->count = 1;
+
+    tp = ngx_timeofday();
+    r->start_sec = tp->sec;
+    r->start_msec = tp->msec;
+
+    r->method = NGX_HTTP_UNKNOWN;
+
+    r->headers_in.content_length_n = -1;
+    r->headers_in.keep_alive_n = -1;
+    r->headers_out.content_length_n = -1;
+    r->headers_out.last_modified_time = -1;
+
+    r->uri_changes = NGX_HTTP_MAX_URI_CHANGES + 1;
+    r->subrequests = NGX_HTTP_MAX_SUBREQUESTS + 1;
+
+    r->http_state = NGX_HTTP_READING_REQUEST_STATE;
+
+    r->log_handler = ngx_http_log_error_handler;
+
+    /* the response body is copied to the DATA frames */
+    r->main_filter_need_in_memory = 1;
+
+    r->stream = stream;
+
+    stream->request = r;
+    stream->connection = h2c;
+    stream->id = sid;
+    stream->send_window = h2c->init_window;
+    stream->recv_window = h2scf->preread_size;
+
+    index = &h2c->streams_index[sid % NGX_HTTP_V2_STREAMS_INDEX];
+
+    stream->index = *index;
+    *index = stream;
+
+    h2c->processing++;
+
+    c->idle = 0;
+    ngx_reusable_connection(c, 0);
+
+#if (NGX_STAT_STUB)
+    (void) ngx_atomic_fetch_add(ngx_stat_reading, 1);
+    r->stat_reading = 1;
+    (void) ngx_atomic_fetch_add(ngx_stat_requests, 1);
+#endif
+
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "http2 create stream %ui", sid);
+
+    return stream;
+
+failed:
+
+    if (pool) {
+        ngx_destroy_pool(pool);
+    }
+
+    fc->data = h2c->free_fake_connections;
+    h2c->free_fake_connections = fc;
+
+    return NULL;
+}
+
+
+static ngx_http_v2_stream_t *
+ngx_http_v2_get_stream(ngx_http_v2_connection_t *h2c, ngx_uint_t sid)
+{
+    ngx_http_v2_stream_t  *stream;
+
+    stream = h2c->streams_index[sid % NGX_HTTP_V2_STREAMS_INDEX];
+
+    while (stream) {
+        if (stream->id == sid) {
+            return stream;
+        }
+
+        stream = stream->index;
+    }
+
+    return NULL;
+}
+
+
+/*
+ * a stream is terminated through its fake connection: the request handlers
+ * see the error on the next event and finalize the request as usual
+ */
+
+static void
+ngx_http_v2_terminate_stream(ngx_http_v2_connection_t *h2c,
+    ngx_http_v2_stream_t *stream, ngx_uint_t status)
+{
+    ngx_connection_t  *fc;
+
+    fc = stream->request->connection;
+
+    if (!stream->rst_sent) {
+        if (ngx_http_v2_send_rst_stream(h2c, stream->id, status) != NGX_OK) {
+            h2c->connection->error = 1;
+        }
+
+        stream->rst_sent = 1;
+    }
+
+    stream->in_closed = 1;
+    stream->out_closed = 1;
+    stream->skip_data = 1;
+
+    fc->error = 1;
+
+    ngx_post_event(fc->read, &ngx_posted_events);
+    ngx_post_event(fc->write, &ngx_posted_events);
+}
+
+
+static void
+ngx_http_v2_close_stream_handler(ngx_event_t *ev)
+{
+    ngx_connection_t    *fc;
+    ngx_http_request_t  *r;
+
+    fc = ev->data;
+    r = fc->data;
+
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, fc->log, 0,
+                   "http2 close stream handler");
+
+    if (ev->timedout) {
+        ngx_log_error(NGX_LOG_INFO, fc->log, NGX_ETIMEDOUT,
+                      "client timed out");
+
+        fc->timedout = 1;
+    }
+
+    ngx_http_v2_close_stream(r->stream, 0);
+}
+
+
+void
+ngx_http_v2_close_stream(ngx_http_v2_stream_t *stream, ngx_int_t rc)
+{
+    ngx_event_t               *ev;
+    ngx_connection_t          *fc;
+    ngx_http_request_t        *r;
+    ngx_http_v2_stream_t     **index;
+    ngx_http_v2_connection_t  *h2c;
+
+    h2c = stream->connection;
+    r = stream->request;
+    fc = r->connection;
+
+    ngx_log_debug3(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                   "http2 close stream %ui, queued %ui, processing %ui",
+                   stream->id, stream->queued, h2c->processing);
+
+    if (stream->queued) {
+        /* the stream is closed once its frames are sent */
+        fc->write->handler = ngx_http_v2_close_stream_handler;
+        fc->read->handler = ngx_http_empty_handler;
+        return;
+    }
+
+    if (!stream->rst_sent && !h2c->connection->error) {
+
+        if (!stream->out_closed) {
+            (void) ngx_http_v2_send_rst_stream(h2c, stream->id,
+                                           fc->timedout
+                                           ? NGX_HTTP_V2_PROTOCOL_ERROR
+                                           : NGX_HTTP_V2_INTERNAL_ERROR);
+
+        } else if (!stream->in_closed) {
+            (void) ngx_http_v2_send_rst_stream(h2c, stream->id,
+                                               NGX_HTTP_V2_NO_ERROR);
+        }
+    }
+
+    index = &h2c->streams_index[stream->id % NGX_HTTP_V2_STREAMS_INDEX];
+
+    while (*index) {
+        if (*index == stream) {
+            *index = stream->index;
+            break;
+        }
+
+        index = &(*index)->index;
+    }
+
+    if (stream->waiting) {
+        ngx_queue_remove(&stream->queue);
+    }
+
+    h2c->processing--;
+
+    /* the request pool with the stream is destroyed here */
+
+    ngx_http_free_request(r, rc);
+
+    ev = fc->read;
+
+    if (ev->timer_set) {
+        ngx_del_timer(ev);
+    }
+
+    if (ev->prev) {
+        ngx_delete_posted_event(ev);
+    }
+
+    ev = fc->write;
+
+    if (ev->timer_set) {
+        ngx_del_timer(ev);
+    }
+
+    if (ev->prev) {
+        ngx_delete_posted_event(ev);
+    }
+
+    fc->data = h2c->free_fake_connections;
+    h2c->free_fake_connections = fc;
+
+    ngx_post_event(h2c->connection->write, &ngx_posted_events);
+}
+
+
+static ssize_t
+ngx_http_v2_recv(ngx_connection_t *fc, u_char *buf, size_t size)
+{
+    ngx_log_error(NGX_LOG_ALERT, fc->log, 0,
+                  "http2 stream connection is not readable");
+
+    return NGX_ERROR;
+}
+
+
+ngx_int_t
+ngx_http_v2_read_request_body(ngx_http_request_t *r,
+    ngx_http_client_body_handler_pt post_handler)
+{
+    off_t                      len;
+    size_t                     size;
+    ngx_buf_t                 *preread;
+    ngx_int_t                  rc;
+    ngx_http_v2_stream_t      *stream;
+    ngx_http_request_body_t   *rb;
+    ngx_http_core_loc_conf_t  *clcf;
+
+    stream = r->stream;
+
+    rb = ngx_pcalloc(r->pool, sizeof(ngx_http_request_body_t));
+    if (rb == NULL) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+
+    r->request_body = rb;
+
+    len = r->headers_in.content_length_n;
+
+    if (stream->skip_data
+        || len == 0
+        || (stream->in_closed && stream->preread == NULL))
+    {
+        stream->skip_data = 1;
+        post_handler(r);
+        return NGX_OK;
+    }
+
+    clcf = ngx_http_get_module_loc_conf(r, ngx_http_core_module);
+
+    size = clcf->client_body_buffer_size;
+
+    if (len > 0 && len < (off_t) size) {
+        size = (size_t) len;
+    }
+
+    rb->buf = ngx_create_temp_buf(r->pool, size);
+    if (rb->buf == NULL) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+
+    rb->bufs = ngx_alloc_chain_link(r->pool);
+    if (rb->bufs == NULL) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+
+    rb->bufs->buf = rb->buf;
+    rb->bufs->next = NULL;
+
+    rb->rest = (len > 0) ? len : 0;
+    rb->post_handler = post_handler;
+
+    r->read_event_handler = ngx_http_v2_read_client_request_body_handler;
+
+    preread = stream->preread;
+    stream->preread = NULL;
+
+    if (preread) {
+        rc = ngx_http_v2_process_request_body(r, preread->pos,
+                                              preread->last - preread->pos,
+                                              stream->in_closed);
+    } else {
+        rc = ngx_http_v2_process_request_body(r, NULL, 0, 0);
+    }
+
+    if (rc == NGX_ERROR) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+
+    if (rc >= NGX_HTTP_SPECIAL_RESPONSE) {
+        stream->skip_data = 1;
+        return rc;
+    }
+
+    if (ngx_http_v2_send_output_queue(stream->connection) == NGX_ERROR) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+
+    return rc;
+}
+
+
+static ngx_int_t
+ngx_http_v2_process_request_body(ngx_http_request_t *r, u_char *pos,
+    size_t size, ngx_uint_t last)
+{
+    size_t                     n;
+    ngx_buf_t                 *b, *buf;
+    ngx_table_elt_t           *h;
+    ngx_connection_t          *fc;
+    ngx_http_v2_stream_t      *stream;
+    ngx_http_request_body_t   *rb;
+    ngx_http_core_loc_conf_t  *clcf;
+
+    fc = r->connection;
+    rb = r->request_body;
+    buf = rb->buf;
+    stream = r->stream;
+
+    clcf = ngx_http_get_module_loc_conf(r, ngx_http_core_module);
+
+    if (size) {
+        stream->received += size;
+
+        if (r->headers_in.content_length_n >= 0) {
+
+            if (stream->received > r->headers_in.content_length_n) {
+                ngx_log_error(NGX_LOG_INFO, fc->log, 0,
+                              "client intended to send body data "
+                              "larger than declared");
+
+                return NGX_HTTP_BAD_REQUEST;
+            }
+
+            rb->rest = r->headers_in.content_length_n - stream->received;
+
+        } else if (clcf->client_max_body_size
+                   && stream->received > clcf->client_max_body_size)
+        {
+            ngx_log_error(NGX_LOG_ERR, fc->log, 0,
+                          "client intended to send too large body: "
+                          "%O bytes", stream->received);
+
+            return NGX_HTTP_REQUEST_ENTITY_TOO_LARGE;
+        }
+
+        r->request_length += size;
+
+        while (size) {
+
+            if (buf->last == buf->end) {
+
+                if (ngx_http_write_request_body(r, rb->bufs) != NGX_OK) {
+                    return NGX_HTTP_INTERNAL_SERVER_ERROR;
+                }
+
+                buf->pos = buf->start;
+                buf->last = buf->start;
+            }
+
+            n = ngx_min(size, (size_t) (buf->end - buf->last));
+
+            buf->last = ngx_cpymem(buf->last, pos, n);
+            pos += n;
+            size -= n;
+        }
+    }
+
+    if (!last) {
+        ngx_add_timer(fc->read, clcf->client_body_timeout);
+
+        if (ngx_http_v2_update_stream_window(stream->connection, stream)
+            != NGX_OK)
+        {
+            return NGX_ERROR;
+        }
+
+        return NGX_AGAIN;
+    }
+
+    if (fc->read->timer_set) {
+        ngx_del_timer(fc->read);
+    }
+
+    if (r->headers_in.content_length_n < 0) {
+
+        /* the body length becomes known with the END_STREAM flag */
+
+        h = ngx_list_push(&r->headers_in.headers);
+        if (h == NULL) {
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
+
+        h->value.data = ngx_pnalloc(r->pool, NGX_OFF_T_LEN + 1);
+        if (h->value.data == NULL) {
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
+
+        ngx_str_set(&h->key, "content-length");
+        h->lowcase_key = h->key.data;
+        h->hash = ngx_hash_key(h->key.data, h->key.len);
+
+        h->value.len = ngx_sprintf(h->value.data, "%O", stream->received)
+                       - h->value.data;
+        h->value.data[h->value.len] = '\0';
+
+        r->headers_in.content_length = h;
+        r->headers_in.content_length_n = stream->received;
+
+    } else if (stream->received != r->headers_in.content_length_n) {
+        ngx_log_error(NGX_LOG_INFO, fc->log, 0,
+                      "client prematurely closed stream: only %O out of %O "
+                      "bytes of request body received",
+                      stream->received, r->headers_in.content_length_n);
+
+        return NGX_HTTP_BAD_REQUEST;
+    }
+
+    if (rb->temp_file || r->request_body_in_file_only) {
+
+        /* save the last part */
+
+        if (ngx_http_write_request_body(r, rb->bufs) != NGX_OK) {
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
+
+        b = ngx_calloc_buf(r->pool);
+        if (b == NULL) {
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
+
+        b->in_file = 1;
+        b->file_pos = 0;
+        b->file_last = rb->temp_file->file.offset;
+        b->file = &rb->temp_file->file;
+
+        rb->bufs->buf = b;
+    }
+
+    rb->rest = 0;
+
+    r->read_event_handler = ngx_http_block_reading;
+
+    rb->post_handler(r);
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_http_v2_read_client_request_body_handler(ngx_http_request_t *r)
+{
+    ngx_connection_t  *fc;
+
+    fc = r->connection;
+
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, fc->log, 0,
+                   "http2 read client request body handler");
+
+    if (fc->read->timedout) {
+        ngx_log_error(NGX_LOG_INFO, fc->log, NGX_ETIMEDOUT,
+                      "client timed out");
+
+        fc->timedout = 1;
+        r->stream->skip_data = 1;
+
+        ngx_http_finalize_request(r, NGX_HTTP_REQUEST_TIME_OUT);
+        return;
+    }
+
+    if (fc->error) {
+        ngx_log_error(NGX_LOG_INFO, fc->log, 0,
+                      "client prematurely closed stream");
+
+        ngx_http_finalize_request(r, NGX_HTTP_CLIENT_CLOSED_REQUEST);
+        return;
+    }
+}
+
+
+static ngx_int_t
+ngx_http_v2_update_stream_window(ngx_http_v2_connection_t *h2c,
+    ngx_http_v2_stream_t *stream)
+{
+    size_t                     window;
+    ngx_http_v2_srv_conf_t    *h2scf;
+    ngx_http_core_loc_conf_t  *clcf;
+
+    if (stream->in_closed) {
+        return NGX_OK;
+    }
+
+    h2scf = ngx_http_v2_get_module_srv_conf(h2c, ngx_http_v2_module);
+    clcf = ngx_http_get_module_loc_conf(stream->request, ngx_http_core_module);
+
+    /* the body is buffered in memory or written to a file at once */
+
+    window = ngx_max(h2scf->preread_size, clcf->client_body_buffer_size);
+
+    if (stream->recv_window >= window / 2) {
+        return NGX_OK;
+    }
+
+    if (ngx_http_v2_send_window_update(h2c, stream->id,
+                                       window - stream->recv_window)
+        != NGX_OK)
+    {
+        return NGX_ERROR;
+    }
+
+    stream->recv_window = window;
+
+    return NGX_OK;
+}
+
+
+static ngx_http_v2_out_frame_t *
+ngx_http_v2_get_frame(ngx_http_v2_connection_t *h2c, size_t length,
+    ngx_uint_t type, ngx_uint_t flags, ngx_uint_t sid)
+{
+    u_char                   *p;
+    ngx_http_v2_out_frame_t  *frame;
+
+    frame = h2c->free_frames;
+
+    if (frame) {
+        h2c->free_frames = frame->next;
+
+    } else {
+        frame = ngx_palloc(h2c->connection->pool,
+                           sizeof(ngx_http_v2_out_frame_t)
+                           + NGX_HTTP_V2_FRAME_HEADER_SIZE
+                           + NGX_HTTP_V2_CONTROL_FRAME_SIZE);
+        if (frame == NULL) {
+            return NULL;
+        }
+    }
+
+    p = (u_char *) frame + sizeof(ngx_http_v2_out_frame_t);
+
+    ngx_memzero(&frame->buf, sizeof(ngx_buf_t));
+
+    frame->buf.start = p;
+    frame->buf.pos = p;
+    frame->buf.end = p + NGX_HTTP_V2_FRAME_HEADER_SIZE
+                     + NGX_HTTP_V2_CONTROL_FRAME_SIZE;
+    frame->buf.temporary = 1;
+
+    frame->buf.last = ngx_http_v2_write_frame_head(p, length, type, flags,
+                                                   sid);
+
+    frame->chain.buf = &frame->buf;
+    frame->next = NULL;
+    frame->stream = NULL;
+    frame->control = 1;
+    frame->data = 0;
+
+    return frame;
+}
+
+
+static ngx_int_t
+ngx_http_v2_send_settings(ngx_http_v2_connection_t *h2c)
+{
+    u_char                   *p;
+    ngx_http_v2_srv_conf_t   *h2scf;
+    ngx_http_v2_out_frame_t  *frame;
+
+    h2scf = ngx_http_v2_get_module_srv_conf(h2c, ngx_http_v2_module);
+
+    frame = ngx_http_v2_get_frame(h2c, 2 * NGX_HTTP_V2_SETTINGS_PARAM_SIZE,
+                                  NGX_HTTP_V2_SETTINGS_FRAME,
+                                  NGX_HTTP_V2_NO_FLAG, 0);
+    if (frame == NULL) {
+        return NGX_ERROR;
+    }
+
+    p = frame->buf.last;
+
+    p = ngx_http_v2_write_uint16(p, NGX_HTTP_V2_MAX_STREAMS);
+    p = ngx_http_v2_write_uint32(p, h2scf->concurrent_streams);
+
+    p = ngx_http_v2_write_uint16(p, NGX_HTTP_V2_INIT_WINDOW_SIZE);
+    p = ngx_http_v2_write_uint32(p, h2scf->preread_size);
+
+    frame->buf.last = p;
+
+    ngx_http_v2_queue_frame(h2c, frame);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_send_window_update(ngx_http_v2_connection_t *h2c, ngx_uint_t sid,
+    size_t window)
+{
+    ngx_http_v2_out_frame_t  *frame;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                   "http2 send WINDOW_UPDATE sid:%ui window:%uz",
+                   sid, window);
+
+    frame = ngx_http_v2_get_frame(h2c, 4, NGX_HTTP_V2_WINDOW_UPDATE_FRAME,
+                                  NGX_HTTP_V2_NO_FLAG, sid);
+    if (frame == NULL) {
+        return NGX_ERROR;
+    }
+
+    frame->buf.last = ngx_http_v2_write_uint32(frame->buf.last, window);
+
+    ngx_http_v2_queue_frame(h2c, frame);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_send_rst_stream(ngx_http_v2_connection_t *h2c, ngx_uint_t sid,
+    ngx_uint_t status)
+{
+    ngx_http_v2_out_frame_t  *frame;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                   "http2 send RST_STREAM sid:%ui status:%ui",
+                   sid, status);
+
+    frame = ngx_http_v2_get_frame(h2c, 4, NGX_HTTP_V2_RST_STREAM_FRAME,
+                                  NGX_HTTP_V2_NO_FLAG, sid);
+    if (frame == NULL) {
+        return NGX_ERROR;
+    }
+
+    frame->buf.last = ngx_http_v2_write_uint32(frame->buf.last, status);
+
+    ngx_http_v2_queue_frame(h2c, frame);
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_send_goaway(ngx_http_v2_connection_t *h2c, ngx_uint_t status)
+{
+    u_char                   *p;
+    ngx_http_v2_out_frame_t  *frame;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                   "http2 send GOAWAY last sid:%ui status:%ui",
+                   h2c->last_sid, status);
+
+    frame = ngx_http_v2_get_frame(h2c, 8, NGX_HTTP_V2_GOAWAY_FRAME,
+                                  NGX_HTTP_V2_NO_FLAG, 0);
+    if (frame == NULL) {
+        return NGX_ERROR;
+    }
+
+    p = frame->buf.last;
+
+    p = ngx_http_v2_write_sid(p, h2c->last_sid);
+    p = ngx_http_v2_write_uint32(p, status);
+
+    frame->buf.last = p;
+
+    ngx_http_v2_queue_frame(h2c, frame);
+
+    return NGX_OK;
+}
+
+
+u_char *
+ngx_http_v2_write_frame_head(u_char *p, size_t length, ngx_uint_t type,
+    ngx_uint_t flags, ngx_uint_t sid)
+{
+    *p++ = (u_char) (length >> 16);
+    *p++ = (u_char) (length >> 8);
+    *p++ = (u_char) length;
+    *p++ = (u_char) type;
+    *p++ = (u_char) flags;
+
+    return ngx_http_v2_write_sid(p, sid);
+}
+
+
+void
+ngx_http_v2_queue_frame(ngx_http_v2_connection_t *h2c,
+    ngx_http_v2_out_frame_t *frame)
+{
+    frame->next = NULL;
+
+    *h2c->last_out = frame;
+    h2c->last_out = &frame->next;
+}
+
+
+ngx_int_t
+ngx_http_v2_send_output_queue(ngx_http_v2_connection_t *h2c)
+{
+    ngx_event_t               *wev;
+    ngx_chain_t               *cl;
+    ngx_connection_t          *c;
+    ngx_http_v2_out_frame_t   *frame, *next;
+    ngx_http_core_srv_conf_t  *cscf;
+    ngx_http_core_loc_conf_t  *clcf;
+
+    c = h2c->connection;
+    wev = c->write;
+
+    if (h2c->out == NULL) {
+        return NGX_OK;
+    }
+
+    if (c->error) {
+        return NGX_ERROR;
+    }
+
+    if (!wev->ready) {
+        return NGX_AGAIN;
+    }
+
+    for (frame = h2c->out; frame->next; frame = frame->next) {
+        frame->chain.next = &frame->next->chain;
+    }
+
+    frame->chain.next = NULL;
+    frame->buf.flush = 1;
+
+    cl = c->send_chain(c, &h2c->out->chain, 0);
+
+    if (cl == NGX_CHAIN_ERROR) {
+        goto error;
+    }
+
+    for (frame = h2c->out; frame; frame = next) {
+
+        if (frame->buf.pos != frame->buf.last) {
+            break;
+        }
+
+        next = frame->next;
+
+        ngx_http_v2_frame_sent(h2c, frame);
+    }
+
+    h2c->out = frame;
+
+    if (frame == NULL) {
+        h2c->last_out = &h2c->out;
+
+        if (wev->timer_set) {
+            ngx_del_timer(wev);
+        }
+
+        return NGX_OK;
+    }
+
+    cscf = ngx_http_v2_get_module_srv_conf(h2c, ngx_http_core_module);
+    clcf = cscf->ctx->loc_conf[ngx_http_core_module.ctx_index];
+
+    ngx_add_timer(wev, clcf->send_timeout);
+
+    if (ngx_handle_write_event(wev, 0) != NGX_OK) {
+        goto error;
+    }
+
+    return NGX_AGAIN;
+
+error:
+
+    /* the connection is finalized by its write handler */
+
+    c->error = 1;
+
+    ngx_post_event(wev, &ngx_posted_events);
+
+    return NGX_ERROR;
+}
+
+
+static void
+ngx_http_v2_frame_sent(ngx_http_v2_connection_t *h2c,
+    ngx_http_v2_out_frame_t *frame)
+{
+    ngx_connection_t      *fc;
+    ngx_http_v2_stream_t  *stream;
+
+    stream = frame->stream;
+
+    if (frame->control) {
+        frame->next = h2c->free_frames;
+        h2c->free_frames = frame;
+
+    } else if (frame->data) {
+        frame->next = h2c->free_data_frames;
+        h2c->free_data_frames = frame;
+    }
+
+    if (stream == NULL) {
+        return;
+    }
+
+    stream->queued--;
+
+    fc = stream->request->connection;
+
+    if (stream->blocked
+        || (stream->queued == 0
+            && ((fc->buffered & NGX_HTTP_V2_BUFFERED)
+                || fc->write->handler == ngx_http_v2_close_stream_handler)))
+    {
+        stream->blocked = 0;
+        ngx_post_event(fc->write, &ngx_posted_events);
+    }
+}
+
+
+static void
+ngx_http_v2_wake_streams(ngx_http_v2_connection_t *h2c)
+{
+    ngx_queue_t           *q;
+    ngx_http_v2_stream_t  *stream;
+
+    while (!ngx_queue_empty(&h2c->waiting)) {
+        q = ngx_queue_head(&h2c->waiting);
+        ngx_queue_remove(q);
+
+        stream = ngx_queue_data(q, ngx_http_v2_stream_t, queue);
+        stream->waiting = 0;
+
+        ngx_post_event(stream->request->connection->write,
+                       &ngx_posted_events);
+    }
+}
+
+
+ngx_chain_t *
+ngx_http_v2_send_chain(ngx_connection_t *fc, ngx_chain_t *in, off_t limit)
+{
+    u_char                    *p;
+    off_t                      sent;
+    size_t                     size, n, len, frame_size;
+    ssize_t                    window, nread;
+    ngx_buf_t                 *b;
+    ngx_uint_t                 fin;
+    ngx_http_request_t        *r;
+    ngx_http_v2_stream_t      *stream;
+    ngx_http_v2_loc_conf_t    *h2lcf;
+    ngx_http_v2_out_frame_t   *frame;
+    ngx_http_v2_connection_t  *h2c;
+
+    r = fc->data;
+    stream = r->stream;
+    h2c = stream->connection;
+
+    if (fc->error) {
+        return NGX_CHAIN_ERROR;
+    }
+
+    h2lcf = ngx_http_get_module_loc_conf(r, ngx_http_v2_module);
+
+    frame_size = ngx_min(h2lcf->chunk_size, h2c->frame_size);
+    frame_size = ngx_min(frame_size, NGX_HTTP_V2_DEFAULT_FRAME_SIZE);
+
+    sent = 0;
+    fin = 0;
+
+    for ( ;; ) {
+
+        while (in && ngx_buf_size(in->buf) == 0) {
+            if (in->buf->last_buf) {
+                fin = 1;
+            }
+
+            in = in->next;
+        }
+
+        if (stream->out_closed) {
+
+            /* a response to HEAD, or a reset stream */
+
+            for ( /* void */ ; in; in = in->next) {
+                b = in->buf;
+
+                if (ngx_buf_in_memory(b)) {
+                    b->pos = b->last;
+                }
+
+                if (b->in_file) {
+                    b->file_pos = b->file_last;
+                }
+            }
+
+            break;
+        }
+
+        if (in == NULL && !fin) {
+            break;
+        }
+
+        size = 0;
+
+        if (in) {
+
+            if (limit && sent >= limit) {
+                break;
+            }
+
+            if (stream->queued >= NGX_HTTP_V2_MAX_QUEUED) {
+                stream->blocked = 1;
+                break;
+            }
+
+            window = ngx_min(stream->send_window, (ssize_t) h2c->send_window);
+
+            if (window <= 0) {
+
+                ngx_log_debug1(NGX_LOG_DEBUG_HTTP, fc->log, 0,
+                               "http2 stream %ui is blocked by flow control",
+                               stream->id);
+
+                if (!stream->waiting) {
+                    ngx_queue_insert_tail(&h2c->waiting, &stream->queue);
+                    stream->waiting = 1;
+                }
+
+                break;
+            }
+
+            size = ngx_min((size_t) window, frame_size);
+
+            if (limit && (off_t) size > limit - sent) {
+                size = (size_t) (limit - sent);
+            }
+        }
+
+        frame = h2c->free_data_frames;
+
+        if (frame) {
+            h2c->free_data_frames = frame->next;
+
+        } else {
+            frame = ngx_palloc(h2c->connection->pool,
+                               sizeof(ngx_http_v2_out_frame_t)
+                               + NGX_HTTP_V2_FRAME_BUFFER_SIZE);
+            if (frame == NULL) {
+                return NGX_CHAIN_ERROR;
+            }
+        }
+
+        ngx_memzero(&frame->buf, sizeof(ngx_buf_t));
+
+        frame->buf.start = (u_char *) frame + sizeof(ngx_http_v2_out_frame_t);
+        frame->buf.pos = frame->buf.start;
+        frame->buf.end = frame->buf.start + NGX_HTTP_V2_FRAME_BUFFER_SIZE;
+        frame->buf.temporary = 1;
+
+        frame->chain.buf = &frame->buf;
+        frame->stream = stream;
+        frame->control = 0;
+        frame->data = 1;
+
+        p = frame->buf.pos + NGX_HTTP_V2_FRAME_HEADER_SIZE;
+        n = 0;
+
+        while (in && n < size) {
+            b = in->buf;
+
+            len = (size_t) ngx_min(ngx_buf_size(b), (off_t) (size - n));
+
+            if (ngx_buf_in_memory(b)) {
+                p = ngx_cpymem(p, b->pos, len);
+                b->pos += len;
+
+            } else {
+                nread = ngx_read_file(b->file, p, len, b->file_pos);
+
+                if (nread != (ssize_t) len) {
+                    if (nread != NGX_ERROR) {
+                        ngx_log_error(NGX_LOG_ALERT, fc->log, 0,
+                                      ngx_read_file_n " read only %z of %uz "
+                                      "from \"%s\"", nread, len,
+                                      b->file->name.data);
+                    }
+
+                    return NGX_CHAIN_ERROR;
+                }
+
+                p += len;
+            }
+
+            if (b->in_file) {
+                b->file_pos += len;
+            }
+
+            n += len;
+
+            while (in && ngx_buf_size(in->buf) == 0) {
+                if (in->buf->last_buf) {
+                    fin = 1;
+                }
+
+                in = in->next;
+            }
+        }
+
+        frame->buf.last = p;
+
+        fin = (fin && in == NULL);
+
+        (void) ngx_http_v2_write_frame_head(frame->buf.pos, n,
+                                            NGX_HTTP_V2_DATA_FRAME,
+                                            fin ? NGX_HTTP_V2_END_STREAM_FLAG
+                                                : NGX_HTTP_V2_NO_FLAG,
+                                            stream->id);
+
+        ngx_log_debug3(NGX_LOG_DEBUG_HTTP, fc->log, 0,
+                       "http2 DATA frame sid:%ui l:%uz fin:%ui",
+                       stream->id, n, fin);
+
+        stream->send_window -= n;
+        h2c->send_window -= n;
+
+        sent += n;
+        fc->sent += n;
+
+        stream->queued++;
+        ngx_http_v2_queue_frame(h2c, frame);
+
+        if (fin) {
+            stream->out_closed = 1;
+        }
+    }
+
+    if (ngx_http_v2_send_output_queue(h2c) == NGX_ERROR) {
+        fc->error = 1;
+        return NGX_CHAIN_ERROR;
+    }
+
+    if (in || stream->queued) {
+        fc->buffered |= NGX_HTTP_V2_BUFFERED;
+
+    } else {
+        fc->buffered &= ~NGX_HTTP_V2_BUFFERED;
+    }
+
+    return in;
+}
+
+
+static void
+ngx_http_v2_finalize_connection(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t status)
+{
+    ngx_uint_t             i;
+    ngx_event_t           *ev;
+    ngx_connection_t      *c, *fc;
+    ngx_http_v2_stream_t  *stream, *next;
+
+    c = h2c->connection;
+
+    if (h2c->closing) {
+        return;
+    }
+
+    h2c->closing = 1;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, c->log, 0,
+                   "http2 finalize connection, status:%ui processing:%ui",
+                   status, h2c->processing);
+
+    if (!c->error && !c->timedout
+        && ngx_http_v2_send_goaway(h2c, status) == NGX_OK)
+    {
+        (void) ngx_http_v2_send_output_queue(h2c);
+    }
+
+    c->error = 1;
+
+    h2c->out = NULL;
+    h2c->last_out = &h2c->out;
+
+    if (c->read->timer_set) {
+        ngx_del_timer(c->read);
+    }
+
+    if (c->write->timer_set) {
+        ngx_del_timer(c->write);
+    }
+
+    /* each request sees the error and closes its stream */
+
+    for (i = 0; i < NGX_HTTP_V2_STREAMS_INDEX; i++) {
+
+        for (stream = h2c->streams_index[i]; stream; stream = next) {
+            next = stream->index;
+
+            fc = stream->request->connection;
+            fc->error = 1;
+
+            stream->rst_sent = 1;
+
+            if (stream->waiting) {
+                ngx_queue_remove(&stream->queue);
+                stream->waiting = 0;
+            }
+
+            if (stream->queued || stream->blocked) {
+                stream->queued = 0;
+                stream->blocked = 0;
+                ev = fc->write;
+
+            } else {
+                ev = fc->read;
+            }
+
+            ev->eof = 1;
+            ev->handler(ev);
+        }
+    }
+
+    if (h2c->processing == 0) {
+        ngx_http_close_connection(c);
+    }
+}
+
+
+static void
+ngx_http_v2_pool_cleanup(void *data)
+{
+    ngx_http_v2_connection_t  *h2c = data;
+
+    if (h2c->buffer) {
+        ngx_free(h2c->buffer);
+    }
+
+    if (h2c->header_block) {
+        ngx_free(h2c->header_block);
+    }
+
+    ngx_http_v2_table_cleanup(&h2c->hpack);
+}
+
+
+static ngx_int_t
+ngx_http_v2_add_variables(ngx_conf_t *cf)
+{
+    ngx_http_variable_t  *var, *v;
+
+    for (v = ngx_http_v2_vars; v->name.len; v++) {
+        var = ngx_http_add_variable(cf, &v->name, v->flags);
+        if (var == NULL) {
+            return NGX_ERROR;
+        }
+
+        var->get_handler = v->get_handler;
+        var->data = v->data;
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_variable(ngx_http_request_t *r, ngx_http_variable_value_t *v,
+    uintptr_t data)
+{
+    if (r->stream == NULL) {
+        *v = ngx_http_variable_null_value;
+        return NGX_OK;
+    }
+
+#if (NGX_HTTP_SSL)
+
+    if (r->connection->ssl) {
+        v->len = sizeof("h2") - 1;
+        v->data = (u_char *) "h2";
+
+    } else
+
+#endif
+    {
+        v->len = sizeof("h2c") - 1;
+        v->data = (u_char *) "h2c";
+    }
+
+    v->valid = 1;
+    v->no_cacheable = 0;
+    v->not_found = 0;
+
+    return NGX_OK;
+}
+
+
+static void *
+ngx_http_v2_create_main_conf(ngx_conf_t *cf)
+{
+    ngx_http_v2_main_conf_t  *h2mcf;
+
+    h2mcf = ngx_pcalloc(cf->pool, sizeof(ngx_http_v2_main_conf_t));
+    if (h2mcf == NULL) {
+        return NULL;
+    }
+
+    h2mcf->recv_buffer_size = NGX_CONF_UNSET_SIZE;
+
+    return h2mcf;
+}
+
+
+static char *
+ngx_http_v2_init_main_conf(ngx_conf_t *cf, void *conf)
+{
+    ngx_http_v2_main_conf_t *h2mcf = conf;
+
+    ngx_conf_init_size_value(h2mcf->recv_buffer_size, 256 * 1024);
+
+    return NGX_CONF_OK;
+}
+
+
+static void *
+ngx_http_v2_create_srv_conf(ngx_conf_t *cf)
+{
+    ngx_http_v2_srv_conf_t  *h2scf;
+
+    h2scf = ngx_pcalloc(cf->pool, sizeof(ngx_http_v2_srv_conf_t));
+    if (h2scf == NULL) {
+        return NULL;
+    }
+
+    h2scf->concurrent_streams = NGX_CONF_UNSET_UINT;
+    h2scf->preread_size = NGX_CONF_UNSET_SIZE;
+    h2scf->max_field_size = NGX_CONF_UNSET_SIZE;
+    h2scf->max_header_size = NGX_CONF_UNSET_SIZE;
+    h2scf->recv_timeout = NGX_CONF_UNSET_MSEC;
+    h2scf->idle_timeout = NGX_CONF_UNSET_MSEC;
+
+    return h2scf;
+}
+
+
+static char *
+ngx_http_v2_merge_srv_conf(ngx_conf_t *cf, void *parent, void *child)
+{
+    ngx_http_v2_srv_conf_t *prev = parent;
+    ngx_http_v2_srv_conf_t *conf = child;
+
+    ngx_conf_merge_uint_value(conf->concurrent_streams,
+                              prev->concurrent_streams, 128);
+    ngx_conf_merge_size_value(conf->preread_size, prev->preread_size,
+                              65536);
+    ngx_conf_merge_size_value(conf->max_field_size, prev->max_field_size,
+                              4096);
+    ngx_conf_merge_size_value(conf->max_header_size, prev->max_header_size,
+                              16384);
+    ngx_conf_merge_msec_value(conf->recv_timeout, prev->recv_timeout,
+                              30000);
+    ngx_conf_merge_msec_value(conf->idle_timeout, prev->idle_timeout,
+                              180000);
+
+    return NGX_CONF_OK;
+}
+
+
+static void *
+ngx_http_v2_create_loc_conf(ngx_conf_t *cf)
+{
+    ngx_http_v2_loc_conf_t  *h2lcf;
+
+    h2lcf = ngx_pcalloc(cf->pool, sizeof(ngx_http_v2_loc_conf_t));
+    if (h2lcf == NULL) {
+        return NULL;
+    }
+
+    h2lcf->chunk_size = NGX_CONF_UNSET_SIZE;
+
+    return h2lcf;
+}
+
+
+static char *
+ngx_http_v2_merge_loc_conf(ngx_conf_t *cf, void *parent, void *child)
+{
+    ngx_http_v2_loc_conf_t *prev = parent;
+    ngx_http_v2_loc_conf_t *conf = child;
+
+    ngx_conf_merge_size_value(conf->chunk_size, prev->chunk_size, 8 * 1024);
+
+    return NGX_CONF_OK;
+}
+
+
+static char *
+ngx_http_v2_recv_buffer_size(ngx_conf_t *cf, void *post, void *data)
+{
+    size_t *sp = data;
+
+    if (*sp < 2 * NGX_HTTP_V2_FRAME_BUFFER_SIZE) {
+        return "value is too small";
+    }
+
+    return NGX_CONF_OK;
+}
+
+
+static char *
+ngx_http_v2_preread_size(ngx_conf_t *cf, void *post, void *data)
+{
+    size_t *sp = data;
+
+    if (*sp > NGX_HTTP_V2_MAX_WINDOW) {
+        return "value is too large";
+    }
+
+    return NGX_CONF_OK;
+}
+
+
+static char *
+ngx_http_v2_chunk_size(ngx_conf_t *cf, void *post, void *data)
+{
+    size_t *sp = data;
+
+    if (*sp == 0) {
+        return "value is too small";
+    }
+
+    return NGX_CONF_OK;
+}
@@ -0,0 +1,235 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#ifndef _NGX_HTTP_V2_H_INCLUDED_
+#define _NGX_HTTP_V2_H_INCLUDED_
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+#define NGX_HTTP_V2_ALPN_ADVERTISE       "\x02h2\x08http/1.1"
+
+#define NGX_HTTP_V2_FRAME_HEADER_SIZE    9
+#define NGX_HTTP_V2_DEFAULT_FRAME_SIZE   (1 << 14)
+#define NGX_HTTP_V2_MAX_FRAME_SIZE       ((1 << 24) - 1)
+
+#define NGX_HTTP_V2_DEFAULT_WINDOW       65535
+#define NGX_HTTP_V2_MAX_WINDOW           ((1U << 31) - 1)
+
+#define NGX_HTTP_V2_TABLE_SIZE           4096
+
+#define NGX_HTTP_V2_STREAMS_INDEX        64
+
+/* frame types */
+#define NGX_HTTP_V2_DATA_FRAME           0x0
+#define NGX_HTTP_V2_HEADERS_FRAME        0x1
+#define NGX_HTTP_V2_PRIORITY_FRAME       0x2
+#define NGX_HTTP_V2_RST_STREAM_FRAME     0x3
+#define NGX_HTTP_V2_SETTINGS_FRAME       0x4
+#define NGX_HTTP_V2_PUSH_PROMISE_FRAME   0x5
+#define NGX_HTTP_V2_PING_FRAME           0x6
+#define NGX_HTTP_V2_GOAWAY_FRAME         0x7
+#define NGX_HTTP_V2_WINDOW_UPDATE_FRAME  0x8
+#define NGX_HTTP_V2_CONTINUATION_FRAME   0x9
+
+/* frame flags */
+#define NGX_HTTP_V2_NO_FLAG              0x00
+#define NGX_HTTP_V2_ACK_FLAG             0x01
+#define NGX_HTTP_V2_END_STREAM_FLAG      0x01
+#define NGX_HTTP_V2_END_HEADERS_FLAG     0x04
+#define NGX_HTTP_V2_PADDED_FLAG          0x08
+#define NGX_HTTP_V2_PRIORITY_FLAG        0x20
+
+/* errors */
+#define NGX_HTTP_V2_NO_ERROR             0x0
+#define NGX_HTTP_V2_PROTOCOL_ERROR       0x1
+#define NGX_HTTP_V2_INTERNAL_ERROR       0x2
+#define NGX_HTTP_V2_FLOW_CTRL_ERROR      0x3
+#define NGX_HTTP_V2_SETTINGS_TIMEOUT     0x4
+#define NGX_HTTP_V2_STREAM_CLOSED        0x5
+#define NGX_HTTP_V2_SIZE_ERROR           0x6
+#define NGX_HTTP_V2_REFUSED_STREAM       0x7
+#define NGX_HTTP_V2_CANCEL               0x8
+#define NGX_HTTP_V2_COMP_ERROR           0x9
+#define NGX_HTTP_V2_CONNECT_ERROR        0xa
+#define NGX_HTTP_V2_ENHANCE_YOUR_CALM    0xb
+#define NGX_HTTP_V2_INADEQUATE_SECURITY  0xc
+#define NGX_HTTP_V2_HTTP_1_1_REQUIRED    0xd
+
+/* a low level buffered flag of the stream fake connection */
+#define NGX_HTTP_V2_BUFFERED             0x02
+
+
+typedef struct ngx_http_v2_connection_s   ngx_http_v2_connection_t;
+typedef struct ngx_http_v2_out_frame_s    ngx_http_v2_out_frame_t;
+
+
+typedef struct {
+    size_t                           recv_buffer_size;
+    u_char                          *recv_buffer;
+} ngx_http_v2_main_conf_t;
+
+
+typedef struct {
+    ngx_uint_t                       concurrent_streams;
+    size_t                           preread_size;
+    size_t                           max_field_size;
+    size_t                           max_header_size;
+    ngx_msec_t                       recv_timeout;
+    ngx_msec_t                       idle_timeout;
+} ngx_http_v2_srv_conf_t;
+
+
+typedef struct {
+    size_t                           chunk_size;
+} ngx_http_v2_loc_conf_t;
+
+
+typedef struct {
+    ngx_str_t                        name;
+    ngx_str_t                        value;
+} ngx_http_v2_header_t;
+
+
+typedef struct {
+    ngx_http_v2_header_t           **entries;
+    ngx_uint_t                       added;
+    ngx_uint_t                       deleted;
+    size_t                           size;
+    size_t                           max;
+} ngx_http_v2_hpack_t;
+
+
+struct ngx_http_v2_out_frame_s {
+    ngx_http_v2_out_frame_t         *next;
+    ngx_chain_t                      chain;
+    ngx_buf_t                        buf;
+    ngx_http_v2_stream_t            *stream;
+
+    unsigned                         control:1;
+    unsigned                         data:1;
+};
+
+
+struct ngx_http_v2_stream_s {
+    ngx_http_request_t              *request;
+    ngx_http_v2_connection_t        *connection;
+    ngx_http_v2_stream_t            *index;
+
+    ngx_uint_t                       id;
+    ngx_uint_t                       queued;
+
+    ssize_t                          send_window;
+    size_t                           recv_window;
+
+    ngx_buf_t                       *preread;
+    off_t                            received;
+
+    ngx_queue_t                      queue;
+
+    unsigned                         blocked:1;
+    unsigned                         waiting:1;
+    unsigned                         in_closed:1;
+    unsigned                         out_closed:1;
+    unsigned                         rst_sent:1;
+    unsigned                         skip_data:1;
+};
+
+
+struct ngx_http_v2_connection_s {
+    ngx_connection_t                *connection;
+    ngx_http_connection_t           *http_connection;
+
+    void                           **main_conf;
+    void                           **srv_conf;
+    ngx_http_virtual_names_t        *virtual_names;
+
+    ngx_uint_t                       processing;
+
+    size_t                           send_window;
+    size_t                           recv_window;
+    size_t                           init_window;
+    size_t                           frame_size;
+
+    ngx_queue_t                      waiting;
+
+    ngx_http_v2_stream_t           **streams_index;
+    ngx_uint_t                       last_sid;
+
+    ngx_http_v2_hpack_t              hpack;
+
+    /* a partially received frame and a header block being assembled */
+    u_char                          *buffer;
+    size_t                           buffer_len;
+    u_char                          *header_block;
+    size_t                           header_block_len;
+    ngx_uint_t                       header_sid;
+    ngx_uint_t                       header_flags;
+
+    ngx_http_v2_out_frame_t         *out;
+    ngx_http_v2_out_frame_t        **last_out;
+
+    ngx_http_v2_out_frame_t         *free_frames;
+    ngx_http_v2_out_frame_t         *free_data_frames;
+    ngx_connection_t                *free_fake_connections;
+
+    unsigned                         preface:1;
+    unsigned                         goaway:1;
+    unsigned                         closing:1;
+};
+
+
+void ngx_http_v2_init(ngx_event_t *rev);
+ngx_int_t ngx_http_v2_read_request_body(ngx_http_request_t *r,
+    ngx_http_client_body_handler_pt post_handler);
+void ngx_http_v2_close_stream(ngx_http_v2_stream_t *stream, ngx_int_t rc);
+
+void ngx_http_v2_queue_frame(ngx_http_v2_connection_t *h2c,
+    ngx_http_v2_out_frame_t *frame);
+ngx_int_t ngx_http_v2_send_output_queue(ngx_http_v2_connection_t *h2c);
+ngx_chain_t *ngx_http_v2_send_chain(ngx_connection_t *fc, ngx_chain_t *in,
+    off_t limit);
+
+ngx_int_t ngx_http_v2_get_indexed_header(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t index, ngx_uint_t name_only, ngx_pool_t *pool,
+    ngx_http_v2_header_t *header);
+ngx_int_t ngx_http_v2_add_header(ngx_http_v2_connection_t *h2c,
+    ngx_http_v2_header_t *header);
+ngx_int_t ngx_http_v2_table_size(ngx_http_v2_connection_t *h2c, size_t size);
+void ngx_http_v2_table_cleanup(void *data);
+
+
+#define ngx_http_v2_parse_uint16(p)  ((p)[0] << 8 | (p)[1])
+#define ngx_http_v2_parse_uint32(p)                                           \
+    ((uint32_t) (p)[0] << 24 | (p)[1] << 16 | (p)[2] << 8 | (p)[3])
+#define ngx_http_v2_parse_length(p)  ((p)[0] << 16 | (p)[1] << 8 | (p)[2])
+#define ngx_http_v2_parse_sid(p)     (ngx_http_v2_parse_uint32(p) & 0x7fffffff)
+
+#define ngx_http_v2_write_uint16(p, s)                                        \
+    ((p)[0] = (u_char) ((s) >> 8), (p)[1] = (u_char) (s), (p) + 2)
+#define ngx_http_v2_write_uint32(p, s)                                        \
+    ((p)[0] = (u_char) ((s) >> 24), (p)[1] = (u_char) ((s) >> 16),           \
+     (p)[2] = (u_char) ((s) >> 8), (p)[3] = (u_char) (s), (p) + 4)
+#define ngx_http_v2_write_sid        ngx_http_v2_write_uint32
+
+u_char *ngx_http_v2_write_frame_head(u_char *p, size_t length,
+    ngx_uint_t type, ngx_uint_t flags, ngx_uint_t sid);
+
+
+#define ngx_http_v2_get_module_main_conf(h2c, module)                         \
+    (h2c)->main_conf[module.ctx_index]
+#define ngx_http_v2_get_module_srv_conf(h2c, module)                          \
+    (h2c)->srv_conf[module.ctx_index]
+
+
+extern ngx_module_t  ngx_http_v2_module;
+
+
+#endif /* _NGX_HTTP_V2_H_INCLUDED_ */
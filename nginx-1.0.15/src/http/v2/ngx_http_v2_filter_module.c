@@ -0,0 +1,637 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+#include <nginx.h>
+
+
+/* the largest integer of a header field sent needs 4 octets */
+#define NGX_HTTP_V2_INT_OCTETS           4
+
+#define ngx_http_v2_prefix(bits)         ((1 << (bits)) - 1)
+#define ngx_http_v2_indexed(i)           (128 + (i))
+
+/* static table indexes */
+#define NGX_HTTP_V2_STATUS_INDEX          8
+#define NGX_HTTP_V2_STATUS_200_INDEX      8
+#define NGX_HTTP_V2_STATUS_204_INDEX      9
+#define NGX_HTTP_V2_STATUS_206_INDEX     10
+#define NGX_HTTP_V2_STATUS_304_INDEX     11
+#define NGX_HTTP_V2_STATUS_400_INDEX     12
+#define NGX_HTTP_V2_STATUS_404_INDEX     13
+#define NGX_HTTP_V2_STATUS_500_INDEX     14
+
+#define NGX_HTTP_V2_CONTENT_LENGTH_INDEX 28
+#define NGX_HTTP_V2_CONTENT_TYPE_INDEX   31
+#define NGX_HTTP_V2_DATE_INDEX           33
+#define NGX_HTTP_V2_LAST_MODIFIED_INDEX  44
+#define NGX_HTTP_V2_LOCATION_INDEX       46
+#define NGX_HTTP_V2_SERVER_INDEX         54
+#define NGX_HTTP_V2_VARY_INDEX           59
+
+
+static u_char *ngx_http_v2_write_int(u_char *pos, ngx_uint_t prefix,
+    ngx_uint_t value);
+static u_char *ngx_http_v2_write_field(u_char *pos, ngx_uint_t index,
+    u_char *value, size_t len);
+static ngx_int_t ngx_http_v2_queue_header_block(ngx_http_request_t *r,
+    u_char *block, size_t len);
+static ngx_int_t ngx_http_v2_filter_init(ngx_conf_t *cf);
+
+
+static ngx_http_module_t  ngx_http_v2_filter_module_ctx = {
+    NULL,                                  /* preconfiguration */
+    ngx_http_v2_filter_init,               /* postconfiguration */
+
+    NULL,                                  /* create main configuration */
+    NULL,                                  /* init main configuration */
+
+    NULL,                                  /* create server configuration */
+    NULL,                                  /* merge server configuration */
+
+    NULL,                                  /* create location configuration */
+    NULL                                   /* merge location configuration */
+};
+
+
+ngx_module_t  ngx_http_v2_filter_module = {
+    NGX_MODULE_V1,
+    &ngx_http_v2_filter_module_ctx,        /* module context */
+    NULL,                                  /* module directives */
+    NGX_HTTP_MODULE,                       /* module type */
+    NULL,                                  /* init master */
+    NULL,                                  /* init module */
+    NULL,                                  /* init process */
+    NULL,                                  /* init thread */
+    NULL,                                  /* exit thread */
+    NULL,                                  /* exit process */
+    NULL,                                  /* exit master */
+    NGX_MODULE_V1_PADDING
+};
+
+
+static ngx_http_output_header_filter_pt  ngx_http_next_header_filter;
+
+
+static ngx_int_t
+ngx_http_v2_header_filter(ngx_http_request_t *r)
+{
+    u_char                    *pos, *start, *p, *last, *tmp;
+    size_t                     len, tmp_len;
+    ngx_str_t                  host, location;
+    ngx_uint_t                 i, index, status, port;
+    ngx_list_part_t           *part;
+    ngx_table_elt_t           *header;
+    ngx_connection_t          *fc;
+    ngx_http_core_loc_conf_t  *clcf;
+    ngx_http_core_srv_conf_t  *cscf;
+    struct sockaddr_in        *sin;
+#if (NGX_HAVE_INET6)
+    struct sockaddr_in6       *sin6;
+#endif
+    u_char                     addr[NGX_SOCKADDR_STRLEN];
+
+    if (r->stream == NULL) {
+        return ngx_http_next_header_filter(r);
+    }
+
+    ngx_log_debug0(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                   "http2 header filter");
+
+    if (r->header_sent) {
+        return NGX_OK;
+    }
+
+    r->header_sent = 1;
+
+    if (r != r->main) {
+        return NGX_OK;
+    }
+
+    fc = r->connection;
+
+    if (fc->error) {
+        return NGX_ERROR;
+    }
+
+    if (r->method == NGX_HTTP_HEAD) {
+        r->header_only = 1;
+    }
+
+    status = r->headers_out.status;
+
+    if (status == 0 && r->headers_out.status_line.len >= 3) {
+        status = ngx_atoi(r->headers_out.status_line.data, 3);
+    }
+
+    switch (status) {
+
+    case NGX_HTTP_OK:
+        index = NGX_HTTP_V2_STATUS_200_INDEX;
+        break;
+
+    case NGX_HTTP_NO_CONTENT:
+        r->header_only = 1;
+
+        ngx_str_null(&r->headers_out.content_type);
+
+        r->headers_out.content_length = NULL;
+        r->headers_out.content_length_n = -1;
+
+        r->headers_out.last_modified_time = -1;
+        r->headers_out.last_modified = NULL;
+
+        index = NGX_HTTP_V2_STATUS_204_INDEX;
+        break;
+
+    case NGX_HTTP_PARTIAL_CONTENT:
+        index = NGX_HTTP_V2_STATUS_206_INDEX;
+        break;
+
+    case NGX_HTTP_NOT_MODIFIED:
+        r->header_only = 1;
+        index = NGX_HTTP_V2_STATUS_304_INDEX;
+        break;
+
+    default:
+        r->headers_out.last_modified_time = -1;
+        r->headers_out.last_modified = NULL;
+
+        switch (status) {
+
+        case NGX_HTTP_BAD_REQUEST:
+            index = NGX_HTTP_V2_STATUS_400_INDEX;
+            break;
+
+        case NGX_HTTP_NOT_FOUND:
+            index = NGX_HTTP_V2_STATUS_404_INDEX;
+            break;
+
+        case NGX_HTTP_INTERNAL_SERVER_ERROR:
+            index = NGX_HTTP_V2_STATUS_500_INDEX;
+            break;
+
+        default:
+            index = 0;
+        }
+    }
+
+    clcf = ngx_http_get_module_loc_conf(r, ngx_http_core_module);
+
+    /* a literal field takes a name index or a name, and a value */
+
+    len = (index ? 1 : 1 + NGX_HTTP_V2_INT_OCTETS + sizeof("418") - 1);
+
+    if (r->headers_out.server == NULL) {
+        len += 1 + NGX_HTTP_V2_INT_OCTETS
+               + (clcf->server_tokens ? sizeof(NGINX_VER) - 1
+                                      : sizeof("nginx") - 1);
+    }
+
+    if (r->headers_out.date == NULL) {
+        len += 1 + NGX_HTTP_V2_INT_OCTETS + ngx_cached_http_time.len;
+    }
+
+    if (r->headers_out.content_type.len) {
+        len += 1 + NGX_HTTP_V2_INT_OCTETS + r->headers_out.content_type.len;
+
+        if (r->headers_out.content_type_len == r->headers_out.content_type.len
+            && r->headers_out.charset.len)
+        {
+            len += sizeof("; charset=") - 1 + r->headers_out.charset.len;
+        }
+    }
+
+    if (r->headers_out.content_length == NULL
+        && r->headers_out.content_length_n >= 0)
+    {
+        len += 1 + NGX_HTTP_V2_INT_OCTETS + NGX_OFF_T_LEN;
+    }
+
+    if (r->headers_out.last_modified == NULL
+        && r->headers_out.last_modified_time != -1)
+    {
+        len += 1 + NGX_HTTP_V2_INT_OCTETS
+               + sizeof("Mon, 28 Sep 1970 06:00:00 GMT") - 1;
+    }
+
+    ngx_str_null(&location);
+
+    if (r->headers_out.location
+        && r->headers_out.location->value.len
+        && r->headers_out.location->value.data[0] == '/')
+    {
+        r->headers_out.location->hash = 0;
+
+        if (clcf->server_name_in_redirect) {
+            cscf = ngx_http_get_module_srv_conf(r, ngx_http_core_module);
+            host = cscf->server_name;
+
+        } else if (r->headers_in.server.len) {
+            host = r->headers_in.server;
+
+        } else {
+            host.len = NGX_SOCKADDR_STRLEN;
+            host.data = addr;
+
+            if (ngx_connection_local_sockaddr(fc, &host, 0) != NGX_OK) {
+                return NGX_ERROR;
+            }
+        }
+
+        switch (fc->local_sockaddr->sa_family) {
+
+#if (NGX_HAVE_INET6)
+        case AF_INET6:
+            sin6 = (struct sockaddr_in6 *) fc->local_sockaddr;
+            port = ntohs(sin6->sin6_port);
+            break;
+#endif
+#if (NGX_HAVE_UNIX_DOMAIN)
+        case AF_UNIX:
+            port = 0;
+            break;
+#endif
+        default: /* AF_INET */
+            sin = (struct sockaddr_in *) fc->local_sockaddr;
+            port = ntohs(sin->sin_port);
+            break;
+        }
+
+        if (clcf->port_in_redirect) {
+
+#if (NGX_HTTP_SSL)
+            if (fc->ssl)
+                port = (port == 443) ? 0 : port;
+            else
+#endif
+                port = (port == 80) ? 0 : port;
+
+        } else {
+            port = 0;
+        }
+
+        location.len = sizeof("https://") - 1 + host.len
+                       + sizeof(":65535") - 1
+                       + r->headers_out.location->value.len;
+
+        location.data = ngx_pnalloc(r->pool, location.len);
+        if (location.data == NULL) {
+            return NGX_ERROR;
+        }
+
+        p = ngx_cpymem(location.data, "http", sizeof("http") - 1);
+
+#if (NGX_HTTP_SSL)
+        if (fc->ssl) {
+            *p++ = 's';
+        }
+#endif
+
+        *p++ = ':'; *p++ = '/'; *p++ = '/';
+        p = ngx_copy(p, host.data, host.len);
+
+        if (port) {
+            p = ngx_sprintf(p, ":%ui", port);
+        }
+
+        p = ngx_copy(p, r->headers_out.location->value.data,
+                     r->headers_out.location->value.len);
+
+        location.len = p - location.data;
+
+        /* update r->headers_out.location->value for possible logging */
+
+        r->headers_out.location->value = location;
+        ngx_str_set(&r->headers_out.location->key, "Location");
+
+        len += 1 + NGX_HTTP_V2_INT_OCTETS + location.len;
+    }
+
+#if (NGX_HTTP_GZIP)
+    if (r->gzip_vary) {
+        if (clcf->gzip_vary) {
+            len += 1 + NGX_HTTP_V2_INT_OCTETS
+                   + sizeof("Accept-Encoding") - 1;
+
+        } else {
+            r->gzip_vary = 0;
+        }
+    }
+#endif
+
+    tmp_len = 0;
+
+    part = &r->headers_out.headers.part;
+    header = part->elts;
+
+    for (i = 0; /* void */; i++) {
+
+        if (i >= part->nelts) {
+            if (part->next == NULL) {
+                break;
+            }
+
+            part = part->next;
+            header = part->elts;
+            i = 0;
+        }
+
+        if (header[i].hash == 0) {
+            continue;
+        }
+
+        len += 1 + NGX_HTTP_V2_INT_OCTETS + header[i].key.len
+               + NGX_HTTP_V2_INT_OCTETS + header[i].value.len;
+
+        if (header[i].key.len > tmp_len) {
+            tmp_len = header[i].key.len;
+        }
+    }
+
+    tmp = ngx_pnalloc(r->pool, ngx_max(tmp_len,
+                              sizeof("Mon, 28 Sep 1970 06:00:00 GMT") - 1));
+    if (tmp == NULL) {
+        return NGX_ERROR;
+    }
+
+    start = ngx_pnalloc(r->pool, len);
+    if (start == NULL) {
+        return NGX_ERROR;
+    }
+
+    pos = start;
+
+    if (index) {
+        *pos++ = (u_char) ngx_http_v2_indexed(index);
+
+    } else {
+        (void) ngx_sprintf(tmp, "%03ui", status);
+        pos = ngx_http_v2_write_field(pos, NGX_HTTP_V2_STATUS_INDEX, tmp, 3);
+    }
+
+    if (r->headers_out.server == NULL) {
+        if (clcf->server_tokens) {
+            pos = ngx_http_v2_write_field(pos, NGX_HTTP_V2_SERVER_INDEX,
+                                          (u_char *) NGINX_VER,
+                                          sizeof(NGINX_VER) - 1);
+
+        } else {
+            pos = ngx_http_v2_write_field(pos, NGX_HTTP_V2_SERVER_INDEX,
+                                          (u_char *) "nginx",
+                                          sizeof("nginx") - 1);
+        }
+    }
+
+    if (r->headers_out.date == NULL) {
+        pos = ngx_http_v2_write_field(pos, NGX_HTTP_V2_DATE_INDEX,
+                                      ngx_cached_http_time.data,
+                                      ngx_cached_http_time.len);
+    }
+
+    if (r->headers_out.content_type.len) {
+
+        if (r->headers_out.content_type_len == r->headers_out.content_type.len
+            && r->headers_out.charset.len)
+        {
+            p = ngx_pnalloc(r->pool, r->headers_out.content_type.len
+                                     + sizeof("; charset=") - 1
+                                     + r->headers_out.charset.len);
+            if (p == NULL) {
+                return NGX_ERROR;
+            }
+
+            /* update r->headers_out.content_type for possible logging */
+
+            last = ngx_cpymem(p, r->headers_out.content_type.data,
+                              r->headers_out.content_type.len);
+            last = ngx_cpymem(last, "; charset=", sizeof("; charset=") - 1);
+            last = ngx_copy(last, r->headers_out.charset.data,
+                            r->headers_out.charset.len);
+
+            r->headers_out.content_type.len = last - p;
+            r->headers_out.content_type.data = p;
+        }
+
+        pos = ngx_http_v2_write_field(pos, NGX_HTTP_V2_CONTENT_TYPE_INDEX,
+                                      r->headers_out.content_type.data,
+                                      r->headers_out.content_type.len);
+    }
+
+    if (r->headers_out.content_length == NULL
+        && r->headers_out.content_length_n >= 0)
+    {
+        p = ngx_sprintf(tmp, "%O", r->headers_out.content_length_n);
+
+        pos = ngx_http_v2_write_field(pos, NGX_HTTP_V2_CONTENT_LENGTH_INDEX,
+                                      tmp, p - tmp);
+    }
+
+    if (r->headers_out.last_modified == NULL
+        && r->headers_out.last_modified_time != -1)
+    {
+        p = ngx_http_time(tmp, r->headers_out.last_modified_time);
+
+        pos = ngx_http_v2_write_field(pos, NGX_HTTP_V2_LAST_MODIFIED_INDEX,
+                                      tmp, p - tmp);
+    }
+
+    if (location.len) {
+        pos = ngx_http_v2_write_field(pos, NGX_HTTP_V2_LOCATION_INDEX,
+                                      location.data, location.len);
+    }
+
+#if (NGX_HTTP_GZIP)
+    if (r->gzip_vary) {
+        pos = ngx_http_v2_write_field(pos, NGX_HTTP_V2_VARY_INDEX,
+                                      (u_char *) "Accept-Encoding",
+                                      sizeof("Accept-Encoding") - 1);
+    }
+#endif
+
+    part = &r->headers_out.headers.part;
+    header = part->elts;
+
+    for (i = 0; /* void */; i++) {
+
+        if (i >= part->nelts) {
+            if (part->next == NULL) {
+                break;
+            }
+
+            part = part->next;
+            header = part->elts;
+            i = 0;
+        }
+
+        if (header[i].hash == 0) {
+            continue;
+        }
+
+        ngx_strlow(tmp, header[i].key.data, header[i].key.len);
+
+        /* the connection-specific header fields are not sent */
+
+        if ((header[i].key.len == sizeof("connection") - 1
+             && ngx_strncmp(tmp, "connection", header[i].key.len) == 0)
+            || (header[i].key.len == sizeof("keep-alive") - 1
+                && ngx_strncmp(tmp, "keep-alive", header[i].key.len) == 0)
+            || (header[i].key.len == sizeof("proxy-connection") - 1
+                && ngx_strncmp(tmp, "proxy-connection",
+                               header[i].key.len) == 0)
+            || (header[i].key.len == sizeof("transfer-encoding") - 1
+                && ngx_strncmp(tmp, "transfer-encoding",
+                               header[i].key.len) == 0)
+            || (header[i].key.len == sizeof("upgrade") - 1
+                && ngx_strncmp(tmp, "upgrade", header[i].key.len) == 0))
+        {
+            continue;
+        }
+
+        pos = ngx_http_v2_write_field(pos, 0, tmp, header[i].key.len);
+
+        *pos = 0;
+        pos = ngx_http_v2_write_int(pos, ngx_http_v2_prefix(7),
+                                    header[i].value.len);
+        pos = ngx_cpymem(pos, header[i].value.data, header[i].value.len);
+    }
+
+    if (ngx_http_v2_queue_header_block(r, start, pos - start) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    if (ngx_http_v2_send_output_queue(r->stream->connection) == NGX_ERROR) {
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+
+/*
+ * writes a literal field without indexing: the name is given by
+ * a static table index, or follows as a string if the index is 0
+ */
+
+static u_char *
+ngx_http_v2_write_field(u_char *pos, ngx_uint_t index, u_char *value,
+    size_t len)
+{
+    *pos = 0;
+    pos = ngx_http_v2_write_int(pos, ngx_http_v2_prefix(4), index);
+
+    *pos = 0;
+    pos = ngx_http_v2_write_int(pos, ngx_http_v2_prefix(7), len);
+
+    return ngx_cpymem(pos, value, len);
+}
+
+
+static u_char *
+ngx_http_v2_write_int(u_char *pos, ngx_uint_t prefix, ngx_uint_t value)
+{
+    if (value < prefix) {
+        *pos++ |= value;
+        return pos;
+    }
+
+    *pos++ |= prefix;
+    value -= prefix;
+
+    while (value >= 128) {
+        *pos++ = value % 128 + 128;
+        value /= 128;
+    }
+
+    *pos++ = (u_char) value;
+
+    return pos;
+}
+
+
+static ngx_int_t
+ngx_http_v2_queue_header_block(ngx_http_request_t *r, u_char *block,
+    size_t len)
+{
+    size_t                     size, frame_size;
+    ngx_uint_t                 type, flags;
+    ngx_http_v2_stream_t      *stream;
+    ngx_http_v2_out_frame_t   *frame;
+    ngx_http_v2_connection_t  *h2c;
+
+    stream = r->stream;
+    h2c = stream->connection;
+
+    frame_size = h2c->frame_size;
+
+    type = NGX_HTTP_V2_HEADERS_FRAME;
+    flags = r->header_only ? NGX_HTTP_V2_END_STREAM_FLAG : NGX_HTTP_V2_NO_FLAG;
+
+    do {
+        size = ngx_min(len, frame_size);
+        len -= size;
+
+        if (len == 0) {
+            flags |= NGX_HTTP_V2_END_HEADERS_FLAG;
+        }
+
+        frame = ngx_palloc(r->pool, sizeof(ngx_http_v2_out_frame_t)
+                                    + NGX_HTTP_V2_FRAME_HEADER_SIZE + size);
+        if (frame == NULL) {
+            return NGX_ERROR;
+        }
+
+        ngx_memzero(frame, sizeof(ngx_http_v2_out_frame_t));
+
+        frame->buf.start = (u_char *) frame + sizeof(ngx_http_v2_out_frame_t);
+        frame->buf.pos = frame->buf.start;
+        frame->buf.last = ngx_http_v2_write_frame_head(frame->buf.pos, size,
+                                                       type, flags,
+                                                       stream->id);
+        frame->buf.last = ngx_cpymem(frame->buf.last, block, size);
+        frame->buf.end = frame->buf.last;
+        frame->buf.temporary = 1;
+
+        frame->chain.buf = &frame->buf;
+        frame->stream = stream;
+
+        ngx_log_debug3(NGX_LOG_DEBUG_HTTP, r->connection->log, 0,
+                       "http2 header frame type:%ui f:%Xi l:%uz",
+                       type, flags, size);
+
+        stream->queued++;
+
+        r->header_size += NGX_HTTP_V2_FRAME_HEADER_SIZE + size;
+        r->connection->sent += NGX_HTTP_V2_FRAME_HEADER_SIZE + size;
+
+        ngx_http_v2_queue_frame(h2c, frame);
+
+        block += size;
+
+        type = NGX_HTTP_V2_CONTINUATION_FRAME;
+        flags = NGX_HTTP_V2_NO_FLAG;
+
+    } while (len);
+
+    if (r->header_only) {
+        stream->out_closed = 1;
+    }
+
+    return NGX_OK;
+}
+
+
+static ngx_int_t
+ngx_http_v2_filter_init(ngx_conf_t *cf)
+{
+    ngx_http_next_header_filter = ngx_http_top_header_filter;
+    ngx_http_top_header_filter = ngx_http_v2_header_filter;
+
+    return NGX_OK;
+}
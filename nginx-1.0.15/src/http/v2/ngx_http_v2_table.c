@@ -0,0 +1,266 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+#include <ngx_http.h>
+
+
+#define NGX_HTTP_V2_TABLE_ENTRY_SIZE  32
+
+#define NGX_HTTP_V2_TABLE_ENTRIES                                             \
+    (NGX_HTTP_V2_TABLE_SIZE / NGX_HTTP_V2_TABLE_ENTRY_SIZE)
+
+
+static void ngx_http_v2_table_evict(ngx_http_v2_hpack_t *hpack);
+
+
+static ngx_http_v2_header_t  ngx_http_v2_static_table[] = {
+    { ngx_string(":authority"), ngx_string("") },
+    { ngx_string(":method"), ngx_string("GET") },
+    { ngx_string(":method"), ngx_string("POST") },
+    { ngx_string(":path"), ngx_string("/") },
+    { ngx_string(":path"), ngx_string("/index.html") },
+    { ngx_string(":scheme"), ngx_string("http") },
+    { ngx_string(":scheme"), ngx_string("https") },
+    { ngx_string(":status"), ngx_string("200") },
+    { ngx_string(":status"), ngx_string("204") },
+    { ngx_string(":status"), ngx_string("206") },
+    { ngx_string(":status"), ngx_string("304") },
+    { ngx_string(":status"), ngx_string("400") },
+    { ngx_string(":status"), ngx_string("404") },
+    { ngx_string(":status"), ngx_string("500") },
+    { ngx_string("accept-charset"), ngx_string("") },
+    { ngx_string("accept-encoding"), ngx_string("gzip, deflate") },
+    { ngx_string("accept-language"), ngx_string("") },
+    { ngx_string("accept-ranges"), ngx_string("") },
+    { ngx_string("accept"), ngx_string("") },
+    { ngx_string("access-control-allow-origin"), ngx_string("") },
+    { ngx_string("age"), ngx_string("") },
+    { ngx_string("allow"), ngx_string("") },
+    { ngx_string("authorization"), ngx_string("") },
+    { ngx_string("cache-control"), ngx_string("") },
+    { ngx_string("content-disposition"), ngx_string("") },
+    { ngx_string("content-encoding"), ngx_string("") },
+    { ngx_string("content-language"), ngx_string("") },
+    { ngx_string("content-length"), ngx_string("") },
+    { ngx_string("content-location"), ngx_string("") },
+    { ngx_string("content-range"), ngx_string("") },
+    { ngx_string("content-type"), ngx_string("") },
+    { ngx_string("cookie"), ngx_string("") },
+    { ngx_string("date"), ngx_string("") },
+    { ngx_string("etag"), ngx_string("") },
+    { ngx_string("expect"), ngx_string("") },
+    { ngx_string("expires"), ngx_string("") },
+    { ngx_string("from"), ngx_string("") },
+    { ngx_string("host"), ngx_string("") },
+    { ngx_string("if-match"), ngx_string("") },
+    { ngx_string("if-modified-since"), ngx_string("") },
+    { ngx_string("if-none-match"), ngx_string("") },
+    { ngx_string("if-range"), ngx_string("") },
+    { ngx_string("if-unmodified-since"), ngx_string("") },
+    { ngx_string("last-modified"), ngx_string("") },
+    { ngx_string("link"), ngx_string("") },
+    { ngx_string("location"), ngx_string("") },
+    { ngx_string("max-forwards"), ngx_string("") },
+    { ngx_string("proxy-authenticate"), ngx_string("") },
+    { ngx_string("proxy-authorization"), ngx_string("") },
+    { ngx_string("range"), ngx_string("") },
+    { ngx_string("referer"), ngx_string("") },
+    { ngx_string("refresh"), ngx_string("") },
+    { ngx_string("retry-after"), ngx_string("") },
+    { ngx_string("server"), ngx_string("") },
+    { ngx_string("set-cookie"), ngx_string("") },
+    { ngx_string("strict-transport-security"), ngx_string("") },
+    { ngx_string("transfer-encoding"), ngx_string("") },
+    { ngx_string("user-agent"), ngx_string("") },
+    { ngx_string("vary"), ngx_string("") },
+    { ngx_string("via"), ngx_string("") },
+    { ngx_string("www-authenticate"), ngx_string("") },
+};
+
+#define NGX_HTTP_V2_STATIC_TABLE_ENTRIES                                      \
+    (sizeof(ngx_http_v2_static_table)                                         \
+     / sizeof(ngx_http_v2_header_t))
+
+
+/*
+ * the header fields returned are copied to the pool since an entry
+ * of the dynamic table may be evicted by the next field of the block
+ */
+
+ngx_int_t
+ngx_http_v2_get_indexed_header(ngx_http_v2_connection_t *h2c,
+    ngx_uint_t index, ngx_uint_t name_only, ngx_pool_t *pool,
+    ngx_http_v2_header_t *header)
+{
+    ngx_uint_t             i;
+    ngx_http_v2_header_t  *entry;
+
+    ngx_log_debug2(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                   "http2 get indexed %s: %ui",
+                   name_only ? "name" : "header", index);
+
+    if (index == 0) {
+        goto failed;
+    }
+
+    i = index - 1;
+
+    if (i < NGX_HTTP_V2_STATIC_TABLE_ENTRIES) {
+        entry = &ngx_http_v2_static_table[i];
+
+    } else {
+        i -= NGX_HTTP_V2_STATIC_TABLE_ENTRIES;
+
+        if (i >= h2c->hpack.added - h2c->hpack.deleted) {
+            goto failed;
+        }
+
+        entry = h2c->hpack.entries[(h2c->hpack.added - i - 1)
+                                   % NGX_HTTP_V2_TABLE_ENTRIES];
+    }
+
+    header->name.len = entry->name.len;
+    header->name.data = ngx_pnalloc(pool, entry->name.len + 1);
+    if (header->name.data == NULL) {
+        return NGX_ERROR;
+    }
+
+    ngx_memcpy(header->name.data, entry->name.data, entry->name.len);
+    header->name.data[entry->name.len] = '\0';
+
+    if (name_only) {
+        return NGX_OK;
+    }
+
+    header->value.len = entry->value.len;
+    header->value.data = ngx_pnalloc(pool, entry->value.len + 1);
+    if (header->value.data == NULL) {
+        return NGX_ERROR;
+    }
+
+    ngx_memcpy(header->value.data, entry->value.data, entry->value.len);
+    header->value.data[entry->value.len] = '\0';
+
+    return NGX_OK;
+
+failed:
+
+    ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                  "client sent invalid hpack table index: %ui", index);
+
+    return NGX_DECLINED;
+}
+
+
+ngx_int_t
+ngx_http_v2_add_header(ngx_http_v2_connection_t *h2c,
+    ngx_http_v2_header_t *header)
+{
+    size_t                 size;
+    ngx_http_v2_header_t  *entry;
+    ngx_http_v2_hpack_t   *hpack;
+
+    hpack = &h2c->hpack;
+
+    size = header->name.len + header->value.len
+           + NGX_HTTP_V2_TABLE_ENTRY_SIZE;
+
+    ngx_log_debug3(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                   "http2 add header to hpack table: \"%V: %V\", size: %uz",
+                   &header->name, &header->value, size);
+
+    if (hpack->entries == NULL) {
+        hpack->entries = ngx_palloc(h2c->connection->pool,
+                                    sizeof(ngx_http_v2_header_t *)
+                                    * NGX_HTTP_V2_TABLE_ENTRIES);
+        if (hpack->entries == NULL) {
+            return NGX_ERROR;
+        }
+    }
+
+    /* an entry larger than the table empties it */
+
+    while (hpack->size + size > hpack->max
+           && hpack->added != hpack->deleted)
+    {
+        ngx_http_v2_table_evict(hpack);
+    }
+
+    if (size > hpack->max) {
+        return NGX_OK;
+    }
+
+    entry = ngx_alloc(sizeof(ngx_http_v2_header_t)
+                      + header->name.len + header->value.len,
+                      h2c->connection->log);
+    if (entry == NULL) {
+        return NGX_ERROR;
+    }
+
+    entry->name.len = header->name.len;
+    entry->name.data = (u_char *) entry + sizeof(ngx_http_v2_header_t);
+    ngx_memcpy(entry->name.data, header->name.data, header->name.len);
+
+    entry->value.len = header->value.len;
+    entry->value.data = entry->name.data + header->name.len;
+    ngx_memcpy(entry->value.data, header->value.data, header->value.len);
+
+    hpack->entries[hpack->added++ % NGX_HTTP_V2_TABLE_ENTRIES] = entry;
+    hpack->size += size;
+
+    return NGX_OK;
+}
+
+
+ngx_int_t
+ngx_http_v2_table_size(ngx_http_v2_connection_t *h2c, size_t size)
+{
+    ngx_log_debug1(NGX_LOG_DEBUG_HTTP, h2c->connection->log, 0,
+                   "http2 hpack table size update: %uz", size);
+
+    if (size > NGX_HTTP_V2_TABLE_SIZE) {
+        ngx_log_error(NGX_LOG_INFO, h2c->connection->log, 0,
+                      "client sent invalid table size update: %uz", size);
+
+        return NGX_DECLINED;
+    }
+
+    h2c->hpack.max = size;
+
+    while (h2c->hpack.size > size) {
+        ngx_http_v2_table_evict(&h2c->hpack);
+    }
+
+    return NGX_OK;
+}
+
+
+void
+ngx_http_v2_table_cleanup(void *data)
+{
+    ngx_http_v2_hpack_t  *hpack = data;
+
+    while (hpack->added != hpack->deleted) {
+        ngx_http_v2_table_evict(hpack);
+    }
+}
+
+
+static void
+ngx_http_v2_table_evict(ngx_http_v2_hpack_t *hpack)
+{
+    ngx_http_v2_header_t  *entry;
+
+    entry = hpack->entries[hpack->deleted++ % NGX_HTTP_V2_TABLE_ENTRIES];
+
+    hpack->size -= entry->name.len + entry->value.len
+                   + NGX_HTTP_V2_TABLE_ENTRY_SIZE;
+
+    ngx_free(entry);
+}
@@ -177,6 +177,19 @@ ngx_mail_init_connection(ngx_connection_t *c)
         return;
     }
 
+    if (sslcf->starttls) {
+
+        /*
+         * the session may switch to SSL on the same socket,
+         * so it must not be read ahead by the event module
+         */
+
+        c->recv = ngx_os_io.recv;
+        c->send = ngx_os_io.send;
+        c->recv_chain = ngx_os_io.recv_chain;
+        c->send_chain = ngx_os_io.send_chain;
+    }
+
     }
 #endif
 
@@ -77,7 +77,7 @@ extern ssize_t sendfile(int s, int fd, int32_t *offset, size_t size);
 #endif
 
 
-#if (NGX_HAVE_POLL || NGX_HAVE_RTSIG)
+#if (NGX_HAVE_POLL || NGX_HAVE_RTSIG || NGX_HAVE_IO_URING)
 #include <poll.h>
 #endif
 
@@ -87,6 +87,23 @@ extern ssize_t sendfile(int s, int fd, int32_t *offset, size_t size);
 #endif
 
 
+#if (NGX_HAVE_IO_URING)
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+
+#if (NGX_HAVE_SYS_EVENTFD_H)
+#include <sys/eventfd.h>
+#endif
+
+
+#if (NGX_HAVE_FUTEX)
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+
 #if (NGX_HAVE_FILE_AIO)
 #include <sys/syscall.h>
 #include <linux/aio_abi.h>
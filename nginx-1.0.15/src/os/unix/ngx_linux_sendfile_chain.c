@@ -27,6 +27,28 @@
 #define NGX_SENDFILE_LIMIT  2147483647L
 
 
+#if (NGX_THREAD_POOL)
+
+#include <ngx_thread_pool.h>
+
+typedef struct {
+    ngx_socket_t   socket;
+    ngx_fd_t       fd;
+    off_t          offset;
+    size_t         size;
+
+    size_t         sent;
+    ngx_err_t      err;
+} ngx_linux_sendfile_ctx_t;
+
+
+static ssize_t ngx_linux_sendfile_thread(ngx_connection_t *c, ngx_buf_t *file,
+    size_t size);
+static void ngx_linux_sendfile_thread_handler(void *data, ngx_log_t *log);
+
+#endif
+
+
 #if (IOV_MAX > 64)
 #define NGX_HEADERS  64
 #else
@@ -53,13 +75,31 @@ ngx_linux_sendfile_chain(ngx_connection_t *c, ngx_chain_t *in, off_t limit)
 #else
     int32_t        offset;
 #endif
+#if (NGX_THREAD_POOL)
+    ssize_t        n;
+    ngx_uint_t     thread;
+#endif
 
     wev = c->write;
 
+#if (NGX_THREAD_POOL)
+
+    /* the result of a completed sendfile task is taken even if not ready */
+
+    if (!wev->ready
+        && (c->sendfile_task == NULL || !c->sendfile_task->event.complete))
+    {
+        return in;
+    }
+
+#else
+
     if (!wev->ready) {
         return in;
     }
 
+#endif
+
 
     /* the maximum limit size is 2G-1 - the page size */
 
@@ -81,6 +121,9 @@ ngx_linux_sendfile_chain(ngx_connection_t *c, ngx_chain_t *in, off_t limit)
         eintr = 0;
         complete = 0;
         prev_send = send;
+#if (NGX_THREAD_POOL)
+        thread = 0;
+#endif
 
         header.nelts = 0;
 
@@ -259,8 +302,33 @@ ngx_linux_sendfile_chain(ngx_connection_t *c, ngx_chain_t *in, off_t limit)
             ngx_log_debug2(NGX_LOG_DEBUG_EVENT, c->log, 0,
                            "sendfile: @%O %uz", file->file_pos, file_size);
 
+#if (NGX_THREAD_POOL)
+
+            if (file->file->thread_handler) {
+                n = ngx_linux_sendfile_thread(c, file, file_size);
+
+                if (n == NGX_ERROR) {
+                    return NGX_CHAIN_ERROR;
+                }
+
+                if (n == NGX_DONE) {
+                    /* the task is posted, the chain is sent on completion */
+                    return in;
+                }
+
+                thread = 1;
+                rc = (int) n;
+
+            } else {
+                rc = sendfile(c->fd, file->file->fd, &offset, file_size);
+            }
+
+#else
+
             rc = sendfile(c->fd, file->file->fd, &offset, file_size);
 
+#endif
+
             if (rc == -1) {
                 err = ngx_errno;
 
@@ -365,6 +433,15 @@ ngx_linux_sendfile_chain(ngx_connection_t *c, ngx_chain_t *in, off_t limit)
         }
 
         if (!complete) {
+
+#if (NGX_THREAD_POOL)
+            if (thread && wev->ready) {
+                /* the socket has become writable while the task was running */
+                in = cl;
+                continue;
+            }
+#endif
+
             wev->ready = 0;
             return cl;
         }
@@ -376,3 +453,115 @@ ngx_linux_sendfile_chain(ngx_connection_t *c, ngx_chain_t *in, off_t limit)
         in = cl;
     }
 }
+
+
+#if (NGX_THREAD_POOL)
+
+/*
+ * sendfile() may block on reading the file from disk, so it is run in
+ * a thread pool; the first call posts the task and returns NGX_DONE,
+ * the call after the task completion returns the number of bytes sent
+ */
+
+static ssize_t
+ngx_linux_sendfile_thread(ngx_connection_t *c, ngx_buf_t *file, size_t size)
+{
+    ngx_event_t               *wev;
+    ngx_thread_task_t         *task;
+    ngx_linux_sendfile_ctx_t  *ctx;
+
+    task = c->sendfile_task;
+
+    if (task == NULL) {
+        task = ngx_thread_task_alloc(c->pool, sizeof(ngx_linux_sendfile_ctx_t));
+        if (task == NULL) {
+            return NGX_ERROR;
+        }
+
+        task->handler = ngx_linux_sendfile_thread_handler;
+
+        c->sendfile_task = task;
+    }
+
+    ctx = task->ctx;
+    wev = c->write;
+
+    if (task->event.complete) {
+        task->event.complete = 0;
+
+        if (ctx->err && ctx->err != NGX_EAGAIN) {
+            wev->error = 1;
+            ngx_connection_error(c, ctx->err, "sendfile() failed");
+            return NGX_ERROR;
+        }
+
+        ngx_log_debug3(NGX_LOG_DEBUG_EVENT, c->log, ctx->err,
+                       "sendfile thread: @%O %uz of %uz",
+                       ctx->offset, ctx->sent, ctx->size);
+
+        /*
+         * if the socket buffer was filled, wev->ready stays cleared
+         * unless the socket has been reported writable since the task
+         * was posted
+         */
+
+        if (ctx->sent == ctx->size) {
+            wev->ready = 1;
+        }
+
+        return ctx->sent;
+    }
+
+    if (task->event.active) {
+        return NGX_DONE;
+    }
+
+    ctx->socket = c->fd;
+    ctx->fd = file->file->fd;
+    ctx->offset = file->file_pos;
+    ctx->size = size;
+
+    wev->ready = 0;
+
+    if (file->file->thread_handler(task, file->file) != NGX_OK) {
+        return NGX_ERROR;
+    }
+
+    return NGX_DONE;
+}
+
+
+static void
+ngx_linux_sendfile_thread_handler(void *data, ngx_log_t *log)
+{
+    ngx_linux_sendfile_ctx_t *ctx = data;
+
+    ssize_t  n;
+#if (NGX_HAVE_SENDFILE64)
+    off_t    offset;
+#else
+    int32_t  offset;
+#endif
+
+    offset = ctx->offset;
+
+again:
+
+    n = sendfile(ctx->socket, ctx->fd, &offset, ctx->size);
+
+    if (n == -1) {
+        ctx->err = ngx_errno;
+
+        if (ctx->err == NGX_EINTR) {
+            goto again;
+        }
+
+        ctx->sent = 0;
+
+    } else {
+        ctx->err = 0;
+        ctx->sent = n;
+    }
+}
+
+#endif
@@ -122,6 +122,11 @@ ngx_int_t ngx_cond_signal(ngx_cond_t *cv);
 
 #define ngx_thread_main()     1
 
+
+#if (NGX_THREAD_POOL)
+#include <pthread.h>
+#endif
+
 #endif
 
 
@@ -0,0 +1,356 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+/*
+ * The SSE2 copy of usual characters in ngx_http_parse_complex_uri()
+ * must leave the result as is: the parser is built here once more
+ * without it, and both copies process the URIs of the corpus and
+ * generated ones, with and without merge_slashes.  The return code,
+ * the URI, the arguments, the extension, and the flags must be the same.
+ *
+ *     ngx_http_parse_complex_uri_test [runs [seed]]
+ */
+
+
+#include "ngx_test.h"
+#include <ngx_http.h>
+
+
+#if (NGX_HAVE_SSE2)
+
+#define NGX_TEST_SSE2  1
+
+/* the scalar copy of the parsers */
+
+#undef NGX_HAVE_SSE2
+#define NGX_HAVE_SSE2  0
+
+#define ngx_http_parse_request_line   ngx_test_parse_request_line
+#define ngx_http_parse_header_line    ngx_test_parse_header_line
+#define ngx_http_parse_complex_uri    ngx_test_parse_complex_uri
+#define ngx_http_parse_status_line    ngx_test_parse_status_line
+#define ngx_http_parse_unsafe_uri     ngx_test_parse_unsafe_uri
+#define ngx_http_parse_multi_header_lines                                     \
+    ngx_test_parse_multi_header_lines
+#define ngx_http_arg                  ngx_test_arg
+#define ngx_http_split_args           ngx_test_split_args
+#define ngx_http_parse_chunked        ngx_test_parse_chunked
+
+#include "../src/http/ngx_http_parse.c"
+
+#undef ngx_http_parse_request_line
+#undef ngx_http_parse_header_line
+#undef ngx_http_parse_complex_uri
+#undef ngx_http_parse_status_line
+#undef ngx_http_parse_unsafe_uri
+#undef ngx_http_parse_multi_header_lines
+#undef ngx_http_arg
+#undef ngx_http_split_args
+#undef ngx_http_parse_chunked
+
+#undef NGX_HAVE_SSE2
+#define NGX_HAVE_SSE2  1
+
+#endif
+
+
+#if (NGX_TEST_SSE2)
+
+#define NGX_TEST_CORPUS    "ngx_http_parse_complex_uri.corpus"
+#define NGX_TEST_URI_SIZE  4096
+
+
+static uint64_t          ngx_test_seed = 88172645463325252ULL;
+static ngx_connection_t  ngx_test_connection;
+static ngx_uint_t        ngx_test_uris;
+static ngx_uint_t        ngx_test_complex;
+
+
+static char  *segments[] = {
+    "/", "//", "/./", "/../", "/.", "/..", ".", "..", "%2F", "%2f", "%2E",
+    "%2e%2e", "%3F", "%3f", "%23", "%25", "%00", "%2B", "%20", "%C3%A9",
+    "%E4%B8%AD%E6%96%87", "%zz", "%4", "?", "#", "+", "a", "index.html",
+    "images", "static", "v1", "abcdefghijklmnopqrstuvwxyz0123456789",
+    "product-name_with~chars", "file.tar.gz", "%7E", "%5C", "\\", "&x=1",
+    "=", ";", "%", "%%", "\x80\xfe", "%2e%2E/", "%2F%2F"
+};
+
+
+static uint32_t
+ngx_test_random(void)
+{
+    /* xorshift64 */
+
+    ngx_test_seed ^= ngx_test_seed << 13;
+    ngx_test_seed ^= ngx_test_seed >> 7;
+    ngx_test_seed ^= ngx_test_seed << 17;
+
+    return (uint32_t) ngx_test_seed;
+}
+
+
+static ngx_int_t
+ngx_test_compare(ngx_int_t *rcs, ngx_http_request_t *r)
+{
+    u_char  *e[2];
+
+    if (rcs[0] != rcs[1]) {
+        ngx_test_fail("rc %ld, scalar %ld", (long) rcs[0], (long) rcs[1]);
+        return NGX_ERROR;
+    }
+
+    if (rcs[0] != NGX_OK) {
+        return NGX_OK;
+    }
+
+    if (r[0].uri.len != r[1].uri.len
+        || ngx_memcmp(r[0].uri.data, r[1].uri.data, r[0].uri.len) != 0)
+    {
+        ngx_test_fail("uri \"%.*s\", scalar \"%.*s\"",
+                      (int) r[0].uri.len, r[0].uri.data,
+                      (int) r[1].uri.len, r[1].uri.data);
+        return NGX_ERROR;
+    }
+
+    e[0] = r[0].exten.data;
+    e[1] = r[1].exten.data;
+
+    if (r[0].args.data != r[1].args.data
+        || r[0].args.len != r[1].args.len
+        || r[0].args_start != r[1].args_start
+        || r[0].exten.len != r[1].exten.len
+        || (e[0] ? e[0] - r[0].uri.data : -1)
+           != (e[1] ? e[1] - r[1].uri.data : -1)
+        || r[0].plus_in_uri != r[1].plus_in_uri
+        || r[0].quoted_uri != r[1].quoted_uri)
+    {
+        ngx_test_fail("args, exten, or flags differ for \"%.*s\"",
+                      (int) r[0].uri.len, r[0].uri.data);
+        return NGX_ERROR;
+    }
+
+    return NGX_OK;
+}
+
+
+static void
+ngx_test_uri(u_char *uri, size_t size, ngx_uint_t merge_slashes)
+{
+    size_t               len;
+    u_char              *line;
+    ngx_int_t            rcs[2];
+    ngx_uint_t           i;
+    ngx_buf_t            b;
+    ngx_http_request_t   r, req[2];
+
+    ngx_test_uris++;
+
+    /* the line is allocated exactly, so overreads are seen by ASAN */
+
+    len = sizeof("GET ") - 1 + size + sizeof(" HTTP/1.1" CRLF) - 1;
+
+    line = ngx_alloc(len, ngx_cycle->log);
+    if (line == NULL) {
+        exit(1);
+    }
+
+    ngx_memcpy(line, "GET ", sizeof("GET ") - 1);
+    ngx_memcpy(line + sizeof("GET ") - 1, uri, size);
+    ngx_memcpy(line + sizeof("GET ") - 1 + size, " HTTP/1.1" CRLF,
+               sizeof(" HTTP/1.1" CRLF) - 1);
+
+    ngx_memzero(&r, sizeof(ngx_http_request_t));
+    ngx_memzero(&b, sizeof(ngx_buf_t));
+
+    r.connection = &ngx_test_connection;
+
+    b.pos = line;
+    b.last = line + len;
+
+    if (ngx_http_parse_request_line(&r, &b) != NGX_OK
+        || !(r.complex_uri || r.quoted_uri))
+    {
+        ngx_free(line);
+        return;
+    }
+
+    ngx_test_complex++;
+
+    /* as in ngx_http_process_request_uri() */
+
+    if (r.args_start) {
+        r.uri.len = r.args_start - 1 - r.uri_start;
+    } else {
+        r.uri.len = r.uri_end - r.uri_start;
+    }
+
+    for (i = 0; i < 2; i++) {
+        req[i] = r;
+
+        req[i].uri.data = ngx_alloc(r.uri.len + 1, ngx_cycle->log);
+        if (req[i].uri.data == NULL) {
+            exit(1);
+        }
+    }
+
+    rcs[0] = ngx_http_parse_complex_uri(&req[0], merge_slashes);
+    rcs[1] = ngx_test_parse_complex_uri(&req[1], merge_slashes);
+
+    if (ngx_test_compare(rcs, req) != NGX_OK) {
+        ngx_test_fail("merge_slashes %lu, input: \"%.*s\"",
+                      (unsigned long) merge_slashes, (int) size, uri);
+    }
+
+    ngx_free(req[0].uri.data);
+    ngx_free(req[1].uri.data);
+    ngx_free(line);
+}
+
+
+static ngx_int_t
+ngx_test_corpus(char *name)
+{
+    u_char           *buf, *p, *last, *eol;
+    ssize_t           n;
+    ngx_fd_t          fd;
+    ngx_file_info_t   fi;
+
+    fd = ngx_open_file(name, NGX_FILE_RDONLY, NGX_FILE_OPEN, 0);
+    if (fd == NGX_INVALID_FILE) {
+        ngx_test_fail("%s: cannot be opened", name);
+        return NGX_ERROR;
+    }
+
+    if (ngx_fd_info(fd, &fi) == NGX_FILE_ERROR) {
+        ngx_test_fail("%s: cannot be stat()ed", name);
+        ngx_close_file(fd);
+        return NGX_ERROR;
+    }
+
+    buf = ngx_alloc(ngx_file_size(&fi), ngx_cycle->log);
+    if (buf == NULL) {
+        exit(1);
+    }
+
+    n = ngx_read_fd(fd, buf, ngx_file_size(&fi));
+
+    ngx_close_file(fd);
+
+    if (n != (ssize_t) ngx_file_size(&fi)) {
+        ngx_test_fail("%s: cannot be read", name);
+        ngx_free(buf);
+        return NGX_ERROR;
+    }
+
+    last = buf + n;
+
+    for (p = buf; p < last; p = eol + 1) {
+
+        eol = ngx_strlchr(p, last, LF);
+        if (eol == NULL) {
+            eol = last;
+        }
+
+        if (eol == p || *p == '#') {
+            continue;
+        }
+
+        ngx_test_uri(p, eol - p, 0);
+        ngx_test_uri(p, eol - p, 1);
+
+        if (ngx_test_failed >= 10) {
+            break;
+        }
+    }
+
+    ngx_free(buf);
+
+    return NGX_OK;
+}
+
+
+static size_t
+ngx_test_generate(u_char *buf)
+{
+    u_char      *p, *last;
+    ngx_uint_t   i, n;
+
+    static char  usual[] = "abcdefghijklmnop0123456789-_~";
+
+    p = buf;
+    last = buf + NGX_TEST_URI_SIZE - 128;
+
+    *p++ = '/';
+
+    for (n = 1 + ngx_test_random() % 30; n && p < last; n--) {
+        i = ngx_test_random() % (sizeof(segments) / sizeof(char *));
+        p = ngx_cpymem(p, segments[i], ngx_strlen(segments[i]));
+
+        if (ngx_test_random() % 4 == 0) {
+            for (i = ngx_test_random() % 40; i; i--) {
+                *p++ = usual[ngx_test_random() % (sizeof(usual) - 1)];
+            }
+        }
+    }
+
+    /* a random byte */
+
+    if (ngx_test_random() % 8 == 0 && p - buf > 1) {
+        i = 1 + ngx_test_random() % (p - buf - 1);
+        buf[i] = (u_char) ngx_test_random();
+    }
+
+    return p - buf;
+}
+
+
+int ngx_cdecl
+main(int argc, char *const *argv)
+{
+    size_t       len;
+    ngx_int_t    runs;
+    ngx_uint_t   i;
+    static u_char  buf[NGX_TEST_URI_SIZE];
+
+    ngx_test_connection.log = ngx_test_init();
+
+    runs = (argc > 1) ? ngx_atoi((u_char *) argv[1], ngx_strlen(argv[1]))
+                      : 200000;
+
+    if (argc > 2) {
+        ngx_test_seed = ngx_atoi((u_char *) argv[2], ngx_strlen(argv[2]));
+    }
+
+    if (runs == NGX_ERROR || ngx_test_seed == (uint64_t) NGX_ERROR) {
+        printf("usage: %s [runs [seed]]\n", argv[0]);
+        return 1;
+    }
+
+    (void) ngx_test_corpus(NGX_TEST_CORPUS);
+
+    for (i = 0; i < (ngx_uint_t) runs && ngx_test_failed < 10; i++) {
+        len = ngx_test_generate(buf);
+        ngx_test_uri(buf, len, ngx_test_random() % 2);
+    }
+
+    printf("%lu uris, %lu complex\n", (unsigned long) ngx_test_uris,
+           (unsigned long) ngx_test_complex);
+
+    return ngx_test_failed ? 1 : 0;
+}
+
+#else
+
+int ngx_cdecl
+main(int argc, char *const *argv)
+{
+    printf("built without SSE2, skipped\n");
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,437 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+/*
+ * The SSE2 fast paths of the request line and header parsers must not
+ * change a single result: the parsers are built here once more without
+ * them, and both copies are fed the same generated and mutated requests,
+ * split at random points and pipelined.  After each call the return code,
+ * b->pos, and all parser fields of the request must be the same.  Under
+ * AddressSanitizer the bytes past b->last are poisoned.
+ *
+ *     ngx_http_parse_test [runs [seed]]
+ */
+
+
+#include "ngx_test.h"
+#include <ngx_http.h>
+
+
+#if (NGX_HAVE_SSE2)
+
+#define NGX_TEST_SSE2  1
+
+/* the scalar copy of the parsers */
+
+#undef NGX_HAVE_SSE2
+#define NGX_HAVE_SSE2  0
+
+#define ngx_http_parse_request_line   ngx_test_parse_request_line
+#define ngx_http_parse_header_line    ngx_test_parse_header_line
+#define ngx_http_parse_complex_uri    ngx_test_parse_complex_uri
+#define ngx_http_parse_status_line    ngx_test_parse_status_line
+#define ngx_http_parse_unsafe_uri     ngx_test_parse_unsafe_uri
+#define ngx_http_parse_multi_header_lines                                     \
+    ngx_test_parse_multi_header_lines
+#define ngx_http_arg                  ngx_test_arg
+#define ngx_http_split_args           ngx_test_split_args
+#define ngx_http_parse_chunked        ngx_test_parse_chunked
+
+#include "../src/http/ngx_http_parse.c"
+
+#undef ngx_http_parse_request_line
+#undef ngx_http_parse_header_line
+#undef ngx_http_parse_complex_uri
+#undef ngx_http_parse_status_line
+#undef ngx_http_parse_unsafe_uri
+#undef ngx_http_parse_multi_header_lines
+#undef ngx_http_arg
+#undef ngx_http_split_args
+#undef ngx_http_parse_chunked
+
+#undef NGX_HAVE_SSE2
+#define NGX_HAVE_SSE2  1
+
+#endif
+
+
+#if (NGX_TEST_SSE2)
+
+#if (defined __SANITIZE_ADDRESS__)
+
+#include <sanitizer/asan_interface.h>
+
+#define ngx_test_poison(p, n)    ASAN_POISON_MEMORY_REGION(p, n)
+#define ngx_test_unpoison(p, n)  ASAN_UNPOISON_MEMORY_REGION(p, n)
+
+#else
+
+#define ngx_test_poison(p, n)
+#define ngx_test_unpoison(p, n)
+
+#endif
+
+
+#define NGX_TEST_BUF_SIZE  8192
+
+
+static uint64_t     ngx_test_seed = 88172645463325252ULL;
+static u_char      *ngx_test_base[2];
+static ngx_uint_t   ngx_test_calls;
+
+
+static char  *pieces[] = {
+    "/", "/api/v1/users", "/a.b.c/d.html", "?x=1&y=2", "#frag", "%2F",
+    "%zz", "+", " ", "  ", "http://", "example.com", ":8080",
+    "HTTP/1.1 200", "\r\n", "\n", "\r", "\t", "\x01", "\x80\xff", "\\",
+    "..", "/./", "/../", "//", "?", ":", "", "  trailing  ",
+    "Host: example.com", "User-Agent: curl/7.88.1 (x86_64)", "Accept: */*",
+    "X_Under_Score: v", "Cookie: a=1; b=2; cccccccccccc=ddddd", "X-Long: ",
+    "abcdefghijklmnopqrstuvwxyz0123456789ABCDEF", "Content-Length: 12345"
+};
+
+#define NGX_TEST_URI_PIECES  13
+
+
+static uint32_t
+ngx_test_random(void)
+{
+    /* xorshift64 */
+
+    ngx_test_seed ^= ngx_test_seed << 13;
+    ngx_test_seed ^= ngx_test_seed >> 7;
+    ngx_test_seed ^= ngx_test_seed << 17;
+
+    return (uint32_t) ngx_test_seed;
+}
+
+
+static u_char *
+ngx_test_piece(u_char *p, char *s)
+{
+    size_t  len;
+
+    /* the empty piece stands for a NUL byte */
+
+    len = ngx_strlen(s);
+
+    if (len == 0) {
+        *p++ = '\0';
+        return p;
+    }
+
+    return ngx_cpymem(p, s, len);
+}
+
+
+static size_t
+ngx_test_generate(u_char *buf)
+{
+    u_char      *p, *last;
+    ngx_uint_t   i, j, n, reqs;
+
+    static char  *methods[] = { "GET ", "POST ", "HEAD ", "OPTIONS " };
+    static char   uri[] = "abcdefgh/._-~%?+#";
+
+    p = buf;
+    last = buf + NGX_TEST_BUF_SIZE - 512;
+
+    reqs = 1 + ngx_test_random() % 3;
+
+    for (i = 0; i < reqs && p < last; i++) {
+
+        p = ngx_test_piece(p, methods[ngx_test_random() % 4]);
+
+        n = ngx_test_random() % 12;
+
+        while (n-- && p < last) {
+            p = ngx_test_piece(p,
+                    pieces[ngx_test_random() % NGX_TEST_URI_PIECES]);
+
+            if (ngx_test_random() % 3 == 0) {
+                for (j = ngx_test_random() % 40; j; j--) {
+                    *p++ = uri[ngx_test_random() % (sizeof(uri) - 1)];
+                }
+            }
+        }
+
+        p = ngx_cpymem(p, " HTTP/1.1" CRLF, sizeof(" HTTP/1.1" CRLF) - 1);
+
+        n = ngx_test_random() % 8;
+
+        while (n-- && p < last) {
+            p = ngx_test_piece(p,
+                    pieces[NGX_TEST_URI_PIECES
+                           + ngx_test_random()
+                             % (sizeof(pieces) / sizeof(pieces[0])
+                                - NGX_TEST_URI_PIECES)]);
+
+            if (ngx_test_random() % 2) {
+                for (j = ngx_test_random() % 100; j; j--) {
+                    *p++ = (u_char) (' ' + ngx_test_random() % 95);
+                }
+            }
+
+            if (ngx_test_random() % 4) {
+                *p++ = CR; *p++ = LF;
+            }
+        }
+
+        *p++ = CR; *p++ = LF;
+    }
+
+    /* mutations */
+
+    for (n = ngx_test_random() % 4; n && p > buf + 2; n--) {
+
+        switch (ngx_test_random() % 3) {
+
+        case 0:
+            buf[ngx_test_random() % (p - buf)] = (u_char) ngx_test_random();
+            break;
+
+        case 1:
+            buf[ngx_test_random() % (p - buf)] =
+                                 "\r\n \0#%?/.+:"[ngx_test_random() % 11];
+            break;
+
+        default:
+            p -= ngx_test_random() % 3;
+        }
+    }
+
+    return p - buf;
+}
+
+
+#define ngx_test_pointer(f)                                                   \
+    if ((r[0]->f ? r[0]->f - ngx_test_base[0] : -1)                           \
+        != (r[1]->f ? r[1]->f - ngx_test_base[1] : -1))                       \
+    {                                                                         \
+        ngx_test_fail("%s: " #f " differs", what);                            \
+        rc = NGX_ERROR;                                                       \
+    }
+
+#define ngx_test_value(f)                                                     \
+    if (r[0]->f != r[1]->f) {                                                 \
+        ngx_test_fail("%s: " #f " %lu, scalar %lu", what,                     \
+                      (unsigned long) r[0]->f, (unsigned long) r[1]->f);      \
+        rc = NGX_ERROR;                                                       \
+    }
+
+
+static ngx_int_t
+ngx_test_compare(char *what, ngx_int_t *rcs, ngx_http_request_t **r,
+    ngx_buf_t *b)
+{
+    ngx_int_t  rc;
+
+    ngx_test_calls++;
+
+    rc = NGX_OK;
+
+    if (rcs[0] != rcs[1]) {
+        ngx_test_fail("%s: rc %ld, scalar %ld", what, (long) rcs[0],
+                      (long) rcs[1]);
+        rc = NGX_ERROR;
+    }
+
+    if (b[0].pos - ngx_test_base[0] != b[1].pos - ngx_test_base[1]) {
+        ngx_test_fail("%s: pos differs", what);
+        rc = NGX_ERROR;
+    }
+
+    ngx_test_pointer(request_start)
+    ngx_test_pointer(request_end)
+    ngx_test_pointer(method_end)
+    ngx_test_pointer(uri_start)
+    ngx_test_pointer(uri_end)
+    ngx_test_pointer(uri_ext)
+    ngx_test_pointer(args_start)
+    ngx_test_pointer(schema_start)
+    ngx_test_pointer(schema_end)
+    ngx_test_pointer(host_start)
+    ngx_test_pointer(host_end)
+    ngx_test_pointer(port_start)
+    ngx_test_pointer(port_end)
+    ngx_test_pointer(http_protocol.data)
+    ngx_test_pointer(header_name_start)
+    ngx_test_pointer(header_name_end)
+    ngx_test_pointer(header_start)
+    ngx_test_pointer(header_end)
+
+    ngx_test_value(method)
+    ngx_test_value(http_major)
+    ngx_test_value(http_minor)
+    ngx_test_value(http_version)
+    ngx_test_value(complex_uri)
+    ngx_test_value(quoted_uri)
+    ngx_test_value(plus_in_uri)
+    ngx_test_value(space_in_uri)
+    ngx_test_value(invalid_header)
+    ngx_test_value(state)
+    ngx_test_value(header_hash)
+    ngx_test_value(lowcase_index)
+
+    if (ngx_memcmp(r[0]->lowcase_header, r[1]->lowcase_header,
+                   NGX_HTTP_LC_HEADER_LEN)
+        != 0)
+    {
+        ngx_test_fail("%s: lowcase_header differs", what);
+        rc = NGX_ERROR;
+    }
+
+    return rc;
+}
+
+
+static void
+ngx_test_run(u_char *input, size_t len)
+{
+    size_t               cut;
+    ngx_int_t            rcs[2];
+    ngx_uint_t           i, header, underscores;
+    ngx_buf_t            b[2];
+    ngx_http_request_t   req[2], *r[2];
+
+    header = 0;
+    underscores = ngx_test_random() % 2;
+
+    cut = (ngx_test_random() % 2) ? len : ngx_test_random() % (len + 1);
+
+    for (i = 0; i < 2; i++) {
+        ngx_test_base[i] = ngx_alloc(len + 1, ngx_cycle->log);
+        if (ngx_test_base[i] == NULL) {
+            exit(1);
+        }
+
+        ngx_memcpy(ngx_test_base[i], input, len);
+
+        ngx_memzero(&req[i], sizeof(ngx_http_request_t));
+        r[i] = &req[i];
+
+        ngx_memzero(&b[i], sizeof(ngx_buf_t));
+        b[i].pos = ngx_test_base[i];
+        b[i].last = ngx_test_base[i] + cut;
+    }
+
+    for ( ;; ) {
+
+        for (i = 0; i < 2; i++) {
+            ngx_test_poison(b[i].last, len + 1 - cut);
+        }
+
+        if (header) {
+            rcs[0] = ngx_http_parse_header_line(r[0], &b[0], underscores);
+            rcs[1] = ngx_test_parse_header_line(r[1], &b[1], underscores);
+
+        } else {
+            rcs[0] = ngx_http_parse_request_line(r[0], &b[0]);
+            rcs[1] = ngx_test_parse_request_line(r[1], &b[1]);
+        }
+
+        for (i = 0; i < 2; i++) {
+            ngx_test_unpoison(ngx_test_base[i], len + 1);
+        }
+
+        if (ngx_test_compare(header ? "header line" : "request line",
+                             rcs, r, b)
+            != NGX_OK)
+        {
+            ngx_test_fail("input: \"%.*s\"", (int) len, input);
+            break;
+        }
+
+        if (rcs[0] == NGX_AGAIN) {
+            if (cut == len) {
+                break;
+            }
+
+            /* the next read */
+
+            cut += 1 + ngx_test_random() % (len - cut);
+
+            b[0].last = ngx_test_base[0] + cut;
+            b[1].last = ngx_test_base[1] + cut;
+
+            continue;
+        }
+
+        if (!header) {
+            if (rcs[0] != NGX_OK) {
+                break;
+            }
+
+            header = 1;
+            continue;
+        }
+
+        if (rcs[0] == NGX_HTTP_PARSE_HEADER_DONE) {
+
+            /* the next pipelined request */
+
+            header = 0;
+            r[0]->state = 0;
+            r[1]->state = 0;
+
+            continue;
+        }
+
+        if (rcs[0] != NGX_OK) {
+            break;
+        }
+    }
+
+    ngx_free(ngx_test_base[0]);
+    ngx_free(ngx_test_base[1]);
+}
+
+
+int ngx_cdecl
+main(int argc, char *const *argv)
+{
+    size_t       len;
+    ngx_int_t    runs;
+    ngx_uint_t   i;
+    static u_char  buf[NGX_TEST_BUF_SIZE];
+
+    (void) ngx_test_init();
+
+    runs = (argc > 1) ? ngx_atoi((u_char *) argv[1], ngx_strlen(argv[1]))
+                      : 200000;
+
+    if (argc > 2) {
+        ngx_test_seed = ngx_atoi((u_char *) argv[2], ngx_strlen(argv[2]));
+    }
+
+    if (runs == NGX_ERROR || ngx_test_seed == (uint64_t) NGX_ERROR) {
+        printf("usage: %s [runs [seed]]\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 0; i < (ngx_uint_t) runs && ngx_test_failed < 10; i++) {
+        len = ngx_test_generate(buf);
+        ngx_test_run(buf, len);
+    }
+
+    printf("%lu runs, %lu calls\n", (unsigned long) i,
+           (unsigned long) ngx_test_calls);
+
+    return ngx_test_failed ? 1 : 0;
+}
+
+#else
+
+int ngx_cdecl
+main(int argc, char *const *argv)
+{
+    printf("built without SSE2, skipped\n");
+
+    return 0;
+}
+
+#endif
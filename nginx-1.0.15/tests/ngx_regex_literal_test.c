@@ -0,0 +1,137 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+/*
+ * ngx_regex_literal() must return a string which every subject matched
+ * by the pattern contains; the test checks the expected literals and
+ * runs the sample subjects through PCRE to verify the claim.
+ */
+
+
+#include "ngx_test.h"
+
+
+#if (NGX_PCRE)
+
+typedef struct {
+    char   *pattern;
+    char   *literal;
+    char   *subjects[4];
+} ngx_regex_literal_test_t;
+
+
+static ngx_regex_literal_test_t  tests[] = {
+
+    { "\\.php$", ".php", { "/index.php", NULL } },
+    { "^/images/.*\\.(gif|jpg)$", "/images/",
+      { "/images/a.gif", "/images/b/c.jpg", NULL } },
+    { "(foo|bar)baz", "baz", { "foobaz", "barbaz", NULL } },
+    { "\\d{2,3}abc", "abc", { "12abc", "123abc", NULL } },
+    { "a\\d+bcd", "bcd", { "a1bcd", "a12bcd", NULL } },
+    { "\\x{41}bc", "bc", { "Abc", NULL } },
+    { "\\x41/bc", "/bc", { "A/bc", NULL } },
+    { "ab*cde", "cde", { "acde", "abbcde", NULL } },
+
+    /* a top-level alternation hidden behind a quantified escape */
+    { "\\d{2}|foo", "", { "12", "foo", "x34y", NULL } },
+    { "\\w{3}|bar", "", { "abc", "bar", NULL } },
+    { "\\s{1}|baz", "", { " ", "baz", NULL } },
+    { "\\s'|foo|'bar", "", { " '", "foo", "'bar", NULL } },
+    { "\\d{|foo}x", "", { "1{", "foo}x", NULL } },
+    { "\\d<|foo>", "", { "1<", "foo>", NULL } },
+
+    { "foo|bar", "", { "foo", "bar", NULL } },
+    { "\\Qa.b\\E", "", { "a.b", NULL } },
+    { "(?x) a b c", "", { "abc", NULL } },
+};
+
+
+int ngx_cdecl
+main(int argc, char *const *argv)
+{
+    ngx_str_t             pattern, literal;
+    ngx_log_t            *log;
+    ngx_uint_t            i, j;
+    ngx_pool_t           *pool;
+    int                   erroff;
+    pcre                 *re;
+    const char           *err;
+
+    log = ngx_test_init();
+
+    pool = ngx_create_pool(1024, log);
+    if (pool == NULL) {
+        return 1;
+    }
+
+    for (i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+
+        pattern.len = ngx_strlen(tests[i].pattern);
+        pattern.data = (u_char *) tests[i].pattern;
+
+        if (ngx_regex_literal(pool, &pattern, &literal) != NGX_OK) {
+            ngx_test_fail("\"%s\": error", tests[i].pattern);
+            continue;
+        }
+
+        if (literal.len != ngx_strlen(tests[i].literal)
+            || ngx_strncmp(literal.data, tests[i].literal, literal.len) != 0)
+        {
+            ngx_test_fail("\"%s\": literal \"%.*s\", expected \"%s\"",
+                          tests[i].pattern, (int) literal.len, literal.data,
+                          tests[i].literal);
+        }
+
+        re = pcre_compile(tests[i].pattern, 0, &err, &erroff, NULL);
+        if (re == NULL) {
+            ngx_test_fail("\"%s\": %s", tests[i].pattern, err);
+            continue;
+        }
+
+        for (j = 0; tests[i].subjects[j]; j++) {
+
+            if (pcre_exec(re, NULL, tests[i].subjects[j],
+                          ngx_strlen(tests[i].subjects[j]), 0, 0, NULL, 0)
+                < 0)
+            {
+                ngx_test_fail("\"%s\": \"%s\" does not match",
+                              tests[i].pattern, tests[i].subjects[j]);
+                continue;
+            }
+
+            if (literal.len
+                && ngx_strlcasestrn((u_char *) tests[i].subjects[j],
+                        (u_char *) tests[i].subjects[j]
+                                   + ngx_strlen(tests[i].subjects[j]),
+                        literal.data, literal.len - 1)
+                   == NULL)
+            {
+                ngx_test_fail("\"%s\": \"%s\" matches without \"%.*s\"",
+                              tests[i].pattern, tests[i].subjects[j],
+                              (int) literal.len, literal.data);
+            }
+        }
+
+        pcre_free(re);
+    }
+
+    ngx_destroy_pool(pool);
+
+    return ngx_test_failed ? 1 : 0;
+}
+
+#else
+
+int ngx_cdecl
+main(int argc, char *const *argv)
+{
+    printf("built without PCRE, skipped\n");
+
+    return 0;
+}
+
+#endif
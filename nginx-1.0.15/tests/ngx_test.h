@@ -0,0 +1,58 @@
+
+/*
+ * Copyright (C) Igor Sysoev
+ * Copyright (C) Nginx, Inc.
+ */
+
+
+#ifndef _NGX_TEST_H_INCLUDED_
+#define _NGX_TEST_H_INCLUDED_
+
+
+#include <ngx_config.h>
+#include <ngx_core.h>
+
+
+static ngx_open_file_t  ngx_test_log_file;
+static ngx_log_t        ngx_test_log;
+static ngx_cycle_t      ngx_test_cycle;
+static ngx_uint_t       ngx_test_failed;
+
+
+static ngx_inline ngx_log_t *
+ngx_test_init(void)
+{
+    ngx_uint_t  n;
+
+    ngx_test_log_file.fd = ngx_stderr;
+    ngx_test_log.file = &ngx_test_log_file;
+    ngx_test_log.log_level = NGX_LOG_NOTICE;
+
+    ngx_test_cycle.log = &ngx_test_log;
+    ngx_cycle = &ngx_test_cycle;
+
+    ngx_pagesize = getpagesize();
+    for (n = ngx_pagesize; n >>= 1; ngx_pagesize_shift++) { /* void */ }
+
+    ngx_time_init();
+
+    return &ngx_test_log;
+}
+
+
+static void
+ngx_test_fail(const char *fmt, ...)
+{
+    va_list  args;
+
+    ngx_test_failed++;
+
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+
+    printf("\n");
+}
+
+
+#endif /* _NGX_TEST_H_INCLUDED_ */
@@ -0,0 +1,70 @@
+
+# Copyright (C) Igor Sysoev
+# Copyright (C) Nginx, Inc.
+
+
+# Builds the tests against the objects of a configured and built tree
+# and runs them:
+#
+#     ./configure ... && make && make test
+
+
+NGX_OBJS=objs
+NGX_TESTS=$NGX_OBJS/tests
+
+if [ ! -f $NGX_OBJS/Makefile -o ! -f $NGX_OBJS/ngx_modules.o ]; then
+    echo "$0: error: configure and build nginx first"
+    exit 1
+fi
+
+mkdir -p $NGX_TESTS
+
+
+ngx_make_var() {
+    printf 'ngx_make_var:\n\t@echo $(%s)\n' $1 \
+        | make -s -f $NGX_OBJS/Makefile -f - ngx_make_var
+}
+
+CC=`ngx_make_var CC`
+CFLAGS=`ngx_make_var CFLAGS`
+ALL_INCS=`ngx_make_var ALL_INCS`
+
+ngx_link=`sed -n -e '/$(LINK) -o objs\/nginx/,/^$/p' $NGX_OBJS/Makefile`
+
+NGX_TEST_OBJS=`echo "$ngx_link" \
+    | sed -n -e 's/^[ 	]*\(objs\/[^ ]*\.o\).*/\1/p' \
+    | grep -v '^objs/src/core/nginx\.o$'`
+
+NGX_TEST_LIBS=`echo "$ngx_link" \
+    | sed -e '1d' -e '/^[ 	]*objs\//d' -e 's/\\\\$//'`
+
+# nginx.o is linked with its main() renamed
+
+objcopy --redefine-sym main=ngx_nginx_main \
+    $NGX_OBJS/src/core/nginx.o $NGX_TESTS/nginx.o || exit 1
+
+
+ngx_failed=0
+
+for ngx_test in tests/*_test.c
+do
+    ngx_name=`basename $ngx_test .c`
+
+    if ! $CC $CFLAGS $ALL_INCS -o $NGX_TESTS/$ngx_name $ngx_test \
+             $NGX_TESTS/nginx.o $NGX_TEST_OBJS $NGX_TEST_LIBS
+    then
+        echo "$ngx_name: build failed"
+        ngx_failed=1
+        continue
+    fi
+
+    if (cd tests && ../$NGX_TESTS/$ngx_name); then
+        echo "$ngx_name: ok"
+
+    else
+        echo "$ngx_name: FAILED"
+        ngx_failed=1
+    fi
+done
+
+exit $ngx_failed